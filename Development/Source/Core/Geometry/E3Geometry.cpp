@@ -65,6 +65,7 @@
 #include "E3GeometryEllipse.h"
 #include "E3GeometryEllipsoid.h"
 #include "E3GeometryGeneralPolygon.h"
+#include "E3GeometryInstances.h"
 #include "E3GeometryLine.h"
 #include "E3GeometryMarker.h"
 #include "E3GeometryMesh.h"
@@ -80,6 +81,10 @@
 #include "E3GeometryTriGrid.h"
 #include "E3GeometryTriMesh.h"
 
+#if QUESA_PARALLEL_TRAVERSAL
+	#include <mutex>
+#endif
+
 
 
 
@@ -92,6 +97,19 @@
 
 
 
+
+//=============================================================================
+//      Internal variables
+//-----------------------------------------------------------------------------
+#if QUESA_PARALLEL_TRAVERSAL
+static std::mutex	sGeometryCacheLock;
+// Cached representations are rebuilt during traversals, which may be running
+// on several threads, so they are checked and replaced under this lock.
+#endif
+
+
+
+
 //=============================================================================
 //      Internal functions
 //-----------------------------------------------------------------------------
@@ -212,6 +230,10 @@ e3geometry_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 	toInstanceData->instanceData.cachedEditIndex   = 0;
 	toInstanceData->instanceData.cachedObject      = nullptr;
 	toInstanceData->instanceData.cachedDeterminant = 0.0f;
+#if QUESA_GEOMETRY_CULLING
+	toInstanceData->instanceData.cullData.isChecked = kQ3False;
+	toInstanceData->instanceData.cullData.hasBounds = kQ3False;
+#endif
 	
 	return kQ3Success ;
 	}
@@ -259,6 +281,30 @@ e3geometry_submit_decomposed(TQ3ViewObject theView, TQ3ObjectType objectType, TQ
 
 
 
+#if QUESA_PARALLEL_TRAVERSAL
+		// Rebuild the cached object if it's out of date, and take our own
+		// reference in case another thread replaces it while we submit it
+		TQ3Object cachedObject = nullptr ;
+			{
+			std::lock_guard<std::mutex> cacheLock ( sGeometryCacheLock ) ;
+			if ( ! theClass->cacheIsValid ( theView, objectType, theObject,
+				objectData, instanceData->instanceData.cachedObject ) )
+				
+				theClass->cacheUpdate(theView, objectType, theObject, objectData,
+					&instanceData->instanceData.cachedObject);
+			
+			E3Shared_Acquire ( &cachedObject, instanceData->instanceData.cachedObject ) ;
+			}
+
+
+
+		// Submit the cached object (or we fail)
+		if (cachedObject != nullptr)
+			{
+			qd3dStatus = E3View_SubmitRetained(theView, cachedObject);
+			Q3Object_Dispose ( cachedObject ) ;
+			}
+#else
 		// Rebuild the cached object if it's out of date
 		if ( ! theClass->cacheIsValid ( theView, objectType, theObject,
 			objectData, instanceData->instanceData.cachedObject ) )
@@ -271,6 +317,7 @@ e3geometry_submit_decomposed(TQ3ViewObject theView, TQ3ObjectType objectType, TQ
 		// Submit the cached object (or we fail)
 		if (instanceData->instanceData.cachedObject != nullptr)
 			qd3dStatus = E3View_SubmitRetained(theView, instanceData->instanceData.cachedObject);
+#endif
 		}
 
 
@@ -308,12 +355,83 @@ e3geometry_submit_decomposed(TQ3ViewObject theView, TQ3ObjectType objectType, TQ
 
 
 
+#if QUESA_GEOMETRY_CULLING
+//=============================================================================
+//      e3geometry_is_culled : Is a geometry outside the view frustum?
+//-----------------------------------------------------------------------------
+//		Note :	Retained geometries keep their own bounding box for culling,
+//				in local coordinates, which is recalculated when their edit
+//				index changes, or when the subdivision style of the view
+//				changes and the geometry is tessellated according to it. If
+//				the box can't be calculated we remember that too, rather than
+//				trying again for every frame.
+//
+//				Markers are never culled, since their images extend beyond
+//				their bounds, and nothing is culled while the view disallows
+//				group culling.
+//-----------------------------------------------------------------------------
+static TQ3Boolean
+e3geometry_is_culled(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject)
+	{
+	// Check we can cull the geometry
+	if ( theObject == nullptr || ! E3View_IsGroupCullingAllowed ( theView ) )
+		return kQ3False ;
+	
+	if ( objectType == kQ3GeometryTypeMarker || objectType == kQ3GeometryTypePixmapMarker )
+		return kQ3False ;
+
+
+
+	// Recalculate the box if necessary
+	E3GeometryCullData* cullData = ( (E3Geometry*) theObject )->GetCullData () ;
+	E3Instances_UpdateEditIndex ( theObject ) ;
+	TQ3Uns32 editIndex = ( (E3Geometry*) theObject )->GetEditIndex () ;
+	const TQ3SubdivisionStyleData* subdivisionStyle = E3View_State_GetStyleSubdivision ( theView ) ;
+
+	if ( ! cullData->isChecked || cullData->editIndex != editIndex ||
+		( cullData->usesSubdivision &&
+		  memcmp ( &cullData->subdivision, subdivisionStyle, sizeof ( TQ3SubdivisionStyleData ) ) != 0 ) )
+		{
+		cullData->hasBounds = (TQ3Boolean)
+			( E3View_CalcLocalBounds ( theView, theObject, &cullData->bounds, &cullData->usesSubdivision ) == kQ3Success &&
+			  ! cullData->bounds.isEmpty ) ;
+		
+		cullData->subdivision = *subdivisionStyle ;
+		cullData->editIndex   = editIndex ;
+		cullData->isChecked   = kQ3True ;
+		}
+
+
+
+	// Test the box
+	if ( ! cullData->hasBounds )
+		return kQ3False ;
+	
+	return (TQ3Boolean) ! E3Renderer_Method_IsBBoxVisible ( theView, &cullData->bounds ) ;
+	}
+#endif // QUESA_GEOMETRY_CULLING
+
+
+
+
+
 //=============================================================================
 //      e3geometry_render : Geometry render method.
 //-----------------------------------------------------------------------------
 static TQ3Status
 e3geometry_render(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject, const void *objectData)
 	{
+#if QUESA_GEOMETRY_CULLING
+	// Skip the geometry if it can't be seen
+	if ( e3geometry_is_culled ( theView, objectType, theObject ) )
+		{
+		E3View_CountGeometry ( theView, kQ3True ) ;
+		return kQ3Success ;
+		}
+#endif
+
+
+
 	// Get the public data for the geometry object
 	//
 	// The pointer submitted to renderers must be of the public data structure for
@@ -343,6 +461,8 @@ e3geometry_render(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object the
 	// Note that we pass the instance data on if we need to decompose.
 	if ( ! geomSupported )
 		qd3dStatus = e3geometry_submit_decomposed ( theView, objectType, theObject, objectData ) ;
+	else
+		E3View_CountGeometry ( theView, kQ3False ) ;
 
 	return qd3dStatus ;
 	}
@@ -406,6 +526,10 @@ e3geometry_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theOb
 //
 //				This requires that every object be expressible in terms of the
 //				most primitive geometries (which should always be the case).
+//
+//				The decomposed form of geometries which use subdivision depends
+//				on the subdivision style, which the view may not be able to
+//				bound with.
 //-----------------------------------------------------------------------------
 static TQ3Status
 e3geometry_bounds(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject, const void *objectData)
@@ -413,6 +537,14 @@ e3geometry_bounds(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object the
 
 
 
+	// Check we can bound the decomposed form
+	E3ClassInfoPtr theClass = E3ClassTree::GetClass ( objectType ) ;
+	if ( theClass != nullptr && theClass->GetMethod ( kQ3XMethodTypeGeomUsesSubdivision ) != nullptr &&
+		! E3View_CanBoundSubdivision ( theView ) )
+		return(kQ3Success);
+
+
+
 	// Submit the decomposed form
 	qd3dStatus = e3geometry_submit_decomposed(theView, objectType, theObject, objectData);
 
@@ -747,6 +879,9 @@ E3Geometry_RegisterClass ( void )
 	if ( qd3dStatus != kQ3Failure )
 		qd3dStatus = E3GeometryGeneralPolygon_RegisterClass () ;
 
+	if ( qd3dStatus != kQ3Failure )
+		qd3dStatus = E3GeometryInstances_RegisterClass () ;
+
 	if ( qd3dStatus != kQ3Failure )
 		qd3dStatus = E3GeometryLine_RegisterClass () ;
 
@@ -813,6 +948,7 @@ E3Geometry_UnregisterClass(void)
 	E3GeometryEllipse_UnregisterClass();
 	E3GeometryEllipsoid_UnregisterClass();
 	E3GeometryGeneralPolygon_UnregisterClass();
+	E3GeometryInstances_UnregisterClass();
 	E3GeometryLine_UnregisterClass();
 	E3GeometryMarker_UnregisterClass();
 	E3GeometryMesh_UnregisterClass();
@@ -88,6 +88,20 @@ public :
 
 
 
+// Bounding box kept by a geometry for culling
+#if QUESA_GEOMETRY_CULLING
+struct E3GeometryCullData
+{
+	TQ3BoundingBox				bounds;				// local bounds used for culling
+	TQ3SubdivisionStyleData		subdivision;		// style bounds was calculated with
+	TQ3Uns32					editIndex;			// edit index of bounds
+	TQ3Boolean					isChecked;			// bounds has been calculated, or can't be
+	TQ3Boolean					hasBounds;			// bounds can be used for culling
+	TQ3Boolean					usesSubdivision;	// bounds depends on the subdivision style
+};
+#endif
+
+
 // Geometry data
 struct E3GeometryData
 {
@@ -97,6 +111,9 @@ struct E3GeometryData
 	TQ3Uns32					cachedEditIndex;
 	TQ3Object					cachedObject;
 	float						cachedDeterminant;
+#if QUESA_GEOMETRY_CULLING
+	E3GeometryCullData			cullData;
+#endif
 };
 
 
@@ -116,6 +133,9 @@ Q3_CLASS_ENUMS ( kQ3ShapeTypeGeometry, E3Geometry, E3Shape )
 public :
 	
 	E3GeometryInfo*				GetClass ( void ) { return (E3GeometryInfo*) OpaqueTQ3Object::GetClass () ; }
+#if QUESA_GEOMETRY_CULLING
+	E3GeometryCullData*			GetCullData ( void ) { return &instanceData.cullData ; }
+#endif
 	
 	friend TQ3Status			e3geometry_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 					 								TQ3Object toObject,   void       *toPrivateData) ;
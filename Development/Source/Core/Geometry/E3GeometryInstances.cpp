@@ -0,0 +1,706 @@
+/*  NAME:
+        E3GeometryInstances.cpp
+
+    DESCRIPTION:
+        Implementation of Quesa Instances geometry class.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2018, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <http://www.quesa.org/>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3View.h"
+#include "E3Geometry.h"
+#include "E3GeometryInstances.h"
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+
+class E3Instances : public E3Geometry // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+Q3_CLASS_ENUMS ( kQ3GeometryTypeInstances, E3Instances, E3Geometry )
+public :
+
+	TQ3InstancesData		instanceData ;
+	TQ3Uns32				geometryEditIndex ;	// edit index of the geometry when we last looked
+
+	} ;
+	
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3geom_instances_submit_each : Submit the geometry at each placement.
+//-----------------------------------------------------------------------------
+//		Note :	Rather than pushing and popping the view state around each
+//				placement, we replace the local to world matrix directly. The
+//				renderer then sees nothing but a new matrix between submits of
+//				the same geometry, and can draw each placement again without
+//				setting up its state.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_instances_submit_each(TQ3ViewObject theView, const TQ3InstancesData *instanceData)
+{	TQ3Matrix4x4		localToWorld, instanceToWorld;
+	TQ3Status			qd3dStatus = kQ3Success;
+	TQ3Uns32			n;
+
+
+
+	// Nothing to do if there's nothing to place
+	if (instanceData->geometry == nullptr || instanceData->numInstances == 0)
+		return(kQ3Success);
+
+
+
+	// Apply our attributes to every placement
+	if (instanceData->instancesAttributeSet != nullptr)
+		{
+		qd3dStatus = E3Push_Submit(theView);
+		if (qd3dStatus == kQ3Failure)
+			return(qd3dStatus);
+
+		E3View_SubmitRetained(theView, instanceData->instancesAttributeSet);
+		}
+
+
+
+	// Submit the geometry at each placement
+	localToWorld = *E3View_State_GetMatrixLocalToWorld(theView);
+
+	for (n = 0; n < instanceData->numInstances && qd3dStatus == kQ3Success; n++)
+		{
+		Q3Matrix4x4_Multiply(&instanceData->instanceTransforms[n], &localToWorld, &instanceToWorld);
+
+		qd3dStatus = E3View_State_SetMatrix(theView, kQ3MatrixStateLocalToWorld, &instanceToWorld, nullptr, nullptr);
+		if (qd3dStatus == kQ3Success)
+			qd3dStatus = E3View_SubmitRetained(theView, instanceData->geometry);
+		}
+
+
+
+	// Restore the view state
+	E3View_State_SetMatrix(theView, kQ3MatrixStateLocalToWorld, &localToWorld, nullptr, nullptr);
+
+	if (instanceData->instancesAttributeSet != nullptr)
+		E3Pop_Submit(theView);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_places : Does an Instances place an object?
+//-----------------------------------------------------------------------------
+//		Note :	Follows the chain of Instances objects starting at theGeometry,
+//				which can't contain a cycle since we never allow one to be made.
+//-----------------------------------------------------------------------------
+static bool
+e3geom_instances_places(TQ3Object theGeometry, TQ3Object theObject)
+{
+
+
+	// Look for the object along the chain
+	while (theGeometry != nullptr)
+		{
+		if (theGeometry == theObject)
+			return(true);
+
+		if (! Q3_OBJECT_IS_CLASS(theGeometry, E3Instances))
+			break;
+
+		theGeometry = ( (E3Instances*) theGeometry )->instanceData.geometry;
+		}
+
+	return(false);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_new : Instances new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_instances_new( TQ3Object theObject, void * privateData, const void * paramData )
+{
+	TQ3InstancesData *			instanceData  = (TQ3InstancesData *)		privateData ;
+	const TQ3InstancesData *	instancesData = (const TQ3InstancesData *)	paramData ;
+	TQ3Status					qd3dStatus;
+
+
+
+	// Initialise our instance data
+	Q3Memory_Clear(instanceData, sizeof(TQ3InstancesData));
+	
+	qd3dStatus = E3Instances_SetData(theObject, instancesData);
+	
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_delete : Instances delete method.
+//-----------------------------------------------------------------------------
+static void
+e3geom_instances_delete(TQ3Object theObject, void *privateData)
+{	TQ3InstancesData		*instanceData = (TQ3InstancesData *) privateData;
+#pragma unused(theObject)
+
+
+
+	// Dispose of our instance data
+	E3Instances_EmptyData(instanceData);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_duplicate : Instances duplicate method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_instances_duplicate(TQ3Object fromObject, const void *fromPrivateData,
+						   TQ3Object toObject,   void       *toPrivateData)
+{	TQ3InstancesData		*toInstanceData = (TQ3InstancesData *) toPrivateData;
+	TQ3Status				qd3dStatus;
+	TQ3Object				dupObject;
+#pragma unused(fromPrivateData)
+#pragma unused(toObject)
+
+
+
+	// Validate our parameters
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(fromObject),    kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(toPrivateData), kQ3Failure);
+
+
+
+	// Copy the data from fromObject to toObject
+	qd3dStatus = E3Instances_GetData(fromObject, toInstanceData);
+
+
+
+	// Duplicate the geometry and the attribute set
+	if ( (qd3dStatus == kQ3Success) &&
+		(toInstanceData->geometry != nullptr) )
+	{
+		dupObject = Q3Object_Duplicate( toInstanceData->geometry );
+		Q3Object_Dispose( toInstanceData->geometry );
+		toInstanceData->geometry = dupObject;
+		if (dupObject == nullptr)
+		{
+			qd3dStatus = kQ3Failure;
+		}
+	}
+	
+	if ( (qd3dStatus == kQ3Success) &&
+		(toInstanceData->instancesAttributeSet != nullptr) )
+	{
+		dupObject = Q3Object_Duplicate( toInstanceData->instancesAttributeSet );
+		Q3Object_Dispose( toInstanceData->instancesAttributeSet );
+		toInstanceData->instancesAttributeSet = dupObject;
+		if (dupObject == nullptr)
+		{
+			qd3dStatus = kQ3Failure;
+		}
+	}
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_cache_new : Instances cache new method.
+//-----------------------------------------------------------------------------
+//		Note :	The cached form is only needed by file formats, since we can
+//				render, pick, and bound ourselves without it.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3geom_instances_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom, const TQ3InstancesData *geomData)
+{	TQ3GroupObject			theGroup, theInstance;
+	TQ3TransformObject		theTransform;
+	TQ3Uns32				n;
+#pragma unused(theView)
+#pragma unused(theGeom)
+
+
+
+	// Create a group to hold the cached representation
+	theGroup = Q3DisplayGroup_New();
+	if (theGroup == nullptr)
+		{
+		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
+		return(nullptr);
+		}
+
+
+
+	// Add the attributes
+	if (geomData->instancesAttributeSet != nullptr)
+		Q3Group_AddObject(theGroup, geomData->instancesAttributeSet);
+
+
+
+	// Add a group holding a transform and the geometry for each placement
+	if (geomData->geometry != nullptr)
+		{
+		for (n = 0; n < geomData->numInstances; n++)
+			{
+			theInstance  = Q3DisplayGroup_New();
+			theTransform = Q3MatrixTransform_New(&geomData->instanceTransforms[n]);
+			if (theInstance == nullptr || theTransform == nullptr)
+				{
+				Q3Object_CleanDispose(&theInstance);
+				Q3Object_CleanDispose(&theTransform);
+				break;
+				}
+
+			Q3Group_AddObjectAndDispose(theInstance, &theTransform);
+			Q3Group_AddObject(theInstance, geomData->geometry);
+			Q3Group_AddObjectAndDispose(theGroup, &theInstance);
+			}
+		}
+
+	return(theGroup);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_render : Instances render method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_instances_render(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject, const void *objectData)
+{	const TQ3InstancesData			*instanceData = (const TQ3InstancesData *) objectData;
+#pragma unused(objectType)
+#pragma unused(theObject)
+
+
+
+	// Submit each placement
+	//
+	// Each placement is culled separately by the geometry's own render method.
+	return(e3geom_instances_submit_each(theView, instanceData));
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_pick : Instances picking method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_instances_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject, const void *objectData)
+{	const TQ3InstancesData			*instanceData = (const TQ3InstancesData *) objectData;
+	TQ3Status						qd3dStatus;
+#pragma unused(objectType)
+#pragma unused(theObject)
+
+
+
+	// Submit each placement, as parts of ourselves
+	//
+	// As with decomposed objects, hits on the geometry are reported as hits on
+	// the Instances object.
+	E3View_PickStack_BeginDecomposedObject(theView);
+
+	qd3dStatus = e3geom_instances_submit_each(theView, instanceData);
+
+	E3View_PickStack_EndDecomposedObject(theView);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_bounds : Instances bounds method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_instances_bounds(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject, const void *objectData)
+{	const TQ3InstancesData			*instanceData = (const TQ3InstancesData *) objectData;
+#pragma unused(objectType)
+#pragma unused(theObject)
+
+
+
+	// Bound each placement
+	return(e3geom_instances_submit_each(theView, instanceData));
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_get_attribute : Instances get attribute set pointer.
+//-----------------------------------------------------------------------------
+static TQ3AttributeSet *
+e3geom_instances_get_attribute ( E3Instances* instances )
+	{
+	// Return the address of the geometry attribute set
+	return & instances->instanceData.instancesAttributeSet ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3geom_instances_metahandler : Instances metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3geom_instances_metahandler(TQ3XMethodType methodType)
+{	
+	TQ3XFunctionPointer		theMethod = nullptr;
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_delete;
+			break;
+
+		case kQ3XMethodTypeObjectDuplicate:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_duplicate;
+			break;
+
+		case kQ3XMethodTypeGeomCacheNew:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_cache_new;
+			break;
+
+		case kQ3XMethodTypeObjectSubmitRender:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_render;
+			break;
+
+		case kQ3XMethodTypeObjectSubmitPick:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_pick;
+			break;
+
+		case kQ3XMethodTypeObjectSubmitBounds:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_bounds;
+			break;
+		
+		case kQ3XMethodTypeGeomGetAttribute:
+			theMethod = (TQ3XFunctionPointer) e3geom_instances_get_attribute;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3GeometryInstances_RegisterClass : Register the class.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3Status
+E3GeometryInstances_RegisterClass(void)
+	{
+	// Register the class
+	return Q3_REGISTER_CLASS (	kQ3ClassNameGeometryInstances,
+								e3geom_instances_metahandler,
+								E3Instances ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3GeometryInstances_UnregisterClass : Unregister the class.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3GeometryInstances_UnregisterClass(void)
+{	TQ3Status		qd3dStatus;
+
+
+
+	// Unregister the class
+	qd3dStatus = E3ClassTree::UnregisterClass(kQ3GeometryTypeInstances, kQ3True);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Instances_New : Create an Instances object.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3GeometryObject
+E3Instances_New(const TQ3InstancesData *instancesData)
+{	TQ3Object		theObject;
+
+
+
+	// Create the object
+	theObject = E3ClassTree::CreateInstance ( kQ3GeometryTypeInstances, kQ3False, instancesData);
+
+	return(theObject);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Instances_Submit : Submit an Instances object.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Instances_Submit(const TQ3InstancesData *instancesData, TQ3ViewObject theView)
+{	TQ3Status		qd3dStatus;
+
+
+
+	// Submit the geometry
+	qd3dStatus = E3View_SubmitImmediate(theView, kQ3GeometryTypeInstances, instancesData);
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Instances_GetData : Get the data describing the Instances object.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Instances_GetData(TQ3GeometryObject theInstances, TQ3InstancesData *instancesData)
+	{
+	E3Instances* instances = (E3Instances*) theInstances ;
+	TQ3Uns32 theSize = static_cast<TQ3Uns32>(instances->instanceData.numInstances * sizeof(TQ3Matrix4x4)) ;
+
+
+
+	// Copy the transforms
+	instancesData->instanceTransforms = nullptr ;
+
+	if ( theSize != 0 )
+		{
+		instancesData->instanceTransforms = (TQ3Matrix4x4 *) Q3Memory_Allocate ( theSize ) ;
+		if ( instancesData->instanceTransforms == nullptr )
+			return kQ3Failure ;
+		
+		Q3Memory_Copy ( instances->instanceData.instanceTransforms, instancesData->instanceTransforms, theSize ) ;
+		}
+	
+	instancesData->numInstances = instances->instanceData.numInstances ;
+
+
+
+	// Return the objects
+	E3Shared_Acquire ( & instancesData->geometry, instances->instanceData.geometry ) ;
+	E3Shared_Acquire ( & instancesData->instancesAttributeSet, instances->instanceData.instancesAttributeSet ) ;
+	
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Instances_SetData : Set the data that describes an Instances object.
+//-----------------------------------------------------------------------------
+//		Note :	The geometry must be a geometry, and may not be the Instances
+//				itself, or an Instances which places it, since submitting it
+//				would then never end.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Instances_SetData(TQ3GeometryObject theInstances, const TQ3InstancesData *instancesData)
+	{
+	E3Instances* instances = (E3Instances*) theInstances ;
+	TQ3Uns32 theSize = static_cast<TQ3Uns32>(instancesData->numInstances * sizeof(TQ3Matrix4x4)) ;
+	TQ3Matrix4x4* newTransforms = nullptr ;
+
+
+
+	// Check the geometry
+	if ( instancesData->geometry != nullptr )
+		{
+		if ( ! Q3Object_IsType ( instancesData->geometry, kQ3ShapeTypeGeometry ) )
+			{
+			E3ErrorManager_PostError ( kQ3ErrorInvalidObjectType, kQ3False ) ;
+			return kQ3Failure ;
+			}
+		
+		if ( e3geom_instances_places ( instancesData->geometry, theInstances ) )
+			{
+			E3ErrorManager_PostError ( kQ3ErrorInvalidParameter, kQ3False ) ;
+			return kQ3Failure ;
+			}
+		}
+
+
+
+	// Copy the transforms
+	if ( theSize != 0 )
+		{
+		if ( instancesData->instanceTransforms == nullptr )
+			{
+			E3ErrorManager_PostError ( kQ3ErrorInvalidParameter, kQ3False ) ;
+			return kQ3Failure ;
+			}
+		
+		newTransforms = (TQ3Matrix4x4 *) Q3Memory_Allocate ( theSize ) ;
+		if ( newTransforms == nullptr )
+			return kQ3Failure ;
+		
+		Q3Memory_Copy ( instancesData->instanceTransforms, newTransforms, theSize ) ;
+		}
+
+	Q3Memory_Free ( & instances->instanceData.instanceTransforms ) ;
+	instances->instanceData.instanceTransforms = newTransforms ;
+	instances->instanceData.numInstances       = instancesData->numInstances ;
+
+
+
+	// Replace the objects
+	E3Shared_Replace ( & instances->instanceData.geometry, instancesData->geometry ) ;
+	E3Shared_Replace ( & instances->instanceData.instancesAttributeSet, instancesData->instancesAttributeSet ) ;
+
+	instances->geometryEditIndex = 0 ;
+	if ( instances->instanceData.geometry != nullptr )
+		instances->geometryEditIndex = Q3Shared_GetEditIndex ( instances->instanceData.geometry ) ;
+
+	Q3Shared_Edited ( instances ) ;
+	
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Instances_UpdateEditIndex : Track edits to the geometry of Instances.
+//-----------------------------------------------------------------------------
+//		Note :	Editing the geometry of an Instances object changes how the
+//				Instances is drawn, so the caches that are keyed by its edit
+//				index need that index to change too. We can't tell when the
+//				geometry is edited, so callers which are about to read the
+//				edit index of an object call this first: if the object is an
+//				Instances whose geometry has been edited since we last looked,
+//				the Instances is marked as edited.
+//
+//				Other objects are left alone.
+//-----------------------------------------------------------------------------
+void
+E3Instances_UpdateEditIndex(TQ3Object theObject)
+	{
+	// Check the object is an Instances with a geometry
+	if ( theObject == nullptr || ! Q3_OBJECT_IS_CLASS ( theObject, E3Instances ) )
+		return ;
+	
+	E3Instances* instances = (E3Instances*) theObject ;
+	TQ3GeometryObject theGeometry = instances->instanceData.geometry ;
+	if ( theGeometry == nullptr )
+		return ;
+
+
+
+	// Catch up with the geometry, which may itself be an Instances
+	E3Instances_UpdateEditIndex ( theGeometry ) ;
+
+	TQ3Uns32 editIndex = ( (E3Shared*) theGeometry )->GetEditIndex () ;
+	if ( editIndex != instances->geometryEditIndex )
+		{
+		instances->geometryEditIndex = editIndex ;
+		Q3Shared_Edited ( instances ) ;
+		}
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Instances_EmptyData :	Release the memory occupied by the data
+//								structure returned by a previous call to
+//								Q3Instances_GetData.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Instances_EmptyData(TQ3InstancesData *instancesData)
+{
+
+
+	// Release the data
+	Q3Memory_Free ( & instancesData->instanceTransforms ) ;
+	instancesData->numInstances = 0 ;
+	
+	Q3Object_CleanDispose ( & instancesData->geometry ) ;
+	Q3Object_CleanDispose ( & instancesData->instancesAttributeSet ) ;
+
+	return(kQ3Success);
+}
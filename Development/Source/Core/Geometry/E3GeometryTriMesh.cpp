@@ -52,6 +52,7 @@
 #include "E3Geometry.h"
 #include "E3GeometryTriMesh.h"
 #include "E3ErrorManager.h"
+#include "E3BVH.h"
 #include "QuesaMathOperators.hpp"
 
 #include <cstring>
@@ -66,6 +67,10 @@ const TQ3Uns32 kTriMeshNone											= 0;
 const TQ3Uns32 kTriMeshLocked										= (1 << 0);
 const TQ3Uns32 kTriMeshLockedReadOnly								= (1 << 1);
 
+#if QUESA_TRIMESH_PICK_BVH
+const TQ3Uns32 kTriMeshMinTrianglesForBVH							= 256;
+#endif
+
 
 
 
@@ -73,11 +78,27 @@ const TQ3Uns32 kTriMeshLockedReadOnly								= (1 << 1);
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
+// TriMesh shared data
+//
+// Holds the arrays shared by a TriMesh and its duplicates. The geomData of
+// each TriMesh points at these arrays, but each TriMesh keeps its own
+// attribute set (which is always nullptr here).
+typedef struct TQ3TriMeshSharedData {
+	TQ3Uns32			refCount;
+	TQ3TriMeshData		geomData;
+} TQ3TriMeshSharedData;
+
+
 // TriMesh instance data
 typedef struct {
-	TQ3Uns32			theFlags;
-	TQ3Uns32			lockCount;
-	TQ3TriMeshData		geomData;
+	TQ3Uns32				theFlags;
+	TQ3Uns32				lockCount;
+	TQ3TriMeshData			geomData;
+	TQ3TriMeshSharedData	*sharedData;		// nullptr if arrays are not shared
+#if QUESA_TRIMESH_PICK_BVH
+	E3BVH					*pickBVH;			// triangle hierarchy for ray picks, or nullptr
+	TQ3Uns32				pickBVHEditIndex;	// edit index pickBVH was built at
+#endif
 } TQ3TriMeshInstanceData;
 
 
@@ -440,6 +461,129 @@ e3geom_trimesh_copydata(const TQ3TriMeshData *src, TQ3TriMeshData *dst, TQ3Boole
 
 
 
+//=============================================================================
+//      e3geom_trimesh_releasedata : Release the data for a TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	If the arrays are shared with other TriMeshes, we release our
+//				attribute set and our reference to the arrays. Otherwise we
+//				dispose of the data as normal.
+//-----------------------------------------------------------------------------
+static void
+e3geom_trimesh_releasedata(TQ3TriMeshInstanceData *instanceData)
+{	TQ3TriMeshSharedData		*sharedData = instanceData->sharedData;
+
+
+
+	// Dispose of unshared data
+	if (sharedData == nullptr)
+		{
+		e3geom_trimesh_disposedata(&instanceData->geomData);
+		return;
+		}
+
+
+
+	// Release our reference to the shared data
+	Q3Object_CleanDispose(&instanceData->geomData.triMeshAttributeSet);
+	Q3Memory_Clear(&instanceData->geomData, sizeof(TQ3TriMeshData));
+	instanceData->sharedData = nullptr;
+
+	Q3_ASSERT(sharedData->refCount != 0);
+	sharedData->refCount--;
+
+	if (sharedData->refCount == 0)
+		{
+		e3geom_trimesh_disposedata(&sharedData->geomData);
+		Q3Memory_Free(&sharedData);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_trimesh_share : Prepare to share the arrays of a TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	Moves the arrays of an unshared TriMesh into a new shared data
+//				block, without copying them. The TriMesh's geomData continues to
+//				point at the same arrays.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_trimesh_share(TQ3TriMeshInstanceData *instanceData)
+{	TQ3TriMeshSharedData		*sharedData;
+
+
+
+	// Check to see if we're already shared
+	if (instanceData->sharedData != nullptr)
+		return(kQ3Success);
+
+
+
+	// Move the arrays into the shared data
+	sharedData = (TQ3TriMeshSharedData *) Q3Memory_Allocate(sizeof(TQ3TriMeshSharedData));
+	if (sharedData == nullptr)
+		return(kQ3Failure);
+
+	sharedData->refCount                     = 1;
+	sharedData->geomData                     = instanceData->geomData;
+	sharedData->geomData.triMeshAttributeSet = nullptr;
+
+	instanceData->sharedData = sharedData;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_trimesh_make_unique : Stop sharing the arrays of a TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	Must be called before the arrays of a TriMesh are modified. If
+//				the arrays are still shared with another TriMesh we take our own
+//				copy, otherwise we simply take ownership of them.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_trimesh_make_unique(TQ3TriMeshInstanceData *instanceData)
+{	TQ3TriMeshSharedData		*sharedData = instanceData->sharedData;
+	TQ3TriMeshData				theCopy;
+	TQ3Status					qd3dStatus;
+
+
+
+	// Check to see if we're shared
+	if (sharedData == nullptr)
+		return(kQ3Success);
+
+
+
+	// If we're the last user of the shared data, the arrays are now ours
+	if (sharedData->refCount == 1)
+		{
+		Q3Memory_Free(&instanceData->sharedData);
+		return(kQ3Success);
+		}
+
+
+
+	// Otherwise, copy the arrays and release our reference to the originals
+	qd3dStatus = e3geom_trimesh_copydata(&instanceData->geomData, &theCopy, kQ3False);
+	if (qd3dStatus != kQ3Success)
+		return(qd3dStatus);
+
+	e3geom_trimesh_releasedata(instanceData);
+	instanceData->geomData = theCopy;
+
+	return(kQ3Success);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_trimesh_get_geom_data : Get the TQ3TriMeshData for a TriMesh.
 //-----------------------------------------------------------------------------
@@ -475,6 +619,92 @@ e3geom_trimesh_get_geom_data(TQ3Object theObject, const void *objectData)
 
 
 
+#if QUESA_TRIMESH_PICK_BVH
+//=============================================================================
+//      e3geom_trimesh_get_pick_bvh : Get the triangle hierarchy of a TriMesh.
+//-----------------------------------------------------------------------------
+//		Note :	The hierarchy is built in local coordinates the first time a
+//				large TriMesh is ray picked, and rebuilt if the TriMesh has been
+//				edited since. Immediate mode TriMeshes, and TriMeshes that are
+//				locked for writing, do not have one.
+//-----------------------------------------------------------------------------
+static const E3BVH *
+e3geom_trimesh_get_pick_bvh(TQ3Object theObject, const void *objectData)
+{	TQ3TriMeshInstanceData		*instanceData;
+	TQ3BoundingBox				*triBounds;
+	TQ3Uns32					n, editIndex;
+
+
+
+	// Check we can use a hierarchy
+	if (theObject == nullptr)
+		return(nullptr);
+
+	instanceData = (TQ3TriMeshInstanceData *) objectData;
+	const TQ3TriMeshData& geomData = instanceData->geomData;
+
+	if (geomData.numTriangles < kTriMeshMinTrianglesForBVH)
+		return(nullptr);
+
+	if (instanceData->lockCount != 0 && !E3Bit_IsSet(instanceData->theFlags, kTriMeshLockedReadOnly))
+		return(nullptr);
+
+
+
+	// Check for an up to date hierarchy
+	editIndex = Q3Shared_GetEditIndex(theObject);
+	if (instanceData->pickBVH != nullptr && instanceData->pickBVHEditIndex == editIndex)
+		return(instanceData->pickBVH);
+
+
+
+	// Bound each triangle
+	triBounds = (TQ3BoundingBox *) Q3Memory_Allocate(static_cast<TQ3Uns32>(geomData.numTriangles * sizeof(TQ3BoundingBox)));
+	if (triBounds == nullptr)
+		return(nullptr);
+
+	for (n = 0; n < geomData.numTriangles; ++n)
+		{
+		const TQ3Point3D& p0 = geomData.points[ geomData.triangles[n].pointIndices[0] ];
+		const TQ3Point3D& p1 = geomData.points[ geomData.triangles[n].pointIndices[1] ];
+		const TQ3Point3D& p2 = geomData.points[ geomData.triangles[n].pointIndices[2] ];
+
+		triBounds[n].min.x   = std::min( p0.x, std::min( p1.x, p2.x ) );
+		triBounds[n].min.y   = std::min( p0.y, std::min( p1.y, p2.y ) );
+		triBounds[n].min.z   = std::min( p0.z, std::min( p1.z, p2.z ) );
+		triBounds[n].max.x   = std::max( p0.x, std::max( p1.x, p2.x ) );
+		triBounds[n].max.y   = std::max( p0.y, std::max( p1.y, p2.y ) );
+		triBounds[n].max.z   = std::max( p0.z, std::max( p1.z, p2.z ) );
+		triBounds[n].isEmpty = kQ3False;
+		}
+
+
+
+	// Build the hierarchy
+	try
+		{
+		if (instanceData->pickBVH == nullptr)
+			instanceData->pickBVH = new E3BVH;
+
+		instanceData->pickBVH->Build(geomData.numTriangles, triBounds);
+		instanceData->pickBVHEditIndex = editIndex;
+		}
+	catch (...)
+		{
+		delete instanceData->pickBVH;
+		instanceData->pickBVH = nullptr;
+		}
+
+	Q3Memory_Free(&triBounds);
+
+	return(instanceData->pickBVH);
+}
+#endif
+
+
+
+
+
 //=============================================================================
 //      e3geom_trimesh_optimize_normals : Optimise TriMesh normals.
 //-----------------------------------------------------------------------------
@@ -638,6 +868,9 @@ e3geom_trimesh_new(TQ3Object theObject, void *privateData, const void *paramData
 
 	// Initialise the TriMesh, then optimise it
 	instanceData->theFlags = kTriMeshNone;
+#if QUESA_TRIMESH_PICK_BVH
+	instanceData->pickBVH  = nullptr;
+#endif
 	qd3dStatus = e3geom_trimesh_copydata(trimeshData, &instanceData->geomData,
 		kQ3False);
 	
@@ -671,6 +904,9 @@ e3geom_trimesh_new_nocopy(TQ3Object theObject, void *privateData, const void *pa
 
 	// Initialise the TriMesh, then optimise it
 	instanceData->theFlags = kTriMeshNone;
+#if QUESA_TRIMESH_PICK_BVH
+	instanceData->pickBVH  = nullptr;
+#endif
 
 	Q3Memory_Copy( trimeshData, &instanceData->geomData, sizeof(TQ3TriMeshData) );
 	
@@ -704,7 +940,12 @@ e3geom_trimesh_delete(TQ3Object theObject, void *privateData)
 
 
 	// Dispose of our instance data
-	e3geom_trimesh_disposedata(&instanceData->geomData);
+	e3geom_trimesh_releasedata(instanceData);
+
+#if QUESA_TRIMESH_PICK_BVH
+	delete instanceData->pickBVH;
+	instanceData->pickBVH = nullptr;
+#endif
 }
 
 
@@ -714,6 +955,10 @@ e3geom_trimesh_delete(TQ3Object theObject, void *privateData)
 //=============================================================================
 //      e3geom_trimesh_duplicate : TriMesh duplicate method.
 //-----------------------------------------------------------------------------
+//		Note :	Unless the original is locked for writing, the duplicate shares
+//				its arrays until one of them is changed. The attribute set is
+//				always duplicated.
+//-----------------------------------------------------------------------------
 static TQ3Status
 e3geom_trimesh_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 						  TQ3Object toObject,  void       *toPrivateData)
@@ -732,8 +977,45 @@ e3geom_trimesh_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 
 	// Initialise the instance data of the new object
+	//
+	// The duplicate builds its own pick hierarchy if it is picked.
 	toData->theFlags = fromData->theFlags;
-	qd3dStatus       = e3geom_trimesh_copydata( &fromData->geomData, &toData->geomData, kQ3True );
+#if QUESA_TRIMESH_PICK_BVH
+	toData->pickBVH  = nullptr;
+#endif
+
+#if QUESA_SHARE_GEOMETRY_DATA
+	if (fromData->lockCount == 0 || E3Bit_IsSet(fromData->theFlags, kTriMeshLockedReadOnly))
+		{
+		// Share the arrays of the original
+		//
+		// The instance data of the original is updated to refer to the shared
+		// arrays, although its contents are unchanged.
+		qd3dStatus = e3geom_trimesh_share((TQ3TriMeshInstanceData *) fromData);
+		if (qd3dStatus != kQ3Success)
+			return(qd3dStatus);
+
+		toData->geomData                     = fromData->geomData;
+		toData->geomData.triMeshAttributeSet = nullptr;
+
+		if (fromData->geomData.triMeshAttributeSet != nullptr)
+			{
+			toData->geomData.triMeshAttributeSet = Q3Object_Duplicate(fromData->geomData.triMeshAttributeSet);
+			if (toData->geomData.triMeshAttributeSet == nullptr)
+				{
+				Q3Memory_Clear(&toData->geomData, sizeof(TQ3TriMeshData));
+				return(kQ3Failure);
+				}
+			}
+
+		toData->sharedData = fromData->sharedData;
+		toData->sharedData->refCount++;
+
+		return(kQ3Success);
+		}
+#endif
+
+	qd3dStatus = e3geom_trimesh_copydata( &fromData->geomData, &toData->geomData, kQ3True );
 
 	return(qd3dStatus);
 }
@@ -952,25 +1234,83 @@ e3geom_trimesh_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 
 
 
+//=============================================================================
+//      e3geom_trimesh_record_triangle_hit : Record a hit on a triangle.
+//-----------------------------------------------------------------------------
+//		Note :	p0, p1, and p2 are the world coordinates of the triangle, and
+//				theHit is the hit on it.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_trimesh_record_triangle_hit( TQ3ViewObject			theView,
+									TQ3PickObject			thePick,
+									const TQ3TriMeshData	*geomData,
+									TQ3Uns32				triIndex,
+									const TQ3Point3D&		p0,
+									const TQ3Point3D&		p1,
+									const TQ3Point3D&		p2,
+									TQ3Param3D&				theHit )
+{	TQ3TriangleData					worldTriangle;
+	TQ3Param2D						hitUV, *resultUV;
+	TQ3Vector3D						hitNormal;
+	TQ3Point3D						hitXYZ;
+	TQ3Boolean						haveUV;
+	TQ3Status						qd3dStatus;
+
+
+
+	// Create the triangle, and update the vertices to the transformed coordinates
+	e3geom_trimesh_triangle_new(theView, geomData, triIndex, &worldTriangle);
+	worldTriangle.vertices[0].point = p0;
+	worldTriangle.vertices[1].point = p1;
+	worldTriangle.vertices[2].point = p2;
+
+
+	// Obtain the XYZ, normal, and UV for the hit point. We always return an
+	// XYZ and normal for the hit, however we need to cope with missing UVs.
+	E3Triangle_InterpolateHit(theView,&worldTriangle, &theHit,
+		&hitXYZ, &hitNormal, &hitUV, &haveUV);
+	resultUV = (haveUV ? &hitUV : nullptr);
+
+
+	// Record the hit
+	qd3dStatus = E3Pick_RecordHit(thePick, theView, &hitXYZ, &hitNormal,
+		resultUV, nullptr, &theHit, triIndex );
+
+
+	// Clean up
+	e3geom_trimesh_triangle_delete(&worldTriangle);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_trimesh_pick_with_ray : TriMesh ray picking method.
 //-----------------------------------------------------------------------------
+//		Note :	If pickBVH is not nullptr, it is used to find the triangles
+//				that an exact pick may hit instead of testing them all.
+//
+//				If the pick only keeps its closest hit, exact picks skip the
+//				mesh, or any triangle, that lies beyond the hit it has so far.
+//-----------------------------------------------------------------------------
 static TQ3Status
 e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 								TQ3PickObject			thePick,
 								const TQ3Ray3D			*theRay,
-								const TQ3TriMeshData	*geomData )
+								const TQ3TriMeshData	*geomData,
+								const E3BVH				*pickBVH )
 {	TQ3Uns32						n, numPoints, v0, v1, v2;
-	TQ3Boolean						haveUV, cullBackface;
-	TQ3Param2D						hitUV, *resultUV;
+	TQ3Boolean						cullBackface;
 	TQ3BackfacingStyle				backfacingStyle;
-	TQ3TriangleData					worldTriangle;
 	TQ3Point3D						*worldPoints;
 	TQ3Status						qd3dStatus;
-	TQ3Vector3D						hitNormal;
-	TQ3Point3D						hitXYZ;
 	TQ3Param3D						theHit;
 	TQ3BoundingBox					worldBounds;
+	TQ3Point3D						boundsHit;
+	float							rayLimit = kQ3MaxFloat;
 	
 
 
@@ -1045,14 +1385,71 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 	else // no tolerance to worry about, look for exact hit in world space
 	{
 		E3BoundingBox_Transform( &geomData->bBox, localToWorld, &worldBounds );
-		if (! E3Ray3D_IntersectBoundingBox( theRay, &worldBounds, nullptr ))
+		if (! E3Ray3D_IntersectBoundingBox( theRay, &worldBounds, &boundsHit ))
 		{
 			// The ray misses the bounds, so it misses the mesh.
 			return kQ3Success;
 		}
+		
+		// If the ray enters the bounds beyond the closest hit so far, the
+		// mesh can't provide a nearer one.
+		rayLimit = E3Pick_GetClosestHitRayLimit( thePick, theRay );
+		if ( (rayLimit < kQ3MaxFloat) &&
+			(Q3Dot3D( boundsHit - theRay->origin, theRay->direction ) >
+				rayLimit * Q3LengthSquared3D( theRay->direction )) )
+		{
+			return kQ3Success;
+		}
 	}
 
 
+	// Determine if we should cull back-facing triangles or not
+	qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+	cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+
+
+
+	// If we have a triangle hierarchy, take the ray into local coordinates to
+	// find the triangles it may hit, and test just those in world coordinates.
+	//
+	// This needs an affine transform, so that the distance along the ray is the
+	// same in both coordinate systems. Tolerant picks test every triangle.
+	if (pickBVH != nullptr && !useTolerance && qd3dStatus == kQ3Success &&
+		localToWorld->value[0][3] == 0.0f && localToWorld->value[1][3] == 0.0f &&
+		localToWorld->value[2][3] == 0.0f && localToWorld->value[3][3] == 1.0f &&
+		E3Matrix4x4_Determinant(localToWorld) != 0.0f)
+	{
+		TQ3Matrix4x4	worldToLocal;
+		TQ3Ray3D		localRay;
+		E3Matrix4x4_Invert( localToWorld, &worldToLocal );
+		E3Point3D_Transform( &theRay->origin, &worldToLocal, &localRay.origin );
+		E3Vector3D_Transform( &theRay->direction, &worldToLocal, &localRay.direction );
+
+		auto pickTriangle = [&]( TQ3Uns32 triIndex, float& ioMaxDistance ) -> bool
+		{
+			const TQ3Uns32* pointIndices = geomData->triangles[ triIndex ].pointIndices;
+			TQ3Point3D p0 = geomData->points[ pointIndices[0] ] * *localToWorld;
+			TQ3Point3D p1 = geomData->points[ pointIndices[1] ] * *localToWorld;
+			TQ3Point3D p2 = geomData->points[ pointIndices[2] ] * *localToWorld;
+
+			if (E3Ray3D_IntersectTriangle( *theRay, p0, p1, p2, cullBackface, theHit ) &&
+				theHit.w <= ioMaxDistance)
+			{
+				qd3dStatus = e3geom_trimesh_record_triangle_hit( theView, thePick,
+					geomData, triIndex, p0, p1, p2, theHit );
+				ioMaxDistance = std::min( ioMaxDistance,
+					E3Pick_GetClosestHitRayLimit( thePick, theRay ) );
+			}
+
+			return qd3dStatus == kQ3Success;
+		};
+
+		pickBVH->TraverseRay( localRay, rayLimit, pickTriangle );
+		return(qd3dStatus);
+	}
+
+
+
 	// Transform our points from local to world coordinates
 	numPoints   = geomData->numPoints;
 	worldPoints = (TQ3Point3D *) Q3Memory_Allocate(static_cast<TQ3Uns32>(numPoints * sizeof(TQ3Point3D)));
@@ -1060,7 +1457,7 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 		return(kQ3Failure);
 
 	Q3Point3D_To3DTransformArray(geomData->points,
-								 E3View_State_GetMatrixLocalToWorld(theView),
+								 localToWorld,
 								 worldPoints,
 								 numPoints,
 								 sizeof(TQ3Point3D),
@@ -1068,12 +1465,6 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 
 
 
-	// Determine if we should cull back-facing triangles or not
-	qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
-	cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
-
-
-
 	// See if we fall within the pick
 	//
 	// Note we do not use any vertex/edge tolerances supplied for the pick, since
@@ -1119,35 +1510,20 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 				}
 			}
 		}
-		else // require exact hits
+		else // require exact hits, no farther than the closest so far
 		{
 			didHit = E3Ray3D_IntersectTriangle( *theRay,
 				p0, p1, p2, cullBackface, theHit );
+			if (didHit && theHit.w > rayLimit)
+				didHit = kQ3False;
 		}
 
 		if (didHit)
 		{
-			// Create the triangle, and update the vertices to the transformed coordinates
-			e3geom_trimesh_triangle_new(theView, geomData, n, &worldTriangle);
-			worldTriangle.vertices[0].point = p0;
-			worldTriangle.vertices[1].point = p1;
-			worldTriangle.vertices[2].point = p2;
-
-
-			// Obtain the XYZ, normal, and UV for the hit point. We always return an
-			// XYZ and normal for the hit, however we need to cope with missing UVs.
-			E3Triangle_InterpolateHit(theView,&worldTriangle, &theHit,
-				&hitXYZ, &hitNormal, &hitUV, &haveUV);
-			resultUV = (haveUV ? &hitUV : nullptr);
-
-
-			// Record the hit
-			qd3dStatus = E3Pick_RecordHit(thePick, theView, &hitXYZ, &hitNormal,
-				resultUV, nullptr, &theHit, n );
-
-
-			// Clean up
-			e3geom_trimesh_triangle_delete(&worldTriangle);
+			qd3dStatus = e3geom_trimesh_record_triangle_hit(theView, thePick,
+				geomData, n, p0, p1, p2, theHit);
+			if (!useTolerance)
+				rayLimit = E3Pick_GetClosestHitRayLimit( thePick, theRay );
 		}
 	}
 
@@ -1174,7 +1550,7 @@ e3geom_trimesh_find_line_point_in_area( const TQ3Area& inRect,
 										TQ3Point3D& outInArea )
 {
 	TQ3Point2D	startPt = { inPtOne.x, inPtOne.y };
-	TQ3Point2D	endPt = { inPtOne.x, inPtOne.y };
+	TQ3Point2D	endPt = { inPtTwo.x, inPtTwo.y };
 	TQ3Point2D	clipStart = startPt;
 	TQ3Point2D	clipEnd = endPt;
 	
@@ -1218,25 +1594,88 @@ e3geom_trimesh_find_line_point_in_area( const TQ3Area& inRect,
 //				coordinates and an area in window space, try to find a point
 //				in both the triangle and the area.
 //-----------------------------------------------------------------------------
+//		Note :	The clip codes are those of the vertices against the area, as
+//				returned by E3Rect_GetClipCodes. They let us accept a triangle
+//				with a vertex inside the area, and reject one lying wholly to
+//				one side of it, before clipping any edges.
+//
+//				If the triangle overlaps the area but no edge crosses it, the
+//				area lies inside the triangle and we return its centre.
+//-----------------------------------------------------------------------------
 static TQ3Boolean
 e3geom_trimesh_find_triangle_point_in_area( const TQ3Area& inRect,
 											const TQ3Point3D& inVert1,
 											const TQ3Point3D& inVert2,
 											const TQ3Point3D& inVert3,
+											TQ3Uns8 inCode1,
+											TQ3Uns8 inCode2,
+											TQ3Uns8 inCode3,
 											TQ3Point3D& outInArea )
 {
-	TQ3Boolean	foundPoint = kQ3False;
 
+
+	// Accept a vertex in the area
+	if (inCode1 == 0)
+	{
+		outInArea = inVert1;
+		return kQ3True;
+	}
+
+	if (inCode2 == 0)
+	{
+		outInArea = inVert2;
+		return kQ3True;
+	}
+
+	if (inCode3 == 0)
+	{
+		outInArea = inVert3;
+		return kQ3True;
+	}
+
+
+
+	// Reject a triangle outside one side of the area
+	if ((inCode1 & inCode2 & inCode3) != 0)
+		return kQ3False;
+
+
+
+	// Clip the edges that may cross the area
 	if (
-		e3geom_trimesh_find_line_point_in_area( inRect, inVert1, inVert2, outInArea ) ||
-		e3geom_trimesh_find_line_point_in_area( inRect, inVert1, inVert3, outInArea ) ||
-		e3geom_trimesh_find_line_point_in_area( inRect, inVert2, inVert3, outInArea )
+		(((inCode1 & inCode2) == 0) && e3geom_trimesh_find_line_point_in_area( inRect, inVert1, inVert2, outInArea )) ||
+		(((inCode1 & inCode3) == 0) && e3geom_trimesh_find_line_point_in_area( inRect, inVert1, inVert3, outInArea )) ||
+		(((inCode2 & inCode3) == 0) && e3geom_trimesh_find_line_point_in_area( inRect, inVert2, inVert3, outInArea ))
 	)
 	{
-		foundPoint = kQ3True;
+		return kQ3True;
 	}
-	
-	return foundPoint;
+
+
+
+	// Otherwise see if the centre of the area is inside the triangle
+	float	centreX = 0.5f * (inRect.min.x + inRect.max.x);
+	float	centreY = 0.5f * (inRect.min.y + inRect.max.y);
+	float	theDet  = (inVert2.y - inVert3.y) * (inVert1.x - inVert3.x) +
+					  (inVert3.x - inVert2.x) * (inVert1.y - inVert3.y);
+
+	if (fabsf( theDet ) < kQ3RealZero)
+		return kQ3False;
+
+	float	b1 = ((inVert2.y - inVert3.y) * (centreX - inVert3.x) +
+				  (inVert3.x - inVert2.x) * (centreY - inVert3.y)) / theDet;
+	float	b2 = ((inVert3.y - inVert1.y) * (centreX - inVert3.x) +
+				  (inVert1.x - inVert3.x) * (centreY - inVert3.y)) / theDet;
+	float	b3 = 1.0f - b1 - b2;
+
+	if (b1 < 0.0f || b2 < 0.0f || b3 < 0.0f)
+		return kQ3False;
+
+	outInArea.x = centreX;
+	outInArea.y = centreY;
+	outInArea.z = b1 * inVert1.z + b2 * inVert2.z + b3 * inVert3.z;
+
+	return kQ3True;
 }
 
 
@@ -1246,6 +1685,10 @@ e3geom_trimesh_find_triangle_point_in_area( const TQ3Area& inRect,
 //=============================================================================
 //      e3geom_trimesh_pick_with_rect : TriMesh rect picking method.
 //-----------------------------------------------------------------------------
+//		Note :	All of the points are projected to window coordinates, and
+//				clip coded against the rect, in one pass before the triangles
+//				are tested.
+//-----------------------------------------------------------------------------
 static TQ3Status
 e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 								TQ3PickObject			thePick,
@@ -1253,8 +1696,8 @@ e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 								const TQ3TriMeshData	*geomData)
 {	TQ3Matrix4x4		worldToFrustum, frustumToWindow, worldToWindow, localToWindow;
 	TQ3Uns32			n, numPoints, v0, v1, v2;
-	TQ3Point2D			triVertices[3];
 	TQ3Point3D			*windowPoints;
+	TQ3Uns8				*clipCodes;
 	TQ3Status			qd3dStatus;
 
 
@@ -1265,6 +1708,13 @@ e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 	if (windowPoints == nullptr)
 		return(kQ3Failure);
 
+	clipCodes = (TQ3Uns8 *) Q3Memory_Allocate(static_cast<TQ3Uns32>(numPoints * sizeof(TQ3Uns8)));
+	if (clipCodes == nullptr)
+		{
+		Q3Memory_Free(&windowPoints);
+		return(kQ3Failure);
+		}
+
 	Q3View_GetWorldToFrustumMatrixState(theView,  &worldToFrustum);
 	Q3View_GetFrustumToWindowMatrixState(theView, &frustumToWindow);
 	Q3Matrix4x4_Multiply( &worldToFrustum, &frustumToWindow, &worldToWindow );
@@ -1273,6 +1723,8 @@ e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 	Q3Point3D_To3DTransformArray(geomData->points, &localToWindow, windowPoints,
 		numPoints, sizeof(TQ3Point3D), sizeof(TQ3Point3D));
 
+	E3Rect_GetClipCodes(theRect, numPoints, windowPoints, clipCodes);
+
 
 
 	// See if we fall within the pick
@@ -1289,21 +1741,11 @@ e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 		Q3_ASSERT(v2 >= 0 && v2 < geomData->numPoints);
 
 
-		// Set up the 2D component of the triangle
-		triVertices[0].x = windowPoints[v0].x;
-		triVertices[0].y = windowPoints[v0].y;
-
-		triVertices[1].x = windowPoints[v1].x;
-		triVertices[1].y = windowPoints[v1].y;
-
-		triVertices[2].x = windowPoints[v2].x;
-		triVertices[2].y = windowPoints[v2].y;
-
-
 		// See if this triangle falls within the pick
 		TQ3Point3D	windowHitPt;
-		if (e3geom_trimesh_find_triangle_point_in_area( *theRect, windowPoints[v0],
-			windowPoints[v1], windowPoints[v2], windowHitPt ))
+		if (e3geom_trimesh_find_triangle_point_in_area( *theRect,
+			windowPoints[v0], windowPoints[v1], windowPoints[v2],
+			clipCodes[v0],    clipCodes[v1],    clipCodes[v2], windowHitPt ))
 			{
 			TQ3Matrix4x4	windowToWorld;
 			Q3Matrix4x4_Invert( &worldToWindow, &windowToWorld );
@@ -1317,6 +1759,7 @@ e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 
 
 	// Clean up
+	Q3Memory_Free(&clipCodes);
 	Q3Memory_Free(&windowPoints);
 
 	return(qd3dStatus);			
@@ -1331,11 +1774,18 @@ e3geom_trimesh_pick_with_rect(TQ3ViewObject				theView,
 //-----------------------------------------------------------------------------
 //		Note :	Returns a 2D bounding rect that encloses the eight vertices of
 //				our bounding box when projected to the screen.
+//
+//				If any of those vertices is at or behind the eye, its
+//				projection is meaningless, and we return an unbounded rect so
+//				that the caller falls back to testing the triangles.
 //-----------------------------------------------------------------------------
 static void
 e3geom_trimesh_pick_screen_bounds(TQ3ViewObject theView, const TQ3TriMeshData *geomData, TQ3Area *windowBounds)
 {	TQ3Matrix4x4		theMatrix, worldToFrustum, frustumToWindow;
-	TQ3BoundingBox		windowBoundingBox;
+	TQ3Point3D			theCorners[8];
+	TQ3RationalPoint4D	windowCorners[8];
+	TQ3Uns32			n;
+
 
 
 	// Compute the local to window coordinate transformation matrix
@@ -1343,17 +1793,38 @@ e3geom_trimesh_pick_screen_bounds(TQ3ViewObject theView, const TQ3TriMeshData *g
 	Q3View_GetFrustumToWindowMatrixState(theView, &frustumToWindow);
 	Q3Matrix4x4_Multiply(E3View_State_GetMatrixLocalToWorld(theView), &worldToFrustum, &theMatrix);
 	Q3Matrix4x4_Multiply(&theMatrix, &frustumToWindow, &theMatrix);
-	
-	
-	// Compute a bounding box in window coordinates
-	E3BoundingBox_Transform(  &geomData->bBox, &theMatrix, &windowBoundingBox );
-	
-	
+
+
+
+	// Transform the corners of our bounding box, keeping w
+	E3BoundingBox_GetCorners(&geomData->bBox, theCorners);
+	Q3Point3D_To4DTransformArray(theCorners, &theMatrix, windowCorners, 8,
+		sizeof(TQ3Point3D), sizeof(TQ3RationalPoint4D));
+
+
+
 	// Return the window bounds, discarding depth
-	windowBounds->min.x = windowBoundingBox.min.x;
-	windowBounds->max.x = windowBoundingBox.max.x;
-	windowBounds->min.y = windowBoundingBox.min.y;
-	windowBounds->max.y = windowBoundingBox.max.y;
+	windowBounds->min.x = windowBounds->min.y =  kQ3MaxFloat;
+	windowBounds->max.x = windowBounds->max.y = -kQ3MaxFloat;
+
+	for (n = 0; n < 8; ++n)
+		{
+		if (windowCorners[n].w <= 0.0f)
+			{
+			windowBounds->min.x = windowBounds->min.y = -kQ3MaxFloat;
+			windowBounds->max.x = windowBounds->max.y =  kQ3MaxFloat;
+			break;
+			}
+
+		float	invW = 1.0f / windowCorners[n].w;
+		float	x    = windowCorners[n].x * invW;
+		float	y    = windowCorners[n].y * invW;
+
+		windowBounds->min.x = E3Num_Min(windowBounds->min.x, x);
+		windowBounds->max.x = E3Num_Max(windowBounds->max.x, x);
+		windowBounds->min.y = E3Num_Min(windowBounds->min.y, y);
+		windowBounds->max.y = E3Num_Max(windowBounds->max.y, y);
+		}
 }
 
 
@@ -1364,7 +1835,8 @@ e3geom_trimesh_pick_screen_bounds(TQ3ViewObject theView, const TQ3TriMeshData *g
 //      e3geom_trimesh_pick_window_point : TriMesh window-point picking method.
 //-----------------------------------------------------------------------------
 static TQ3Status
-e3geom_trimesh_pick_window_point(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData)
+e3geom_trimesh_pick_window_point(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData,
+									const E3BVH *pickBVH)
 {
 	TQ3Status					qd3dStatus;
 	TQ3Ray3D					theRay;
@@ -1374,7 +1846,7 @@ e3geom_trimesh_pick_window_point(TQ3ViewObject theView, TQ3PickObject thePick, c
 	E3View_GetRayThroughPickPoint(theView, &theRay);
 	
 	qd3dStatus = e3geom_trimesh_pick_with_ray( theView, thePick, &theRay,
-			geomData );
+			geomData, pickBVH );
 
 	return(qd3dStatus);
 }
@@ -1441,7 +1913,8 @@ e3geom_trimesh_pick_window_rect(TQ3ViewObject theView, TQ3PickObject thePick, co
 //      e3geom_trimesh_pick_world_ray : TriMesh world-ray picking method.
 //-----------------------------------------------------------------------------
 static TQ3Status
-e3geom_trimesh_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData)
+e3geom_trimesh_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData,
+								const E3BVH *pickBVH)
 {
 	TQ3Status					qd3dStatus;
 	TQ3Ray3D					pickRay;
@@ -1454,8 +1927,142 @@ e3geom_trimesh_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, cons
 
 
 	qd3dStatus = e3geom_trimesh_pick_with_ray( theView, thePick,
-			&pickRay, geomData );
+			&pickRay, geomData, pickBVH );
+
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_trimesh_pick_ray_batch : TriMesh world-ray batch picking method.
+//-----------------------------------------------------------------------------
+//		Note :	If we have a triangle hierarchy, the active rays of the batch
+//				are taken down it together, and each triangle is tested
+//				against the rays which reach it four at a time. Otherwise, or
+//				if the pick is tolerant or the transform is not affine, each
+//				ray is picked on its own.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_trimesh_pick_ray_batch(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData,
+								const E3BVH *pickBVH)
+{
+	const TQ3Matrix4x4*			localToWorld = E3View_State_GetMatrixLocalToWorld(theView);
+	const TQ3Uns32*				activeRays;
+	TQ3Uns32					numRays = E3WorldRayBatchPick_GetActiveRays(thePick, &activeRays);
+	TQ3BackfacingStyle			backfacingStyle;
+	TQ3Status					qd3dStatus;
+	TQ3Ray3D					pickRay;
+	float						faceTolerance;
+	TQ3Uns32					n;
+
+
+
+	// Check we have something to do
+	if (numRays == 0)
+		return(kQ3Success);
+
+
+
+	// Pick each ray on its own if we can't take them down the hierarchy together
+	E3Pick_GetFaceTolerance( thePick, &faceTolerance );
+	qd3dStatus = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+
+	if (pickBVH == nullptr || faceTolerance * faceTolerance > kQ3RealZero || qd3dStatus != kQ3Success ||
+		localToWorld->value[0][3] != 0.0f || localToWorld->value[1][3] != 0.0f ||
+		localToWorld->value[2][3] != 0.0f || localToWorld->value[3][3] != 1.0f ||
+		E3Matrix4x4_Determinant(localToWorld) == 0.0f)
+	{
+		qd3dStatus = kQ3Success;
+		for (n = 0; n < numRays && qd3dStatus == kQ3Success; ++n)
+		{
+			E3WorldRayBatchPick_SetCurrentRay( thePick, activeRays[n] );
+			E3WorldRayPick_GetRay( thePick, &pickRay );
+			qd3dStatus = e3geom_trimesh_pick_with_ray( theView, thePick, &pickRay, geomData, pickBVH );
+		}
+
+		E3WorldRayBatchPick_SetCurrentRay( thePick, kQ3ArrayIndexNULL );
+		return(qd3dStatus);
+	}
+
+	TQ3Boolean cullBackface = (backfacingStyle == kQ3BackfacingStyleRemove) ? kQ3True : kQ3False;
+
+
+
+	try
+	{
+		// Take the rays into local coordinates, and find how far along each
+		// of them a hit would still be nearer than the one it has
+		std::vector<TQ3Ray3D>		worldRays( numRays );
+		std::vector<TQ3Ray3D>		localRays( numRays );
+		std::vector<TQ3Vector3D>	worldInverses( numRays );
+		std::vector<float>			rayLimits( numRays );
+		TQ3Matrix4x4				worldToLocal;
+
+		E3Matrix4x4_Invert( localToWorld, &worldToLocal );
+		for (n = 0; n < numRays; ++n)
+		{
+			E3WorldRayBatchPick_GetRay( thePick, activeRays[n], &worldRays[n] );
+			E3Point3D_Transform( &worldRays[n].origin, &worldToLocal, &localRays[n].origin );
+			E3Vector3D_Transform( &worldRays[n].direction, &worldToLocal, &localRays[n].direction );
+			worldInverses[n] = E3Ray3D_GetInverseDirection( worldRays[n] );
+			rayLimits[n]     = E3WorldRayBatchPick_GetRayLimit( thePick, activeRays[n] );
+		}
+
+
+
+		// Test each triangle in world coordinates against the rays which reach it
+		auto pickTriangle = [&]( TQ3Uns32 triIndex, const TQ3Uns32* rayIndices, TQ3Uns32 numTriRays ) -> bool
+		{
+			const TQ3Uns32* pointIndices = geomData->triangles[ triIndex ].pointIndices;
+			TQ3Point3D p0 = geomData->points[ pointIndices[0] ] * *localToWorld;
+			TQ3Point3D p1 = geomData->points[ pointIndices[1] ] * *localToWorld;
+			TQ3Point3D p2 = geomData->points[ pointIndices[2] ] * *localToWorld;
+			E3RayPacket	thePacket;
+			TQ3Param3D	theHits[ kE3RayPacketSize ];
+
+			for (TQ3Uns32 first = 0; first < numTriRays && qd3dStatus == kQ3Success; first += kE3RayPacketSize)
+			{
+				TQ3Uns32 numLanes = std::min( kE3RayPacketSize, numTriRays - first );
+
+				E3RayPacket_Clear( thePacket );
+				for (TQ3Uns32 lane = 0; lane < numLanes; ++lane)
+				{
+					TQ3Uns32 r = rayIndices[ first + lane ];
+					E3RayPacket_SetLane( thePacket, lane, worldRays[r], worldInverses[r], rayLimits[r] );
+				}
+
+				TQ3Uns32 hitMask = E3Ray3D_IntersectTrianglePacket( thePacket, p0, p1, p2,
+																	cullBackface, theHits );
+
+				for (TQ3Uns32 lane = 0; lane < numLanes && qd3dStatus == kQ3Success; ++lane)
+				{
+					if ((hitMask & (1U << lane)) == 0)
+						continue;
+
+					TQ3Uns32 r = rayIndices[ first + lane ];
+					E3WorldRayBatchPick_SetCurrentRay( thePick, activeRays[r] );
+					qd3dStatus = e3geom_trimesh_record_triangle_hit( theView, thePick,
+						geomData, triIndex, p0, p1, p2, theHits[lane] );
+					rayLimits[r] = std::min( rayLimits[r],
+						E3WorldRayBatchPick_GetRayLimit( thePick, activeRays[r] ) );
+				}
+			}
 
+			return qd3dStatus == kQ3Success;
+		};
+
+		pickBVH->TraverseRays( numRays, &localRays[0], &rayLimits[0], pickTriangle );
+	}
+	catch (...)
+	{
+		qd3dStatus = kQ3Failure;
+	}
+
+	E3WorldRayBatchPick_SetCurrentRay( thePick, kQ3ArrayIndexNULL );
 
 	return(qd3dStatus);
 }
@@ -1473,6 +2080,7 @@ e3geom_trimesh_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object t
 #pragma unused( objectType )
 	TQ3Status				qd3dStatus;
 	const TQ3TriMeshData	*geomData;
+	const E3BVH				*pickBVH = nullptr;
 	TQ3PickObject			thePick;
 
 
@@ -1487,7 +2095,10 @@ e3geom_trimesh_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object t
 	thePick = E3View_AccessPick(theView);
 	switch (Q3Pick_GetType(thePick)) {
 		case kQ3PickTypeWindowPoint:
-			qd3dStatus = e3geom_trimesh_pick_window_point(theView, thePick, geomData);
+#if QUESA_TRIMESH_PICK_BVH
+			pickBVH    = e3geom_trimesh_get_pick_bvh(theObject, objectData);
+#endif
+			qd3dStatus = e3geom_trimesh_pick_window_point(theView, thePick, geomData, pickBVH);
 			break;
 
 		case kQ3PickTypeWindowRect:
@@ -1495,7 +2106,13 @@ e3geom_trimesh_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object t
 			break;
 
 		case kQ3PickTypeWorldRay:
-			qd3dStatus = e3geom_trimesh_pick_world_ray(theView, thePick, geomData);
+#if QUESA_TRIMESH_PICK_BVH
+			pickBVH    = e3geom_trimesh_get_pick_bvh(theObject, objectData);
+#endif
+			if (E3Pick_IsRayBatch(thePick))
+				qd3dStatus = e3geom_trimesh_pick_ray_batch(theView, thePick, geomData, pickBVH);
+			else
+				qd3dStatus = e3geom_trimesh_pick_world_ray(theView, thePick, geomData, pickBVH);
 			break;
 
 		default:
@@ -1632,6 +2249,10 @@ e3geom_trimesh_metahandler(TQ3XMethodType methodType)
 		case kQ3XMethodTypeGeomUsesOrientation:
 			theMethod = (TQ3XFunctionPointer) kQ3True;
 			break;
+
+		case kQ3XMethodTypeGeomPicksRayBatch:
+			theMethod = (TQ3XFunctionPointer) kQ3True;
+			break;
 		}
 	
 	return(theMethod);
@@ -1751,7 +2372,7 @@ E3TriMesh_SetData(TQ3GeometryObject theTriMesh, const TQ3TriMeshData *triMeshDat
 	E3TriMesh* triMesh = (E3TriMesh*) theTriMesh ;
 
 	// Dispose of the existing data
-	e3geom_trimesh_disposedata ( & triMesh->instanceData.geomData ) ;
+	e3geom_trimesh_releasedata ( & triMesh->instanceData ) ;
 
 
 
@@ -1821,6 +2442,9 @@ E3TriMesh_EmptyData(TQ3TriMeshData *triMeshData)
 //		Note :	Our current implementation does not require locking, and so we
 //				can simply return a pointer to the TriMesh instance data.
 //
+//				If the TriMesh shares its arrays with a duplicate, it must take
+//				its own copy before it can be locked for writing.
+//
 //				We will eventually be able to move responsibility for geometry
 //				data down to the renderer objects, at which time we will need
 //				to keep a flag indicating if a TriMesh is locked.
@@ -1839,6 +2463,15 @@ E3TriMesh_LockData(TQ3GeometryObject theTriMesh, TQ3Boolean readOnly, TQ3TriMesh
 	// then this lock had better be read-only, lest the code that did the outer
 	// lock gets confused.
 	Q3_ASSERT( (triMesh->instanceData.lockCount == 0) || readOnly );
+
+
+
+	// Make sure we can be modified
+	if ( ! readOnly )
+		{
+		if ( e3geom_trimesh_make_unique ( & triMesh->instanceData ) != kQ3Success )
+			return kQ3Failure ;
+		}
 	
 
 
@@ -1922,6 +2555,12 @@ E3TriMesh_AddTriangleNormals(TQ3GeometryObject theTriMesh, TQ3OrientationStyle t
 
 
 
+	// Make sure we can be modified
+	if ( e3geom_trimesh_make_unique ( & triMesh->instanceData ) != kQ3Success )
+		return ;
+
+
+
 	// Allocate the normals
 	TQ3Uns32 theSize    = static_cast<TQ3Uns32>(triMesh->instanceData.geomData.numTriangles * sizeof ( TQ3Vector3D ));
 	TQ3Vector3D* theNormals = (TQ3Vector3D *) Q3Memory_Allocate ( theSize ) ;
@@ -175,8 +175,8 @@ Q3Notice_Register(TQ3NoticeMethod noticePost, TQ3Int32 reference)
 //-----------------------------------------------------------------------------
 TQ3Error
 Q3Error_Get(TQ3Error *firstError)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
-	TQ3Boolean		saveState;
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
+	TQ3Boolean			saveState;
 
 
 
@@ -191,12 +191,12 @@ Q3Error_Get(TQ3Error *firstError)
 
 
 	// Call the bottleneck, saving the state around it
-	saveState                      = theGlobals->systemDoBottleneck;
-	theGlobals->systemDoBottleneck = kQ3False;
+	saveState                    = theState->systemDoBottleneck;
+	theState->systemDoBottleneck = kQ3False;
 
 	E3System_Bottleneck();
 	
-	theGlobals->systemDoBottleneck = saveState;
+	theState->systemDoBottleneck = saveState;
 
 
 
@@ -237,8 +237,8 @@ Q3Error_IsFatalError(TQ3Error error)
 //-----------------------------------------------------------------------------
 TQ3Warning
 Q3Warning_Get(TQ3Warning *firstWarning)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
-	TQ3Boolean		saveState;
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
+	TQ3Boolean			saveState;
 
 
 
@@ -254,12 +254,12 @@ Q3Warning_Get(TQ3Warning *firstWarning)
 
 
 	// Call the bottleneck, saving the state around it
-	saveState                      = theGlobals->errMgrClearWarning;
-	theGlobals->errMgrClearWarning = kQ3False;
+	saveState                    = theState->errMgrClearWarning;
+	theState->errMgrClearWarning = kQ3False;
 
 	E3System_Bottleneck();
 	
-	theGlobals->errMgrClearWarning = saveState;
+	theState->errMgrClearWarning = saveState;
 
 
 
@@ -279,8 +279,8 @@ Q3Warning_Get(TQ3Warning *firstWarning)
 //-----------------------------------------------------------------------------
 TQ3Notice
 Q3Notice_Get(TQ3Notice *firstNotice)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
-	TQ3Boolean		saveState;
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
+	TQ3Boolean			saveState;
 
 
 
@@ -296,12 +296,12 @@ Q3Notice_Get(TQ3Notice *firstNotice)
 
 
 	// Call the bottleneck, saving the state around it
-	saveState                     = theGlobals->errMgrClearNotice;
-	theGlobals->errMgrClearNotice = kQ3False;
+	saveState                   = theState->errMgrClearNotice;
+	theState->errMgrClearNotice = kQ3False;
 
 	E3System_Bottleneck();
 	
-	theGlobals->errMgrClearNotice = saveState;
+	theState->errMgrClearNotice = saveState;
 
 
 
@@ -322,8 +322,8 @@ Q3Notice_Get(TQ3Notice *firstNotice)
 #if QUESA_ALLOW_QD3D_EXTENSIONS
 TQ3Uns32
 Q3Error_PlatformGet(TQ3Uns32 *firstErr)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
-	TQ3Boolean		saveState;
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
+	TQ3Boolean			saveState;
 
 
 
@@ -339,12 +339,12 @@ Q3Error_PlatformGet(TQ3Uns32 *firstErr)
 
 
 	// Call the bottleneck, saving the state around it
-	saveState                       = theGlobals->errMgrClearPlatform;
-	theGlobals->errMgrClearPlatform = kQ3False;
+	saveState                     = theState->errMgrClearPlatform;
+	theState->errMgrClearPlatform = kQ3False;
 
 	E3System_Bottleneck();
 	
-	theGlobals->errMgrClearPlatform = saveState;
+	theState->errMgrClearPlatform = saveState;
 
 
 
@@ -380,6 +380,37 @@ Q3Error_PlatformPost(TQ3Uns32 theErr)
 
 
 
+
+//=============================================================================
+//      Q3Error_DrainReports : Quesa API entry point.
+//-----------------------------------------------------------------------------
+//		Note :	Does not call the bottleneck, since this routine is part of
+//				the Error Manager and should not clear existing state.
+//-----------------------------------------------------------------------------
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+TQ3Uns32
+Q3Error_DrainReports(TQ3ErrorReport *reports, TQ3Uns32 maxReports)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(reports), 0);
+
+
+
+	// Debug build checks
+
+
+
+	// Call our implementation
+	return(E3Error_DrainReports(reports, maxReports));
+}
+#endif
+
+
+
+
+
 //=============================================================================
 //      Q3Error_ToString : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -53,6 +53,7 @@
 #include "E3GeometryEllipse.h"
 #include "E3GeometryEllipsoid.h"
 #include "E3GeometryGeneralPolygon.h"
+#include "E3GeometryInstances.h"
 #include "E3GeometryLine.h"
 #include "E3GeometryMarker.h"
 #include "E3GeometryMesh.h"
@@ -3549,6 +3550,159 @@ Q3GeneralPolygon_GetShapeHint(TQ3GeometryObject generalPolygon, TQ3GeneralPolygo
 
 
 
+//=============================================================================
+//      Q3Instances_New : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3GeometryObject
+Q3Instances_New(const TQ3InstancesData *instancesData)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(instancesData), nullptr);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Instances_New(instancesData));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Instances_Submit : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Instances_Submit(const TQ3InstancesData *instancesData, TQ3ViewObject view)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(instancesData), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Instances_Submit(instancesData, view));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Instances_SetData : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Instances_SetData(TQ3GeometryObject instances, const TQ3InstancesData *instancesData)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(instances, (kQ3GeometryTypeInstances)), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(instancesData), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Instances_SetData(instances, instancesData));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Instances_GetData : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Instances_GetData(TQ3GeometryObject instances, TQ3InstancesData *instancesData)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(instances, (kQ3GeometryTypeInstances)), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(instancesData), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Instances_GetData(instances, instancesData));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Instances_EmptyData : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Instances_EmptyData(TQ3InstancesData *instancesData)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(instancesData), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Instances_EmptyData(instancesData));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3Line_New : Quesa API entry point.
 //-----------------------------------------------------------------------------
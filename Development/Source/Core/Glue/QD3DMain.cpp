@@ -399,6 +399,125 @@ Q3ObjectHierarchy_EmptySubClassData(TQ3SubClassData *subClassData)
 
 
 
+//=============================================================================
+//      Q3Stats_IsAvailable : Quesa API entry point.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3Boolean
+Q3Stats_IsAvailable(void)
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Stats_IsAvailable());
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Stats_Reset : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Stats_Reset(void)
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Stats_Reset());
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Stats_GetClassStatistics : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Stats_GetClassStatistics(TQ3ObjectType classType, TQ3ClassStatistics *info)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(info), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Stats_GetClassStatistics(classType, info));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Stats_Dump : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Stats_Dump(const char *fileName)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(fileName), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Stats_Dump(fileName));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3Object_Dispose : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -462,6 +581,36 @@ Q3Object_CleanDispose(TQ3Object *object)
 
 
 
+//=============================================================================
+//      Q3Object_DisposeArray : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Object_DisposeArray(TQ3Uns32 numObjects, TQ3Object *theObjects)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(numObjects == 0 || Q3_VALID_PTR(theObjects), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return OpaqueTQ3Object::DisposeArray ( numObjects, theObjects ) ;
+}
+
+
+
+
+
 /*!
  *	@function
  *		Q3Object_GetWeakReference
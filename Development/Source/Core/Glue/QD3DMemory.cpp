@@ -512,6 +512,84 @@ Q3Memory_GetStatistics(
 
 
 
+//=============================================================================
+//      Q3Memory_StartProfiling : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Memory_StartProfiling( TQ3Uns32 sampleInterval )
+{
+	#if Q3_DEBUG
+		// Call the bottleneck
+		E3System_Bottleneck();
+
+
+		// Call our implementation
+		return E3Memory_StartProfiling( sampleInterval );
+
+	#else
+		#pragma unused( sampleInterval )
+		return kQ3Failure;
+	#endif
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Memory_StopProfiling : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Memory_StopProfiling(void)
+{
+	#if Q3_DEBUG
+		// Call the bottleneck
+		E3System_Bottleneck();
+
+
+		// Call our implementation
+		return E3Memory_StopProfiling();
+
+	#else
+		return kQ3Failure;
+	#endif
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Memory_DumpProfile : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Memory_DumpProfile( const char* fileName, TQ3Boolean countCalls )
+{
+	#if Q3_DEBUG
+
+		// Release build checks
+		Q3_REQUIRE_OR_RESULT( Q3_VALID_PTR(fileName), kQ3Failure );
+
+
+
+		// Call the bottleneck
+		E3System_Bottleneck();
+
+
+
+		// Call our implementation
+		return E3Memory_DumpProfile( fileName, countCalls );
+
+	#else
+		#pragma unused( fileName, countCalls )
+		return kQ3Failure;
+	#endif
+}
+
+
+
+
+
 /*!
 	@function	Q3Memory_GetObjectCount
 	@abstract	Get a count of Quesa objects currently in existence.
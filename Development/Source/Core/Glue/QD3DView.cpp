@@ -566,6 +566,37 @@ Q3View_EndPicking(TQ3ViewObject view)
 
 
 
+//=============================================================================
+//      Q3View_SubmitParallel : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3View_SubmitParallel(TQ3ViewObject view, TQ3GroupObject group, TQ3Uns32 numThreads)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT( E3Group::IsOfMyClass ( group ), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3View_SubmitParallel(view, group, numThreads));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3View_GetCamera : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -1012,6 +1043,39 @@ Q3View_AllowAllGroupCulling(TQ3ViewObject view, TQ3Boolean allowCulling)
 
 
 
+
+//=============================================================================
+//      Q3View_GetGeometryCounts : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3View_GetGeometryCounts(TQ3ViewObject view, TQ3Uns32 *numSubmitted, TQ3Uns32 *numCulled)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(numSubmitted), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(numCulled), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3View_GetGeometryCounts(view, numSubmitted, numCulled));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3View_TransformLocalToWorld : Quesa API entry point.
 //-----------------------------------------------------------------------------
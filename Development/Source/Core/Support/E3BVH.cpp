@@ -0,0 +1,395 @@
+/*  NAME:
+        E3BVH.cpp
+
+    DESCRIPTION:
+        Bounding volume hierarchy over an array of bounding boxes.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2018, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <http://www.quesa.org/>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3BVH.h"
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+const TQ3Uns32 kBVHNumBins											= 16;
+const TQ3Uns32 kBVHMinLeafSize										= 4;
+const TQ3Uns32 kBVHMaxLeafSize										= 16;
+const float    kBVHTraversalCost									= 1.0f;
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+namespace
+{
+	// A range of items waiting to become a node
+	struct BuildTask
+	{
+		TQ3Uns32	first;
+		TQ3Uns32	count;
+		TQ3Uns32	depth;
+		TQ3Uns32	parent;		// node whose right child this is, or ~0U
+	};
+	
+	
+	// Items whose centroids fall in a bin
+	struct SplitBin
+	{
+		TQ3Point3D	min;
+		TQ3Point3D	max;
+		TQ3Uns32	count;
+	};
+}
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3bvh_empty_bounds : Reset a min/max pair so that anything extends it.
+//-----------------------------------------------------------------------------
+static inline void
+e3bvh_empty_bounds( TQ3Point3D& outMin, TQ3Point3D& outMax )
+{
+	outMin.x = outMin.y = outMin.z =  kQ3MaxFloat;
+	outMax.x = outMax.y = outMax.z = -kQ3MaxFloat;
+}
+
+
+
+
+
+//=============================================================================
+//      e3bvh_extend_bounds : Extend a min/max pair to include another.
+//-----------------------------------------------------------------------------
+static inline void
+e3bvh_extend_bounds( TQ3Point3D& ioMin, TQ3Point3D& ioMax,
+					const TQ3Point3D& inMin, const TQ3Point3D& inMax )
+{
+	ioMin.x = std::min( ioMin.x, inMin.x );
+	ioMin.y = std::min( ioMin.y, inMin.y );
+	ioMin.z = std::min( ioMin.z, inMin.z );
+	ioMax.x = std::max( ioMax.x, inMax.x );
+	ioMax.y = std::max( ioMax.y, inMax.y );
+	ioMax.z = std::max( ioMax.z, inMax.z );
+}
+
+
+
+
+
+//=============================================================================
+//      e3bvh_half_area : Half the surface area of a min/max pair.
+//-----------------------------------------------------------------------------
+static inline float
+e3bvh_half_area( const TQ3Point3D& inMin, const TQ3Point3D& inMax )
+{
+	float	dx = inMax.x - inMin.x;
+	float	dy = inMax.y - inMin.y;
+	float	dz = inMax.z - inMin.z;
+
+	return dx * dy + dy * dz + dz * dx;
+}
+
+
+
+
+
+//=============================================================================
+//      Private functions
+//-----------------------------------------------------------------------------
+//      E3BVH::FilterRays : Find the rays which hit a node.
+//-----------------------------------------------------------------------------
+//		Note :	Tests the rays whose indices are in ioRayIndices between
+//				inBegin and inEnd, and appends those that hit the node.
+//-----------------------------------------------------------------------------
+void
+E3BVH::FilterRays( const E3BVHNode& inNode, const TQ3Ray3D* inRays,
+					const TQ3Vector3D* inInvDirections, const float* inMaxDistances,
+					TQ3Uns32 inBegin, TQ3Uns32 inEnd,
+					std::vector<TQ3Uns32>& ioRayIndices ) const
+{	TQ3BoundingBox		nodeBounds;
+	E3RayPacket			thePacket;
+	TQ3Uns32			packetRays[ kE3RayPacketSize ];
+
+
+
+	nodeBounds.min     = inNode.min;
+	nodeBounds.max     = inNode.max;
+	nodeBounds.isEmpty = kQ3False;
+
+	for (TQ3Uns32 n = inBegin; n < inEnd; n += kE3RayPacketSize)
+	{
+		// Fill a packet with the next rays
+		TQ3Uns32 numLanes = std::min( kE3RayPacketSize, inEnd - n );
+
+		E3RayPacket_Clear( thePacket );
+		for (TQ3Uns32 lane = 0; lane < numLanes; ++lane)
+		{
+			TQ3Uns32 rayIndex = ioRayIndices[ n + lane ];
+			packetRays[ lane ] = rayIndex;
+			E3RayPacket_SetLane( thePacket, lane, inRays[ rayIndex ],
+								inInvDirections[ rayIndex ], inMaxDistances[ rayIndex ] );
+		}
+
+
+
+		// And keep the ones which hit
+		TQ3Uns32 hitMask = E3Ray3D_IntersectBoundingBoxPacket( thePacket, nodeBounds );
+		for (TQ3Uns32 lane = 0; lane < numLanes; ++lane)
+		{
+			if ((hitMask & (1U << lane)) != 0)
+				ioRayIndices.push_back( packetRays[ lane ] );
+		}
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3BVH::clear : Release the hierarchy.
+//-----------------------------------------------------------------------------
+void
+E3BVH::clear()
+{
+	std::vector<E3BVHNode>().swap( mNodes );
+	std::vector<TQ3Uns32>().swap( mItems );
+}
+
+
+
+
+
+//=============================================================================
+//      E3BVH::Build : Build the hierarchy for an array of boxes.
+//-----------------------------------------------------------------------------
+//		Note :	Nodes are created depth first, so that the left child of each
+//				interior node directly follows it. The right child's index is
+//				patched into its parent when the right child is created.
+//
+//				Each range is split at the cheapest of the planes between
+//				kBVHNumBins bins along the longest axis of its centroids. If
+//				the centroids all coincide, or the best plane leaves one side
+//				empty, the range is split in half instead.
+//-----------------------------------------------------------------------------
+void
+E3BVH::Build( TQ3Uns32 inNumItems, const TQ3BoundingBox* inItemBounds )
+{
+	std::vector<TQ3Point3D>	centroids;
+	std::vector<BuildTask>	tasks;
+	SplitBin				bins[ kBVHNumBins ];
+	float					rightArea[ kBVHNumBins ];
+	TQ3Uns32				rightCount[ kBVHNumBins ];
+
+
+
+	// Start again
+	mNodes.clear();
+	mItems.clear();
+
+	if (inNumItems == 0)
+		return;
+
+	mItems.resize( inNumItems );
+	centroids.resize( inNumItems );
+	for (TQ3Uns32 n = 0; n < inNumItems; ++n)
+	{
+		mItems[n] = n;
+		centroids[n].x = 0.5f * (inItemBounds[n].min.x + inItemBounds[n].max.x);
+		centroids[n].y = 0.5f * (inItemBounds[n].min.y + inItemBounds[n].max.y);
+		centroids[n].z = 0.5f * (inItemBounds[n].min.z + inItemBounds[n].max.z);
+	}
+
+	mNodes.reserve( 2 * (inNumItems / kBVHMinLeafSize) + 1 );
+
+	BuildTask	rootTask = { 0, inNumItems, 0, ~0U };
+	tasks.push_back( rootTask );
+
+
+
+	// Build the nodes
+	while (! tasks.empty())
+	{
+		BuildTask	theTask = tasks.back();
+		tasks.pop_back();
+		
+		TQ3Uns32	nodeIndex = static_cast<TQ3Uns32>(mNodes.size());
+		mNodes.push_back( E3BVHNode() );
+		if (theTask.parent != ~0U)
+			mNodes[ theTask.parent ].first = nodeIndex;
+
+
+		// Bound the items, and their centroids
+		TQ3Point3D	boxMin, boxMax, centMin, centMax;
+		e3bvh_empty_bounds( boxMin, boxMax );
+		e3bvh_empty_bounds( centMin, centMax );
+		
+		TQ3Uns32*	items = &mItems[ theTask.first ];
+		for (TQ3Uns32 n = 0; n < theTask.count; ++n)
+		{
+			const TQ3BoundingBox&	itemBox = inItemBounds[ items[n] ];
+			e3bvh_extend_bounds( boxMin, boxMax, itemBox.min, itemBox.max );
+			e3bvh_extend_bounds( centMin, centMax, centroids[ items[n] ], centroids[ items[n] ] );
+		}
+		
+		mNodes[ nodeIndex ].min   = boxMin;
+		mNodes[ nodeIndex ].max   = boxMax;
+		mNodes[ nodeIndex ].first = theTask.first;
+		mNodes[ nodeIndex ].count = theTask.count;
+		
+		if (theTask.count <= kBVHMinLeafSize || theTask.depth >= kE3BVHMaxDepth)
+			continue;
+
+
+		// Find the longest axis of the centroids
+		int		axis = 0;
+		float	extent[3] = { centMax.x - centMin.x, centMax.y - centMin.y, centMax.z - centMin.z };
+		if (extent[1] > extent[axis])
+			axis = 1;
+		if (extent[2] > extent[axis])
+			axis = 2;
+
+		TQ3Uns32	numLeft = theTask.count / 2;
+		if (extent[axis] > 0.0f)
+		{
+			// Sort the items into bins
+			float	axisMin  = (&centMin.x)[ axis ];
+			float	binScale = kBVHNumBins * (1.0f - 1.0e-5f) / extent[axis];
+			
+			for (TQ3Uns32 b = 0; b < kBVHNumBins; ++b)
+			{
+				e3bvh_empty_bounds( bins[b].min, bins[b].max );
+				bins[b].count = 0;
+			}
+			
+			for (TQ3Uns32 n = 0; n < theTask.count; ++n)
+			{
+				TQ3Uns32	b = static_cast<TQ3Uns32>(((&centroids[ items[n] ].x)[ axis ] - axisMin) * binScale);
+				b = std::min( b, kBVHNumBins - 1 );
+				const TQ3BoundingBox&	itemBox = inItemBounds[ items[n] ];
+				e3bvh_extend_bounds( bins[b].min, bins[b].max, itemBox.min, itemBox.max );
+				bins[b].count += 1;
+			}
+
+
+			// Sweep from the right, then from the left, to cost each plane
+			TQ3Point3D	sweepMin, sweepMax;
+			TQ3Uns32	sweepCount = 0;
+			e3bvh_empty_bounds( sweepMin, sweepMax );
+			for (TQ3Uns32 b = kBVHNumBins - 1; b > 0; --b)
+			{
+				e3bvh_extend_bounds( sweepMin, sweepMax, bins[b].min, bins[b].max );
+				sweepCount += bins[b].count;
+				rightArea[b]  = (sweepCount == 0) ? 0.0f : e3bvh_half_area( sweepMin, sweepMax );
+				rightCount[b] = sweepCount;
+			}
+			
+			float		bestCost  = kQ3MaxFloat;
+			TQ3Uns32	bestPlane = 0;
+			sweepCount = 0;
+			e3bvh_empty_bounds( sweepMin, sweepMax );
+			for (TQ3Uns32 b = 1; b < kBVHNumBins; ++b)
+			{
+				e3bvh_extend_bounds( sweepMin, sweepMax, bins[b - 1].min, bins[b - 1].max );
+				sweepCount += bins[b - 1].count;
+				if (sweepCount == 0 || rightCount[b] == 0)
+					continue;
+
+				float	theCost = e3bvh_half_area( sweepMin, sweepMax ) * sweepCount +
+								  rightArea[b] * rightCount[b];
+				if (theCost < bestCost)
+				{
+					bestCost  = theCost;
+					bestPlane = b;
+				}
+			}
+
+
+			// Stay a leaf if splitting does not pay for the extra node
+			float	nodeArea = e3bvh_half_area( boxMin, boxMax );
+			float	leafCost = static_cast<float>(theTask.count);
+			if (bestPlane != 0 && nodeArea > 0.0f)
+				bestCost = kBVHTraversalCost + bestCost / nodeArea;
+			
+			if (bestPlane != 0 && bestCost >= leafCost && theTask.count <= kBVHMaxLeafSize)
+				continue;
+
+
+			// Partition the items about the chosen plane
+			if (bestPlane != 0)
+			{
+				TQ3Uns32*	middle = std::partition( items, items + theTask.count,
+					[&]( TQ3Uns32 inItem )
+					{
+						TQ3Uns32	b = static_cast<TQ3Uns32>(((&centroids[ inItem ].x)[ axis ] - axisMin) * binScale);
+						return std::min( b, kBVHNumBins - 1 ) < bestPlane;
+					} );
+				numLeft = static_cast<TQ3Uns32>(middle - items);
+			}
+			
+			if (numLeft == 0 || numLeft == theTask.count)
+				numLeft = theTask.count / 2;
+		}
+
+
+		// Queue the children, right first so that the left is created next
+		mNodes[ nodeIndex ].count = 0;
+		
+		BuildTask	rightTask = { theTask.first + numLeft, theTask.count - numLeft,
+								  theTask.depth + 1, nodeIndex };
+		BuildTask	leftTask  = { theTask.first, numLeft, theTask.depth + 1, ~0U };
+		tasks.push_back( rightTask );
+		tasks.push_back( leftTask );
+	}
+}
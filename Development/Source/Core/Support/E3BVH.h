@@ -0,0 +1,421 @@
+/*  NAME:
+        E3BVH.h
+
+    DESCRIPTION:
+        Bounding volume hierarchy over an array of bounding boxes.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2018, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <http://www.quesa.org/>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3BVH_HDR
+#define E3BVH_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Math_Intersect.h"
+
+#include <algorithm>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+// BVH node
+//
+// The left child of an interior node immediately follows it in the node
+// array, and first holds the index of its right child. For a leaf, first
+// is the offset of its items in the item array and count is their number.
+struct E3BVHNode
+{
+	TQ3Point3D				min;
+	TQ3Point3D				max;
+	TQ3Uns32				first;
+	TQ3Uns32				count;
+};
+
+
+
+
+
+/*!
+	@class		E3BVH
+	
+	@abstract	Bounding volume hierarchy over an array of bounding boxes.
+	
+	@discussion	The hierarchy is built top-down with a binned surface area
+				heuristic, and stored as a flat array of nodes. It only holds
+				the indices of the boxes it was built from, so the caller
+				keeps whatever the boxes stand for and tests the candidates
+				that a traversal returns.
+				
+				Build may throw std::bad_alloc.
+*/
+class E3BVH
+{
+public:
+	void				Build( TQ3Uns32 inNumItems, const TQ3BoundingBox* inItemBounds );
+	void				clear();
+	bool				empty() const { return mNodes.empty(); }
+
+	/*!
+		@function	TraverseRay
+		@abstract	Visit the items whose boxes may be hit by a ray.
+		@discussion	Nodes are visited roughly front to back. The visitor is
+					called as ioVisitor( itemIndex, ioMaxDistance ), where
+					ioMaxDistance is in units of the ray's direction and may
+					be reduced by the visitor to skip farther nodes. If the
+					visitor returns false, the traversal stops.
+	*/
+	template <typename Visitor>
+	void				TraverseRay( const TQ3Ray3D& inRay, float inMaxDistance,
+									Visitor& ioVisitor ) const;
+
+	/*!
+		@function	TraverseRays
+		@abstract	Visit the items whose boxes may be hit by any of several
+					rays.
+		@discussion	Each node is tested against the rays which reached its
+					parent, in packets of four, and only the rays which hit
+					it are carried down to its children. The visitor is
+					called as ioVisitor( itemIndex, rayIndices, numRays ),
+					with the indices of the rays which reached the item's
+					leaf. It may reduce ioMaxDistances[ rayIndex ] to skip
+					farther nodes for that ray. If it returns false, the
+					traversal stops.
+					
+					May throw std::bad_alloc.
+	*/
+	template <typename Visitor>
+	void				TraverseRays( TQ3Uns32 inNumRays, const TQ3Ray3D* inRays,
+									float* ioMaxDistances, Visitor& ioVisitor ) const;
+
+private:
+	bool				IntersectNode( const E3BVHNode& inNode,
+									const TQ3Ray3D& inRay,
+									const TQ3Vector3D& inInvDirection,
+									float inMaxDistance,
+									float& outNear ) const;
+	
+	void				FilterRays( const E3BVHNode& inNode,
+									const TQ3Ray3D* inRays,
+									const TQ3Vector3D* inInvDirections,
+									const float* inMaxDistances,
+									TQ3Uns32 inBegin, TQ3Uns32 inEnd,
+									std::vector<TQ3Uns32>& ioRayIndices ) const;
+
+	std::vector<E3BVHNode>	mNodes;
+	std::vector<TQ3Uns32>	mItems;
+};
+
+
+
+
+
+//=============================================================================
+//      Constants
+//-----------------------------------------------------------------------------
+// Deepest node Build will create, which bounds the traversal stack
+const TQ3Uns32 kE3BVHMaxDepth										= 60;
+
+
+
+
+
+//=============================================================================
+//      Inline functions
+//-----------------------------------------------------------------------------
+//      E3BVH::IntersectNode : Slab test of a ray against a node.
+//-----------------------------------------------------------------------------
+//		Note :	A zero component of the ray direction has an infinite inverse,
+//				so that axis is handled separately rather than risking 0 * inf.
+//-----------------------------------------------------------------------------
+inline bool
+E3BVH::IntersectNode( const E3BVHNode& inNode, const TQ3Ray3D& inRay,
+					const TQ3Vector3D& inInvDirection, float inMaxDistance,
+					float& outNear ) const
+{
+	const float*	origin    = &inRay.origin.x;
+	const float*	direction = &inRay.direction.x;
+	const float*	invDir    = &inInvDirection.x;
+	const float*	boxMin    = &inNode.min.x;
+	const float*	boxMax    = &inNode.max.x;
+	float			tNear     = 0.0f;
+	float			tFar      = inMaxDistance;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (direction[axis] == 0.0f)
+		{
+			if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+				return false;
+		}
+		else
+		{
+			float	t0 = (boxMin[axis] - origin[axis]) * invDir[axis];
+			float	t1 = (boxMax[axis] - origin[axis]) * invDir[axis];
+			if (t0 > t1)
+				std::swap( t0, t1 );
+
+			if (t0 > tNear)
+				tNear = t0;
+			if (t1 < tFar)
+				tFar = t1;
+			if (tNear > tFar)
+				return false;
+		}
+	}
+
+	outNear = tNear;
+	return true;
+}
+
+
+
+
+
+//=============================================================================
+//      E3BVH::TraverseRay : Visit the items that may be hit by a ray.
+//-----------------------------------------------------------------------------
+template <typename Visitor>
+void
+E3BVH::TraverseRay( const TQ3Ray3D& inRay, float inMaxDistance, Visitor& ioVisitor ) const
+{
+	struct StackEntry
+	{
+		TQ3Uns32	node;
+		float		tNear;
+	};
+	StackEntry		theStack[ kE3BVHMaxDepth + 2 ];
+	TQ3Uns32		stackSize = 0;
+	float			maxDistance = inMaxDistance;
+	float			tNear;
+
+
+
+	// Check the root
+	if (mNodes.empty())
+		return;
+
+	TQ3Vector3D		invDirection;
+	invDirection.x = (inRay.direction.x == 0.0f) ? 0.0f : 1.0f / inRay.direction.x;
+	invDirection.y = (inRay.direction.y == 0.0f) ? 0.0f : 1.0f / inRay.direction.y;
+	invDirection.z = (inRay.direction.z == 0.0f) ? 0.0f : 1.0f / inRay.direction.z;
+
+	if (! IntersectNode( mNodes[0], inRay, invDirection, maxDistance, tNear ))
+		return;
+
+	theStack[ stackSize ].node  = 0;
+	theStack[ stackSize ].tNear = tNear;
+	++stackSize;
+
+
+
+	// Walk the tree, nearer child first
+	while (stackSize > 0)
+	{
+		--stackSize;
+		if (theStack[ stackSize ].tNear > maxDistance)
+			continue;
+
+		TQ3Uns32			nodeIndex = theStack[ stackSize ].node;
+		const E3BVHNode&	theNode   = mNodes[ nodeIndex ];
+
+		if (theNode.count != 0)
+		{
+			for (TQ3Uns32 n = 0; n < theNode.count; ++n)
+			{
+				if (! ioVisitor( mItems[ theNode.first + n ], maxDistance ))
+					return;
+			}
+		}
+		else
+		{
+			TQ3Uns32	leftIndex  = nodeIndex + 1;
+			TQ3Uns32	rightIndex = theNode.first;
+			float		leftNear, rightNear;
+			bool		hitLeft  = IntersectNode( mNodes[ leftIndex ], inRay,
+									invDirection, maxDistance, leftNear );
+			bool		hitRight = IntersectNode( mNodes[ rightIndex ], inRay,
+									invDirection, maxDistance, rightNear );
+
+			if (hitLeft && hitRight)
+			{
+				if (leftNear > rightNear)
+				{
+					std::swap( leftIndex, rightIndex );
+					std::swap( leftNear, rightNear );
+				}
+				theStack[ stackSize ].node  = rightIndex;
+				theStack[ stackSize ].tNear = rightNear;
+				++stackSize;
+				theStack[ stackSize ].node  = leftIndex;
+				theStack[ stackSize ].tNear = leftNear;
+				++stackSize;
+			}
+			else if (hitLeft)
+			{
+				theStack[ stackSize ].node  = leftIndex;
+				theStack[ stackSize ].tNear = leftNear;
+				++stackSize;
+			}
+			else if (hitRight)
+			{
+				theStack[ stackSize ].node  = rightIndex;
+				theStack[ stackSize ].tNear = rightNear;
+				++stackSize;
+			}
+		}
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3BVH::TraverseRays : Visit the items that may be hit by several rays.
+//-----------------------------------------------------------------------------
+//		Note :	The rays which reach a node are kept in rayIndices, between
+//				the begin and end of its stack entry. Since the tree is walked
+//				depth first, anything after that range belongs to a subtree
+//				which has been finished with, and is discarded when the node
+//				is popped.
+//-----------------------------------------------------------------------------
+template <typename Visitor>
+void
+E3BVH::TraverseRays( TQ3Uns32 inNumRays, const TQ3Ray3D* inRays,
+					float* ioMaxDistances, Visitor& ioVisitor ) const
+{
+	struct StackEntry
+	{
+		TQ3Uns32	node;
+		TQ3Uns32	raysBegin;
+		TQ3Uns32	raysEnd;
+	};
+	StackEntry				theStack[ kE3BVHMaxDepth + 2 ];
+	TQ3Uns32				stackSize = 0;
+
+
+
+	// Prepare the rays
+	if (mNodes.empty() || inNumRays == 0)
+		return;
+
+	std::vector<TQ3Vector3D>	invDirections( inNumRays );
+	std::vector<TQ3Uns32>		rayIndices( inNumRays );
+	for (TQ3Uns32 n = 0; n < inNumRays; ++n)
+	{
+		invDirections[n] = E3Ray3D_GetInverseDirection( inRays[n] );
+		rayIndices[n]    = n;
+	}
+
+	theStack[ stackSize ].node      = 0;
+	theStack[ stackSize ].raysBegin = 0;
+	theStack[ stackSize ].raysEnd   = inNumRays;
+	++stackSize;
+
+
+
+	// Walk the tree
+	while (stackSize > 0)
+	{
+		--stackSize;
+		StackEntry			theEntry = theStack[ stackSize ];
+		const E3BVHNode&	theNode  = mNodes[ theEntry.node ];
+
+
+
+		// Find the rays which hit this node
+		rayIndices.resize( theEntry.raysEnd );
+		FilterRays( theNode, inRays, &invDirections[0], ioMaxDistances,
+					theEntry.raysBegin, theEntry.raysEnd, rayIndices );
+
+		TQ3Uns32	raysBegin = theEntry.raysEnd;
+		TQ3Uns32	raysEnd   = static_cast<TQ3Uns32>( rayIndices.size() );
+		if (raysBegin == raysEnd)
+			continue;
+
+
+
+		// Visit the items of a leaf
+		if (theNode.count != 0)
+		{
+			for (TQ3Uns32 n = 0; n < theNode.count; ++n)
+			{
+				if (! ioVisitor( mItems[ theNode.first + n ], &rayIndices[ raysBegin ],
+								raysEnd - raysBegin ))
+					return;
+			}
+		}
+
+
+
+		// Or push the children, nearer to the first ray on top
+		else
+		{
+			TQ3Uns32			leftIndex  = theEntry.node + 1;
+			TQ3Uns32			rightIndex = theNode.first;
+			const TQ3Ray3D&		firstRay   = inRays[ rayIndices[ raysBegin ] ];
+			const E3BVHNode&	leftNode   = mNodes[ leftIndex ];
+			const E3BVHNode&	rightNode  = mNodes[ rightIndex ];
+			
+			float	leftDistance  = (leftNode.min.x  + leftNode.max.x  - 2.0f * firstRay.origin.x) * firstRay.direction.x +
+									(leftNode.min.y  + leftNode.max.y  - 2.0f * firstRay.origin.y) * firstRay.direction.y +
+									(leftNode.min.z  + leftNode.max.z  - 2.0f * firstRay.origin.z) * firstRay.direction.z;
+			float	rightDistance = (rightNode.min.x + rightNode.max.x - 2.0f * firstRay.origin.x) * firstRay.direction.x +
+									(rightNode.min.y + rightNode.max.y - 2.0f * firstRay.origin.y) * firstRay.direction.y +
+									(rightNode.min.z + rightNode.max.z - 2.0f * firstRay.origin.z) * firstRay.direction.z;
+			if (leftDistance > rightDistance)
+				std::swap( leftIndex, rightIndex );
+
+			theStack[ stackSize ].node      = rightIndex;
+			theStack[ stackSize ].raysBegin = raysBegin;
+			theStack[ stackSize ].raysEnd   = raysEnd;
+			++stackSize;
+			theStack[ stackSize ].node      = leftIndex;
+			theStack[ stackSize ].raysBegin = raysBegin;
+			theStack[ stackSize ].raysEnd   = raysEnd;
+			++stackSize;
+		}
+	}
+}
+
+#endif
+
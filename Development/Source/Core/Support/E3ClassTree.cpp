@@ -67,6 +67,14 @@
 #include <stdio.h>
 #include <new>
 
+#if QUESA_CLASS_STATS
+	#include <chrono>
+#endif
+
+#if QUESA_PARALLEL_TRAVERSAL
+	#include <mutex>
+#endif
+
 
 
 
@@ -75,7 +83,12 @@
 //      Internal constants
 //-----------------------------------------------------------------------------
 #define kClassHashTableSize							512
-#define kMethodHashTableSize						64
+#define kMethodHashTableSize						16
+
+#define kInstancePoolMaxItemSize					256
+#define kInstancePoolBlockSize						(16 * 1024)
+#define kInstancePoolAlignment						16
+#define kInstancePoolTrimBlocks						4
 
 static TQ3Uns8	sDummyPlaceholder;
 
@@ -84,6 +97,19 @@ static void* const	sMissingMethodPlaceholder	= (void*) &sDummyPlaceholder;
 // nothing is found, so we must use a different value to indicate a missing
 // method in the method table.
 
+#if QUESA_PARALLEL_TRAVERSAL
+static std::recursive_mutex	sMethodTableLock;
+// Serialises updates to the method tables and caches, which are filled in
+// lazily as methods are looked up. Metahandlers may look up other methods,
+// so the lock is recursive.
+#endif
+
+#if QUESA_CLASS_STATS
+static uint64_t		sStatsNestedTime = 0;
+// Time spent in the submit scopes nested inside the current one, so that the
+// current scope can subtract it from its self time.
+#endif
+
 
 
 
@@ -108,6 +134,18 @@ static void* const	sMissingMethodPlaceholder	= (void*) &sDummyPlaceholder;
 #endif
 
 
+// Find the slot for a method type in a class's method cache, by Fibonacci
+// hashing to the top 5 bits (kQ3MethodCacheSize is 32)
+#define E3_METHOD_CACHE_SLOT(_type)		((((TQ3Uns32) (_type)) * 2654435769U) >> 27)
+
+// Round a size up to the alignment of pooled instances
+#define E3_POOL_ALIGN(_size)			(((_size) + kInstancePoolAlignment - 1) & ~(kInstancePoolAlignment - 1))
+
+// Layout of the blocks of an instance pool
+#define E3_POOL_ITEM_OFFSET				E3_POOL_ALIGN ( (TQ3Uns32) sizeof ( TE3PoolBlock ) )
+#define E3_POOL_BLOCK_LENGTH(_size)		E3Num_Max ( kInstancePoolBlockSize / (_size), 2U )
+
+
 
 
 
@@ -139,6 +177,81 @@ OpaqueTQ3Object::Verify ()
 
 
 
+//=============================================================================
+//      e3class_stats_now : Get the current time for the class statistics.
+//-----------------------------------------------------------------------------
+#if QUESA_CLASS_STATS
+
+static uint64_t
+e3class_stats_now ( void )
+	{
+	return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch() ).count() ;
+	}
+
+#endif // QUESA_CLASS_STATS
+
+
+
+
+
+//=============================================================================
+//      e3class_read_cached_method : Read an entry in a method cache.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the entry was being written, or was replaced
+//				while we read it, in which case the caller must take the lock
+//				and look the method up again.
+//-----------------------------------------------------------------------------
+#if QUESA_PARALLEL_TRAVERSAL
+
+static inline bool
+e3class_read_cached_method ( TQ3MethodCacheEntry* cacheEntry, TQ3XMethodType* methodType, TQ3XFunctionPointer* theMethod )
+{
+	TQ3Uns32 startSequence = cacheEntry->sequence.load ( std::memory_order_acquire ) ;
+	if ( ( startSequence & 1 ) != 0 )
+		return false ;
+
+	*methodType = cacheEntry->methodType.load ( std::memory_order_relaxed ) ;
+	*theMethod  = cacheEntry->theMethod.load ( std::memory_order_relaxed ) ;
+
+	std::atomic_thread_fence ( std::memory_order_acquire ) ;
+	return cacheEntry->sequence.load ( std::memory_order_relaxed ) == startSequence ;
+}
+
+#endif // QUESA_PARALLEL_TRAVERSAL
+
+
+
+
+
+//=============================================================================
+//      e3class_write_cached_method : Write an entry in a method cache.
+//-----------------------------------------------------------------------------
+//		Note :	With QUESA_PARALLEL_TRAVERSAL, must be called with
+//				sMethodTableLock held, so there is only one writer at a time.
+//-----------------------------------------------------------------------------
+static inline void
+e3class_write_cached_method ( TQ3MethodCacheEntry* cacheEntry, TQ3XMethodType methodType, TQ3XFunctionPointer theMethod )
+{
+#if QUESA_PARALLEL_TRAVERSAL
+	TQ3Uns32 theSequence = cacheEntry->sequence.load ( std::memory_order_relaxed ) ;
+	cacheEntry->sequence.store ( theSequence + 1, std::memory_order_relaxed ) ;
+	std::atomic_thread_fence ( std::memory_order_release ) ;
+
+	cacheEntry->methodType.store ( methodType, std::memory_order_relaxed ) ;
+	cacheEntry->theMethod.store  ( theMethod,  std::memory_order_relaxed ) ;
+
+	cacheEntry->sequence.store ( theSequence + 2, std::memory_order_release ) ;
+#else
+	cacheEntry->methodType = methodType ;
+	cacheEntry->theMethod  = theMethod ;
+#endif
+}
+
+
+
+
+
 //=============================================================================
 //      E3ClassInfo::E3ClassInfo : Constructor for class info of root class.
 //-----------------------------------------------------------------------------
@@ -152,12 +265,22 @@ E3ClassInfo::E3ClassInfo	(
 	classType = 0 ;
 	className = nullptr ;
 	methodTable = nullptr ;
+	Q3Memory_Clear ( methodCache, sizeof ( methodCache ) ) ;
 	abstract = kQ3False ;
 	numInstances = 0 ;
 	instanceSize = 0 ;
 	deltaInstanceSize = 0;
+	instancePoolItemSize = 0 ;
+	numPoolAllocations = 0 ;
+	numPoolHits = 0 ;
+	numPoolFreeItems = 0 ;
+	poolTrimLimit = 0 ;
+	E3Pool_Create ( &instancePool ) ;
 	numChildren = 0 ;
 	theChildren = nullptr ;
+#if QUESA_CLASS_STATS
+	ResetStatistics () ;
+#endif
 	for ( TQ3Int32 i = kQ3MaxBuiltInClassHierarchyDepth - 1 ; i >= 0 ; --i )
 		ownAndParentTypes [ i ] = 0 ;
 	
@@ -380,6 +503,18 @@ E3ClassInfo::Dump_Class ( FILE *theFile, TQ3Uns32 indent )
 	fprintf(theFile, "%s-> deltaInstanceSize = %lu\n", thePad, (unsigned long)deltaInstanceSize);
 
 	fprintf(theFile, "%s-> numChildren  = %lu\n", thePad, (unsigned long)numChildren);
+
+	if (instancePoolItemSize != 0)
+		{
+		fprintf(theFile, "%s-> instance pool, item size   = %lu\n", thePad,
+							(unsigned long)instancePoolItemSize);
+
+		fprintf(theFile, "%s-> instance pool, allocations = %lu\n", thePad,
+							(unsigned long)numPoolAllocations);
+
+		fprintf(theFile, "%s-> instance pool, hits        = %lu\n", thePad,
+							(unsigned long)numPoolHits);
+		}
 	
 	if (E3HashTable_GetNumItems( methodTable) == 0)
 		fprintf(theFile, "%s-> method cache is empty\n", thePad);
@@ -417,6 +552,269 @@ E3ClassInfo::Dump_Class ( FILE *theFile, TQ3Uns32 indent )
 
 
 
+//=============================================================================
+//      E3ClassInfo::AllocateInstance : Allocate cleared memory for an instance.
+//-----------------------------------------------------------------------------
+//		Note :	The block includes space for the trailer tag after the
+//				instance data. Classes with small instances take their memory
+//				from the class's free-list, other classes use the heap.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3ClassInfo::AllocateInstance ( void )
+	{
+	// Allocate large instances from the heap
+	if ( instancePoolItemSize == 0 )
+		return (TQ3Object) Q3Memory_AllocateClear ( instanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+
+
+
+	// Allocate small instances from the pool, recording whether we could
+	// reuse a free item or had to grow the pool by a block.
+	bool hasFreeItem = E3Pool_HasFreeItem ( &instancePool ) ;
+	if ( hasFreeItem )
+		++numPoolHits ;
+
+#if Q3_DEBUG
+	E3Memory_BeginPoolAllocation () ;
+#endif
+
+	TE3PoolItem* theItem = E3Pool_AllocateTagged ( &instancePool,
+										E3_POOL_ITEM_OFFSET,
+										instancePoolItemSize,
+										E3_POOL_BLOCK_LENGTH ( instancePoolItemSize ),
+										nullptr ) ;
+
+#if Q3_DEBUG
+	E3Memory_EndPoolAllocation ( theItem != nullptr ? instancePoolItemSize : 0 ) ;
+#endif
+
+	if ( theItem == nullptr )
+		return nullptr ;
+	
+	++numPoolAllocations ;
+
+	if ( hasFreeItem )
+		--numPoolFreeItems ;
+	else
+		numPoolFreeItems += E3_POOL_BLOCK_LENGTH ( instancePoolItemSize ) - 1 ;
+
+
+
+	// Pooled items are recycled, so clear them just as the heap would
+	Q3Memory_Clear ( theItem, instancePoolItemSize ) ;
+	
+	return (TQ3Object) theItem ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::FreeInstance : Release the memory of an instance.
+//-----------------------------------------------------------------------------
+//		Note :	Once enough of the pool is free, we trim it, so that memory
+//				which was only needed for a peak in the number of instances
+//				goes back to the heap during the session.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::FreeInstance ( TQ3Object theObject )
+	{
+	if ( instancePoolItemSize == 0 )
+		{
+		Q3Memory_Free ( &theObject ) ;
+		return ;
+		}
+
+	E3Pool_Free ( &instancePool, (TE3PoolItem**) &theObject ) ;
+
+	if ( ++numPoolFreeItems >= poolTrimLimit )
+		TrimInstancePool () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::TrimInstancePool : Release the free blocks of our pool.
+//-----------------------------------------------------------------------------
+//		Note :	If the free items are spread across blocks that are still in
+//				use, trimming releases little, so the limit for the next trim
+//				grows with the number of free items that are left. This keeps
+//				the cost of trimming in proportion to the number of frees.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::TrimInstancePool ( void )
+	{
+	// Check we have a pool
+	if ( instancePoolItemSize == 0 )
+		return ;
+
+
+
+	// Trim it, and set the limit for the next time
+	TQ3Uns32 blockLength = E3_POOL_BLOCK_LENGTH ( instancePoolItemSize ) ;
+	TQ3Uns32 numReleased = E3Pool_Trim ( &instancePool, E3_POOL_ITEM_OFFSET, instancePoolItemSize, blockLength ) ;
+
+	numPoolFreeItems -= numReleased * blockLength ;
+	poolTrimLimit     = E3Num_Max ( kInstancePoolTrimBlocks * blockLength, 2 * numPoolFreeItems ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::TrimInstancePools : Release the free blocks of a sub-tree.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::TrimInstancePools ( void )
+	{
+	// Trim our own pool
+	TrimInstancePool () ;
+
+
+
+	// Trim the pools of our children
+	for ( TQ3Uns32 n = 0 ; n < numChildren ; ++n )
+		theChildren [ n ]->TrimInstancePools () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::AccumulatePoolStatistics : Sum pool stats of a sub-tree.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::AccumulatePoolStatistics ( TQ3Uns32 *numAllocations, TQ3Uns32 *numHits )
+	{
+	// Add our own stats
+	*numAllocations += numPoolAllocations ;
+	*numHits        += numPoolHits ;
+
+
+
+	// Add the stats of our children
+	for ( TQ3Uns32 n = 0 ; n < numChildren ; ++n )
+		theChildren [ n ]->AccumulatePoolStatistics ( numAllocations, numHits ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::ResetStatistics : Reset the submit stats of a sub-tree.
+//-----------------------------------------------------------------------------
+#if QUESA_CLASS_STATS
+
+void
+E3ClassInfo::ResetStatistics ( void )
+	{
+	// Reset our own stats
+	for ( TQ3Uns32 m = 0 ; m < kQ3StatsMethodCount ; ++m )
+		{
+		statsNumSubmits [ m ] = 0 ;
+		statsTotalTime  [ m ] = 0 ;
+		statsSelfTime   [ m ] = 0 ;
+		}
+
+
+
+	// Reset the stats of our children
+	for ( TQ3Uns32 n = 0 ; n < numChildren ; ++n )
+		theChildren [ n ]->ResetStatistics () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::DumpStatistics : Dump the submit stats of a sub-tree.
+//-----------------------------------------------------------------------------
+//		Note :	Classes which have not been submitted are skipped, so that
+//				the file only lists the classes which contributed to a frame.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::DumpStatistics ( FILE *theFile )
+	{
+	static const char* kMethodNames [ kQ3StatsMethodCount ] =
+		{ "render", "pick", "bounds", "write" } ;
+
+
+
+	// Dump our own stats
+	for ( TQ3Uns32 m = 0 ; m < kQ3StatsMethodCount ; ++m )
+		{
+		if ( statsNumSubmits [ m ] != 0 )
+			fprintf ( theFile, "%-32s %-6s %10lu %10lu %12.3f %12.3f\n",
+						className,
+						kMethodNames [ m ],
+						(unsigned long) numInstances,
+						(unsigned long) statsNumSubmits [ m ],
+						(double) statsTotalTime [ m ] / 1000000.0,
+						(double) statsSelfTime  [ m ] / 1000000.0 ) ;
+		}
+
+
+
+	// Dump the stats of our children
+	for ( TQ3Uns32 n = 0 ; n < numChildren ; ++n )
+		theChildren [ n ]->DumpStatistics ( theFile ) ;
+	}
+
+#endif // QUESA_CLASS_STATS
+
+
+
+
+
+//=============================================================================
+//      E3ClassStatsScope::E3ClassStatsScope : Start timing a submit.
+//-----------------------------------------------------------------------------
+#if QUESA_CLASS_STATS
+
+E3ClassStatsScope::E3ClassStatsScope ( E3ClassInfo* inClass, TQ3StatsMethod inMethod )
+	{
+	theClass        = inClass ;
+	theMethod       = inMethod ;
+	outerNestedTime = sStatsNestedTime ;
+	sStatsNestedTime = 0 ;
+	startTime       = e3class_stats_now () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassStatsScope::~E3ClassStatsScope : Record a submit.
+//-----------------------------------------------------------------------------
+//		Note :	The time spent in this scope is passed on to the enclosing
+//				scope as nested time, so that it is only counted as self time
+//				of the innermost class.
+//-----------------------------------------------------------------------------
+E3ClassStatsScope::~E3ClassStatsScope ( void )
+	{
+	uint64_t elapsedTime = e3class_stats_now () - startTime ;
+
+	theClass->statsNumSubmits [ theMethod ] += 1 ;
+	theClass->statsTotalTime  [ theMethod ] += elapsedTime ;
+	theClass->statsSelfTime   [ theMethod ] += elapsedTime - sStatsNestedTime ;
+
+	sStatsNestedTime = outerNestedTime + elapsedTime ;
+	}
+
+#endif // QUESA_CLASS_STATS
+
+
+
+
+
 //=============================================================================
 //      Public functions
 //-----------------------------------------------------------------------------
@@ -567,6 +965,14 @@ E3ClassTree::RegisterClass (	TQ3ObjectType		parentClassType,
 	newClass->deltaInstanceSize = deltaInstanceSize;
 	newClass->deltaInstanceOffset = deltaInstanceOffset;
 	
+#if QUESA_USE_INSTANCE_POOLS
+	TQ3Uns32 poolItemSize = E3_POOL_ALIGN ( totalInstanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+	if ( poolItemSize <= kInstancePoolMaxItemSize )
+		{
+		newClass->instancePoolItemSize = poolItemSize ;
+		newClass->poolTrimLimit        = kInstancePoolTrimBlocks * E3_POOL_BLOCK_LENGTH ( poolItemSize ) ;
+		}
+#endif
 
 	strcpy ( newClass->className, className ) ;
 
@@ -705,6 +1111,7 @@ E3ClassTree::UnregisterClass ( TQ3ObjectType classType, TQ3Boolean isRequired )
 
 	Q3Memory_Free(&theClass->className);
 	E3HashTable_Destroy(&theClass->methodTable);
+	E3Pool_Destroy(&theClass->instancePool);
 	
 	delete theClass ;
 	
@@ -837,8 +1244,11 @@ E3ClassInfo::CreateInstance (	TQ3Boolean		sharedParams,
 	if ( abstract )
 		return nullptr ; // Cannot create an object of an abstract class, the required methods are missing (pure virtual)
 		
+	// Attribute any allocations to our class in the allocation profile
+	E3MemoryProfileScope profileScope ( classType ) ;
+
 	// Allocate and initialise the object
-	TQ3Object theObject = (TQ3Object) Q3Memory_AllocateClear ( instanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+	TQ3Object theObject = AllocateInstance () ;
 	if ( theObject == nullptr )
 		return nullptr ;
 
@@ -853,7 +1263,7 @@ E3ClassInfo::CreateInstance (	TQ3Boolean		sharedParams,
 
 	if ( qd3dStatus == kQ3Failure )
 		{
-		Q3Memory_Free ( &theObject ) ;
+		FreeInstance ( theObject ) ;
 		return nullptr ;
 		}
 		
@@ -932,8 +1342,7 @@ OpaqueTQ3Object::DestroyInstance ( void )
 
 
 	// Dispose of the object
-	TQ3Object theObject = (TQ3Object) this ;		
-	Q3Memory_Free ( & theObject ) ;
+	theClass->FreeInstance ( (TQ3Object) this ) ;
 	
 	
 	
@@ -1023,8 +1432,13 @@ OpaqueTQ3Object::DuplicateInstance ( void )
 
 
 
+	// Attribute any allocations to our class in the allocation profile
+	E3MemoryProfileScope profileScope ( theClass->classType ) ;
+
+
+
 	// Allocate and initialise the object
-	TQ3Object newObject = (TQ3Object) Q3Memory_AllocateClear ( theClass->instanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+	TQ3Object newObject = theClass->AllocateInstance () ;
 	if ( newObject == nullptr )
 		return nullptr ;
 
@@ -1039,7 +1453,7 @@ OpaqueTQ3Object::DuplicateInstance ( void )
 	TQ3Status qd3dStatus = DuplicateInstanceData ( newObject , theClass ) ;
 	if ( qd3dStatus == kQ3Failure )
 		{
-		Q3Memory_Free ( &newObject ) ;
+		theClass->FreeInstance ( newObject ) ;
 		return nullptr ;
 		}
 	
@@ -1451,17 +1865,49 @@ E3ClassInfo::GetNumInstances ( void )
 
 
 
+//=============================================================================
+//      E3ClassInfo::GetStatistics : Get the submit stats of a class.
+//-----------------------------------------------------------------------------
+#if QUESA_CLASS_STATS
+
+void
+E3ClassInfo::GetStatistics ( TQ3ClassStatistics *theStats )
+	{
+	theStats->classType    = classType ;
+	theStats->numInstances = numInstances ;
+
+	for ( TQ3Uns32 m = 0 ; m < kQ3StatsMethodCount ; ++m )
+		{
+		theStats->numSubmits [ m ] = statsNumSubmits [ m ] ;
+		theStats->totalTime  [ m ] = (TQ3Float64) statsTotalTime [ m ] / 1.0e9 ;
+		theStats->selfTime   [ m ] = (TQ3Float64) statsSelfTime  [ m ] / 1.0e9 ;
+		}
+	}
+
+#endif // QUESA_CLASS_STATS
+
+
+
+
+
 //=============================================================================
 //      E3ClassTree_GetMethod : Get a method for a class.
 //-----------------------------------------------------------------------------
-//		Note :	When looking for methods, we first check the method table for
-//				the class. If this fails, we call the class metahandler.
+//		Note :	When looking for methods, we first check the method cache and
+//				then the method table for the class. If this fails, we call
+//				the class metahandler.
 //
 //				When calling the metahandler, we inherit methods that the class
 //				does't implement from the parent of the class.
 //
 //				If we find the method, we store it in the method table to cache
-//				it for the next time.
+//				it for the next time. The result is also stored in the method
+//				cache, even if the method was not found.
+//
+//				With QUESA_PARALLEL_TRAVERSAL, everything after the cache is
+//				done under sMethodTableLock. The cache is read without the
+//				lock, using the sequence count of the entry to detect that it
+//				was replaced while it was read.
 //-----------------------------------------------------------------------------
 TQ3XFunctionPointer
 E3ClassInfo::GetMethod ( TQ3XMethodType methodType )
@@ -1471,6 +1917,25 @@ E3ClassInfo::GetMethod ( TQ3XMethodType methodType )
 
 
 
+	// Check the method cache
+	//
+	// The cache is cleared to 0s, which is never a valid method type.
+	TQ3MethodCacheEntry* cacheEntry = &methodCache [ E3_METHOD_CACHE_SLOT ( methodType ) ] ;
+#if QUESA_PARALLEL_TRAVERSAL
+	TQ3XMethodType		cachedType ;
+	TQ3XFunctionPointer	cachedMethod ;
+	if ( e3class_read_cached_method ( cacheEntry, &cachedType, &cachedMethod ) &&
+		 ( cachedType == methodType ) && ( methodType != kQ3ObjectTypeInvalid ) )
+		return cachedMethod ;
+
+	std::lock_guard<std::recursive_mutex> tableLock ( sMethodTableLock ) ;
+#else
+	if ( ( cacheEntry->methodType == methodType ) && ( methodType != kQ3ObjectTypeInvalid ) )
+		return cacheEntry->theMethod ;
+#endif
+
+
+
 	// Find the method
 	//
 	// We first check the hash table for the class. If this fails, we invoke the
@@ -1495,6 +1960,11 @@ E3ClassInfo::GetMethod ( TQ3XMethodType methodType )
 		}
 	}
 
+
+
+	// Remember the result in the method cache
+	e3class_write_cached_method ( cacheEntry, methodType, theMethod ) ;
+
 	return theMethod ;
 }
 
@@ -1538,6 +2008,10 @@ E3ClassInfo::AddMethod ( TQ3XMethodType methodType, TQ3XFunctionPointer theMetho
 
 
 	// Add the method to the hash table for the class
+#if QUESA_PARALLEL_TRAVERSAL
+	std::lock_guard<std::recursive_mutex> tableLock ( sMethodTableLock ) ;
+#endif
+
 	if (theMethod == nullptr)
 	{
 		E3HashTable_Add( methodTable, methodType, sMissingMethodPlaceholder );
@@ -1546,6 +2020,38 @@ E3ClassInfo::AddMethod ( TQ3XMethodType methodType, TQ3XFunctionPointer theMetho
 	{
 		E3HashTable_Add( methodTable, methodType, (void*)theMethod );
 	}
+
+
+
+	// Invalidate any stale entry in the method caches of this class and the
+	// classes which inherit from it
+	InvalidateCachedMethod ( methodType ) ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::InvalidateCachedMethod : Invalidate a cached method.
+//-----------------------------------------------------------------------------
+//		Note :	Subclasses cache the methods they inherit, including the fact
+//				that a method was not found, so a change to a class's method
+//				must be invalidated throughout its sub-tree.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::InvalidateCachedMethod ( TQ3XMethodType methodType )
+{
+	// Invalidate our own entry
+	TQ3MethodCacheEntry* cacheEntry = &methodCache [ E3_METHOD_CACHE_SLOT ( methodType ) ] ;
+	if ( cacheEntry->methodType == methodType )
+		e3class_write_cached_method ( cacheEntry, kQ3ObjectTypeInvalid, nullptr ) ;
+
+
+
+	// Invalidate the entries of our children
+	for ( TQ3Uns32 n = 0 ; n < numChildren ; ++n )
+		theChildren [ n ]->InvalidateCachedMethod ( methodType ) ;
 }
 
 
@@ -1574,6 +2080,109 @@ E3ClassTree::AddMethod ( TQ3ObjectType classType, TQ3XMethodType methodType, TQ3
 
 
 
+//=============================================================================
+//      E3ClassTree::GetPoolStatistics : Get instance pool stats for all classes.
+//-----------------------------------------------------------------------------
+void
+E3ClassTree::GetPoolStatistics ( TQ3Uns32 *numAllocations, TQ3Uns32 *numHits )
+	{
+	E3GlobalsPtr theGlobals = E3Globals_Get () ;
+
+
+
+	// Sum the stats of every class, starting at the root
+	*numAllocations = 0 ;
+	*numHits        = 0 ;
+
+	if ( theGlobals->classTreeRoot != nullptr )
+		theGlobals->classTreeRoot->AccumulatePoolStatistics ( numAllocations, numHits ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassTree::TrimPools : Release unused instance pool memory.
+//-----------------------------------------------------------------------------
+//		Note :	Instance pools grow to the largest number of instances that
+//				were alive at once. Trimming them returns any block with no
+//				live instances to the heap.
+//-----------------------------------------------------------------------------
+void
+E3ClassTree::TrimPools ( void )
+	{
+	E3GlobalsPtr theGlobals = E3Globals_Get () ;
+
+
+
+	// Trim the pool of every class, starting at the root
+	if ( theGlobals->classTreeRoot != nullptr )
+		theGlobals->classTreeRoot->TrimInstancePools () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassTree::ResetStatistics : Reset the submit stats of all classes.
+//-----------------------------------------------------------------------------
+#if QUESA_CLASS_STATS
+
+void
+E3ClassTree::ResetStatistics ( void )
+	{
+	E3GlobalsPtr theGlobals = E3Globals_Get () ;
+
+	if ( theGlobals->classTreeRoot != nullptr )
+		theGlobals->classTreeRoot->ResetStatistics () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassTree::DumpStatistics : Dump the submit stats of all classes.
+//-----------------------------------------------------------------------------
+//		Note :	Times are written in milliseconds.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ClassTree::DumpStatistics ( const char *fileName )
+	{
+	E3GlobalsPtr theGlobals = E3Globals_Get () ;
+
+
+
+	// Open our file
+	FILE* theFile = fopen ( fileName, "w" ) ;
+	if ( theFile == nullptr )
+		return kQ3Failure ;
+
+
+
+	// Write out a header, then the stats of every class
+	fprintf ( theFile, "%-32s %-6s %10s %10s %12s %12s\n",
+				"class", "method", "instances", "submits", "total (ms)", "self (ms)" ) ;
+
+	if ( theGlobals->classTreeRoot != nullptr )
+		theGlobals->classTreeRoot->DumpStatistics ( theFile ) ;
+
+
+
+	// Clean up
+	fclose ( theFile ) ;
+	
+	return kQ3Success ;
+	}
+
+#endif // QUESA_CLASS_STATS
+
+
+
+
+
 //=============================================================================
 //      E3ClassTree_Dump : Dump some stats on the class tree.
 //-----------------------------------------------------------------------------
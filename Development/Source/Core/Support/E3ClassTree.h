@@ -49,6 +49,11 @@
 
 
 #include "E3HashTable.h"
+#include "E3Pool.h"
+
+#if QUESA_ATOMIC_REFCOUNTS
+	#include <atomic>
+#endif
 
 
 //=============================================================================
@@ -69,7 +74,8 @@ extern "C" {
 
 enum
 	{
-	kQ3MaxBuiltInClassHierarchyDepth = 6
+	kQ3MaxBuiltInClassHierarchyDepth = 6,
+	kQ3MethodCacheSize = 32					// Must be a power of 2
 	} ;
 
 
@@ -89,6 +95,23 @@ typedef Q3_CALLBACK_API_C ( E3ClassInfo*, TQ3XObjectRegisterMethod ) (	TQ3XMetaH
 																		E3ClassInfo*	newParent ) ;
 
 
+// An entry in the method dispatch cache of a class
+//
+// When traversals may run on several threads, the entry is guarded by a
+// sequence count, which is odd while the entry is being written, so that a
+// reader can check that the entry was not replaced while it was read.
+typedef struct TQ3MethodCacheEntry {
+#if QUESA_PARALLEL_TRAVERSAL
+	std::atomic<TQ3Uns32>				sequence ;
+	std::atomic<TQ3XMethodType>			methodType ;
+	std::atomic<TQ3XFunctionPointer>	theMethod ;
+#else
+	TQ3XMethodType		methodType ;
+	TQ3XFunctionPointer	theMethod ;
+#endif
+} TQ3MethodCacheEntry ;
+
+
 // A single node within the class tree
 class E3ClassInfo
 	{
@@ -97,6 +120,10 @@ class E3ClassInfo
 	char				*className ;
 	TQ3XMetaHandler		classMetaHandler ;
 	E3HashTablePtr		methodTable ;
+	TQ3MethodCacheEntry	methodCache [ kQ3MethodCacheSize ] ;
+	// Direct-mapped cache in front of methodTable, so that the methods looked
+	// up on every submit cost a single compare. Unlike the hash table, it also
+	// records methods which the class does not implement.
 	
 	TQ3Boolean			abstract ;	// If set, class is 'abstract' in the C++ sense, in that no instances of the class can be created
 									// It gets set because the class has necessary methods missing (= 0 or pure virtual in C++ parlance)
@@ -105,7 +132,11 @@ class E3ClassInfo
 
 
 	// Instances
+#if QUESA_ATOMIC_REFCOUNTS
+	std::atomic<TQ3Uns32>	numInstances ;
+#else
 	TQ3Uns32			numInstances ;
+#endif
 	TQ3Uns32			instanceSize ; // Includes all parents instance data
 	TQ3Uns32			deltaInstanceSize;
 	// deltaInstanceSize is intended to be the size of the instance data that is
@@ -115,6 +146,28 @@ class E3ClassInfo
 	TQ3Uns32			deltaInstanceOffset;
 	// Offset in bytes from the beginning of the object to the child instance
 	// data.  This is not necessarily the same as the parent's instanceSize.
+	
+	TE3Pool				instancePool ;
+	TQ3Uns32			instancePoolItemSize ;
+	// Classes with small instances recycle their instance memory through a
+	// free-list, rather than going back to the system allocator each time.
+	// instancePoolItemSize is 0 if the instances of this class are not pooled.
+	TQ3Uns32			numPoolAllocations ;
+	TQ3Uns32			numPoolHits ;
+	// Number of instances allocated from the pool, and how many of those were
+	// satisfied by a previously freed item rather than a new block.
+	TQ3Uns32			numPoolFreeItems ;
+	TQ3Uns32			poolTrimLimit ;
+	// Number of free items in the pool, and the number at which freeing an
+	// instance trims the pool.
+
+#if QUESA_CLASS_STATS
+	TQ3Uns32			statsNumSubmits [ kQ3StatsMethodCount ] ;
+	uint64_t			statsTotalTime [ kQ3StatsMethodCount ] ;
+	uint64_t			statsSelfTime [ kQ3StatsMethodCount ] ;
+	// Submit counts and times (in nanoseconds) for the Q3Stats API, indexed
+	// by TQ3StatsMethod and updated by E3ClassStatsScope.
+#endif
 
 
 	// Parent/children
@@ -134,6 +187,16 @@ class E3ClassInfo
 	void				Detach ( void ) ;	
 	E3ClassInfoPtr		Find ( const char *className ) ;
 	void				Dump_Class ( FILE *theFile, TQ3Uns32 indent ) ;
+	TQ3Object			AllocateInstance ( void ) ;
+	void				FreeInstance ( TQ3Object theObject ) ;
+	void				AccumulatePoolStatistics ( TQ3Uns32 *numAllocations, TQ3Uns32 *numHits ) ;
+	void				TrimInstancePool ( void ) ;
+	void				TrimInstancePools ( void ) ;
+	void				InvalidateCachedMethod ( TQ3XMethodType methodType ) ;
+#if QUESA_CLASS_STATS
+	void				ResetStatistics ( void ) ;
+	void				DumpStatistics ( FILE *theFile ) ;
+#endif
 						E3ClassInfo ( void ) ; // Not used. Private so nobody can forget to call the normal constructor
 public :
 
@@ -160,9 +223,13 @@ public :
 	void				AddMethod ( TQ3XMethodType methodType, TQ3XFunctionPointer theMethod ) ;
 	TQ3Object			CreateInstance ( TQ3Boolean sharedParams, const void* paramData ) ;
 	void				SetAbstract ( void ) { abstract = kQ3True ; }
+#if QUESA_CLASS_STATS
+	void				GetStatistics ( TQ3ClassStatistics *theStats ) ;
+#endif
 	
 	friend class E3ClassTree ;
 	friend class OpaqueTQ3Object ;
+	friend class E3ClassStatsScope ;
 	} ;
 
 
@@ -204,6 +271,12 @@ public :
 	static E3ClassInfoPtr	GetClass ( const char *className ) ;
 	static E3ClassInfoPtr	GetClass ( TQ3Object theObject ) ;
 	static void				AddMethod ( TQ3ObjectType classType, TQ3XMethodType methodType, TQ3XFunctionPointer theMethod ) ;
+	static void				GetPoolStatistics ( TQ3Uns32 *numAllocations, TQ3Uns32 *numHits ) ;
+	static void				TrimPools ( void ) ;
+#if QUESA_CLASS_STATS
+	static void				ResetStatistics ( void ) ;
+	static TQ3Status		DumpStatistics ( const char *fileName ) ;
+#endif
 	static void				Dump ( void ) ;
 
 
@@ -214,6 +287,31 @@ public :
 
 
 
+// Counts and times one submit of an object, for the lifetime of the scope.
+// Time spent in nested scopes is counted as self time of the inner class only.
+#if QUESA_CLASS_STATS
+class E3ClassStatsScope
+	{
+	E3ClassInfo*		theClass ;
+	TQ3StatsMethod		theMethod ;
+	uint64_t			startTime ;
+	uint64_t			outerNestedTime ;
+
+public :
+						E3ClassStatsScope ( E3ClassInfo* inClass, TQ3StatsMethod inMethod ) ;
+						~E3ClassStatsScope ( void ) ;
+	} ;
+#else
+class E3ClassStatsScope
+	{
+public :
+						E3ClassStatsScope ( E3ClassInfo*, TQ3StatsMethod ) { }
+	} ;
+#endif
+
+
+
+
 
 //=============================================================================
 //		C++ postamble
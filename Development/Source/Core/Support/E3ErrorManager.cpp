@@ -50,6 +50,149 @@
 #include "E3Prefix.h"
 #include "E3ErrorManager.h"
 
+#include <atomic>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Number of reports in the error log (must be a power of 2)
+#define kErrorLogSize									64
+#define kErrorLogMask									(kErrorLogSize - 1)
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// A slot in the error log
+//
+// The log is a bounded queue which may be posted to and drained by any number
+// of threads without a lock. Each slot carries a sequence number which says
+// whether it is waiting to be written or read on the current lap around the
+// log, and which of the posting/draining positions may claim it.
+//
+// The sequence is stored relative to the index of the slot, so that a log of
+// zeroes is a valid empty log and needs no initialisation.
+typedef struct TQ3ErrorLogSlot {
+	std::atomic<TQ3Uns32>	sequence;
+	TQ3ErrorReport			theReport;
+} TQ3ErrorLogSlot;
+
+
+
+
+
+//=============================================================================
+//      Internal globals
+//-----------------------------------------------------------------------------
+static TQ3ErrorLogSlot			sErrorLog[kErrorLogSize];
+static std::atomic<TQ3Uns32>	sErrorLogPostPos(0);
+static std::atomic<TQ3Uns32>	sErrorLogDrainPos(0);
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3errormanager_log_take : Take the oldest report from the error log.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the log is empty. theReport may be nullptr, to
+//				discard the report.
+//-----------------------------------------------------------------------------
+static bool
+e3errormanager_log_take(TQ3ErrorReport *theReport)
+{	TQ3Uns32			thePos = sErrorLogDrainPos.load(std::memory_order_relaxed);
+	TQ3ErrorLogSlot		*theSlot;
+
+
+
+	// Claim the oldest slot which has been written
+	for (;;)
+		{
+		theSlot = &sErrorLog[thePos & kErrorLogMask];
+		
+		TQ3Uns32 theSequence = theSlot->sequence.load(std::memory_order_acquire) + (thePos & kErrorLogMask);
+		TQ3Int32 theDelta    = (TQ3Int32) (theSequence - (thePos + 1));
+
+		if (theDelta == 0)
+			{
+			if (sErrorLogDrainPos.compare_exchange_weak(thePos, thePos + 1, std::memory_order_relaxed))
+				break;
+			}
+		else if (theDelta < 0)
+			return(false);
+		else
+			thePos = sErrorLogDrainPos.load(std::memory_order_relaxed);
+		}
+
+
+
+	// Read the report, then hand the slot back for the next lap
+	if (theReport != nullptr)
+		*theReport = theSlot->theReport;
+
+	theSlot->sequence.store(thePos + kErrorLogSize - (thePos & kErrorLogMask), std::memory_order_release);
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3errormanager_log_post : Add a report to the error log.
+//-----------------------------------------------------------------------------
+//		Note :	If the log is full we discard the oldest report, since the
+//				most recent errors are the interesting ones.
+//-----------------------------------------------------------------------------
+static void
+e3errormanager_log_post(TQ3ErrorReportKind theKind, TQ3Int32 theCode, TQ3Boolean isFatal)
+{	TQ3Uns32			thePos = sErrorLogPostPos.load(std::memory_order_relaxed);
+	TQ3ErrorLogSlot		*theSlot;
+
+
+
+	// Claim the next slot which is free
+	for (;;)
+		{
+		theSlot = &sErrorLog[thePos & kErrorLogMask];
+		
+		TQ3Uns32 theSequence = theSlot->sequence.load(std::memory_order_acquire) + (thePos & kErrorLogMask);
+		TQ3Int32 theDelta    = (TQ3Int32) (theSequence - thePos);
+
+		if (theDelta == 0)
+			{
+			if (sErrorLogPostPos.compare_exchange_weak(thePos, thePos + 1, std::memory_order_relaxed))
+				break;
+			}
+		else if (theDelta < 0)
+			{
+			e3errormanager_log_take(nullptr);
+			thePos = sErrorLogPostPos.load(std::memory_order_relaxed);
+			}
+		else
+			thePos = sErrorLogPostPos.load(std::memory_order_relaxed);
+		}
+
+
+
+	// Write the report, then publish it to the readers
+	theSlot->theReport.serialNumber = thePos;
+	theSlot->theReport.kind         = theKind;
+	theSlot->theReport.code         = theCode;
+	theSlot->theReport.isFatal      = isFatal;
+
+	theSlot->sequence.store(thePos + 1 - (thePos & kErrorLogMask), std::memory_order_release);
+}
+
 
 
 
@@ -61,23 +204,26 @@
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_PostError(TQ3Error theError, TQ3Boolean isFatal)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3GlobalsPtr		theGlobals = E3Globals_Get();
+	E3ThreadGlobalsPtr	theState   = E3ThreadGlobals_Get();
 
 
 
 	// Update our state
-	if (theGlobals->errMgrOldestError == kQ3ErrorNone)
-		theGlobals->errMgrOldestError = theError;
+	if (theState->errMgrOldestError == kQ3ErrorNone)
+		theState->errMgrOldestError = theError;
 	
-	theGlobals->errMgrIsFatalError = isFatal;
-	theGlobals->errMgrLatestError  = theError;
+	theState->errMgrIsFatalError = isFatal;
+	theState->errMgrLatestError  = theError;
+
+	e3errormanager_log_post(kQ3ErrorReportKindError, (TQ3Int32) theError, isFatal);
 
 
 
 	// Call the handler
 	if (theGlobals->errMgrHandlerFuncError != nullptr)
-		theGlobals->errMgrHandlerFuncError(theGlobals->errMgrOldestError,
-										   theGlobals->errMgrLatestError,
+		theGlobals->errMgrHandlerFuncError(theState->errMgrOldestError,
+										   theState->errMgrLatestError,
 										   theGlobals->errMgrHandlerDataError);
 }
 
@@ -90,22 +236,25 @@ E3ErrorManager_PostError(TQ3Error theError, TQ3Boolean isFatal)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_PostWarning(TQ3Warning theWarning)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3GlobalsPtr		theGlobals = E3Globals_Get();
+	E3ThreadGlobalsPtr	theState   = E3ThreadGlobals_Get();
 
 
 
 	// Update our state
-	if (theGlobals->errMgrOldestWarning == kQ3WarningNone)
-		theGlobals->errMgrOldestWarning = theWarning;
+	if (theState->errMgrOldestWarning == kQ3WarningNone)
+		theState->errMgrOldestWarning = theWarning;
 	
-	theGlobals->errMgrLatestWarning = theWarning;
+	theState->errMgrLatestWarning = theWarning;
+
+	e3errormanager_log_post(kQ3ErrorReportKindWarning, (TQ3Int32) theWarning, kQ3False);
 
 
 
 	// Call the handler
 	if (theGlobals->errMgrHandlerFuncWarning != nullptr)
-		theGlobals->errMgrHandlerFuncWarning(theGlobals->errMgrOldestWarning,
-											 theGlobals->errMgrLatestWarning,
+		theGlobals->errMgrHandlerFuncWarning(theState->errMgrOldestWarning,
+											 theState->errMgrLatestWarning,
 											 theGlobals->errMgrHandlerDataWarning);
 }
 
@@ -118,23 +267,27 @@ E3ErrorManager_PostWarning(TQ3Warning theWarning)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_PostNotice(TQ3Notice theNotice)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Update our state
-	if (theGlobals->errMgrOldestNotice == kQ3NoticeNone)
-		theGlobals->errMgrOldestNotice = theNotice;
+	if (theState->errMgrOldestNotice == kQ3NoticeNone)
+		theState->errMgrOldestNotice = theNotice;
 	
-	theGlobals->errMgrLatestNotice = theNotice;
+	theState->errMgrLatestNotice = theNotice;
+
+	e3errormanager_log_post(kQ3ErrorReportKindNotice, (TQ3Int32) theNotice, kQ3False);
 
 
 
 	// Call the handler in debug builds (notices are not posted in release builds)
 	#if Q3_DEBUG
+	E3GlobalsPtr	theGlobals = E3Globals_Get();
+
 	if (theGlobals->errMgrHandlerFuncNotice != nullptr)
-		theGlobals->errMgrHandlerFuncNotice(theGlobals->errMgrOldestNotice,
-											theGlobals->errMgrLatestNotice,
+		theGlobals->errMgrHandlerFuncNotice(theState->errMgrOldestNotice,
+											theState->errMgrLatestNotice,
 											theGlobals->errMgrHandlerDataNotice);
 	#endif
 }
@@ -148,15 +301,18 @@ E3ErrorManager_PostNotice(TQ3Notice theNotice)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_PostPlatformError(TQ3Uns32 theError)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3GlobalsPtr		theGlobals = E3Globals_Get();
+	E3ThreadGlobalsPtr	theState   = E3ThreadGlobals_Get();
 
 
 
 	// Update our state
-	if (theGlobals->errMgrOldestPlatform == 0)
-		theGlobals->errMgrOldestPlatform = theError;
+	if (theState->errMgrOldestPlatform == 0)
+		theState->errMgrOldestPlatform = theError;
 	
-	theGlobals->errMgrLatestPlatform = theError;
+	theState->errMgrLatestPlatform = theError;
+
+	e3errormanager_log_post(kQ3ErrorReportKindPlatform, (TQ3Int32) theError, kQ3False);
 
 
 
@@ -171,8 +327,8 @@ E3ErrorManager_PostPlatformError(TQ3Uns32 theError)
 	// When this API is made public, apps will be able to listen directly
 	// to platform specific errors.
 	if (theGlobals->errMgrHandlerFuncPlatform != nullptr)
-		theGlobals->errMgrHandlerFuncPlatform((TQ3Error) theGlobals->errMgrOldestPlatform,
-											  (TQ3Error) theGlobals->errMgrLatestPlatform,
+		theGlobals->errMgrHandlerFuncPlatform((TQ3Error) theState->errMgrOldestPlatform,
+											  (TQ3Error) theState->errMgrLatestPlatform,
 											  theGlobals->errMgrHandlerDataPlatform);
 	else
 		E3ErrorManager_PostError(
@@ -201,7 +357,7 @@ E3ErrorManager_PostPlatformError(TQ3Uns32 theError)
 //-----------------------------------------------------------------------------
 TQ3Boolean
 E3ErrorManager_GetIsFatalError(TQ3Error theError)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
@@ -212,7 +368,7 @@ E3ErrorManager_GetIsFatalError(TQ3Error theError)
 
 
 	// If this error isn't fatal, see if we've hit one which is
-	return(theGlobals->errMgrIsFatalError);
+	return(theState->errMgrIsFatalError);
 }
 
 
@@ -226,22 +382,22 @@ E3ErrorManager_GetIsFatalError(TQ3Error theError)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_GetError(TQ3Error *oldestError, TQ3Error *latestError)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Return the requested state
 	if (oldestError != nullptr)
-		*oldestError = theGlobals->errMgrOldestError;
+		*oldestError = theState->errMgrOldestError;
 
 	if (latestError != nullptr)
-		*latestError = theGlobals->errMgrLatestError;
+		*latestError = theState->errMgrLatestError;
 
 
 
 	// Set our flags
-	theGlobals->systemDoBottleneck = kQ3True;
-	theGlobals->errMgrClearError   = kQ3True;
+	theState->systemDoBottleneck = kQ3True;
+	theState->errMgrClearError   = kQ3True;
 }
 
 
@@ -255,22 +411,22 @@ E3ErrorManager_GetError(TQ3Error *oldestError, TQ3Error *latestError)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_GetWarning(TQ3Warning *oldestWarning, TQ3Warning *latestWarning)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Return the requested state
 	if (oldestWarning != nullptr)
-		*oldestWarning = theGlobals->errMgrOldestWarning;
+		*oldestWarning = theState->errMgrOldestWarning;
 
 	if (latestWarning != nullptr)
-		*latestWarning = theGlobals->errMgrLatestWarning;
+		*latestWarning = theState->errMgrLatestWarning;
 
 
 
 	// Set our flags
-	theGlobals->systemDoBottleneck = kQ3True;
-	theGlobals->errMgrClearWarning = kQ3True;
+	theState->systemDoBottleneck = kQ3True;
+	theState->errMgrClearWarning = kQ3True;
 }
 
 
@@ -284,22 +440,22 @@ E3ErrorManager_GetWarning(TQ3Warning *oldestWarning, TQ3Warning *latestWarning)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_GetNotice(TQ3Notice *oldestNotice, TQ3Notice *latestNotice)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Return the requested state
 	if (oldestNotice != nullptr)
-		*oldestNotice = theGlobals->errMgrOldestNotice;
+		*oldestNotice = theState->errMgrOldestNotice;
 
 	if (latestNotice != nullptr)
-		*latestNotice = theGlobals->errMgrLatestNotice;
+		*latestNotice = theState->errMgrLatestNotice;
 
 
 
 	// Set our flags
-	theGlobals->systemDoBottleneck = kQ3True;
-	theGlobals->errMgrClearNotice  = kQ3True;
+	theState->systemDoBottleneck = kQ3True;
+	theState->errMgrClearNotice  = kQ3True;
 }
 
 
@@ -313,22 +469,44 @@ E3ErrorManager_GetNotice(TQ3Notice *oldestNotice, TQ3Notice *latestNotice)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_GetPlatformError(TQ3Uns32 *oldestPlatform, TQ3Uns32 *latestPlatform)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Return the requested state
 	if (oldestPlatform != nullptr)
-		*oldestPlatform = theGlobals->errMgrOldestPlatform;
+		*oldestPlatform = theState->errMgrOldestPlatform;
 
 	if (latestPlatform != nullptr)
-		*latestPlatform = theGlobals->errMgrLatestPlatform;
+		*latestPlatform = theState->errMgrLatestPlatform;
 
 
 
 	// Set our flags
-	theGlobals->systemDoBottleneck  = kQ3True;
-	theGlobals->errMgrClearPlatform = kQ3True;
+	theState->systemDoBottleneck  = kQ3True;
+	theState->errMgrClearPlatform = kQ3True;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ErrorManager_DrainReports : Take the oldest reports from the log.
+//-----------------------------------------------------------------------------
+//		Note :	May be called from any thread, while other threads post.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3ErrorManager_DrainReports(TQ3ErrorReport *theReports, TQ3Uns32 maxReports)
+{	TQ3Uns32	numReports = 0;
+
+
+
+	// Take reports until the array is full or the log is empty
+	while (numReports < maxReports && e3errormanager_log_take(&theReports[numReports]))
+		numReports++;
+
+	return(numReports);
 }
 
 
@@ -340,14 +518,14 @@ E3ErrorManager_GetPlatformError(TQ3Uns32 *oldestPlatform, TQ3Uns32 *latestPlatfo
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_ClearError(void)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Clear our state
-	theGlobals->errMgrClearError  	= kQ3False;
-	theGlobals->errMgrOldestError 	= kQ3ErrorNone;
-	theGlobals->errMgrLatestError 	= kQ3ErrorNone;
+	theState->errMgrClearError  	= kQ3False;
+	theState->errMgrOldestError 	= kQ3ErrorNone;
+	theState->errMgrLatestError 	= kQ3ErrorNone;
 }
 
 
@@ -359,14 +537,14 @@ E3ErrorManager_ClearError(void)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_ClearWarning(void)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Clear our state
-	theGlobals->errMgrClearWarning  = kQ3False;
-	theGlobals->errMgrOldestWarning = kQ3WarningNone;
-	theGlobals->errMgrLatestWarning = kQ3WarningNone;
+	theState->errMgrClearWarning  = kQ3False;
+	theState->errMgrOldestWarning = kQ3WarningNone;
+	theState->errMgrLatestWarning = kQ3WarningNone;
 }
 
 
@@ -378,14 +556,14 @@ E3ErrorManager_ClearWarning(void)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_ClearNotice(void)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Clear our state
-	theGlobals->errMgrClearNotice  = kQ3False;
-	theGlobals->errMgrOldestNotice = kQ3NoticeNone;
-	theGlobals->errMgrLatestNotice = kQ3NoticeNone;
+	theState->errMgrClearNotice  = kQ3False;
+	theState->errMgrOldestNotice = kQ3NoticeNone;
+	theState->errMgrLatestNotice = kQ3NoticeNone;
 }
 
 
@@ -397,14 +575,14 @@ E3ErrorManager_ClearNotice(void)
 //-----------------------------------------------------------------------------
 void
 E3ErrorManager_ClearPlatformError(void)
-{	E3GlobalsPtr	theGlobals = E3Globals_Get();
+{	E3ThreadGlobalsPtr	theState = E3ThreadGlobals_Get();
 
 
 
 	// Clear our state
-	theGlobals->errMgrClearPlatform  = kQ3False;
-	theGlobals->errMgrOldestPlatform = 0;
-	theGlobals->errMgrLatestPlatform = 0;
+	theState->errMgrClearPlatform  = kQ3False;
+	theState->errMgrOldestPlatform = 0;
+	theState->errMgrLatestPlatform = 0;
 }
 
 
@@ -71,6 +71,10 @@ void       E3ErrorManager_GetNotice(TQ3Notice       *oldestNotice,   TQ3Notice
 void       E3ErrorManager_GetPlatformError(TQ3Uns32 *oldestPlatform, TQ3Uns32   *latestPlatform);
 
 
+// Take the oldest reports from the log shared by all threads
+TQ3Uns32 E3ErrorManager_DrainReports(TQ3ErrorReport *theReports, TQ3Uns32 maxReports);
+
+
 // Clear the current error, warning, notice, or platform error
 void E3ErrorManager_ClearError(void);
 void E3ErrorManager_ClearWarning(void);
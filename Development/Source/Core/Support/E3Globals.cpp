@@ -58,26 +58,12 @@
 //-----------------------------------------------------------------------------
 E3Globals gE3Globals = {
 	kQ3False,				// systemInitialised
-	kQ3False,				// systemDoBottleneck
 	0,						// systemRefCount
 	nullptr,				// classTree
 	nullptr,				// classTreeRoot
 	0,						// classNextType
 	0,						// sharedLibraryCount
 	nullptr,						// sharedLibraryInfo
-	kQ3False,				// errMgrClearError
-	kQ3False,				// errMgrClearWarning
-	kQ3False,				// errMgrClearNotice
-	kQ3False,				// errMgrClearPlatform
-	kQ3False,				// errMgrIsFatalError
-	kQ3ErrorNone,			// errMgrOldestError
-	kQ3WarningNone,			// errMgrOldestWarning
-	kQ3NoticeNone,			// errMgrOldestNotice
-	0,						// errMgrOldestPlatform
-	kQ3ErrorNone,			// errMgrLatestError
-	kQ3WarningNone,			// errMgrLatestWarning
-	kQ3NoticeNone,			// errMgrLatestNotice
-	0,						// errMgrLatestPlatform
 	nullptr,				// errMgrHandlerFuncError
 	nullptr,				// errMgrHandlerFuncWarning
 	nullptr,				// errMgrHandlerFuncNotice
@@ -103,6 +89,24 @@ E3Globals gE3Globals = {
 };
 
 
+thread_local E3ThreadGlobals gE3ThreadGlobals = {
+	kQ3False,				// systemDoBottleneck
+	kQ3False,				// errMgrClearError
+	kQ3False,				// errMgrClearWarning
+	kQ3False,				// errMgrClearNotice
+	kQ3False,				// errMgrClearPlatform
+	kQ3False,				// errMgrIsFatalError
+	kQ3ErrorNone,			// errMgrOldestError
+	kQ3WarningNone,			// errMgrOldestWarning
+	kQ3NoticeNone,			// errMgrOldestNotice
+	0,						// errMgrOldestPlatform
+	kQ3ErrorNone,			// errMgrLatestError
+	kQ3WarningNone,			// errMgrLatestWarning
+	kQ3NoticeNone,			// errMgrLatestNotice
+	0						// errMgrLatestPlatform
+};
+
+
 
 
 
@@ -122,3 +126,19 @@ E3Globals_Get(void)
 	// Return the globals
 	return(&gE3Globals);
 }
+
+
+
+
+
+//=============================================================================
+//      E3ThreadGlobals_Get : Get access to the calling thread's Quesa state.
+//-----------------------------------------------------------------------------
+E3ThreadGlobalsPtr
+E3ThreadGlobals_Get(void)
+{
+
+
+	// Return the globals for this thread
+	return(&gE3ThreadGlobals);
+}
@@ -132,6 +132,7 @@ extern "C" {
 #define kQ3ClassNameGeometryEllipse					"Ellipse"
 #define kQ3ClassNameGeometryEllipsoid				"Ellipsoid"
 #define kQ3ClassNameGeometryGeneralPolygon			"GeneralPolygon"
+#define kQ3ClassNameGeometryInstances				"Instances"
 #define kQ3ClassNameGeometryLine					"Line"
 #define kQ3ClassNameGeometryMarker					"Marker"
 #define kQ3ClassNameGeometryMesh					"Mesh"
@@ -174,6 +175,7 @@ extern "C" {
 #define kQ3ClassNamePickWindowPoint					"WindowPointPick"
 #define kQ3ClassNamePickWindowRect					"WindowRectPick"
 #define kQ3ClassNamePickWorldRay					"WorldRayPick"
+#define kQ3ClassNamePickWorldRayBatch				"WorldRayBatchPick"
 #define kQ3ClassNameRenderer						"Renderer"
 #define kQ3ClassNameRendererGeneric					"GenericRenderer"
 #define kQ3ClassNameRendererInteractive				"InteractiveRenderer"
@@ -304,6 +306,7 @@ extern "C" {
 #define kQ3XMethodTypeGeomGetPublicData				Q3_METHOD_TYPE('Q', 'g', 'p', 'u')
 #define kQ3XMethodTypeGeomUsesSubdivision			Q3_METHOD_TYPE('Q', 'g', 'u', 's')
 #define kQ3XMethodTypeGeomUsesOrientation			Q3_METHOD_TYPE('Q', 'g', 'u', 'o')
+#define kQ3XMethodTypeGeomPicksRayBatch				Q3_METHOD_TYPE('Q', 'g', 'p', 'b')
 #define kQ3XMethodTypeGeomCacheNew					Q3_METHOD_TYPE('Q', 'g', 'c', 'n')
 #define kQ3XMethodTypeGeomCacheIsValid				Q3_METHOD_TYPE('Q', 'g', 'c', 'v')
 #define kQ3XMethodTypeGeomCacheUpdate				Q3_METHOD_TYPE('Q', 'g', 'c', 'u')
@@ -434,7 +437,6 @@ typedef class OpaqueTQ3Object {
 typedef struct E3Globals {
 	// System
 	TQ3Boolean				systemInitialised;
-	TQ3Boolean				systemDoBottleneck;
 	TQ3Uns32				systemRefCount;
 
 
@@ -450,19 +452,6 @@ typedef struct E3Globals {
 
 
 	// Error Manager
-	TQ3Boolean				errMgrClearError;
-	TQ3Boolean				errMgrClearWarning;
-	TQ3Boolean				errMgrClearNotice;
-	TQ3Boolean				errMgrClearPlatform;
-	TQ3Boolean				errMgrIsFatalError;
-	TQ3Error				errMgrOldestError;
-	TQ3Warning				errMgrOldestWarning;
-	TQ3Notice				errMgrOldestNotice;
-	TQ3Uns32				errMgrOldestPlatform;
-	TQ3Error				errMgrLatestError;
-	TQ3Warning				errMgrLatestWarning;
-	TQ3Notice				errMgrLatestNotice;
-	TQ3Uns32				errMgrLatestPlatform;
 	TQ3ErrorMethod			errMgrHandlerFuncError;
 	TQ3WarningMethod		errMgrHandlerFuncWarning;
 	TQ3NoticeMethod			errMgrHandlerFuncNotice;
@@ -493,6 +482,33 @@ typedef struct E3Globals {
 } E3Globals, *E3GlobalsPtr;
 
 
+// Per-thread state for each instance of Quesa.
+//
+// The Error Manager state is kept per thread, so that the errors posted by
+// one thread are neither reported to nor cleared by another. The bottleneck
+// only exists to clear this state, so it is per thread as well.
+typedef struct E3ThreadGlobals {
+	// System
+	TQ3Boolean				systemDoBottleneck;
+
+
+	// Error Manager
+	TQ3Boolean				errMgrClearError;
+	TQ3Boolean				errMgrClearWarning;
+	TQ3Boolean				errMgrClearNotice;
+	TQ3Boolean				errMgrClearPlatform;
+	TQ3Boolean				errMgrIsFatalError;
+	TQ3Error				errMgrOldestError;
+	TQ3Warning				errMgrOldestWarning;
+	TQ3Notice				errMgrOldestNotice;
+	TQ3Uns32				errMgrOldestPlatform;
+	TQ3Error				errMgrLatestError;
+	TQ3Warning				errMgrLatestWarning;
+	TQ3Notice				errMgrLatestNotice;
+	TQ3Uns32				errMgrLatestPlatform;
+} E3ThreadGlobals, *E3ThreadGlobalsPtr;
+
+
 
 
 
@@ -507,6 +523,13 @@ typedef struct E3Globals {
 extern E3Globals gE3Globals;
 
 
+// Per-thread Quesa state
+//
+// As with gE3Globals, code should use the E3ThreadGlobals_Get accessor except
+// in the bottleneck.
+extern thread_local E3ThreadGlobals gE3ThreadGlobals;
+
+
 
 
 
@@ -514,7 +537,8 @@ extern E3Globals gE3Globals;
 //      Function prototypes
 //-----------------------------------------------------------------------------
 // Get access to the Quesa global state
-E3GlobalsPtr	E3Globals_Get(void);
+E3GlobalsPtr		E3Globals_Get(void);
+E3ThreadGlobalsPtr	E3ThreadGlobals_Get(void);
 
 
 
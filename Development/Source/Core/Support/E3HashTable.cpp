@@ -6,7 +6,8 @@
         
         Implements a simple hash table, where items within the table are
         keyed using four character constants. Collisions are handled by
-        a resizeable array of unsorted items stored at each slot.
+        linear probing within a power-of-two sized table, which grows as
+        items are added.
         
 		Used by the class tree to store the class tree nodes, and to cache
 		the methods for each node.
@@ -58,29 +59,32 @@
 
 
 //=============================================================================
-//      Internal types
+//      Internal constants
 //-----------------------------------------------------------------------------
-// An item stored within each node
-typedef struct E3HashTableItem {
-	TQ3ObjectType		theKey;						// Key for item
-	void				*theItem;					// Data for item
-} E3HashTableItem, *E3HashTableItemPtr;
+#define kHashTableMinSize							8
+#define kHashTableMaxLoadNumerator					3
+#define kHashTableMaxLoadDenominator				4
+
 
 
-// A node within a hash table
-typedef struct E3HashTableNode {
-	TQ3Uns32			numItems;					// Number of items in node
-	E3HashTableItemPtr	theItems;					// Array of items for node
-} E3HashTableNode, *E3HashTableNodePtr;
 
 
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
 // A hash table
+//
+// Keys and items are held in parallel arrays, so that a probe only has to
+// walk the (contiguous) keys. A key of kQ3ObjectTypeInvalid marks an empty
+// slot. A removed item leaves its key behind with a nullptr item, so that
+// probes for keys stored beyond it still find them.
 typedef struct E3HashTable {
-	TQ3Uns32			collisionMax;				// Worst case collision count
-	float				collisionAverage;			// Average collision count
 	TQ3Uns32			numItems;					// Number of items in table
+	TQ3Uns32			numUsedSlots;				// Items plus removed items
 	TQ3Uns32			tableSize;					// Number of slots in table
-	E3HashTableNodePtr	*theTable;					// Array of node pointers
+	TQ3Uns32			hashShift;					// 32 - log2(tableSize)
+	TQ3ObjectType		*theKeys;					// Array of keys
+	void				**theItems;					// Array of items
 } E3HashTable;
 
 
@@ -90,23 +94,16 @@ typedef struct E3HashTable {
 //=============================================================================
 //      Internal functions
 //-----------------------------------------------------------------------------
-//      e3hash_find_node : Find the node for a given key.
+//      e3hash_find_slot : Find the first slot to probe for a given key.
 //-----------------------------------------------------------------------------
-//		Note :	Hash index algorithm inspired by John Punin's hash table code
-//				for the W3's libwww library.  However, libwww needs to hash
-//				strings of unknown length, whereas here we hash just 4 bytes,
-//				which allows a mathematical simplification of the hash function.
-//
-//				Returns the address of a node pointer, rather than the node
-//				pointer itself, since the node pointer may be nullptr if the node
-//				hasn't been allocated yet.
+//		Note :	We use Fibonacci hashing, taking the top bits of the product of
+//				the key and 2^32 divided by the golden ratio. This spreads both
+//				four character constants and small integer keys (such as the
+//				attribute types) evenly across the table.
 //-----------------------------------------------------------------------------
-static E3HashTableNodePtr *
-e3hash_find_node(E3HashTablePtr theTable, TQ3ObjectType theKey)
+static inline TQ3Uns32
+e3hash_find_slot(E3HashTablePtr theTable, TQ3ObjectType theKey)
 {
-	TQ3Uns32		theIndex;
-	TQ3Uns8			*thePtr;
-	
 
 
 	// Validate our parameters
@@ -115,18 +112,8 @@ e3hash_find_node(E3HashTablePtr theTable, TQ3ObjectType theKey)
 
 
 
-	// Calculate the index for the node
-	thePtr   = (TQ3Uns8 *) &theKey;
-	
-	// This hash function may not be the most theoretically sound, but I can't
-	// find anything faster that works as well.
-	theIndex = (27*thePtr[0] + 9*thePtr[1] + 3*thePtr[2] + thePtr[3]) & (theTable->tableSize - 1);
-
-	Q3_ASSERT(theIndex < theTable->tableSize);
-
-
-	// Return the address of the appropriate node within the table
-	return (&theTable->theTable[theIndex]);
+	// Calculate the index for the key
+	return ((TQ3Uns32) theKey * 2654435769U) >> theTable->hashShift;
 }
 
 
@@ -134,32 +121,41 @@ e3hash_find_node(E3HashTablePtr theTable, TQ3ObjectType theKey)
 
 
 //=============================================================================
-//      e3hash_add_key : Add a key and its item to a node.
+//      e3hash_allocate_slots : Allocate the slot arrays for a table.
+//-----------------------------------------------------------------------------
+//		Note :	The keys and items share a single block, items first.
 //-----------------------------------------------------------------------------
 static TQ3Status
-e3hash_add_key(E3HashTableNodePtr theNode, TQ3ObjectType theKey, void *theItem)
-{	TQ3Status		qd3dStatus;
+e3hash_allocate_slots(E3HashTablePtr theTable, TQ3Uns32 tableSize)
+{	TQ3Uns32		hashShift;
 
 
 
 	// Validate our parameters
-	Q3_ASSERT_VALID_PTR(theNode);
+	Q3_ASSERT_VALID_PTR(theTable);
+	Q3_ASSERT( (tableSize & (tableSize - 1)) == 0 );	// power of 2
+
 
 
+	// Allocate the slots, cleared to empty
+	theTable->theItems = (void **) Q3Memory_AllocateClear(static_cast<TQ3Uns32>(
+															(sizeof(void *) + sizeof(TQ3ObjectType)) * tableSize));
+	if (theTable->theItems == nullptr)
+		return(kQ3Failure);
 
-	// Grow the node item array
-	qd3dStatus = Q3Memory_Reallocate(&theNode->theItems,
-										static_cast<TQ3Uns32>(sizeof(E3HashTableItem) * (theNode->numItems + 1)));
-	if (qd3dStatus != kQ3Success)
-		return(qd3dStatus);
+	theTable->theKeys = (TQ3ObjectType *) (theTable->theItems + tableSize);
 
 
 
-	// Save the item and its key at the end of the node's list,
-	// and update the count for the node
-	theNode->theItems[theNode->numItems].theKey  = theKey;
-	theNode->theItems[theNode->numItems].theItem = theItem;
-	theNode->numItems++;
+	// Initialise the table
+	hashShift = 32;
+	while ((1U << (32 - hashShift)) < tableSize)
+		hashShift--;
+
+	theTable->tableSize    = tableSize;
+	theTable->hashShift    = hashShift;
+	theTable->numItems     = 0;
+	theTable->numUsedSlots = 0;
 
 	return(kQ3Success);
 }
@@ -169,40 +165,90 @@ e3hash_add_key(E3HashTableNodePtr theNode, TQ3ObjectType theKey, void *theItem)
 
 
 //=============================================================================
-//      e3hash_update_stats : Update the table stats.
+//      e3hash_resize : Rebuild a table with a new number of slots.
+//-----------------------------------------------------------------------------
+//		Note :	Removed items are dropped, so this is also used to reclaim
+//				their slots without growing the table.
 //-----------------------------------------------------------------------------
-static void
-e3hash_update_stats(E3HashTablePtr theTable)
-{	TQ3Uns32				n, itemCount, slotCount;
-	E3HashTableNodePtr		theNode;
+static TQ3Status
+e3hash_resize(E3HashTablePtr theTable, TQ3Uns32 newSize)
+{	TQ3ObjectType		*oldKeys;
+	void				**oldItems;
+	TQ3Uns32			n, oldSize, theIndex, theMask;
 
 
 
 	// Validate our parameters
 	Q3_ASSERT_VALID_PTR(theTable);
+	Q3_ASSERT(newSize > theTable->numItems);
 
 
 
-	// Recalculate the table stats
-	theTable->collisionMax     = 0;
-	theTable->collisionAverage = 0.0f;
-	itemCount                  = 0;
-	slotCount                  = 0;
+	// Allocate the new slots
+	oldKeys  = theTable->theKeys;
+	oldItems = theTable->theItems;
+	oldSize  = theTable->tableSize;
 	
-	for (n = 0; n < theTable->tableSize; n++)
+	if (e3hash_allocate_slots(theTable, newSize) != kQ3Success)
+		{
+		theTable->theKeys   = oldKeys;
+		theTable->theItems  = oldItems;
+		theTable->tableSize = oldSize;
+		return(kQ3Failure);
+		}
+
+
+
+	// Re-insert the items
+	theMask = theTable->tableSize - 1;
+
+	for (n = 0; n < oldSize; n++)
 		{
-		theNode = theTable->theTable[n];
-		if (theNode != nullptr)
+		if (oldItems[n] != nullptr)
 			{
-			if (theNode->numItems > theTable->collisionMax)
-				theTable->collisionMax = theNode->numItems;
-		
-			itemCount += theNode->numItems;
-			slotCount++;
+			theIndex = e3hash_find_slot(theTable, oldKeys[n]);
+			while (theTable->theKeys[theIndex] != kQ3ObjectTypeInvalid)
+				theIndex = (theIndex + 1) & theMask;
+			
+			theTable->theKeys[theIndex]  = oldKeys[n];
+			theTable->theItems[theIndex] = oldItems[n];
+			theTable->numItems++;
 			}
 		}
+
+	theTable->numUsedSlots = theTable->numItems;
+
+
+
+	// Clean up
+	Q3Memory_Free(&oldItems);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3hash_probe_length : Number of slots probed to find an item.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3hash_probe_length(E3HashTablePtr theTable, TQ3Uns32 theIndex)
+{	TQ3Uns32		homeIndex;
+
+
+
+	// Validate our parameters
+	Q3_ASSERT_VALID_PTR(theTable);
+	Q3_ASSERT(theTable->theItems[theIndex] != nullptr);
+
+
+
+	// Measure the distance from the item's home slot, allowing for wrapping
+	homeIndex = e3hash_find_slot(theTable, theTable->theKeys[theIndex]);
 	
-	theTable->collisionAverage = (float) itemCount / (float) slotCount;
+	return(((theIndex - homeIndex) & (theTable->tableSize - 1)) + 1);
 }
 
 
@@ -214,6 +260,9 @@ e3hash_update_stats(E3HashTablePtr theTable)
 //-----------------------------------------------------------------------------
 //      E3HashTable_Create : Create a hash table.
 //-----------------------------------------------------------------------------
+//		Note :	The table size is only the initial size, since the table will
+//				grow to keep its load factor below 3/4.
+//-----------------------------------------------------------------------------
 #pragma mark -
 E3HashTablePtr
 E3HashTable_Create(TQ3Uns32 tableSize)
@@ -232,21 +281,8 @@ E3HashTable_Create(TQ3Uns32 tableSize)
 	if (theTable != nullptr)
 		{
 		// Initialise the table
-		theTable->collisionMax     = 0;
-		theTable->collisionAverage = 0.0f;
-		theTable->tableSize        = tableSize;
-		theTable->numItems         = 0;
-		theTable->theTable = (E3HashTableNodePtr *) Q3Memory_AllocateClear(static_cast<TQ3Uns32>(sizeof(E3HashTableNodePtr)
-																			* theTable->tableSize));
-
-
-
-		// Handle failure
-		if (theTable->theTable == nullptr)
-			{
+		if (e3hash_allocate_slots(theTable, E3Num_Max(tableSize, (TQ3Uns32) kHashTableMinSize)) != kQ3Success)
 			Q3Memory_Free(&theTable);
-			theTable = nullptr;
-			}
 		}
 
 	return(theTable);
@@ -261,10 +297,7 @@ E3HashTable_Create(TQ3Uns32 tableSize)
 //-----------------------------------------------------------------------------
 void
 E3HashTable_Destroy(E3HashTablePtr *theTable)
-{	E3HashTablePtr			tablePtr;
-	E3HashTableNodePtr		theNode;
-	TQ3Uns32				n;
-
+{
 
 
 	// Validate our parameters
@@ -273,22 +306,8 @@ E3HashTable_Destroy(E3HashTablePtr *theTable)
 
 
 
-	// Dispose of the table items
-	tablePtr = *theTable;
-	for (n = 0; n < tablePtr->tableSize; n++)
-		{
-		theNode = tablePtr->theTable[n];
-		if (theNode != nullptr)
-			{
-			Q3Memory_Free(&theNode->theItems);
-			Q3Memory_Free(&tablePtr->theTable[n]);
-			}
-		}
-
-
-
-	// Dispose of the table itself
-	Q3Memory_Free(&tablePtr->theTable);
+	// Dispose of the table slots and the table itself
+	Q3Memory_Free(&(*theTable)->theItems);
 	Q3Memory_Free(theTable);
 }
 
@@ -304,8 +323,7 @@ E3HashTable_Destroy(E3HashTablePtr *theTable)
 //-----------------------------------------------------------------------------
 TQ3Status
 E3HashTable_Add(E3HashTablePtr theTable, TQ3ObjectType theKey, void *theItem)
-{	TQ3Status				qd3dStatus;
-	E3HashTableNodePtr		*theNode;
+{	TQ3Uns32				theIndex, freeIndex, theMask, newSize;
 
 
 
@@ -320,32 +338,49 @@ E3HashTable_Add(E3HashTablePtr theTable, TQ3ObjectType theKey, void *theItem)
 
 
 
-	// Find the node which should contain the item
-	theNode = e3hash_find_node(theTable, theKey);
-	Q3_ASSERT_VALID_PTR(theNode);
-
-
-
-	// If the node doesn't exist, create it
-	if (*theNode == nullptr)
+	// Make room for the item if the table is too full
+	//
+	// If most of the used slots hold removed items, we can rebuild at the
+	// same size. Otherwise we double the size of the table.
+	if ((theTable->numUsedSlots + 1) * kHashTableMaxLoadDenominator >
+		theTable->tableSize * kHashTableMaxLoadNumerator)
 		{
-		*theNode = (E3HashTableNodePtr) Q3Memory_AllocateClear(sizeof(E3HashTableNode));
-		if (*theNode == nullptr)
+		newSize = theTable->tableSize;
+		if ((theTable->numItems + 1) * 2 > newSize)
+			newSize *= 2;
+
+		if (e3hash_resize(theTable, newSize) != kQ3Success)
 			return(kQ3Failure);
 		}
 
 
 
-	// Add the item to the node
-	qd3dStatus = e3hash_add_key(*theNode, theKey, theItem);
-	if (qd3dStatus != kQ3Success)
-		return(qd3dStatus);
+	// Find a slot for the item, reusing the slot of a removed item if we
+	// pass one before reaching an empty slot
+	theMask   = theTable->tableSize - 1;
+	theIndex  = e3hash_find_slot(theTable, theKey);
+	freeIndex = theTable->tableSize;
+
+	while (theTable->theKeys[theIndex] != kQ3ObjectTypeInvalid)
+		{
+		if (freeIndex == theTable->tableSize && theTable->theItems[theIndex] == nullptr)
+			freeIndex = theIndex;
+
+		theIndex = (theIndex + 1) & theMask;
+		}
+
+	if (freeIndex == theTable->tableSize)
+		{
+		freeIndex = theIndex;
+		theTable->numUsedSlots++;
+		}
 
 
 
-	// Update the table
+	// Add the item to the slot
+	theTable->theKeys[freeIndex]  = theKey;
+	theTable->theItems[freeIndex] = theItem;
 	theTable->numItems++;
-	e3hash_update_stats(theTable);
 
 	return(kQ3Success);
 }
@@ -357,12 +392,13 @@ E3HashTable_Add(E3HashTablePtr theTable, TQ3ObjectType theKey, void *theItem)
 //=============================================================================
 //      E3HashTable_Remove : Remove an item from a hash table.
 //-----------------------------------------------------------------------------
-//		Note : The item must be present in the hash table.
+//		Note :	The item must be present in the hash table.
+//
+//				Removing an item never moves other items, so it is safe to
+//				remove items from within E3HashTable_Iterate.
 //-----------------------------------------------------------------------------
 void E3HashTable_Remove(E3HashTablePtr theTable, TQ3ObjectType theKey)
-{	E3HashTableNodePtr		theNode, *nodePtr;
-	TQ3Boolean				foundItem;
-	TQ3Uns32				n;
+{	TQ3Uns32				theIndex, theMask;
 
 
 
@@ -371,45 +407,42 @@ void E3HashTable_Remove(E3HashTablePtr theTable, TQ3ObjectType theKey)
 
 
 
-	// Find the node which should contain the item
-	nodePtr = e3hash_find_node(theTable, theKey);
-	Q3_ASSERT_VALID_PTR(nodePtr);
-	
-	theNode = *nodePtr;
-	Q3_ASSERT_VALID_PTR(nodePtr);
-
+	// Find the slot which contains the item
+	theMask  = theTable->tableSize - 1;
+	theIndex = e3hash_find_slot(theTable, theKey);
 
-
-	// Remove the item from the node
-	foundItem = kQ3False;
-	for (n = 0; n < theNode->numItems && !foundItem; n++)
+	while (theTable->theKeys[theIndex] != kQ3ObjectTypeInvalid)
 		{
-		if (theKey == theNode->theItems[n].theKey)
-			{
-			// Shift the items above this item, if any, done by 1
-			if (n != (theNode->numItems - 1))
-				memmove(&theNode->theItems[n],
-						&theNode->theItems[n+1],
-						(theNode->numItems - n - 1) * sizeof(E3HashTableItem));
-			
-			
-			// Decrement the node count and break
-			Q3_ASSERT(theNode->numItems >= 1);
-			theNode->numItems--;
-			foundItem = kQ3True;
-			}
+		if (theTable->theKeys[theIndex] == theKey && theTable->theItems[theIndex] != nullptr)
+			break;
+
+		theIndex = (theIndex + 1) & theMask;
 		}
 
 
 
-	// Update the table
-	Q3_ASSERT(foundItem);
+	// Remove the item from the slot
+	Q3_ASSERT(theTable->theKeys[theIndex] == theKey);
 	Q3_ASSERT(theTable->numItems >= 1);
 
-	if (foundItem)
+	if (theTable->theKeys[theIndex] != theKey)
+		return;
+
+	theTable->theItems[theIndex] = nullptr;
+	theTable->numItems--;
+
+
+
+	// If the following slot is empty, no probe passes through this slot, so
+	// it can be made empty again - as can any removed items before it.
+	while (theTable->theKeys[theIndex] != kQ3ObjectTypeInvalid &&
+		   theTable->theItems[theIndex] == nullptr &&
+		   theTable->theKeys[(theIndex + 1) & theMask] == kQ3ObjectTypeInvalid)
 		{
-		theTable->numItems--;
-		e3hash_update_stats(theTable);
+		theTable->theKeys[theIndex] = kQ3ObjectTypeInvalid;
+		theTable->numUsedSlots--;
+		
+		theIndex = (theIndex - 1) & theMask;
 		}
 }
 
@@ -424,10 +457,9 @@ void E3HashTable_Remove(E3HashTablePtr theTable, TQ3ObjectType theKey)
 //-----------------------------------------------------------------------------
 void *
 E3HashTable_Find(E3HashTablePtr theTable, TQ3ObjectType theKey)
-{	E3HashTableNodePtr		theNode, *nodePtr;
-	E3HashTableItemPtr		theItem;
-	TQ3Uns32				n, numItems;
-	
+{	TQ3Uns32				theIndex, theMask;
+	TQ3ObjectType			slotKey;
+
 
 
 	// Validate our parameters
@@ -435,29 +467,20 @@ E3HashTable_Find(E3HashTablePtr theTable, TQ3ObjectType theKey)
 
 
 
-	// Find the node which should contain the item
-	nodePtr = e3hash_find_node(theTable, theKey);
+	// Probe until we find the item or reach an empty slot
+	//
+	// A removed item with the same key has a nullptr item, and since Add
+	// reuses the first free slot on the probe path, any live item with that
+	// key lies before it. So we can return the item of the first match.
+	theMask  = theTable->tableSize - 1;
+	theIndex = e3hash_find_slot(theTable, theKey);
 
-
-
-	// If the node is empty, we're done
-	if (*nodePtr == nullptr)
-		return(nullptr);
-
-	theNode = *nodePtr;
-	Q3_ASSERT_VALID_PTR(theNode);
-
-
-
-	// Otherwise, look for the item
-	theItem = theNode->theItems;
-	numItems = theNode->numItems;
-	for (n = 0; n < numItems; ++n)
+	while ((slotKey = theTable->theKeys[theIndex]) != kQ3ObjectTypeInvalid)
 		{
-		if (theKey == theItem->theKey)
-			return(theItem->theItem);
-		
-		++theItem;
+		if (slotKey == theKey)
+			return(theTable->theItems[theIndex]);
+
+		theIndex = (theIndex + 1) & theMask;
 		}
 
 	return(nullptr);
@@ -470,13 +493,12 @@ E3HashTable_Find(E3HashTablePtr theTable, TQ3ObjectType theKey)
 //=============================================================================
 //      E3HashTable_Iterate : Iterate over the items in a hash table.
 //-----------------------------------------------------------------------------
+//		Note :	The iterator may remove items, but must not add them.
+//-----------------------------------------------------------------------------
 TQ3Status
 E3HashTable_Iterate(E3HashTablePtr theTable, TQ3HashTableIterator theIterator, void *userData)
 {	TQ3Status				qd3dStatus = kQ3Success;
-	E3HashTableItemPtr		theItem;
-	E3HashTableNodePtr		theNode;
 	TQ3Uns32				n;
-	TQ3Int32				m;	// must be signed due to backwards loop
 
 
 
@@ -488,25 +510,14 @@ E3HashTable_Iterate(E3HashTablePtr theTable, TQ3HashTableIterator theIterator, v
 
 	// Iterate over the table
 	for (n = 0; n < theTable->tableSize; n++)
-	{
-		theNode = theTable->theTable[n];
-		
-		if ( theNode != nullptr )
 		{
-			// Iterate backwards in case the iterator function removes any items
-			for (m = theNode->numItems - 1; m >= 0; --m)
+		if (theTable->theItems[n] != nullptr)
 			{
-				theItem = &theNode->theItems[m];
-				
-				qd3dStatus = theIterator(theTable, theItem->theKey, theItem->theItem, userData);
-				if (qd3dStatus != kQ3Success)
-					break;
+			qd3dStatus = theIterator(theTable, theTable->theKeys[n], theTable->theItems[n], userData);
+			if (qd3dStatus != kQ3Success)
+				break;
 			}
 		}
-
-		if (qd3dStatus != kQ3Success)
-			break;
-	}
 	
 	return(qd3dStatus);
 }
@@ -518,9 +529,12 @@ E3HashTable_Iterate(E3HashTablePtr theTable, TQ3HashTableIterator theIterator, v
 //=============================================================================
 //      E3HashTable_GetCollisionMax : Get the max collision count for a table.
 //-----------------------------------------------------------------------------
+//		Note :	Returns the longest probe needed to find an item in the table.
+//-----------------------------------------------------------------------------
 TQ3Uns32
 E3HashTable_GetCollisionMax(E3HashTablePtr theTable)
-{
+{	TQ3Uns32		n, collisionMax;
+
 
 
 	// Validate our parameters
@@ -528,8 +542,16 @@ E3HashTable_GetCollisionMax(E3HashTablePtr theTable)
 
 
 
-	// Get the value
-	return(theTable->collisionMax);
+	// Calculate the value
+	collisionMax = 0;
+	
+	for (n = 0; n < theTable->tableSize; n++)
+		{
+		if (theTable->theItems[n] != nullptr)
+			collisionMax = E3Num_Max(collisionMax, e3hash_probe_length(theTable, n));
+		}
+
+	return(collisionMax);
 }
 
 
@@ -539,9 +561,12 @@ E3HashTable_GetCollisionMax(E3HashTablePtr theTable)
 //=============================================================================
 //      E3HashTable_GetCollisionAverage : Get the average collision count.
 //-----------------------------------------------------------------------------
+//		Note :	Returns the average probe needed to find an item in the table.
+//-----------------------------------------------------------------------------
 float
 E3HashTable_GetCollisionAverage(E3HashTablePtr theTable)
-{
+{	TQ3Uns32		n, probeTotal;
+
 
 
 	// Validate our parameters
@@ -549,8 +574,19 @@ E3HashTable_GetCollisionAverage(E3HashTablePtr theTable)
 
 
 
-	// Get the value
-	return(theTable->collisionAverage);
+	// Calculate the value
+	if (theTable->numItems == 0)
+		return(0.0f);
+
+	probeTotal = 0;
+	
+	for (n = 0; n < theTable->tableSize; n++)
+		{
+		if (theTable->theItems[n] != nullptr)
+			probeTotal += e3hash_probe_length(theTable, n);
+		}
+
+	return((float) probeTotal / (float) theTable->numItems);
 }
 
 
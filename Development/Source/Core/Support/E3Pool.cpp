@@ -70,6 +70,8 @@
 #include "E3Prefix.h"
 #include "E3Pool.h"
 
+#include <stdlib.h>
+
 
 
 
@@ -214,6 +216,165 @@ failure:
 
 
 
+//=============================================================================
+//		e3pool_compare_blocks : qsort callback to order blocks by address.
+//-----------------------------------------------------------------------------
+typedef struct TE3PoolBlockUsage {
+	TE3PoolBlock*				blockPtr;
+	TQ3Uns32					numFreeItems;
+} TE3PoolBlockUsage;
+
+static int
+e3pool_compare_blocks(
+	const void* block1,
+	const void* block2)
+{
+	const char* blockPtr1 = (const char*) ((const TE3PoolBlockUsage*) block1)->blockPtr;
+	const char* blockPtr2 = (const char*) ((const TE3PoolBlockUsage*) block2)->blockPtr;
+
+	return(blockPtr1 < blockPtr2 ? -1 : (blockPtr1 > blockPtr2 ? 1 : 0));
+}
+
+
+
+
+
+//=============================================================================
+//		e3pool_find_block : Find the block containing an item.
+//-----------------------------------------------------------------------------
+//		Note :	The blocks must be sorted by address.
+//-----------------------------------------------------------------------------
+static TE3PoolBlockUsage*
+e3pool_find_block(
+	TE3PoolBlockUsage* blockUsage,
+	TQ3Uns32 numBlocks,
+	const TE3PoolItem* itemPtr)
+{
+	TQ3Uns32 lo = 0, hi = numBlocks;
+
+	// Find the last block starting at or before the item
+	while (hi - lo > 1)
+	{
+		TQ3Uns32 mid = (lo + hi) / 2;
+		if ((const char*) blockUsage[mid].blockPtr <= (const char*) itemPtr)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return(&blockUsage[lo]);
+}
+
+
+
+
+
+//=============================================================================
+//		E3Pool_Trim : Return wholly free blocks to the heap.
+//-----------------------------------------------------------------------------
+//		Note :	The item layout must be the one passed to E3Pool_AllocateTagged,
+//				and the pool must not be tagged, since a tagged block is never
+//				wholly free.
+//
+//				The free items of the remaining blocks keep their order.
+//
+//				Returns the number of blocks released.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Pool_Trim(
+	TE3Pool* poolPtr,
+	TQ3Uns32 itemOffset,
+	TQ3Uns32 itemSize,
+	TQ3Uns32 blockLength)
+{
+	TE3PoolBlockUsage* blockUsage;
+	TE3PoolBlockUsage* usagePtr;
+	TE3PoolBlock* blockPtr;
+	TE3PoolItem* itemPtr;
+	TE3PoolItem** nextFreePtr;
+	TQ3Uns32 numBlocks, numFreeBlocks, n;
+
+	// Validate our parameters
+	Q3_ASSERT_VALID_PTR(poolPtr);
+	Q3_ASSERT(itemOffset >= sizeof(TE3PoolBlock));
+	Q3_ASSERT(itemSize >= sizeof(TE3PoolItem));
+	Q3_ASSERT(blockLength > 0);
+
+	// Nothing to do unless a whole block's worth of items is free
+	if (poolPtr->headFreeItemPtr_private == nullptr)
+		return(0);
+
+	numBlocks = 0;
+	for (blockPtr = poolPtr->headBlockPtr_private; blockPtr != nullptr; blockPtr = blockPtr->nextBlockPtr_private)
+		++numBlocks;
+
+	blockUsage = (TE3PoolBlockUsage*) Q3Memory_Allocate(numBlocks * sizeof(TE3PoolBlockUsage));
+	if (blockUsage == nullptr)
+		return(0);
+
+	// Count the free items in each block
+	n = 0;
+	for (blockPtr = poolPtr->headBlockPtr_private; blockPtr != nullptr; blockPtr = blockPtr->nextBlockPtr_private, ++n)
+	{
+		blockUsage[n].blockPtr     = blockPtr;
+		blockUsage[n].numFreeItems = 0;
+	}
+
+	qsort(blockUsage, numBlocks, sizeof(TE3PoolBlockUsage), e3pool_compare_blocks);
+
+	for (itemPtr = poolPtr->headFreeItemPtr_private; itemPtr != nullptr; itemPtr = itemPtr->nextFreeItemPtr_private)
+	{
+		usagePtr = e3pool_find_block(blockUsage, numBlocks, itemPtr);
+		Q3_ASSERT((const char*) itemPtr >= (const char*) usagePtr->blockPtr + itemOffset);
+		Q3_ASSERT((const char*) itemPtr <  (const char*) usagePtr->blockPtr + itemOffset + itemSize*blockLength);
+		++usagePtr->numFreeItems;
+	}
+
+	numFreeBlocks = 0;
+	for (n = 0; n < numBlocks; ++n)
+	{
+		if (blockUsage[n].numFreeItems == blockLength)
+			++numFreeBlocks;
+	}
+
+	if (numFreeBlocks != 0)
+	{
+		// Unlink the free items of the blocks we are about to release
+		nextFreePtr = &poolPtr->headFreeItemPtr_private;
+		for (itemPtr = poolPtr->headFreeItemPtr_private; itemPtr != nullptr; itemPtr = itemPtr->nextFreeItemPtr_private)
+		{
+			if (e3pool_find_block(blockUsage, numBlocks, itemPtr)->numFreeItems != blockLength)
+			{
+				*nextFreePtr = itemPtr;
+				nextFreePtr  = &itemPtr->nextFreeItemPtr_private;
+			}
+		}
+		*nextFreePtr = nullptr;
+
+		// Relink the blocks we keep, and release the others
+		poolPtr->headBlockPtr_private = nullptr;
+		for (n = 0; n < numBlocks; ++n)
+		{
+			blockPtr = blockUsage[n].blockPtr;
+			if (blockUsage[n].numFreeItems == blockLength)
+				Q3Memory_Free(&blockPtr);
+			else
+			{
+				blockPtr->nextBlockPtr_private = poolPtr->headBlockPtr_private;
+				poolPtr->headBlockPtr_private  = blockPtr;
+			}
+		}
+	}
+
+	Q3Memory_Free(&blockUsage);
+
+	return(numFreeBlocks);
+}
+
+
+
+
+
 //=============================================================================
 //		E3Pool_Free : Free allocated item to pool, and set item pointer to nullptr.
 //-----------------------------------------------------------------------------
@@ -168,6 +168,17 @@ E3Pool_Create(																\
 void
 E3Pool_Destroy			(TE3Pool*				poolPtr);
 
+/*
+TQ3Boolean
+E3Pool_HasFreeItem		(const TE3Pool*			poolPtr);
+*/
+#define /* inline */														\
+E3Pool_HasFreeItem(															\
+	poolPtr)																\
+(																			\
+	(TQ3Boolean) ((poolPtr)->headFreeItemPtr_private != nullptr)			\
+)
+
 TE3PoolItem*
 E3Pool_AllocateTagged	(TE3Pool*				poolPtr,
 						 TQ3Uns32				itemOffset,
@@ -179,6 +190,12 @@ void
 E3Pool_Free				(TE3Pool*				poolPtr,
 						 TE3PoolItem**			itemPtrPtr);
 
+TQ3Uns32
+E3Pool_Trim				(TE3Pool*				poolPtr,
+						 TQ3Uns32				itemOffset,
+						 TQ3Uns32				itemSize,
+						 TQ3Uns32				blockLength);
+
 const TE3PoolItem*
 E3PoolItem_Tag			(const TE3PoolItem*		itemPtr,
 						 TQ3Uns32				itemSize,
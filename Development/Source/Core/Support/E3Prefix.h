@@ -51,6 +51,39 @@
 #endif
 
 
+// Should shared object reference counts and edit indices be updated with
+// atomic operations, so that shared objects can be referenced, edited, and
+// disposed of from several threads at once?
+#ifndef QUESA_ATOMIC_REFCOUNTS
+	#define QUESA_ATOMIC_REFCOUNTS								0
+#endif
+
+
+// Should Q3View_SubmitParallel split bounding and picking traversals of large
+// display groups across worker threads?
+//
+// The workers share the objects being traversed, so this needs atomic
+// reference counts.
+#ifndef QUESA_PARALLEL_TRAVERSAL
+	#define QUESA_PARALLEL_TRAVERSAL							QUESA_ATOMIC_REFCOUNTS
+#endif
+
+#if QUESA_PARALLEL_TRAVERSAL && !QUESA_ATOMIC_REFCOUNTS
+	#error "QUESA_PARALLEL_TRAVERSAL requires QUESA_ATOMIC_REFCOUNTS"
+#endif
+
+
+// Unlocked caches
+//
+// Several of the optimisations below keep caches inside objects, which are
+// filled in or changed as the objects are used: instance free-lists, shared
+// TriMesh arrays, bounding boxes, command lists and pick hierarchies. These
+// are not locked, so each optimisation is off by default when
+// QUESA_ATOMIC_REFCOUNTS is set, and should only be turned on if its objects
+// are never used by several threads at once. In particular, this means that
+// the parallel picks of Q3View_SubmitParallel do not use pick hierarchies.
+
+
 
 
 
@@ -123,6 +156,7 @@
 #include "QuesaRenderer.h"
 #include "QuesaSet.h"
 #include "QuesaShader.h"
+#include "QuesaStats.h"
 #include "QuesaStorage.h"
 #include "QuesaString.h"
 #include "QuesaStyle.h"
@@ -168,6 +202,132 @@
 #endif
 
 
+// Should submits be counted and timed per class, for the Q3Stats API?
+//
+// The counters are not locked, so they are only meaningful when a single
+// thread is submitting.
+#ifndef QUESA_CLASS_STATS
+	#define QUESA_CLASS_STATS									0
+#endif
+
+
+// Should classes with small instances recycle them through a free-list?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_USE_INSTANCE_POOLS
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_USE_INSTANCE_POOLS						0
+	#else
+		#define QUESA_USE_INSTANCE_POOLS						1
+	#endif
+#endif
+
+
+// Should duplicated TriMeshes share their arrays until one is changed?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_SHARE_GEOMETRY_DATA
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_SHARE_GEOMETRY_DATA						0
+	#else
+		#define QUESA_SHARE_GEOMETRY_DATA						1
+	#endif
+#endif
+
+
+// Should display groups maintain their own bounding boxes, and be culled
+// against them while rendering?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_AUTO_GROUP_BOUNDS
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_AUTO_GROUP_BOUNDS							0
+	#else
+		#define QUESA_AUTO_GROUP_BOUNDS							1
+	#endif
+#endif
+
+
+// Should geometries maintain their own bounding boxes, and be culled against
+// them while rendering?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_GEOMETRY_CULLING
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_GEOMETRY_CULLING							0
+	#else
+		#define QUESA_GEOMETRY_CULLING							1
+	#endif
+#endif
+
+
+// Should display groups with kQ3DisplayGroupStateMaskIsCompiled set be
+// rendered from a recorded command list?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_COMPILED_GROUPS
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_COMPILED_GROUPS							0
+	#else
+		#define QUESA_COMPILED_GROUPS							1
+	#endif
+#endif
+
+
+// Should display groups with many members build a bounding volume hierarchy
+// over them, so that ray picks only submit the members they may hit?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_GROUP_PICK_BVH
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_GROUP_PICK_BVH							0
+	#else
+		#define QUESA_GROUP_PICK_BVH							1
+	#endif
+#endif
+
+
+// Should large TriMeshes build a bounding volume hierarchy over their
+// triangles, to speed up ray picking?
+//
+// Off by default with QUESA_ATOMIC_REFCOUNTS, see "Unlocked caches" above.
+#ifndef QUESA_TRIMESH_PICK_BVH
+	#if QUESA_ATOMIC_REFCOUNTS
+		#define QUESA_TRIMESH_PICK_BVH							0
+	#else
+		#define QUESA_TRIMESH_PICK_BVH							1
+	#endif
+#endif
+
+
+// Should groups with many members allocate their positions in chunks, so that
+// the members of a large group are close together in memory?
+#ifndef QUESA_GROUP_POSITION_CHUNKS
+	#define QUESA_GROUP_POSITION_CHUNKS							1
+#endif
+
+
+// Should the first rendering pass be recorded and replayed for any further
+// passes the renderer asks for, rather than asking the application to
+// submit the scene again?
+//
+// Off by default, since the first pass must then be recorded without culling.
+#ifndef QUESA_REPLAY_PASSES
+	#define QUESA_REPLAY_PASSES									0
+#endif
+
+
+// Should arrays of points be transformed and bounded with SSE, where the
+// compiler targets it?
+#ifndef QUESA_USE_SSE
+	#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+		#define QUESA_USE_SSE									1
+	#else
+		#define QUESA_USE_SSE									0
+	#endif
+#endif
+
+
 // Should we register the built-in plug-ins?
 #ifndef QUESA_REGISTER_BUILTIN_PLUGINS
 	#define QUESA_REGISTER_BUILTIN_PLUGINS						1
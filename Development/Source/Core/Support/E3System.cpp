@@ -226,25 +226,25 @@ E3System_ClearBottleneck(void)
 
 
 	// Validate our state
-	Q3_ASSERT(gE3Globals.systemDoBottleneck);
+	Q3_ASSERT(gE3ThreadGlobals.systemDoBottleneck);
 
 
 
 	// Clear the Error Manager state
-	if (gE3Globals.errMgrClearError)
+	if (gE3ThreadGlobals.errMgrClearError)
 		E3ErrorManager_ClearError();
 
-	if (gE3Globals.errMgrClearWarning)
+	if (gE3ThreadGlobals.errMgrClearWarning)
 		E3ErrorManager_ClearWarning();
 
-	if (gE3Globals.errMgrClearNotice)
+	if (gE3ThreadGlobals.errMgrClearNotice)
 		E3ErrorManager_ClearNotice();
 
-	if (gE3Globals.errMgrClearPlatform)
+	if (gE3ThreadGlobals.errMgrClearPlatform)
 		E3ErrorManager_ClearPlatformError();
 
 
 
 	// Reset our state
-	gE3Globals.systemDoBottleneck = kQ3False;
+	gE3ThreadGlobals.systemDoBottleneck = kQ3False;
 }
@@ -72,7 +72,7 @@ extern "C" {
 #define E3System_Bottleneck()													\
 				do																\
 					{															\
-					if (gE3Globals.systemDoBottleneck)							\
+					if (gE3ThreadGlobals.systemDoBottleneck)				\
 						E3System_ClearBottleneck();								\
 					}															\
 				while (0)
@@ -51,6 +51,10 @@
 #include "E3Utils.h"
 #include "E3View.h"
 
+#if QUESA_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
 
 
 
@@ -503,6 +507,84 @@ TQ3Boolean E3Rect_ContainsLine(const TQ3Area *theRect, const TQ3Point2D *lineSta
 
 
 
+//=============================================================================
+//      E3Rect_GetClipCodes : Get the clipping codes of an array of points.
+//-----------------------------------------------------------------------------
+//		Note :	Calculates the Cohen-Sutherland clipping code of the x and y
+//				of each point against the rectangle, as used by
+//				E3Rect_ClipLine. A code of 0 means the point is inside the
+//				rectangle, and two points whose codes share a bit lie on the
+//				same outside side of it.
+//
+//				Where we have SSE, four points are transposed into registers
+//				and tested at once.
+//-----------------------------------------------------------------------------
+void
+E3Rect_GetClipCodes(const TQ3Area *theRect, TQ3Uns32 numPoints, const TQ3Point3D *thePoints, TQ3Uns8 *clipCodes)
+{	TQ3Uns32	n = 0;
+
+
+
+	// Validate our parameters
+	Q3_REQUIRE(Q3_VALID_PTR(theRect));
+	Q3_REQUIRE(numPoints == 0 || Q3_VALID_PTR(thePoints));
+	Q3_REQUIRE(numPoints == 0 || Q3_VALID_PTR(clipCodes));
+
+
+
+#if QUESA_USE_SSE
+	// Calculate the codes four points at a time
+	const float		*theFloats = &thePoints[0].x;
+	__m128			minX = _mm_set1_ps( theRect->min.x );
+	__m128			minY = _mm_set1_ps( theRect->min.y );
+	__m128			maxX = _mm_set1_ps( theRect->max.x );
+	__m128			maxY = _mm_set1_ps( theRect->max.y );
+
+	for (n = 0; n + 4 <= numPoints; n += 4, theFloats += 12)
+		{
+		// Load x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3, and gather the x and y
+		__m128 a   = _mm_loadu_ps( theFloats     );
+		__m128 b   = _mm_loadu_ps( theFloats + 4 );
+		__m128 c   = _mm_loadu_ps( theFloats + 8 );
+		__m128 x01 = _mm_shuffle_ps( a,   a,   _MM_SHUFFLE(3, 0, 3, 0) );
+		__m128 x23 = _mm_shuffle_ps( b,   c,   _MM_SHUFFLE(1, 1, 2, 2) );
+		__m128 x   = _mm_shuffle_ps( x01, x23, _MM_SHUFFLE(2, 0, 1, 0) );
+		__m128 y01 = _mm_shuffle_ps( a,   b,   _MM_SHUFFLE(0, 0, 1, 1) );
+		__m128 y23 = _mm_shuffle_ps( b,   c,   _MM_SHUFFLE(2, 2, 3, 3) );
+		__m128 y   = _mm_shuffle_ps( y01, y23, _MM_SHUFFLE(2, 0, 2, 0) );
+
+
+		// Test the sides, giving the top and left sides priority as
+		// e3clip_calc_opcode does
+		__m128 isTop    = _mm_cmplt_ps( y, minY );
+		__m128 isBottom = _mm_andnot_ps( isTop,  _mm_cmpgt_ps( y, maxY ) );
+		__m128 isLeft   = _mm_cmplt_ps( x, minX );
+		__m128 isRight  = _mm_andnot_ps( isLeft, _mm_cmpgt_ps( x, maxX ) );
+
+		int maskTop    = _mm_movemask_ps( isTop    );
+		int maskBottom = _mm_movemask_ps( isBottom );
+		int maskLeft   = _mm_movemask_ps( isLeft   );
+		int maskRight  = _mm_movemask_ps( isRight  );
+
+		for (TQ3Uns32 i = 0; i < 4; ++i)
+			clipCodes[n + i] = (TQ3Uns8) ((((maskTop    >> i) & 1) * kClipTop)    |
+										  (((maskBottom >> i) & 1) * kClipBottom) |
+										  (((maskLeft   >> i) & 1) * kClipLeft)   |
+										  (((maskRight  >> i) & 1) * kClipRight));
+		}
+#endif
+
+
+
+	// Calculate the remaining codes
+	for ( ; n < numPoints; ++n)
+		clipCodes[n] = e3clip_calc_opcode(theRect, thePoints[n].x, thePoints[n].y);
+}
+
+
+
+
+
 //=============================================================================
 //      E3Rect_ContainsRect : Test to see if rect1 is contained within rect2.
 //-----------------------------------------------------------------------------
@@ -551,18 +633,16 @@ E3Rect_IntersectRect(const TQ3Area *rect1, const TQ3Area *rect2)
 
 
 	// Check for overlaps in x
-	if ((rect1->min.x >= rect2->min.x || rect1->min.x <= rect2->max.x) ||
-		(rect1->max.x >= rect2->min.x || rect1->max.x <= rect2->max.x))
-		return(kQ3True);
+	if (rect1->min.x > rect2->max.x || rect1->max.x < rect2->min.x)
+		return(kQ3False);
 
 
 
 	// Check for overlaps in y
-	if ((rect1->min.y >= rect2->min.y || rect1->min.x <= rect2->max.y) ||
-		(rect1->max.y >= rect2->min.y || rect1->max.x <= rect2->max.y))
-		return(kQ3True);
+	if (rect1->min.y > rect2->max.y || rect1->max.y < rect2->min.y)
+		return(kQ3False);
 	
-	return(kQ3False);
+	return(kQ3True);
 }
 
 
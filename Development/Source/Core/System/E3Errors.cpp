@@ -522,6 +522,22 @@ E3Error_PlatformPost(TQ3Uns32 theErr)
 
 
 
+//=============================================================================
+//      E3Error_DrainReports : Take the oldest reports from the error log.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Error_DrainReports(TQ3ErrorReport *theReports, TQ3Uns32 maxReports)
+{
+
+
+	// Drain the log
+	return(E3ErrorManager_DrainReports(theReports, maxReports));
+}
+
+
+
+
+
 //=============================================================================
 //      E3Error_ToString : Convert a TQ3Error to a text description.
 //-----------------------------------------------------------------------------
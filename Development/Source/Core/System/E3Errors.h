@@ -75,6 +75,7 @@ TQ3Warning			E3Warning_Get(TQ3Warning *firstWarning);
 TQ3Notice			E3Notice_Get(TQ3Notice *firstNotice);
 TQ3Uns32			E3Error_PlatformGet(TQ3Uns32 *firstPlatform);
 void				E3Error_PlatformPost(TQ3Uns32 theErr);
+TQ3Uns32			E3Error_DrainReports(TQ3ErrorReport *theReports, TQ3Uns32 maxReports);
 const char			*E3Error_ToString(TQ3Language theLanguage,   TQ3Error theError);
 const char			*E3Warning_ToString(TQ3Language theLanguage, TQ3Warning theWarning);
 const char			*E3Notice_ToString(TQ3Language theLanguage,  TQ3Notice theNotice);
@@ -51,6 +51,38 @@
 #include "E3Renderer.h"
 #include "E3Style.h"
 #include "E3Main.h"
+#include "E3Pick.h"
+#include "E3BVH.h"
+#include "E3GeometryInstances.h"
+#include "CQ3ObjectRef.h"
+
+#include <algorithm>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Deepest class hierarchy below kQ3ObjectTypeShared that the type index handles
+const TQ3Uns32 kQ3GroupMaxIndexedDepth								= 16;
+
+
+// Number of positions a group allocates on their own, before using chunks
+const TQ3Uns32 kQ3GroupPositionChunkThreshold						= 32;
+
+
+// Number of positions in the first chunk, and the most in any chunk
+const TQ3Uns32 kQ3GroupPositionFirstChunkSize						= 32;
+const TQ3Uns32 kQ3GroupPositionMaxChunkSize							= 1024;
+
+
+// Number of members a display group needs before picks use a hierarchy
+const TQ3Uns32 kQ3GroupMinMembersForPickIndex						= 16;
 
 
 
@@ -59,6 +91,83 @@
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
+// Positions of one type within a group, in group order
+struct E3GroupTypeList
+{
+	TQ3ObjectType			type ;
+	TQ3Uns32				slot ;			// index into TQ3XGroupPosition::typeLinks
+	TQ3Uns32				count ;
+	TQ3XGroupPosition*		first ;
+	TQ3XGroupPosition*		last ;
+};
+
+
+// Index from types to the positions of that type within a group.
+//
+// There is a list for every class, below kQ3ObjectTypeShared, of every object
+// in the group, so that queries by type only need to visit the matches.
+class E3GroupTypeIndex
+{
+public:
+	std::vector<E3GroupTypeList>	lists ;
+};
+
+
+// Chunk of group positions
+//
+// Once a group has created enough positions, it allocates them from chunks
+// rather than one at a time, so that traversing a large group does not visit
+// positions scattered across the heap. Positions never move, so they remain
+// valid TQ3GroupPositions, and deleted positions are reused by the group.
+//
+// Each chunk is twice the size of the one before, up to a limit, and its
+// positions follow the chunk header in memory.
+struct E3GroupPositionChunk
+{
+	E3GroupPositionChunk*	nextChunk ;
+	E3GroupPositionPool*	pool ;
+};
+
+
+// Chunks of group positions owned by a group
+struct E3GroupPositionPool
+{
+	E3GroupPositionChunk*	chunks ;
+	TQ3XGroupPosition*		freeList ;		// linked through next
+	TQ3Uns32				numInUse ;
+	TQ3Uns32				nextChunkSize ;
+};
+
+
+#if QUESA_GROUP_PICK_BVH
+// Member of a display group, as seen by its pick hierarchy
+struct E3GroupPickMember
+{
+	TQ3Object				object ;
+	TQ3GroupPosition		position ;
+	TQ3Uns32				stamp ;			// edit index, or contents version of a display group
+	TQ3BoundingBox			bBox ;			// local bounds, unless isAlwaysPicked
+	TQ3Boolean				isAlwaysPicked ;	// may be hit outside its bounds
+	TQ3Boolean				usesSubdivision ;	// bBox depends on the subdivision style
+	CQ3ObjectRef			reference ;		// keeps object, so its address can't be reused
+};
+
+
+// Pick hierarchy of a display group
+//
+// The members are in the order the group submits them. The hierarchy holds
+// those with a non-empty box, and the members that may be hit outside their
+// bounds are always submitted.
+class E3GroupPickHierarchy
+{
+public:
+	std::vector<E3GroupPickMember>	members ;
+	std::vector<TQ3Uns32>			itemMembers ;	// member of each hierarchy item
+	std::vector<TQ3Uns32>			alwaysPicked ;	// members not in the hierarchy
+	std::vector<TQ3Uns32>			candidates ;	// members to submit for a pick
+	E3BVH							bvh ;
+};
+#endif
 	
 
 
@@ -182,6 +291,130 @@ e3group_new_class_info (
 
 
 
+//=============================================================================
+//      e3group_positionpool_allocate : Allocate a position from a group's chunks.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr if the group should allocate the position on
+//				its own, either because it is still small or because we are
+//				out of memory.
+//-----------------------------------------------------------------------------
+static TQ3XGroupPosition*
+e3group_positionpool_allocate ( E3Group* group )
+	{
+#if QUESA_GROUP_POSITION_CHUNKS
+	// Small groups allocate their positions individually
+	if ( group->groupData.numPositionsCreated < kQ3GroupPositionChunkThreshold )
+		{
+		group->groupData.numPositionsCreated += 1 ;
+		return nullptr ;
+		}
+
+
+
+	// Create the pool if we need to
+	E3GroupPositionPool* thePool = group->groupData.positionPool ;
+	if ( thePool == nullptr )
+		{
+		thePool = (E3GroupPositionPool*) Q3Memory_AllocateClear ( sizeof ( E3GroupPositionPool ) ) ;
+		if ( thePool == nullptr )
+			return nullptr ;
+
+		thePool->nextChunkSize = kQ3GroupPositionFirstChunkSize ;
+		group->groupData.positionPool = thePool ;
+		}
+
+
+
+	// Add a chunk if we've run out of positions. The positions go on the
+	// free list in reverse, so they will be used in order.
+	if ( thePool->freeList == nullptr )
+		{
+		TQ3Uns32 numPositions = thePool->nextChunkSize ;
+		E3GroupPositionChunk* theChunk = (E3GroupPositionChunk*) Q3Memory_Allocate (
+			sizeof ( E3GroupPositionChunk ) + numPositions * sizeof ( TQ3XGroupPosition ) ) ;
+		if ( theChunk == nullptr )
+			return nullptr ;
+
+		theChunk->nextChunk = thePool->chunks ;
+		theChunk->pool      = thePool ;
+		thePool->chunks     = theChunk ;
+		
+		if ( numPositions < kQ3GroupPositionMaxChunkSize )
+			thePool->nextChunkSize = numPositions * 2 ;
+
+		TQ3XGroupPosition* thePositions = (TQ3XGroupPosition*) ( theChunk + 1 ) ;
+		for ( TQ3Uns32 n = numPositions ; n > 0 ; --n )
+			{
+			TQ3XGroupPosition* thePosition = &thePositions[ n - 1 ] ;
+			thePosition->chunk = theChunk ;
+			thePosition->next  = thePool->freeList ;
+			thePool->freeList  = thePosition ;
+			}
+		}
+
+
+
+	// Take the next free position
+	TQ3XGroupPosition* thePosition = thePool->freeList ;
+	thePool->freeList  = thePosition->next ;
+	thePool->numInUse += 1 ;
+
+	return thePosition ;
+#else
+	#pragma unused(group)
+	return nullptr ;
+#endif
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_positionpool_release : Return a position to its chunk.
+//-----------------------------------------------------------------------------
+static void
+e3group_positionpool_release ( TQ3XGroupPosition* thePosition )
+	{
+	E3GroupPositionPool* thePool = thePosition->chunk->pool ;
+	Q3_ASSERT( thePool->numInUse != 0 ) ;
+
+	thePosition->next = thePool->freeList ;
+	thePool->freeList = thePosition ;
+	thePool->numInUse -= 1 ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_positionpool_dispose : Dispose of a group's chunks.
+//-----------------------------------------------------------------------------
+//		Note :	Does nothing if any positions are still in use.
+//-----------------------------------------------------------------------------
+static void
+e3group_positionpool_dispose ( E3Group* group )
+	{
+	E3GroupPositionPool* thePool = group->groupData.positionPool ;
+	if ( thePool == nullptr || thePool->numInUse != 0 )
+		return ;
+
+	while ( thePool->chunks != nullptr )
+		{
+		E3GroupPositionChunk* theChunk = thePool->chunks ;
+		thePool->chunks = theChunk->nextChunk ;
+		Q3Memory_Free ( &theChunk ) ;
+		}
+
+	Q3Memory_Free ( &group->groupData.positionPool ) ;
+	group->groupData.numPositionsCreated = 0 ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3group_new : Group new method.
 //-----------------------------------------------------------------------------
@@ -197,6 +430,9 @@ e3group_new(TQ3Object theObject, void *privateData, const void *paramData)
 	instanceData->groupData.listHead.prev        = &instanceData->groupData.listHead;
 	instanceData->groupData.listHead.object      = theObject; // points to itself but never used
 	instanceData->groupData.groupPositionSize    = sizeof( TQ3GroupPosition );
+	instanceData->groupData.typeIndex            = nullptr;
+	instanceData->groupData.positionPool         = nullptr;
+	instanceData->groupData.numPositionsCreated  = 0;
 
 	return kQ3Success ;
 	}
@@ -217,6 +453,7 @@ e3group_delete(TQ3Object theObject, void *privateData)
 
 	// Empty the group
 	Q3Group_EmptyObjects(theObject);
+	e3group_positionpool_dispose( (E3Group*) theObject );
 }
 
 
@@ -265,6 +502,285 @@ E3Group::createPosition ( TQ3Object object )
 
 
 
+//=============================================================================
+//      e3group_typeindex_find : Find the list for a type in a type index.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3group_typeindex_find ( const E3GroupTypeIndex* theIndex, TQ3ObjectType theType )
+	{
+	TQ3Uns32 numLists = (TQ3Uns32) theIndex->lists.size () ;
+	
+	for ( TQ3Uns32 n = 0 ; n < numLists ; ++n )
+		{
+		if ( theIndex->lists[ n ].type == theType )
+			return n ;
+		}
+
+	return numLists ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_typeindex_contains : Is a position on a list of a type index?
+//-----------------------------------------------------------------------------
+static inline bool
+e3group_typeindex_contains ( const E3GroupTypeIndex* theIndex, const E3GroupTypeList& theList,
+							const TQ3XGroupPosition* thePosition )
+	{
+	return thePosition->numTypeLinks > theList.slot &&
+		   &theIndex->lists[ thePosition->typeLinks[ theList.slot ].listIndex ] == &theList ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::gettypelist : Find the positions of a type.
+//-----------------------------------------------------------------------------
+//		Note :	The type index is built the first time it is needed.
+//
+//				If isIndexed is returned as false, the index can't answer
+//				the query and the caller must search the group. Otherwise we
+//				return the list of positions of the type, or nullptr if no
+//				objects in the group have that type.
+//-----------------------------------------------------------------------------
+E3GroupTypeList*
+E3Group::gettypelist ( TQ3ObjectType isType, TQ3Boolean *isIndexed )
+	{
+	*isIndexed = kQ3False ;
+
+
+
+	// Build the index if we need to
+	if ( groupData.typeIndex == nullptr )
+		{
+		groupData.typeIndex = new (std::nothrow) E3GroupTypeIndex ;
+		if ( groupData.typeIndex == nullptr )
+			return nullptr ;
+
+		for ( TQ3XGroupPosition* pos = groupData.listHead.next ;
+			pos != &groupData.listHead && groupData.typeIndex != nullptr ; pos = pos->next )
+			addtotypeindex ( pos, kQ3True ) ;
+
+		if ( groupData.typeIndex == nullptr )
+			return nullptr ;
+		}
+
+
+
+	// Find the list
+	TQ3Uns32 listIndex = e3group_typeindex_find ( groupData.typeIndex, isType ) ;
+	if ( listIndex < groupData.typeIndex->lists.size () )
+		{
+		*isIndexed = kQ3True ;
+		return &groupData.typeIndex->lists[ listIndex ] ;
+		}
+
+
+
+	// If there isn't one, nothing in the group has the type - as long as it
+	// is a type the index would have held
+	E3ClassInfoPtr theClass = E3ClassTree::GetClass ( isType ) ;
+	if ( theClass == nullptr ||
+		 ( theClass->GetType () != kQ3ObjectTypeShared && theClass->IsType ( kQ3ObjectTypeShared ) ) )
+		*isIndexed = kQ3True ;
+
+	return nullptr ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::addtotypeindex : Add a position to the type index.
+//-----------------------------------------------------------------------------
+//		Note :	The position must already be on the group's list. If isLast
+//				is true, it is known to be at the end of the group, otherwise
+//				we search back through the group to find where it goes on
+//				each list.
+//
+//				If we run out of memory, the index is dropped.
+//-----------------------------------------------------------------------------
+void
+E3Group::addtotypeindex ( TQ3XGroupPosition* position, TQ3Boolean isLast )
+	{
+	E3GroupTypeIndex* theIndex = groupData.typeIndex ;
+	Q3_ASSERT_VALID_PTR( theIndex ) ;
+
+
+
+	// Find the classes of the object below E3Shared, most general first
+	E3ClassInfoPtr	theClasses[ kQ3GroupMaxIndexedDepth ] ;
+	TQ3Uns32		numClasses = 0 ;
+	
+	for ( E3ClassInfoPtr aClass = position->object->GetClass () ;
+		aClass != nullptr && aClass->GetType () != kQ3ObjectTypeShared ; aClass = aClass->GetParent () )
+		{
+		if ( numClasses == kQ3GroupMaxIndexedDepth )
+			{
+			droptypeindex () ;
+			return ;
+			}
+		theClasses[ numClasses++ ] = aClass ;
+		}
+
+	position->typeLinks    = nullptr ;
+	position->numTypeLinks = 0 ;
+	if ( numClasses == 0 )
+		return ;
+
+
+
+	// Allocate the links
+	position->typeLinks = (TQ3XGroupTypeLink*) Q3Memory_Allocate ( numClasses * sizeof ( TQ3XGroupTypeLink ) ) ;
+	if ( position->typeLinks == nullptr )
+		{
+		droptypeindex () ;
+		return ;
+		}
+
+
+
+	// Add the position to the list for each class. The position before it on
+	// a list is also on the lists of the more general classes, so we can
+	// start each search from where the previous one finished.
+	TQ3XGroupPosition* searchFrom = position->prev ;
+	
+	for ( TQ3Uns32 slot = 0 ; slot < numClasses ; ++slot )
+		{
+		TQ3ObjectType	theType   = theClasses[ numClasses - 1 - slot ]->GetType () ;
+		TQ3Uns32		listIndex = e3group_typeindex_find ( theIndex, theType ) ;
+		
+		if ( listIndex == theIndex->lists.size () )
+			{
+			E3GroupTypeList newList = { theType, slot, 0, nullptr, nullptr } ;
+			try
+				{
+				theIndex->lists.push_back ( newList ) ;
+				}
+			catch (...)
+				{
+				droptypeindex () ;
+				return ;
+				}
+			}
+
+		E3GroupTypeList& theList = theIndex->lists[ listIndex ] ;
+		Q3_ASSERT( theList.slot == slot ) ;
+
+
+
+		// Find the previous position of this type
+		TQ3XGroupPosition* prevPos = nullptr ;
+		if ( isLast )
+			prevPos = theList.last ;
+		else
+			{
+			while ( searchFrom != &groupData.listHead && ! e3group_typeindex_contains ( theIndex, theList, searchFrom ) )
+				searchFrom = searchFrom->prev ;
+			
+			if ( searchFrom != &groupData.listHead )
+				prevPos = searchFrom ;
+			}
+
+
+
+		// And link the position in after it
+		TQ3XGroupTypeLink& theLink = position->typeLinks[ slot ] ;
+		theLink.listIndex = listIndex ;
+		theLink.prev      = prevPos ;
+		theLink.next      = ( prevPos != nullptr ) ? prevPos->typeLinks[ slot ].next : theList.first ;
+
+		if ( theLink.prev != nullptr )
+			theLink.prev->typeLinks[ slot ].next = position ;
+		else
+			theList.first = position ;
+
+		if ( theLink.next != nullptr )
+			theLink.next->typeLinks[ slot ].prev = position ;
+		else
+			theList.last = position ;
+
+		theList.count        += 1 ;
+		position->numTypeLinks = slot + 1 ;
+		}
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::removefromtypeindex : Remove a position from the type index.
+//-----------------------------------------------------------------------------
+void
+E3Group::removefromtypeindex ( TQ3XGroupPosition* position )
+	{
+	E3GroupTypeIndex* theIndex = groupData.typeIndex ;
+	Q3_ASSERT_VALID_PTR( theIndex ) ;
+
+
+
+	// Unlink the position from each of its lists
+	for ( TQ3Uns32 slot = 0 ; slot < position->numTypeLinks ; ++slot )
+		{
+		TQ3XGroupTypeLink& theLink = position->typeLinks[ slot ] ;
+		E3GroupTypeList&   theList = theIndex->lists[ theLink.listIndex ] ;
+
+		if ( theLink.prev != nullptr )
+			theLink.prev->typeLinks[ slot ].next = theLink.next ;
+		else
+			theList.first = theLink.next ;
+
+		if ( theLink.next != nullptr )
+			theLink.next->typeLinks[ slot ].prev = theLink.prev ;
+		else
+			theList.last = theLink.prev ;
+
+		theList.count -= 1 ;
+		}
+
+
+
+	// And release the links
+	Q3Memory_Free ( &position->typeLinks ) ;
+	position->numTypeLinks = 0 ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Group::droptypeindex : Dispose of the type index.
+//-----------------------------------------------------------------------------
+//		Note :	The index will be built again by the next query that needs it.
+//-----------------------------------------------------------------------------
+void
+E3Group::droptypeindex ( void )
+	{
+	if ( groupData.typeIndex == nullptr )
+		return ;
+
+	for ( TQ3XGroupPosition* pos = groupData.listHead.next ; pos != &groupData.listHead ; pos = pos->next )
+		{
+		Q3Memory_Free ( &pos->typeLinks ) ;
+		pos->numTypeLinks = 0 ;
+		}
+
+	delete groupData.typeIndex ;
+	groupData.typeIndex = nullptr ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3group_addobject : Group add object method.
 //-----------------------------------------------------------------------------
@@ -289,6 +805,10 @@ E3Group::addobject ( TQ3Object object )
 		newGroupPosition->prev = groupData.listHead.prev ;
 		groupData.listHead.prev->next = newGroupPosition ;
 		groupData.listHead.prev = newGroupPosition ;
+
+		if ( groupData.typeIndex != nullptr )
+			addtotypeindex ( newGroupPosition, kQ3True ) ;
+
 		return (TQ3GroupPosition) newGroupPosition ;
 		}
 	return nullptr ;
@@ -323,6 +843,10 @@ E3Group::addbefore ( TQ3GroupPosition position, TQ3Object object )
 			newGroupPosition->prev = pos->prev ;
 			pos->prev->next = newGroupPosition ;
 			pos->prev = newGroupPosition ;
+
+			if ( groupData.typeIndex != nullptr )
+				addtotypeindex ( newGroupPosition, kQ3False ) ;
+
 			return (TQ3GroupPosition) newGroupPosition ;
 			}
 		}
@@ -358,6 +882,10 @@ E3Group::addafter ( TQ3GroupPosition position, TQ3Object object )
 			newGroupPosition->prev = pos ;
 			pos->next->prev = newGroupPosition ;
 			pos->next = newGroupPosition ;
+
+			if ( groupData.typeIndex != nullptr )
+				addtotypeindex ( newGroupPosition, (TQ3Boolean) ( newGroupPosition->next == &groupData.listHead ) ) ;
+
 			return (TQ3GroupPosition) newGroupPosition ;
 			}
 		}
@@ -378,11 +906,22 @@ e3group_setposition( E3Group* group, TQ3GroupPosition position, TQ3Object object
 	
 	if ( group->GetClass ()->acceptObjectMethod ( group, object ) == kQ3True )
 		{
-		// replace this position with this object
+		// replace this position with this object, moving it to the right
+		// type lists if its class has changed
+		bool isNewClass = ( group->groupData.typeIndex != nullptr ) &&
+						  ( pos->object == nullptr || pos->object->GetClass () != object->GetClass () ) ;
+
+		if ( isNewClass )
+			group->removefromtypeindex ( pos ) ;
+
 		if ( pos->object )
 			Q3Object_Dispose ( pos->object ) ;
 
 		pos->object = Q3Shared_GetReference ( object ) ;
+
+		if ( isNewClass )
+			group->addtotypeindex ( pos, kQ3False ) ;
+
 		return kQ3Success ;
 		}
 	else
@@ -402,6 +941,9 @@ static TQ3Object
 e3group_removeposition ( E3Group* group, TQ3XGroupPosition* finishedGroupPosition )
 	{
 	// disconnect the position from the group
+	if ( group->groupData.typeIndex != nullptr )
+		group->removefromtypeindex ( finishedGroupPosition ) ;
+
 	finishedGroupPosition->next->prev = finishedGroupPosition->prev ;
 	finishedGroupPosition->prev->next = finishedGroupPosition->next ;
 
@@ -443,14 +985,25 @@ E3Group::getfirstposition ( TQ3ObjectType isType, TQ3GroupPosition *position )
 		}
 	else
 		{
-		while ( pos != finish )
+		TQ3Boolean isIndexed ;
+		E3GroupTypeList* theList = gettypelist ( isType, &isIndexed ) ;
+
+		if ( isIndexed )
 			{
-			if ( E3Object_IsType ( pos->object, isType ) )
+			if ( theList != nullptr )
+				*position = (TQ3GroupPosition) theList->first ;
+			}
+		else
+			{
+			while ( pos != finish )
 				{
-				*position = (TQ3GroupPosition) pos ;
-				break ;
+				if ( E3Object_IsType ( pos->object, isType ) )
+					{
+					*position = (TQ3GroupPosition) pos ;
+					break ;
+					}
+				pos = pos->next ;
 				}
-			pos = pos->next ;
 			}
 		}
 
@@ -486,14 +1039,25 @@ E3Group::getlastposition ( TQ3ObjectType isType, TQ3GroupPosition *position )
 		}
 	else
 		{
-		while ( pos != finish )
+		TQ3Boolean isIndexed ;
+		E3GroupTypeList* theList = gettypelist ( isType, &isIndexed ) ;
+
+		if ( isIndexed )
 			{
-			if ( E3Object_IsType ( pos->object, isType ) )
+			if ( theList != nullptr )
+				*position = (TQ3GroupPosition) theList->last ;
+			}
+		else
+			{
+			while ( pos != finish )
 				{
-				*position = (TQ3GroupPosition) pos ;
-				break ;
+				if ( E3Object_IsType ( pos->object, isType ) )
+					{
+					*position = (TQ3GroupPosition) pos ;
+					break ;
+					}
+				pos = pos->prev ;
 				}
-			pos = pos->prev ;
 			}
 		}
 
@@ -523,10 +1087,10 @@ E3Group::getnextposition ( TQ3ObjectType isType, TQ3GroupPosition *position )
 		// documentation says that on entry, *position must be a valid group position.
 	
 	TQ3XGroupPosition* finish = &groupData.listHead ;
-	TQ3XGroupPosition* pos = (TQ3XGroupPosition*) *position ;
-	pos = pos->next ;
+	TQ3XGroupPosition* startPos = (TQ3XGroupPosition*) *position ;
+	TQ3XGroupPosition* pos = startPos->next ;
 	*position = nullptr ;
-	
+
 	if ( isType == kQ3ObjectTypeShared )
 		{
 		if ( pos != finish )
@@ -534,14 +1098,26 @@ E3Group::getnextposition ( TQ3ObjectType isType, TQ3GroupPosition *position )
 		}
 	else
 		{
-		while ( pos != finish )
+		TQ3Boolean isIndexed ;
+		E3GroupTypeList* theList = gettypelist ( isType, &isIndexed ) ;
+
+		if ( isIndexed && ( theList == nullptr || e3group_typeindex_contains ( groupData.typeIndex, *theList, startPos ) ) )
+			{
+			// Starting from a match, the next match is its neighbour on the list
+			if ( theList != nullptr )
+				*position = (TQ3GroupPosition) startPos->typeLinks[ theList->slot ].next ;
+			}
+		else
 			{
-			if ( E3Object_IsType ( pos->object, isType ) )
+			while ( pos != finish )
 				{
-				*position = (TQ3GroupPosition) pos ;
-				break ;
+				if ( E3Object_IsType ( pos->object, isType ) )
+					{
+					*position = (TQ3GroupPosition) pos ;
+					break ;
+					}
+				pos = pos->next ;
 				}
-			pos = pos->next ;
 			}
 		}
 
@@ -569,8 +1145,8 @@ E3Group::getprevposition ( TQ3ObjectType isType, TQ3GroupPosition *position )
 		return kQ3Failure ;
 	
 	TQ3XGroupPosition* finish = &groupData.listHead ;
-	TQ3XGroupPosition* pos = (TQ3XGroupPosition*) *position ;
-	pos = pos->prev ;
+	TQ3XGroupPosition* startPos = (TQ3XGroupPosition*) *position ;
+	TQ3XGroupPosition* pos = startPos->prev ;
 	*position = nullptr ;
 
 	if ( isType == kQ3ObjectTypeShared )
@@ -580,14 +1156,26 @@ E3Group::getprevposition ( TQ3ObjectType isType, TQ3GroupPosition *position )
 		}
 	else
 		{
-		while ( pos != finish )
+		TQ3Boolean isIndexed ;
+		E3GroupTypeList* theList = gettypelist ( isType, &isIndexed ) ;
+
+		if ( isIndexed && ( theList == nullptr || e3group_typeindex_contains ( groupData.typeIndex, *theList, startPos ) ) )
+			{
+			// Starting from a match, the previous match is its neighbour on the list
+			if ( theList != nullptr )
+				*position = (TQ3GroupPosition) startPos->typeLinks[ theList->slot ].prev ;
+			}
+		else
 			{
-			if ( E3Object_IsType ( pos->object, isType ) )
+			while ( pos != finish )
 				{
-				*position = (TQ3GroupPosition) pos ;
-				break ;
+				if ( E3Object_IsType ( pos->object, isType ) )
+					{
+					*position = (TQ3GroupPosition) pos ;
+					break ;
+					}
+				pos = pos->prev ;
 				}
-			pos = pos->prev ;
 			}
 		}
 
@@ -629,31 +1217,42 @@ E3Group::countobjects ( TQ3ObjectType isType, TQ3Uns32 *number )
 		}
 		else
 		{
-			E3ClassInfoPtr typeClass = E3ClassTree::GetClass( isType );
+			TQ3Boolean isIndexed;
+			E3GroupTypeList* theList = gettypelist( isType, &isIndexed );
 			
-			if (typeClass != nullptr)
+			if (isIndexed)
 			{
-				TQ3Uns32 classDepth = 0;
-				
-				for ( E3ClassInfo* aClass = typeClass->GetParent(); aClass != nullptr;
-					aClass = aClass->GetParent() )
+				if (theList != nullptr)
+					*number = theList->count;
+			}
+			else
+			{
+				E3ClassInfoPtr typeClass = E3ClassTree::GetClass( isType );
+			
+				if (typeClass != nullptr)
 				{
-					++classDepth;
-				}
+					TQ3Uns32 classDepth = 0;
 				
-				// Optimization note:  The more obvious way to write this would
-				// use E3Object_IsType, which uses E3ClassInfo::IsType, which
-				// contains a loop that walks up the class tree.  Here, the
-				// GetClass and IsClass calls are constant time.  If there are
-				// enough members in the group, that gain should pay the cost
-				// of the hash table lookup to find typeClass and the loop to
-				// find classDepth.
-				for ( TQ3XGroupPosition* pos = groupData.listHead.next; pos != &groupData.listHead;
-					pos = pos->next )
-				{
-					if (pos->object->GetClass()->IsClass( isType, classDepth ))
+					for ( E3ClassInfo* aClass = typeClass->GetParent(); aClass != nullptr;
+						aClass = aClass->GetParent() )
+					{
+						++classDepth;
+					}
+				
+					// Optimization note:  The more obvious way to write this would
+					// use E3Object_IsType, which uses E3ClassInfo::IsType, which
+					// contains a loop that walks up the class tree.  Here, the
+					// GetClass and IsClass calls are constant time.  If there are
+					// enough members in the group, that gain should pay the cost
+					// of the hash table lookup to find typeClass and the loop to
+					// find classDepth.
+					for ( TQ3XGroupPosition* pos = groupData.listHead.next; pos != &groupData.listHead;
+						pos = pos->next )
 					{
-						*number += 1;
+						if (pos->object->GetClass()->IsClass( isType, classDepth ))
+						{
+							*number += 1;
+						}
 					}
 				}
 			}
@@ -681,6 +1280,42 @@ e3group_emptyobjectsoftype(TQ3GroupObject group, TQ3ObjectType isType)
 TQ3Status
 E3Group::emptyobjects ( TQ3ObjectType isType )
 	{
+	// Emptying everything drops the type index
+	if ( isType == kQ3ObjectTypeShared )
+		droptypeindex () ;
+
+
+
+	// Otherwise, if the index has a list for the type, just visit the matches
+	else
+		{
+		TQ3Boolean isIndexed ;
+		E3GroupTypeList* theList = gettypelist ( isType, &isIndexed ) ;
+		
+		if ( isIndexed )
+			{
+			TQ3XGroupPosition* pos = ( theList != nullptr ) ? theList->first : nullptr ;
+			TQ3Uns32 slot = ( theList != nullptr ) ? theList->slot : 0 ;
+			while ( pos != nullptr )
+				{
+				TQ3XGroupPosition* nextPos = pos->typeLinks[ slot ].next ;
+				
+				// disconnect the position from the group
+				removefromtypeindex ( pos ) ;
+				pos->next->prev = pos->prev ;
+				pos->prev->next = pos->next ;
+
+				GetClass ()->positionDeleteMethod ( pos ) ;
+				pos = nextPos ;
+				}
+
+			return kQ3Success ;
+			}
+		}
+
+
+
+	// Remove the matching positions
 	TQ3XGroupPosition* finish = &groupData.listHead ;
 	TQ3XGroupPosition* pos = groupData.listHead.next ;
 	while ( pos != finish )
@@ -690,6 +1325,9 @@ E3Group::emptyobjects ( TQ3ObjectType isType )
 			TQ3XGroupPosition* nextPos = pos->next ;
 			
 			// disconnect the position from the group
+			if ( groupData.typeIndex != nullptr )
+				removefromtypeindex ( pos ) ;
+
 			nextPos->prev = pos->prev ;
 			pos->prev->next = pos->next ;
 
@@ -913,16 +1551,25 @@ E3Group::getprevobjectposition ( TQ3Object object, TQ3GroupPosition *position )
 static TQ3Status
 e3group_positionnew(TQ3XGroupPosition** position, TQ3Object object, const void *initData)
 {
-#pragma unused (initData)
 	if (position)
 		{
-		TQ3XGroupPosition* newGroupPosition = (TQ3XGroupPosition*) Q3Memory_Allocate(sizeof(TQ3XGroupPosition));
+		// initData is the group the position is for
+		TQ3XGroupPosition* newGroupPosition = e3group_positionpool_allocate ( (E3Group*) initData );
+		
+		if (newGroupPosition == nullptr)
+			{
+			newGroupPosition = (TQ3XGroupPosition*) Q3Memory_Allocate(sizeof(TQ3XGroupPosition));
+			if (newGroupPosition)
+				newGroupPosition->chunk = nullptr;
+			}
 
 		if (newGroupPosition)
 			{
 			newGroupPosition->next        = nullptr;
 			newGroupPosition->prev        = nullptr;
 			newGroupPosition->object      = Q3Shared_GetReference (object);
+			newGroupPosition->typeLinks   = nullptr;
+			newGroupPosition->numTypeLinks = 0;
 			*position = newGroupPosition ;
 			return kQ3Success ;
 			}
@@ -971,7 +1618,12 @@ e3group_positiondelete(void *position)
 	if (pos->object)
 		Q3Object_Dispose (pos->object);
 	
-	Q3Memory_Free (&position);
+	Q3Memory_Free (&pos->typeLinks);
+	
+	if (pos->chunk != nullptr)
+		e3group_positionpool_release (pos);
+	else
+		Q3Memory_Free (&position);
 }
 
 
@@ -1323,6 +1975,101 @@ e3group_display_new(TQ3Object theObject, void *privateData, const void *paramDat
 	instanceData->displayGroupData.bBox.max.z   = 0.0f;
 	instanceData->displayGroupData.bBox.isEmpty = kQ3True;
 
+	instanceData->contents.hasVersion = kQ3False;
+	instanceData->contents.numEntries = 0;
+	instanceData->contents.maxEntries = 0;
+	instanceData->contents.entries    = nullptr;
+
+#if QUESA_AUTO_GROUP_BOUNDS
+	instanceData->autoBounds.isChecked = kQ3False;
+	instanceData->autoBounds.hasBox    = kQ3False;
+#endif
+
+#if QUESA_COMPILED_GROUPS
+	instanceData->compiled.numLists       = 0;
+	instanceData->compiled.isUnrecordable = kQ3False;
+#endif
+
+#if QUESA_GROUP_PICK_BVH
+	instanceData->pickIndex.hierarchy       = nullptr;
+	instanceData->pickIndex.isUnindexable   = kQ3False;
+	instanceData->pickIndex.usesSubdivision = kQ3False;
+#endif
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_display_delete : Display group delete method.
+//-----------------------------------------------------------------------------
+static void
+e3group_display_delete(TQ3Object theObject, void *privateData)
+	{
+	E3DisplayGroup* instanceData = (E3DisplayGroup*) theObject ;
+#pragma unused (privateData)
+
+
+
+	// Dispose of our instance data
+	Q3Memory_Free ( &instanceData->contents.entries ) ;
+
+#if QUESA_COMPILED_GROUPS
+	instanceData->DisposeCompiledLists () ;
+#endif
+
+#if QUESA_GROUP_PICK_BVH
+	delete instanceData->pickIndex.hierarchy ;
+	instanceData->pickIndex.hierarchy = nullptr ;
+#endif
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_display_duplicate : Display group duplicate method.
+//-----------------------------------------------------------------------------
+//		Note :	The state and bounding box are copied, but the caches built
+//				from the contents of the original belong to it alone.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3group_display_duplicate(TQ3Object fromObject, const void *fromPrivateData,
+						  TQ3Object toObject,   void       *toPrivateData)
+	{
+	E3DisplayGroup* fromGroup = (E3DisplayGroup*) fromObject ;
+	E3DisplayGroup* toGroup   = (E3DisplayGroup*) toObject ;
+#pragma unused (fromPrivateData, toPrivateData)
+
+
+
+	// Initialise the instance data of the new object
+	toGroup->displayGroupData    = fromGroup->displayGroupData ;
+	toGroup->contents.hasVersion = kQ3False ;
+	toGroup->contents.numEntries = 0 ;
+	toGroup->contents.maxEntries = 0 ;
+	toGroup->contents.entries    = nullptr ;
+
+#if QUESA_AUTO_GROUP_BOUNDS
+	toGroup->autoBounds.isChecked = kQ3False ;
+	toGroup->autoBounds.hasBox    = kQ3False ;
+#endif
+
+#if QUESA_COMPILED_GROUPS
+	toGroup->compiled.numLists       = 0 ;
+	toGroup->compiled.isUnrecordable = kQ3False ;
+#endif
+
+#if QUESA_GROUP_PICK_BVH
+	toGroup->pickIndex.hierarchy       = nullptr ;
+	toGroup->pickIndex.isUnindexable   = kQ3False ;
+	toGroup->pickIndex.usesSubdivision = kQ3False ;
+#endif
+
 	return kQ3Success ;
 	}
 
@@ -1349,6 +2096,10 @@ e3group_display_submit_render(TQ3ViewObject theView, TQ3ObjectType objectType,
 
 	
 	// Do group culling if appropriate
+	//
+	// A bounding box set by the application takes precedence, otherwise we
+	// can use our own box. Inline groups are never culled automatically,
+	// since they can change the state seen by objects after them.
 	TQ3BoundingBox	theBBox;
 	if ( shouldSubmit &&
 		E3Bit_IsSet( theState, kQ3DisplayGroupStateMaskUseBoundingBox ) &&
@@ -1357,12 +2108,30 @@ e3group_display_submit_render(TQ3ViewObject theView, TQ3ObjectType objectType,
 	{
 		shouldSubmit = E3Renderer_Method_IsBBoxVisible( theView, &theBBox );
 	}
+#if QUESA_AUTO_GROUP_BOUNDS
+	else if ( shouldSubmit &&
+		! E3Bit_AnySet( theState, kQ3DisplayGroupStateMaskIsInline ) &&
+		E3View_IsGroupCullingAllowed( theView ) &&
+		(kQ3Success == ((E3DisplayGroup*)theObject)->GetAutoBoundingBox( theView, &theBBox )) &&
+		! theBBox.isEmpty )
+	{
+		shouldSubmit = E3Renderer_Method_IsBBoxVisible( theView, &theBBox );
+	}
+#endif
 
 
 
 	// If we need to submit the group, do so
 	if ( shouldSubmit )
 	{
+#if QUESA_COMPILED_GROUPS
+		// Compiled groups replay their command list
+		if ( E3Bit_IsSet( theState, kQ3DisplayGroupStateMaskIsCompiled ) &&
+			! E3Bit_AnySet( theState, kQ3DisplayGroupStateMaskIsInline ) )
+			return ((E3DisplayGroup*)theObject)->SubmitCompiled( theView, objectType, objectData );
+#endif
+
+
 		// If the group isn't inline, push the view state and reset the matrix
 		TQ3Boolean isInline = E3Bit_AnySet( theState, kQ3DisplayGroupStateMaskIsInline );
 		if ( ! isInline )
@@ -1418,6 +2187,32 @@ e3group_display_submit_bounds(TQ3ViewObject theView, TQ3ObjectType objectType,
 
 		if ( qd3dStatus == kQ3Failure ) return qd3dStatus;
 		
+#if QUESA_AUTO_GROUP_BOUNDS
+		// If approximate bounds will do and our own box is up to date, use
+		// its corners rather than submitting the contents again
+		if ( ! isInline &&
+			E3View_GetBoundingMethod( theView ) == kQ3BoxBoundsApprox &&
+			((E3DisplayGroup*)theObject)->HasCurrentAutoBoundingBox( theView ) )
+		{
+			// Using the box uses the subdivision style it was calculated with
+			if ( ((E3DisplayGroup*)theObject)->autoBounds.usesSubdivision )
+				(void) E3View_CanBoundSubdivision( theView );
+
+			const TQ3BoundingBox& theBBox = ((E3DisplayGroup*)theObject)->autoBounds.bBox;
+			if ( ! theBBox.isEmpty )
+			{
+				TQ3Point3D	theCorners[8];
+				for (TQ3Uns32 n = 0; n < 8; ++n)
+				{
+					theCorners[n].x = (n & 1) ? theBBox.max.x : theBBox.min.x;
+					theCorners[n].y = (n & 2) ? theBBox.max.y : theBBox.min.y;
+					theCorners[n].z = (n & 4) ? theBBox.max.z : theBBox.min.z;
+				}
+				E3View_UpdateBounds( theView, 8, sizeof(TQ3Point3D), theCorners );
+			}
+		}
+		else
+#endif
 		// Submit the group, using the generic group submit method
 		qd3dStatus = e3group_submit_contents ( theView, objectType, (E3Group*) theObject, objectData ) ;
 
@@ -1465,8 +2260,13 @@ e3group_display_submit_pick(TQ3ViewObject theView, TQ3ObjectType objectType,
 		if ( qd3dStatus == kQ3Failure ) return qd3dStatus;
 		
 		
+#if QUESA_GROUP_PICK_BVH
+		// Ray picks can submit just the members the ray may hit
+		qd3dStatus = ((E3DisplayGroup*)theObject)->SubmitPickIndexed ( theView, objectType, objectData ) ;
+#else
 		// Submit the group, using the generic group submit method
 		qd3dStatus = e3group_submit_pick ( theView, objectType, (E3Group*) theObject, objectData ) ;
+#endif
 
 
 
@@ -1562,6 +2362,14 @@ e3group_display_metahandler(TQ3XMethodType methodType)
 			theMethod = (TQ3XFunctionPointer) e3group_display_new;
 			break;
 
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3group_display_delete;
+			break;
+
+		case kQ3XMethodTypeObjectDuplicate:
+			theMethod = (TQ3XFunctionPointer) e3group_display_duplicate;
+			break;
+
 		case kQ3XMethodTypeObjectSubmitBounds:
 			theMethod = (TQ3XFunctionPointer) e3group_display_submit_bounds;
 			break;
@@ -2856,7 +3664,11 @@ TQ3GroupPosition
 E3Group::AddObject ( TQ3Object object )
 	{
 	// Call the method
-	return GetClass ()->addObjectMethod ( this, object ) ;
+	TQ3GroupPosition result = GetClass ()->addObjectMethod ( this, object ) ;
+
+	Edited () ;
+
+	return result ;
 	}
 
 
@@ -2890,9 +3702,12 @@ E3Group::AddObjectAndDispose ( TQ3Object* theObject )
 TQ3GroupPosition
 E3Group::AddObjectBefore ( TQ3GroupPosition position, TQ3Object object )
 	{
-	
 	// Call the method
-	return GetClass ()->addObjectBeforeMethod ( this, position, object ) ;
+	TQ3GroupPosition result = GetClass ()->addObjectBeforeMethod ( this, position, object ) ;
+
+	Edited () ;
+
+	return result ;
 	}
 
 
@@ -2906,7 +3721,11 @@ TQ3GroupPosition
 E3Group::AddObjectAfter ( TQ3GroupPosition position, TQ3Object object )
 	{
 	// Call the method
-	return GetClass ()->addObjectAfterMethod ( this, position, object ) ;
+	TQ3GroupPosition result = GetClass ()->addObjectAfterMethod ( this, position, object ) ;
+
+	Edited () ;
+
+	return result ;
 	}
 
 
@@ -2964,7 +3783,11 @@ TQ3Object
 E3Group::RemovePosition ( TQ3GroupPosition position )
 	{
 	// Call the method
-	return GetClass ()->removePositionMethod ( this, position ) ;
+	TQ3Object result = GetClass ()->removePositionMethod ( this, position ) ;
+
+	Edited () ;
+
+	return result ;
 	}
 
 
@@ -3048,7 +3871,16 @@ TQ3Status
 E3Group::EmptyObjects ( void )
 	{
 	// Call the method
-	return GetClass ()->emptyObjectsOfTypeMethod ( this, kQ3ObjectTypeShared ) ;
+	TQ3Status result = GetClass ()->emptyObjectsOfTypeMethod ( this, kQ3ObjectTypeShared ) ;
+
+
+
+	// Release any chunks of positions, which are now unused
+	e3group_positionpool_dispose ( this ) ;
+
+	Edited () ;
+
+	return result ;
 	}
 
 
@@ -3132,7 +3964,11 @@ TQ3Status
 E3Group::EmptyObjectsOfType ( TQ3ObjectType isType )
 	{
 	// Call the method
-	return GetClass ()->emptyObjectsOfTypeMethod ( this, isType ) ;
+	TQ3Status result = GetClass ()->emptyObjectsOfTypeMethod ( this, isType ) ;
+
+	Edited () ;
+
+	return result ;
 	}
 
 
@@ -3384,6 +4220,814 @@ E3DisplayGroup::CalcAndUseBoundingBox ( TQ3ComputeBounds computeBounds, TQ3ViewO
 
 
 
+//=============================================================================
+//      e3group_next_contents_version : Get a new contents version.
+//-----------------------------------------------------------------------------
+//		Note :	Versions come from one counter, so that a group can't take on
+//				a version that another group had, and 0 is never used.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3group_next_contents_version ( void )
+	{
+#if QUESA_ATOMIC_REFCOUNTS
+	static std::atomic<TQ3Uns32> sContentsVersion ( 0 ) ;
+#else
+	static TQ3Uns32 sContentsVersion = 0 ;
+#endif
+
+	TQ3Uns32 theVersion = ++sContentsVersion ;
+	if ( theVersion == 0 )
+		theVersion = ++sContentsVersion ;
+	
+	return theVersion ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::GetContentsVersion : Get the contents version.
+//-----------------------------------------------------------------------------
+//		Note :	We keep our own edit index, and the address and edit index of
+//				each object in the group, and take a new version whenever any
+//				of them differ. Nested display groups contribute their own
+//				version, so an edit anywhere below us will change ours.
+//
+//				Since that needs a walk over the whole hierarchy, the members
+//				are only compared again when the global edit count of scene
+//				objects changes. We also note if any drawn contents are left
+//				out of the bounds, which would make it unsafe to cull against
+//				them.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3DisplayGroup::GetContentsVersion ( void )
+	{
+	// Check our saved version
+	TQ3Uns32 editCount = E3Shared::GetGlobalEditCount () ;
+	if ( contents.hasVersion && contents.checkedEditCount == editCount )
+		return contents.version ;
+
+
+
+	// Compare our own edit index and each object in the group with the
+	// entries we saved, replacing them as we go
+	bool		isChanged        = ! contents.hasVersion || contents.editIndex != GetEditIndex () ;
+	TQ3Boolean	isBoundsComplete = kQ3True ;
+#if QUESA_GROUP_PICK_BVH
+	TQ3Boolean	isPickBoundsComplete = kQ3True ;
+#endif
+	TQ3Uns32	numEntries = 0 ;
+	TQ3GroupPosition thePosition ;
+	
+	GetFirstPosition ( &thePosition ) ;
+	while ( thePosition != nullptr )
+		{
+		TQ3Object	theObject = ( (TQ3XGroupPosition*) thePosition )->object ;
+		TQ3Uns32	editIndex ;
+		
+		if ( Q3_OBJECT_IS_CLASS ( theObject, E3DisplayGroup ) )
+			{
+			E3DisplayGroup* subGroup = (E3DisplayGroup*) theObject ;
+			editIndex = subGroup->GetContentsVersion () ;
+			
+			TQ3DisplayGroupState subState = subGroup->displayGroupData.state ;
+			if ( ! subGroup->contents.isBoundsComplete ||
+				( E3Bit_AnySet( subState, kQ3DisplayGroupStateMaskIsNotForBounding ) &&
+				  E3Bit_AnySet( subState, kQ3DisplayGroupStateMaskIsDrawn ) ) )
+				isBoundsComplete = kQ3False ;
+
+#if QUESA_GROUP_PICK_BVH
+			if ( ! subGroup->contents.isPickBoundsComplete ||
+				( E3Bit_AnySet( subState, kQ3DisplayGroupStateMaskIsNotForBounding ) &&
+				  E3Bit_AnySet( subState, kQ3DisplayGroupStateMaskIsPicked ) ) )
+				isPickBoundsComplete = kQ3False ;
+#endif
+			}
+		else
+			{
+			E3Instances_UpdateEditIndex ( theObject ) ;
+			editIndex = ( (E3Shared*) theObject )->GetEditIndex () ;
+
+#if QUESA_GROUP_PICK_BVH
+			// Markers are picked by their image, which is not in their bounds
+			TQ3ObjectType leafType = theObject->GetLeafType () ;
+			if ( leafType == kQ3GeometryTypeMarker || leafType == kQ3GeometryTypePixmapMarker )
+				isPickBoundsComplete = kQ3False ;
+#endif
+			}
+		
+		
+		// Compare and save the entry, growing our list if necessary
+		if ( numEntries == contents.maxEntries )
+			{
+			TQ3Uns32 maxEntries = E3Num_Max ( 2 * contents.maxEntries, 8U ) ;
+			if ( Q3Memory_Reallocate ( &contents.entries,
+					static_cast<TQ3Uns32>( maxEntries * sizeof ( E3DisplayGroupContentsEntry ) ) ) == kQ3Failure )
+				{
+				// Without the list, we can only assume that everything changed
+				contents.hasVersion = kQ3False ;
+				contents.numEntries = 0 ;
+				contents.version    = e3group_next_contents_version () ;
+				contents.isBoundsComplete = kQ3False ;
+#if QUESA_GROUP_PICK_BVH
+				contents.isPickBoundsComplete = kQ3False ;
+#endif
+				return contents.version ;
+				}
+			
+			contents.maxEntries = maxEntries ;
+			}
+		
+		E3DisplayGroupContentsEntry* theEntry = &contents.entries [ numEntries ] ;
+		if ( numEntries >= contents.numEntries || theEntry->object != theObject || theEntry->editIndex != editIndex )
+			{
+			theEntry->object    = theObject ;
+			theEntry->editIndex = editIndex ;
+			isChanged = true ;
+			}
+		
+		++numEntries ;
+		GetNextPosition ( &thePosition ) ;
+		}
+
+	if ( numEntries != contents.numEntries )
+		isChanged = true ;
+
+
+
+	// Save the version
+	if ( isChanged )
+		contents.version = e3group_next_contents_version () ;
+
+	contents.editIndex        = GetEditIndex () ;
+	contents.numEntries       = numEntries ;
+	contents.checkedEditCount = editCount ;
+	contents.hasVersion       = kQ3True ;
+	contents.isBoundsComplete = isBoundsComplete ;
+#if QUESA_GROUP_PICK_BVH
+	contents.isPickBoundsComplete = isPickBoundsComplete ;
+#endif
+	
+	return contents.version ;
+	}
+
+
+
+
+
+#if QUESA_AUTO_GROUP_BOUNDS
+//=============================================================================
+//      E3DisplayGroup::GetAutoBoundingBox : Get our own bounding box.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the bounds of the group in its local coordinates,
+//				recalculating them if the contents have changed since they
+//				were last calculated, or if the subdivision style of the view
+//				has changed and the contents use it.
+//
+//				Fails if the bounds can not be used for culling. We remember
+//				that too, rather than trying again for every frame.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::GetAutoBoundingBox ( TQ3ViewObject theView, TQ3BoundingBox *pBBox )
+	{
+	// Recalculate the box if necessary
+	TQ3Uns32 theVersion = GetContentsVersion () ;
+	const TQ3SubdivisionStyleData* subdivisionStyle = E3View_State_GetStyleSubdivision ( theView ) ;
+
+	if ( ! autoBounds.isChecked || autoBounds.boxVersion != theVersion ||
+		( autoBounds.usesSubdivision &&
+		  memcmp ( &autoBounds.subdivision, subdivisionStyle, sizeof ( TQ3SubdivisionStyleData ) ) != 0 ) )
+		{
+		autoBounds.hasBox = (TQ3Boolean)
+			( E3View_CalcLocalBounds ( theView, this, &autoBounds.bBox, &autoBounds.usesSubdivision ) == kQ3Success ) ;
+		
+		autoBounds.subdivision = *subdivisionStyle ;
+		autoBounds.boxVersion  = theVersion ;
+		autoBounds.isChecked   = kQ3True ;
+		}
+
+
+
+	// Return the box
+	if ( ! autoBounds.hasBox || ! contents.isBoundsComplete )
+		return kQ3Failure ;
+	
+	*pBBox = autoBounds.bBox ;
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::HasCurrentAutoBoundingBox : Is our own box current?
+//-----------------------------------------------------------------------------
+//		Note :	Used while calculating bounds, to reuse the box of a nested
+//				group rather than submitting its contents again. The box must
+//				have been calculated under the subdivision style of theView,
+//				if the contents use it.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3DisplayGroup::HasCurrentAutoBoundingBox ( TQ3ViewObject theView )
+	{
+	if ( ! autoBounds.isChecked || ! autoBounds.hasBox || autoBounds.boxVersion != GetContentsVersion () )
+		return kQ3False ;
+	
+	if ( autoBounds.usesSubdivision &&
+		memcmp ( &autoBounds.subdivision, E3View_State_GetStyleSubdivision ( theView ), sizeof ( TQ3SubdivisionStyleData ) ) != 0 )
+		return kQ3False ;
+	
+	return kQ3True ;
+	}
+#endif // QUESA_AUTO_GROUP_BOUNDS
+
+
+
+
+
+#if QUESA_COMPILED_GROUPS
+//=============================================================================
+//      E3DisplayGroup::SubmitCompiled : Render a compiled group.
+//-----------------------------------------------------------------------------
+//		Note :	Replays one of our command lists if the contents of the group
+//				have not changed since they were recorded, and the view state
+//				matches the state the list was recorded with.
+//
+//				Otherwise we submit the group as normal while recording a new
+//				list, keeping the lists for other states, since an instanced
+//				group may be drawn under several. If something in the group
+//				can not be recorded, or we already have a list for as many
+//				states as we keep, we carry on without a new list until the
+//				contents change. If the view is already recording, such as
+//				the first of several rendering passes, our geometries go into
+//				its list as well as ours.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::SubmitCompiled ( TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData )
+	{
+	// Forget our lists if the contents have changed
+	TQ3Uns32 theVersion = GetContentsVersion () ;
+	if ( compiled.listVersion != theVersion )
+		{
+		DisposeCompiledLists () ;
+		compiled.listVersion = theVersion ;
+		}
+
+
+
+	// Replay a list if we can
+	for ( TQ3Uns32 n = 0 ; n < compiled.numLists ; ++n )
+		{
+		if ( E3View_SubmitCommandList ( theView, compiled.commandLists[ n ] ) == kQ3Success )
+			return kQ3Success ;
+		}
+
+
+
+	// Otherwise submit the group, recording a new list unless we already
+	// know that we can't
+	TQ3Boolean isRecording = kQ3False ;
+	if ( ! compiled.isUnrecordable && compiled.numLists < kQ3GroupMaxCompiledLists )
+		isRecording = (TQ3Boolean) ( E3View_StartCommandList ( theView, kQ3False ) == kQ3Success ) ;
+
+	TQ3Status qd3dStatus = E3Push_Submit ( theView ) ;
+	if ( qd3dStatus != kQ3Failure )
+		{
+		qd3dStatus = e3group_submit_contents ( theView, objectType, this, objectData ) ;
+		E3Pop_Submit ( theView ) ;
+		}
+
+	if ( isRecording )
+		{
+		E3ViewCommandList* theList = E3View_EndCommandList ( theView ) ;
+		if ( theList != nullptr )
+			compiled.commandLists[ compiled.numLists++ ] = theList ;
+		else
+			compiled.isUnrecordable = kQ3True ;
+		}
+	
+	return qd3dStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::DisposeCompiledLists : Dispose of our command lists.
+//-----------------------------------------------------------------------------
+void
+E3DisplayGroup::DisposeCompiledLists ( void )
+	{
+	for ( TQ3Uns32 n = 0 ; n < compiled.numLists ; ++n )
+		E3View_DisposeCommandList ( compiled.commandLists[ n ] ) ;
+
+	compiled.numLists       = 0 ;
+	compiled.isUnrecordable = kQ3False ;
+	}
+#endif // QUESA_COMPILED_GROUPS
+
+
+
+
+
+#if QUESA_GROUP_PICK_BVH
+//=============================================================================
+//      e3group_pick_world_to_local : Get the transform for a pick ray.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the pick can't be tested against bounding
+//				boxes. Only exact picks can, since tolerances are measured in
+//				window space or world space, and the local-to-world transform
+//				must be affine and invertible.
+//-----------------------------------------------------------------------------
+static bool
+e3group_pick_world_to_local ( TQ3ViewObject theView, TQ3Matrix4x4* worldToLocal )
+	{
+	TQ3PickObject	thePick = E3View_AccessPick ( theView ) ;
+	float			vertexTolerance, edgeTolerance, faceTolerance ;
+
+
+
+	// Check the pick
+	E3Pick_GetVertexTolerance ( thePick, &vertexTolerance ) ;
+	E3Pick_GetEdgeTolerance   ( thePick, &edgeTolerance ) ;
+	E3Pick_GetFaceTolerance   ( thePick, &faceTolerance ) ;
+	if ( vertexTolerance != 0.0f || edgeTolerance != 0.0f || faceTolerance != 0.0f )
+		return false ;
+
+
+
+	// Check the transform
+	const TQ3Matrix4x4* localToWorld = E3View_State_GetMatrixLocalToWorld ( theView ) ;
+	if ( localToWorld->value[0][3] != 0.0f || localToWorld->value[1][3] != 0.0f ||
+		 localToWorld->value[2][3] != 0.0f || localToWorld->value[3][3] != 1.0f ||
+		 Q3Matrix4x4_Determinant ( localToWorld ) == 0.0f )
+		return false ;
+
+	Q3Matrix4x4_Invert ( localToWorld, worldToLocal ) ;
+
+	return true ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3group_pick_local_ray : Get the pick ray in world and local coordinates.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the pick can't be tested against bounding
+//				boxes. Only exact window-point and world-ray picks can.
+//-----------------------------------------------------------------------------
+static bool
+e3group_pick_local_ray ( TQ3ViewObject theView, TQ3Ray3D* worldRay, TQ3Ray3D* localRay )
+	{
+	TQ3PickObject	thePick = E3View_AccessPick ( theView ) ;
+	TQ3Matrix4x4	worldToLocal ;
+
+
+
+	// Get the ray
+	switch ( E3Pick_GetType ( thePick ) )
+		{
+		case kQ3PickTypeWindowPoint:
+			E3View_GetRayThroughPickPoint ( theView, worldRay ) ;
+			break ;
+
+		case kQ3PickTypeWorldRay:
+			E3WorldRayPick_GetRay ( thePick, worldRay ) ;
+			break ;
+
+		default:
+			return false ;
+		}
+
+
+
+	// Take the ray into local coordinates
+	if ( ! e3group_pick_world_to_local ( theView, &worldToLocal ) )
+		return false ;
+
+	Q3Point3D_Transform  ( &worldRay->origin,    &worldToLocal, &localRay->origin ) ;
+	Q3Vector3D_Transform ( &worldRay->direction, &worldToLocal, &localRay->direction ) ;
+
+	return true ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::UpdatePickIndex : Bring our pick hierarchy up to date.
+//-----------------------------------------------------------------------------
+//		Note :	Fails if the group can't be picked through a hierarchy. Each
+//				member must leave the view state as it found it, so they
+//				must all be geometries or non-inline display groups.
+//
+//				Only the members which have changed since the hierarchy was
+//				last built have their bounds calculated again, or whose bounds
+//				depend on a subdivision style that has changed. The others
+//				keep their boxes. The hierarchy itself is rebuilt from the
+//				boxes, which is cheap by comparison.
+//
+//				The hierarchy holds a reference to each member, since a
+//				member that was disposed of could otherwise be replaced by a
+//				new object at the same address, which would inherit its box.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::UpdatePickIndex ( TQ3ViewObject theView )
+	{
+	// Check the hierarchy we have
+	TQ3Uns32 theVersion = GetContentsVersion () ;
+	const TQ3SubdivisionStyleData* subdivisionStyle = E3View_State_GetStyleSubdivision ( theView ) ;
+	bool isSameStyle = memcmp ( &pickIndex.subdivision, subdivisionStyle, sizeof ( TQ3SubdivisionStyleData ) ) == 0 ;
+
+	if ( pickIndex.hierarchy != nullptr && pickIndex.indexVersion == theVersion &&
+		 ( isSameStyle || ! pickIndex.usesSubdivision ) )
+		return pickIndex.isUnindexable ? kQ3Failure : kQ3Success ;
+
+	pickIndex.subdivision     = *subdivisionStyle ;
+	pickIndex.indexVersion    = theVersion ;
+	pickIndex.isUnindexable   = kQ3True ;
+	pickIndex.usesSubdivision = kQ3False ;
+
+
+
+	// Collect the members, in the order we submit them
+	E3GroupInfo* groupClass = GetClass () ;
+	std::vector<E3GroupPickMember> theMembers ;
+	TQ3GroupPosition thePosition ;
+	TQ3Object subObject = nullptr ;
+	bool isIndexable = true ;
+
+	try
+		{
+		if ( pickIndex.hierarchy == nullptr )
+			pickIndex.hierarchy = new E3GroupPickHierarchy ;
+
+		TQ3Status qd3dStatus = groupClass->startIterateMethod ( this, &thePosition, &subObject, theView ) ;
+		while ( qd3dStatus != kQ3Failure && subObject != nullptr && isIndexable )
+			{
+			E3GroupPickMember theMember = { subObject, thePosition, 0, { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, kQ3True }, kQ3False, kQ3False,
+											CQ3ObjectRef ( Q3Shared_GetReference ( subObject ) ) } ;
+
+			if ( Q3_OBJECT_IS_CLASS ( subObject, E3DisplayGroup ) )
+				{
+				E3DisplayGroup* subGroup = (E3DisplayGroup*) subObject ;
+				TQ3DisplayGroupState subState = subGroup->displayGroupData.state ;
+
+				theMember.stamp          = subGroup->GetContentsVersion () ;
+				theMember.isAlwaysPicked = (TQ3Boolean) ( ! subGroup->contents.isPickBoundsComplete ||
+											E3Bit_AnySet ( subState, kQ3DisplayGroupStateMaskIsNotForBounding ) ) ;
+				isIndexable = ! E3Bit_AnySet ( subState, kQ3DisplayGroupStateMaskIsInline ) ;
+
+				// Groups that aren't picked would be skipped anyway
+				if ( isIndexable && E3Bit_AnySet ( subState, kQ3DisplayGroupStateMaskIsPicked ) )
+					theMembers.push_back ( theMember ) ;
+				}
+			else if ( Q3Object_IsType ( subObject, kQ3ShapeTypeGeometry ) )
+				{
+				TQ3ObjectType leafType   = subObject->GetLeafType () ;
+				E3Instances_UpdateEditIndex ( subObject ) ;
+				theMember.stamp          = ( (E3Shared*) subObject )->GetEditIndex () ;
+				theMember.isAlwaysPicked = (TQ3Boolean) ( leafType == kQ3GeometryTypeMarker ||
+															leafType == kQ3GeometryTypePixmapMarker ) ;
+				theMembers.push_back ( theMember ) ;
+				}
+			else
+				isIndexable = false ;
+
+			if ( isIndexable )
+				qd3dStatus = groupClass->endIterateMethod ( this, &thePosition, &subObject, theView ) ;
+			}
+
+		if ( ! isIndexable )
+			{
+			Q3Object_Dispose ( subObject ) ;
+			subObject = nullptr ;
+			}
+
+		if ( qd3dStatus == kQ3Failure || ! isIndexable || theMembers.size () < kQ3GroupMinMembersForPickIndex )
+			return kQ3Failure ;
+
+
+
+		// Bound the members, reusing the boxes of those that haven't changed
+		E3GroupPickHierarchy* theIndex = pickIndex.hierarchy ;
+		std::unordered_map<TQ3Object, TQ3Uns32> oldMembers ;
+		for ( TQ3Uns32 n = 0 ; n < theIndex->members.size () ; ++n )
+			oldMembers[ theIndex->members[n].object ] = n ;
+
+		for ( E3GroupPickMember& theMember : theMembers )
+			{
+			if ( theMember.isAlwaysPicked )
+				continue ;
+
+			auto oldMember = oldMembers.find ( theMember.object ) ;
+			if ( oldMember != oldMembers.end () &&
+				 theIndex->members[ oldMember->second ].stamp == theMember.stamp &&
+				 ! theIndex->members[ oldMember->second ].isAlwaysPicked &&
+				 ( isSameStyle || ! theIndex->members[ oldMember->second ].usesSubdivision ) )
+				{
+				theMember.bBox            = theIndex->members[ oldMember->second ].bBox ;
+				theMember.usesSubdivision = theIndex->members[ oldMember->second ].usesSubdivision ;
+				}
+
+			else if ( E3View_CalcLocalBounds ( theView, theMember.object, &theMember.bBox, &theMember.usesSubdivision ) == kQ3Failure )
+				{
+				if ( theMember.usesSubdivision )
+					pickIndex.usesSubdivision = kQ3True ;
+
+				theIndex->members.clear () ;
+				return kQ3Failure ;
+				}
+
+			if ( theMember.usesSubdivision )
+				pickIndex.usesSubdivision = kQ3True ;
+			}
+
+
+
+		// Build the hierarchy over the members with bounds
+		std::vector<TQ3BoundingBox> itemBounds ;
+		theIndex->members.swap ( theMembers ) ;
+		theIndex->itemMembers.clear () ;
+		theIndex->alwaysPicked.clear () ;
+
+		for ( TQ3Uns32 n = 0 ; n < theIndex->members.size () ; ++n )
+			{
+			const E3GroupPickMember& theMember = theIndex->members[n] ;
+			if ( theMember.isAlwaysPicked )
+				theIndex->alwaysPicked.push_back ( n ) ;
+
+			else if ( ! theMember.bBox.isEmpty )
+				{
+				theIndex->itemMembers.push_back ( n ) ;
+				itemBounds.push_back ( theMember.bBox ) ;
+				}
+			}
+
+		theIndex->bvh.Build ( (TQ3Uns32) itemBounds.size (), itemBounds.data () ) ;
+		}
+	catch (...)
+		{
+		if ( subObject != nullptr )
+			Q3Object_Dispose ( subObject ) ;
+
+		if ( pickIndex.hierarchy != nullptr )
+			pickIndex.hierarchy->members.clear () ;
+		return kQ3Failure ;
+		}
+
+	pickIndex.isUnindexable = kQ3False ;
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::SubmitPickIndexed : Pick a group through its hierarchy.
+//-----------------------------------------------------------------------------
+//		Note :	Submits only the members whose bounds the pick ray passes
+//				through, along with any that may be hit outside their bounds.
+//				They are submitted in group order, so an unsorted pick finds
+//				the same hits in the same order as if every member had been
+//				submitted.
+//
+//				If the pick only keeps its closest hit, the order makes no
+//				difference. The members are then submitted front to back as
+//				the hierarchy is traversed, and the traversal stops short of
+//				the closest hit found so far.
+//
+//				Batch picks take all of their rays through the hierarchy at
+//				once, see SubmitPickRays.
+//
+//				If the pick or the group can't use a hierarchy, the group is
+//				submitted as normal.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::SubmitPickIndexed ( TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData )
+	{
+	// Batch picks have several rays
+	if ( E3Pick_IsRayBatch ( E3View_AccessPick ( theView ) ) )
+		return SubmitPickRays ( theView, objectType, objectData ) ;
+
+
+
+	// Find the members the ray may hit
+	TQ3Ray3D worldRay, localRay ;
+	if ( ! e3group_pick_local_ray ( theView, &worldRay, &localRay ) ||
+		 UpdatePickIndex ( theView ) == kQ3Failure )
+		return e3group_submit_pick ( theView, objectType, this, objectData ) ;
+
+	E3GroupPickHierarchy* theIndex = pickIndex.hierarchy ;
+	TQ3PickObject thePick = E3View_AccessPick ( theView ) ;
+	if ( E3Pick_IsClosestHitOnly ( thePick ) )
+		return SubmitPickClosest ( theView, worldRay, localRay ) ;
+
+	std::vector<TQ3Uns32> theCandidates ;
+	try
+		{
+		theCandidates.swap ( theIndex->candidates ) ;
+		theCandidates.assign ( theIndex->alwaysPicked.begin (), theIndex->alwaysPicked.end () ) ;
+
+		auto addCandidate = [&] ( TQ3Uns32 theItem, float& /*ioMaxDistance*/ ) -> bool
+			{
+			theCandidates.push_back ( theIndex->itemMembers[ theItem ] ) ;
+			return true ;
+			} ;
+		theIndex->bvh.TraverseRay ( localRay, kQ3MaxFloat, addCandidate ) ;
+
+		std::sort ( theCandidates.begin (), theCandidates.end () ) ;
+		}
+	catch (...)
+		{
+		return e3group_submit_pick ( theView, objectType, this, objectData ) ;
+		}
+
+
+
+	// Submit them as e3group_submit_pick would
+	TQ3Status qd3dStatus = E3View_PickStack_PushGroup ( theView, this ) ;
+	if ( qd3dStatus != kQ3Failure )
+		{
+		for ( TQ3Uns32 theCandidate : theCandidates )
+			{
+			const E3GroupPickMember& theMember = theIndex->members[ theCandidate ] ;
+			E3View_PickStack_SavePosition ( theView, theMember.position ) ;
+			E3View_SubmitRetained ( theView, theMember.object ) ;
+			}
+
+		E3View_PickStack_PopGroup ( theView ) ;
+		}
+
+
+
+	// Keep the storage for next time
+	theIndex->candidates.swap ( theCandidates ) ;
+	
+	return qd3dStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::SubmitPickClosest : Pick a group for its closest hit.
+//-----------------------------------------------------------------------------
+//		Note :	Members are submitted in the order the hierarchy reaches
+//				them. The members that may be hit outside their bounds go
+//				first, so that any hit they find can cut the traversal short.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::SubmitPickClosest ( TQ3ViewObject theView, const TQ3Ray3D& worldRay, const TQ3Ray3D& localRay )
+	{
+	E3GroupPickHierarchy* theIndex = pickIndex.hierarchy ;
+	TQ3PickObject thePick = E3View_AccessPick ( theView ) ;
+
+
+
+	TQ3Status qd3dStatus = E3View_PickStack_PushGroup ( theView, this ) ;
+	if ( qd3dStatus == kQ3Failure )
+		return qd3dStatus ;
+
+	auto submitMember = [&] ( TQ3Uns32 theCandidate )
+		{
+		const E3GroupPickMember& theMember = theIndex->members[ theCandidate ] ;
+		E3View_PickStack_SavePosition ( theView, theMember.position ) ;
+		E3View_SubmitRetained ( theView, theMember.object ) ;
+		} ;
+
+	for ( TQ3Uns32 theCandidate : theIndex->alwaysPicked )
+		submitMember ( theCandidate ) ;
+
+	auto pickCandidate = [&] ( TQ3Uns32 theItem, float& ioMaxDistance ) -> bool
+		{
+		submitMember ( theIndex->itemMembers[ theItem ] ) ;
+		ioMaxDistance = std::min ( ioMaxDistance, E3Pick_GetClosestHitRayLimit ( thePick, &worldRay ) ) ;
+		return true ;
+		} ;
+	theIndex->bvh.TraverseRay ( localRay, E3Pick_GetClosestHitRayLimit ( thePick, &worldRay ), pickCandidate ) ;
+
+	E3View_PickStack_PopGroup ( theView ) ;
+	
+	return qd3dStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3DisplayGroup::SubmitPickRays : Pick a group for a batch of rays.
+//-----------------------------------------------------------------------------
+//		Note :	The active rays of the batch are taken through the hierarchy
+//				together, and each member is submitted once with just the
+//				rays which reach it made active. Each ray keeps its nearest
+//				hit, so the traversal stops short of it for that ray.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3DisplayGroup::SubmitPickRays ( TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData )
+	{
+	TQ3PickObject thePick = E3View_AccessPick ( theView ) ;
+	TQ3Matrix4x4 worldToLocal ;
+
+
+
+	// Check we can use the hierarchy
+	if ( ! e3group_pick_world_to_local ( theView, &worldToLocal ) ||
+		 UpdatePickIndex ( theView ) == kQ3Failure )
+		return e3group_submit_pick ( theView, objectType, this, objectData ) ;
+
+	E3GroupPickHierarchy* theIndex = pickIndex.hierarchy ;
+	const TQ3Uns32* activeRays ;
+	TQ3Uns32 numRays = E3WorldRayBatchPick_GetActiveRays ( thePick, &activeRays ) ;
+	if ( numRays == 0 )
+		return kQ3Success ;
+
+
+
+	// Take the rays into local coordinates
+	std::vector<TQ3Ray3D> localRays ;
+	std::vector<float> rayLimits ;
+	std::vector<TQ3Uns32> memberRays ;
+	try
+		{
+		localRays.resize ( numRays ) ;
+		rayLimits.resize ( numRays ) ;
+		memberRays.resize ( numRays ) ;
+		}
+	catch (...)
+		{
+		return e3group_submit_pick ( theView, objectType, this, objectData ) ;
+		}
+
+	for ( TQ3Uns32 n = 0 ; n < numRays ; ++n )
+		{
+		TQ3Ray3D worldRay ;
+		E3WorldRayBatchPick_GetRay ( thePick, activeRays[n], &worldRay ) ;
+		Q3Point3D_Transform  ( &worldRay.origin,    &worldToLocal, &localRays[n].origin ) ;
+		Q3Vector3D_Transform ( &worldRay.direction, &worldToLocal, &localRays[n].direction ) ;
+		rayLimits[n] = E3WorldRayBatchPick_GetRayLimit ( thePick, activeRays[n] ) ;
+		}
+
+
+
+	// Submit the members
+	TQ3Status qd3dStatus = E3View_PickStack_PushGroup ( theView, this ) ;
+	if ( qd3dStatus == kQ3Failure )
+		return qd3dStatus ;
+
+	auto submitMember = [&] ( TQ3Uns32 theCandidate )
+		{
+		const E3GroupPickMember& theMember = theIndex->members[ theCandidate ] ;
+		E3View_PickStack_SavePosition ( theView, theMember.position ) ;
+		E3View_SubmitRetained ( theView, theMember.object ) ;
+		} ;
+
+	for ( TQ3Uns32 theCandidate : theIndex->alwaysPicked )
+		submitMember ( theCandidate ) ;
+
+	auto pickCandidate = [&] ( TQ3Uns32 theItem, const TQ3Uns32* rayIndices, TQ3Uns32 numMemberRays ) -> bool
+		{
+		for ( TQ3Uns32 n = 0 ; n < numMemberRays ; ++n )
+			memberRays[n] = activeRays[ rayIndices[n] ] ;
+
+		E3WorldRayBatchPick_SetActiveRays ( thePick, numMemberRays, memberRays.data () ) ;
+		submitMember ( theIndex->itemMembers[ theItem ] ) ;
+		E3WorldRayBatchPick_SetActiveRays ( thePick, numRays, activeRays ) ;
+
+		for ( TQ3Uns32 n = 0 ; n < numMemberRays ; ++n )
+			rayLimits[ rayIndices[n] ] = E3WorldRayBatchPick_GetRayLimit ( thePick, memberRays[n] ) ;
+		return true ;
+		} ;
+
+	try
+		{
+		theIndex->bvh.TraverseRays ( numRays, localRays.data (), rayLimits.data (), pickCandidate ) ;
+		}
+	catch (...)
+		{
+		E3WorldRayBatchPick_SetActiveRays ( thePick, numRays, activeRays ) ;
+		qd3dStatus = kQ3Failure ;
+		}
+
+	E3View_PickStack_PopGroup ( theView ) ;
+	
+	return qd3dStatus ;
+	}
+#endif // QUESA_GROUP_PICK_BVH
+
+
+
+
+
 //=============================================================================
 //      E3LightGroup_New : Creates a new light group.
 //-----------------------------------------------------------------------------
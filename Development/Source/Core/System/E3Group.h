@@ -128,14 +128,32 @@ enum
 
 typedef struct TQ3XGroupPosition *TQ3XGroupPositionPtr;
 
-typedef struct TQ3XGroupPosition { // 12 bytes overhead per object in a group
+
+// Links from a position to its neighbours of the same type, for each class
+// of its object below kQ3ObjectTypeShared, from the most general class down.
+typedef struct TQ3XGroupTypeLink {
+	TQ3XGroupPositionPtr	next;
+	TQ3XGroupPositionPtr	prev;
+	TQ3Uns32				listIndex;		// index of the list in E3GroupTypeIndex
+} TQ3XGroupTypeLink;
+
+
+typedef struct TQ3XGroupPosition { // five pointers and a count of overhead per object in a group
 // initialised in e3group_positionnew
 	TQ3XGroupPositionPtr	next;
 	TQ3XGroupPositionPtr	prev;
 	TQ3Object				object;
+	TQ3XGroupTypeLink*		typeLinks;		// nullptr unless the group has a type index
+	TQ3Uns32				numTypeLinks;
+	struct E3GroupPositionChunk*	chunk;	// nullptr unless allocated from a chunk
 } TQ3XGroupPosition;
 
 
+struct E3GroupTypeList;
+class E3GroupTypeIndex;
+struct E3GroupPositionPool;
+
+
 class E3GroupInfo : public E3ShapeInfo
 	{
 	const TQ3XGroupAddObjectMethod				addObjectMethod ;
@@ -179,6 +197,9 @@ struct E3GroupData
 {
 	TQ3XGroupPosition						listHead ;
 	TQ3Uns32								groupPositionSize ;
+	E3GroupTypeIndex*						typeIndex ;		// built by the first query by type
+	E3GroupPositionPool*					positionPool ;	// chunks of positions for large groups
+	TQ3Uns32								numPositionsCreated ;
 };
 
 
@@ -188,7 +209,7 @@ class E3Group : public E3Shape
 Q3_CLASS_ENUMS ( kQ3ShapeTypeGroup, E3Group, E3Shape )
 
 public :
-// 16 bytes overhead per group
+// a position, two pointers and two counts of overhead per group
 // initialised in e3group_new
 	E3GroupData								groupData;
 		
@@ -198,6 +219,10 @@ public :
 	E3GroupInfo*							GetClass ( void ) { return (E3GroupInfo*) OpaqueTQ3Object::GetClass () ; }
 
 	TQ3XGroupPosition*						createPosition ( TQ3Object object ) ;
+	E3GroupTypeList*						gettypelist ( TQ3ObjectType isType, TQ3Boolean *isIndexed ) ;
+	void									addtotypeindex ( TQ3XGroupPosition* position, TQ3Boolean isLast ) ;
+	void									removefromtypeindex ( TQ3XGroupPosition* position ) ;
+	void									droptypeindex ( void ) ;
 	TQ3GroupPosition						addobject ( TQ3Object object ) ;	
 	TQ3GroupPosition						addbefore ( TQ3GroupPosition position, TQ3Object object ) ;
 	TQ3GroupPosition						addafter ( TQ3GroupPosition position, TQ3Object object ) ;
@@ -256,6 +281,73 @@ struct E3DisplayGroupData
 };
 
 
+// Member of a display group, as last seen by GetContentsVersion.
+struct E3DisplayGroupContentsEntry
+{
+	TQ3Object				object ;		// not a reference, the group holds one
+	TQ3Uns32				editIndex ;		// edit index, or contents version of a display group
+};
+
+
+// Version of the contents of a display group. It changes exactly when the
+// group, or anything inside it, is edited, and no two groups share a version.
+// The members are only compared again when the global edit count of scene
+// objects has changed since they were last checked.
+struct E3DisplayGroupContents
+{
+	TQ3Uns32				version ;
+	TQ3Uns32				checkedEditCount ;
+	TQ3Uns32				editIndex ;		// our own edit index at version
+	TQ3Uns32				numEntries ;
+	TQ3Uns32				maxEntries ;
+	E3DisplayGroupContentsEntry*	entries ;
+	TQ3Boolean				hasVersion ;
+	TQ3Boolean				isBoundsComplete ;	// no drawn contents are left out of bounds
+#if QUESA_GROUP_PICK_BVH
+	TQ3Boolean				isPickBoundsComplete ;	// nothing can be picked outside the bounds
+#endif
+};
+
+
+// Bounding box maintained by the group itself, when QUESA_AUTO_GROUP_BOUNDS
+// is set.
+struct E3DisplayGroupAutoBounds
+{
+	TQ3BoundingBox			bBox ;
+	TQ3SubdivisionStyleData	subdivision ;	// style the box was calculated with
+	TQ3Uns32				boxVersion ;	// contents version of bBox
+	TQ3Boolean				isChecked ;		// bBox has been calculated, or can't be
+	TQ3Boolean				hasBox ;		// bBox can be used
+	TQ3Boolean				usesSubdivision ;	// bBox depends on the subdivision style
+};
+
+
+// Command lists compiled from the group, when QUESA_COMPILED_GROUPS is set.
+// A group drawn under several inherited view states keeps a list for each,
+// up to kQ3GroupMaxCompiledLists of them.
+const TQ3Uns32 kQ3GroupMaxCompiledLists								= 4;
+
+struct E3DisplayGroupCompiled
+{
+	class E3ViewCommandList*	commandLists[ kQ3GroupMaxCompiledLists ] ;
+	TQ3Uns32				numLists ;
+	TQ3Uns32				listVersion ;	// contents version of commandLists
+	TQ3Boolean				isUnrecordable ;	// contents at listVersion can't be recorded
+};
+
+
+// Hierarchy over the members of the group, used to find the members that a
+// pick ray may hit, when QUESA_GROUP_PICK_BVH is set.
+struct E3DisplayGroupPickIndex
+{
+	class E3GroupPickHierarchy*	hierarchy ;
+	TQ3SubdivisionStyleData	subdivision ;	// style the member bounds were calculated with
+	TQ3Uns32				indexVersion ;	// contents version of hierarchy
+	TQ3Boolean				isUnindexable ;	// contents at indexVersion can't be indexed
+	TQ3Boolean				usesSubdivision ;	// some member bounds depend on the subdivision style
+};
+
+
 
 class E3DisplayGroup : public E3Group
 	{
@@ -263,9 +355,19 @@ Q3_CLASS_ENUMS ( kQ3GroupTypeDisplay, E3DisplayGroup, E3Group )
 
 public :
 
-// 32 bytes + 16 bytes = 48 bytes overhead per display group
+// overhead per display group is that of a group, plus the fields below
 // initialised in e3group_display_new
 	E3DisplayGroupData		displayGroupData;
+	E3DisplayGroupContents	contents;
+#if QUESA_AUTO_GROUP_BOUNDS
+	E3DisplayGroupAutoBounds	autoBounds;
+#endif
+#if QUESA_COMPILED_GROUPS
+	E3DisplayGroupCompiled	compiled;
+#endif
+#if QUESA_GROUP_PICK_BVH
+	E3DisplayGroupPickIndex	pickIndex;
+#endif
 	
 
 	TQ3Status				GetState ( TQ3DisplayGroupState* pState ) ;
@@ -276,6 +378,25 @@ public :
 	TQ3Status				RemoveBoundingBox ( void ) ;
 	TQ3Status				CalcAndUseBoundingBox ( TQ3ComputeBounds computeBounds, TQ3ViewObject view ) ;
 
+	TQ3Uns32				GetContentsVersion ( void ) ;
+
+#if QUESA_AUTO_GROUP_BOUNDS
+	TQ3Status				GetAutoBoundingBox ( TQ3ViewObject theView, TQ3BoundingBox *pBBox ) ;
+	TQ3Boolean				HasCurrentAutoBoundingBox ( TQ3ViewObject theView ) ;
+#endif
+
+#if QUESA_COMPILED_GROUPS
+	TQ3Status				SubmitCompiled ( TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData ) ;
+	void					DisposeCompiledLists ( void ) ;
+#endif
+
+#if QUESA_GROUP_PICK_BVH
+	TQ3Status				SubmitPickIndexed ( TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData ) ;
+	TQ3Status				SubmitPickClosest ( TQ3ViewObject theView, const TQ3Ray3D& worldRay, const TQ3Ray3D& localRay ) ;
+	TQ3Status				SubmitPickRays ( TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData ) ;
+	TQ3Status				UpdatePickIndex ( TQ3ViewObject theView ) ;
+#endif
+
 
 	friend TQ3Status		e3group_display_new(TQ3Object theObject,
 								void *privateData, const void *paramData) ;
@@ -132,9 +132,34 @@ typedef std::map< TQ3Object, WeakRefSet > ObToWeakRefs;
 static ObToWeakRefs* sObToWeakRefs = nullptr;
 
 
+// Incremented whenever a shared object that can be part of a scene is edited
+#if QUESA_ATOMIC_REFCOUNTS
+static std::atomic<TQ3Uns32> sSharedEditCount( 0 );
+#else
+static TQ3Uns32 sSharedEditCount = 0;
+#endif
+
+
 //=============================================================================
 //      Internal functions
 //-----------------------------------------------------------------------------
+//      e3shared_is_scene_object : Can an object be part of a scene?
+//-----------------------------------------------------------------------------
+//		Note :	Only shapes and attribute sets can be placed in groups, so
+//				edits to other shared objects, such as the properties that
+//				renderers update every frame, can't change any group.
+//-----------------------------------------------------------------------------
+static inline bool
+e3shared_is_scene_object( E3Shared* theObject )
+{
+	return Q3_OBJECT_IS_CLASS( theObject, E3Shape ) || Q3_OBJECT_IS_CLASS( theObject, E3Set );
+}
+
+
+
+
+
+//=============================================================================
 //      E3ShapeInfo::E3ShapeInfo : Constructor for class info of root class.
 //-----------------------------------------------------------------------------
 
@@ -264,20 +289,24 @@ E3Shared_Dispose ( E3Shared* theObject )
 
 
 	// Decrement the reference count
+	//
+	// We must test the value produced by our own decrement, rather than
+	// re-reading the count, since another thread may release its reference
+	// in between when QUESA_ATOMIC_REFCOUNTS is set.
 	Q3_ASSERT(theObject->sharedData.refCount >= 1);
-	theObject->sharedData.refCount--;
+	TQ3Uns32 newRefCount = --theObject->sharedData.refCount;
 
 #if Q3_DEBUG
 	if (theObject->IsLoggingRefs())
 	{
 		Q3_MESSAGE_FMT("Ref count of %p reduced to %d", theObject,
-			(int) theObject->sharedData.refCount );
+			(int) newRefCount );
 	}
 #endif
 
 
 	// If the reference count falls to 0, dispose of the object
-	if ( theObject->sharedData.refCount == 0 )
+	if ( newRefCount == 0 )
 		theObject->DestroyInstance () ;
 	}
 
@@ -307,7 +336,8 @@ e3shared_duplicate(TQ3Object fromObject,     const void *fromPrivateData,
 
 	// Initialise the instance data of the new object
 	instanceData->sharedData.refCount  = 1;
-	instanceData->sharedData.editIndex = E3Integer_Abs( fromInstanceData->sharedData.editIndex );
+	TQ3Int32 fromEditIndex = fromInstanceData->sharedData.editIndex;
+	instanceData->sharedData.editIndex = E3Integer_Abs( fromEditIndex );
 
 #if Q3_DEBUG
 	instanceData->sharedData.logRefs = kQ3False;
@@ -994,6 +1024,13 @@ E3Exit(void)
 		// Set our flag
 		theGlobals->systemInitialised = kQ3False;
 		}
+	
+	
+	
+	// Otherwise, an inner client is done with Quesa, so release the instance
+	// pool memory it no longer uses
+	else
+		E3ClassTree::TrimPools () ;
 
 	return(kQ3Success);
 }
@@ -1245,6 +1282,97 @@ E3ObjectHierarchy_EmptySubClassData(TQ3SubClassData *subClassData)
 
 
 
+//=============================================================================
+//      E3Stats_IsAvailable : Are per-class stats being collected?
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Stats_IsAvailable(void)
+{
+#if QUESA_CLASS_STATS
+	return(kQ3True);
+#else
+	return(kQ3False);
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Stats_Reset : Reset the submit stats of every class.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Stats_Reset(void)
+{
+#if QUESA_CLASS_STATS
+	E3ClassTree::ResetStatistics();
+	return(kQ3Success);
+#else
+	return(kQ3Failure);
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Stats_GetClassStatistics : Get the stats of a class.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Stats_GetClassStatistics(TQ3ObjectType classType, TQ3ClassStatistics *info)
+{
+#if QUESA_CLASS_STATS
+	// Check the structure version
+	if ( (info->structureVersion < 1) ||
+		(info->structureVersion > kQ3ClassStatisticsStructureVersion) )
+		return(kQ3Failure);
+
+
+
+	// Find the class
+	E3ClassInfoPtr theClass = E3ClassTree::GetClass ( classType ) ;
+	if (theClass == nullptr)
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidObjectClass, kQ3False);
+		return(kQ3Failure);
+		}
+
+
+
+	// Get its stats
+	theClass->GetStatistics(info);
+	return(kQ3Success);
+
+#else
+	#pragma unused(classType, info)
+	return(kQ3Failure);
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Stats_Dump : Write the stats of every class to a file.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Stats_Dump(const char *fileName)
+{
+#if QUESA_CLASS_STATS
+	return(E3ClassTree::DumpStatistics(fileName));
+#else
+	#pragma unused(fileName)
+	return(kQ3Failure);
+#endif
+}
+
+
+
+
+
 //=============================================================================
 //      E3Object_Dispose : Dispose of an object.
 //-----------------------------------------------------------------------------
@@ -1288,6 +1416,39 @@ E3Object_CleanDispose(TQ3Object *theObject)
 
 
 
+//=============================================================================
+//      E3Object_DisposeArray : Dispose of an array of objects.
+//-----------------------------------------------------------------------------
+TQ3Status
+OpaqueTQ3Object::DisposeArray ( TQ3Uns32 numObjects, TQ3Object* theObjects )
+{	TQ3Status		qd3dStatus = kQ3Success;
+
+
+
+	// Dispose of the objects, skipping any which are not valid
+	for (TQ3Uns32 n = 0; n < numObjects; ++n)
+		{
+		TQ3Object theObject = theObjects[n];
+		if (theObject == nullptr)
+			continue;
+
+		if (!theObject->IsObjectValid())
+			{
+			E3ErrorManager_PostError(kQ3ErrorInvalidObject, kQ3False);
+			qd3dStatus = kQ3Failure;
+			continue;
+			}
+
+		theObject->Dispose();
+		}
+
+	return(qd3dStatus);
+}
+
+
+
+
+
 //=============================================================================
 //      E3Object_GetWeakReference : Record an object reference so that it can
 //									be made zero when the object is deleted.
@@ -1956,13 +2117,13 @@ E3Shared::GetReference ( void )
 	// Increment the reference count and return the object. Note that we
 	// return the object passed in: this is OK since we're not declared
 	// to return a different object.
-	sharedData.refCount++;
-	Q3_ASSERT(sharedData.refCount >= 2);
+	TQ3Uns32 newRefCount = ++sharedData.refCount;
+	Q3_ASSERT(newRefCount >= 2);
 #if Q3_DEBUG
 	if (IsLoggingRefs())
 	{
 		Q3_MESSAGE_FMT("Ref count of %p increased to %d", this,
-			(int) sharedData.refCount );
+			(int) newRefCount );
 	}
 #endif
 
@@ -2011,7 +2172,9 @@ TQ3Uns32
 E3Shared::GetEditIndex ( void )
 	{
 	// Return the edit index
-	return E3Integer_Abs( sharedData.editIndex );
+	TQ3Int32 theIndex = sharedData.editIndex;
+
+	return E3Integer_Abs( theIndex );
 	}
 
 
@@ -2025,6 +2188,27 @@ void
 E3Shared::SetEditIndex( TQ3Uns32 inIndex )
 {
 	sharedData.editIndex = inIndex;
+
+	if (e3shared_is_scene_object( this ))
+		++sSharedEditCount;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Shared::GetGlobalEditCount : Return the global edit count.
+//-----------------------------------------------------------------------------
+//		Note :	The global edit count changes whenever the edit index of any
+//				shared object that can be part of a scene changes, so caches
+//				which depend on many objects can tell cheaply that none of
+//				them has been edited.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Shared::GetGlobalEditCount( void )
+{
+	return sSharedEditCount;
 }
 
 
@@ -2047,11 +2231,24 @@ void		E3Shared::SetLoggingRefs( TQ3Boolean inLog )
 TQ3Status
 E3Shared::Edited ( void )
 {
+#if QUESA_ATOMIC_REFCOUNTS
+	// Increment the edit index, unless another thread locks it first
+	TQ3Int32 oldIndex = sharedData.editIndex.load( std::memory_order_relaxed );
+	
+	while ( (oldIndex >= 0) &&
+		! sharedData.editIndex.compare_exchange_weak( oldIndex, oldIndex + 1 ) )
+		{
+		}
+#else
 	if (sharedData.editIndex >= 0)
 	{
 		// Increment the edit index
 		++sharedData.editIndex ;
 	}
+#endif
+
+	if ( e3shared_is_scene_object( this ) )
+		++sSharedEditCount ;
 	
 	return kQ3Success ;
 }
@@ -2066,6 +2263,21 @@ E3Shared::Edited ( void )
 void
 E3Shared::SetEditIndexLocked( TQ3Boolean inIsLocked )
 {
+#if QUESA_ATOMIC_REFCOUNTS
+	// Flip the sign of the edit index, retrying if it was edited meanwhile
+	TQ3Int32 oldIndex = sharedData.editIndex.load( std::memory_order_relaxed );
+	TQ3Int32 newIndex;
+	
+	do
+	{
+		newIndex = E3Integer_Abs( oldIndex );
+		if (inIsLocked)
+		{
+			newIndex = - newIndex;
+		}
+	}
+	while ( ! sharedData.editIndex.compare_exchange_weak( oldIndex, newIndex ) );
+#else
 	if (inIsLocked)
 	{
 		sharedData.editIndex = - E3Integer_Abs( sharedData.editIndex );
@@ -2074,6 +2286,7 @@ E3Shared::SetEditIndexLocked( TQ3Boolean inIsLocked )
 	{
 		sharedData.editIndex = E3Integer_Abs( sharedData.editIndex );
 	}
+#endif
 }
 
 
@@ -49,6 +49,10 @@
 
 #include <new>
 
+#if QUESA_ATOMIC_REFCOUNTS
+	#include <atomic>
+#endif
+
 
 #include "E3Memory.h"
 #include "E3HashTable.h"
@@ -250,6 +254,7 @@ public :
 
 
 	TQ3Status					Dispose ( void ) ;
+	static TQ3Status			DisposeArray ( TQ3Uns32 numObjects, TQ3Object* theObjects ) ;
 	void						DestroyInstance ( void ) ;
 	TQ3Object					DuplicateInstance ( void ) ;
 	void*						FindLeafInstanceData ( void ) ;
@@ -304,10 +309,19 @@ public :
 
 
 
+// When QUESA_ATOMIC_REFCOUNTS is set, the reference count and edit index
+// are atomic so that shared objects may be passed between threads. Instance
+// data is zero-filled rather than constructed, which is a valid initial state
+// for these lock-free atomic types.
 struct E3SharedData
 {
+#if QUESA_ATOMIC_REFCOUNTS
+	std::atomic<TQ3Uns32>	refCount;
+	std::atomic<TQ3Int32>	editIndex;	// normally positive, negative means "locked"
+#else
 	TQ3Uns32		refCount;
 	TQ3Int32		editIndex;	// normally positive, negative means "locked"
+#endif
 #if Q3_DEBUG
 	TQ3Boolean		logRefs;
 #endif
@@ -343,6 +357,7 @@ public :
 	TQ3Status			Edited ( void ) ;
 	void				SetEditIndexLocked( TQ3Boolean inIsLocked );
 	TQ3Boolean			IsEditIndexLocked() const;
+	static TQ3Uns32		GetGlobalEditCount( void );
 
 #if Q3_DEBUG
 	TQ3Boolean			IsLoggingRefs() const;
@@ -378,6 +393,11 @@ TQ3Boolean			E3ObjectHierarchy_IsNameRegistered(const char *objectClassName);
 TQ3Status			E3ObjectHierarchy_GetSubClassData(TQ3ObjectType objectClassType, TQ3SubClassData *subClassData);
 TQ3Status			E3ObjectHierarchy_EmptySubClassData(TQ3SubClassData *subClassData);
 
+TQ3Boolean			E3Stats_IsAvailable(void);
+TQ3Status			E3Stats_Reset(void);
+TQ3Status			E3Stats_GetClassStatistics(TQ3ObjectType classType, TQ3ClassStatistics *info);
+TQ3Status			E3Stats_Dump(const char *fileName);
+
 TQ3Status			E3Object_CleanDispose(TQ3Object *object);
 TQ3Object			E3Object_Duplicate(TQ3Object theObject);
 TQ3Status			E3Object_Submit(TQ3Object theObject, TQ3ViewObject theView);
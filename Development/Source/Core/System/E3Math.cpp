@@ -52,6 +52,10 @@
 #include <limits>
 #include <cstring>
 
+#if QUESA_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
 
 
 //=============================================================================
@@ -2266,6 +2270,49 @@ E3Point3D_TransformAffine(const TQ3Point3D *point3D, const TQ3Matrix4x4 *matrix4
 
 
 
+//=============================================================================
+//      e3matrix4x4_is_affine : Is the last column of a matrix (0, 0, 0, 1)?
+//-----------------------------------------------------------------------------
+//		Note :	If so, points can be transformed without dividing by w.
+//-----------------------------------------------------------------------------
+static inline bool
+e3matrix4x4_is_affine(const TQ3Matrix4x4 *matrix4x4)
+{
+	return (matrix4x4->value[3][3] == 1.0f) &&
+		(matrix4x4->value[0][3] == 0.0f) &&
+		(matrix4x4->value[1][3] == 0.0f) &&
+		(matrix4x4->value[2][3] == 0.0f);
+}
+
+
+
+
+
+#if QUESA_USE_SSE
+//=============================================================================
+//      e3point3d_transform_affine_sse : Transform 3D point by affine matrix.
+//-----------------------------------------------------------------------------
+//		Note :	The rows of the matrix are passed in registers, and the result
+//				is returned in the x, y and z lanes. The products are summed in
+//				the same order as E3Point3D_TransformAffine.
+//-----------------------------------------------------------------------------
+static inline __m128
+e3point3d_transform_affine_sse(const TQ3Point3D *point3D,
+	__m128 row0, __m128 row1, __m128 row2, __m128 row3)
+{
+	__m128 result = _mm_mul_ps( _mm_set1_ps( point3D->x ), row0 );
+	result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( point3D->y ), row1 ) );
+	result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( point3D->z ), row2 ) );
+	result = _mm_add_ps( result, row3 );
+	
+	return(result);
+}
+#endif // QUESA_USE_SSE
+
+
+
+
+
 //=============================================================================
 //      E3RationalPoint4D_Transform : Transform 4D rational point by 4x4 matrix.
 //-----------------------------------------------------------------------------
@@ -2466,11 +2513,26 @@ E3Point3D_To3DTransformArray(const TQ3Point3D		*inPoints3D,
 	
 	// In the common case of the last column of the matrix being (0, 0, 0, 1),
 	// we can avoid some divisions and conditionals inside the loop.
-	if ( (matrix4x4->value[3][3] == 1.0f) &&
-		(matrix4x4->value[0][3] == 0.0f) &&
-		(matrix4x4->value[1][3] == 0.0f) &&
-		(matrix4x4->value[2][3] == 0.0f) )
+	if ( e3matrix4x4_is_affine( matrix4x4 ) )
 	{
+#if QUESA_USE_SSE
+		// Each point is transformed in one register. We store the x, y and z
+		// lanes separately, since the points may be packed or done in place.
+		__m128 row0 = _mm_loadu_ps( matrix4x4->value[0] );
+		__m128 row1 = _mm_loadu_ps( matrix4x4->value[1] );
+		__m128 row2 = _mm_loadu_ps( matrix4x4->value[2] );
+		__m128 row3 = _mm_loadu_ps( matrix4x4->value[3] );
+
+		for (i = 0; i < numPoints; ++i)
+		{
+			__m128 result = e3point3d_transform_affine_sse( inPoints3D, row0, row1, row2, row3 );
+			_mm_storel_pi( (__m64*) &outPoints3D->x, result );
+			_mm_store_ss( &outPoints3D->z, _mm_movehl_ps( result, result ) );
+
+			AdvanceConstPointer( inPoints3D, inStructSize );
+			AdvancePointer( outPoints3D, outStructSize );
+		}
+#else
 		for (i = 0; i < numPoints; ++i)
 		{
 			E3Point3D_TransformAffine( inPoints3D, matrix4x4, outPoints3D );
@@ -2478,9 +2540,39 @@ E3Point3D_To3DTransformArray(const TQ3Point3D		*inPoints3D,
 			AdvanceConstPointer( inPoints3D, inStructSize );
 			AdvancePointer( outPoints3D, outStructSize );
 		}
+#endif
 	}
 	else
 	{
+#if QUESA_USE_SSE
+		// Each point is transformed in one register, with w in the last
+		// lane, and then divided through by w as E3Point3D_Transform does.
+		__m128 row0 = _mm_loadu_ps( matrix4x4->value[0] );
+		__m128 row1 = _mm_loadu_ps( matrix4x4->value[1] );
+		__m128 row2 = _mm_loadu_ps( matrix4x4->value[2] );
+		__m128 row3 = _mm_loadu_ps( matrix4x4->value[3] );
+
+		for (i = 0; i < numPoints; ++i)
+		{
+			__m128 result = e3point3d_transform_affine_sse( inPoints3D, row0, row1, row2, row3 );
+			float  neww   = _mm_cvtss_f32( _mm_shuffle_ps( result, result, _MM_SHUFFLE(3, 3, 3, 3) ) );
+
+			if (neww == 0.0f)
+			{
+				E3ErrorManager_PostError( kQ3ErrorInfiniteRationalPoint, kQ3False );
+				neww = 1.0f;
+			}
+
+			if (neww != 1.0f)
+				result = _mm_mul_ps( result, _mm_set1_ps( 1.0f / neww ) );
+
+			_mm_storel_pi( (__m64*) &outPoints3D->x, result );
+			_mm_store_ss( &outPoints3D->z, _mm_movehl_ps( result, result ) );
+
+			AdvanceConstPointer( inPoints3D, inStructSize );
+			AdvancePointer( outPoints3D, outStructSize );
+		}
+#else
 		// Transform the points - will be in-lined in release builds
 		for (i = 0; i < numPoints; ++i)
 		{
@@ -2489,6 +2581,7 @@ E3Point3D_To3DTransformArray(const TQ3Point3D		*inPoints3D,
 			AdvanceConstPointer( inPoints3D, inStructSize );
 			AdvancePointer( outPoints3D, outStructSize );
 		}
+#endif
 	}
 
 	return(kQ3Success);
@@ -4580,6 +4673,115 @@ E3BoundingBox_UnionRationalPoint4D(const TQ3BoundingBox *bBox,
 
 
 
+//=============================================================================
+//      E3BoundingBox_UnionTransformedPoints3D :	Extend bounding box to
+//													enclose set of transformed
+//													3D points.
+//-----------------------------------------------------------------------------
+//		Note :	Equivalent to transforming the points by 'matrix4x4', then
+//				taking the union of their bounding box and 'bBox', without
+//				storing the transformed points.
+//-----------------------------------------------------------------------------
+TQ3BoundingBox *
+E3BoundingBox_UnionTransformedPoints3D(TQ3BoundingBox *bBox,
+	const TQ3Point3D *points3D, TQ3Uns32 numPoints, TQ3Uns32 structSize,
+	const TQ3Matrix4x4 *matrix4x4)
+{
+	TQ3BoundingBox	pointsBox;
+	TQ3Point3D		thePoint;
+	TQ3Uns32		i;
+
+
+
+	if (numPoints == 0)
+		return(bBox);
+
+
+
+	// Find the bounds of the transformed points
+	bool isAffine = e3matrix4x4_is_affine( matrix4x4 );
+
+#if QUESA_USE_SSE
+	if (isAffine)
+	{
+		// Each point is transformed in one register, and the x, y and z
+		// lanes are reduced together
+		__m128 row0 = _mm_loadu_ps( matrix4x4->value[0] );
+		__m128 row1 = _mm_loadu_ps( matrix4x4->value[1] );
+		__m128 row2 = _mm_loadu_ps( matrix4x4->value[2] );
+		__m128 row3 = _mm_loadu_ps( matrix4x4->value[3] );
+
+		__m128 theMin = e3point3d_transform_affine_sse( points3D, row0, row1, row2, row3 );
+		__m128 theMax = theMin;
+		
+		for (i = 1; i < numPoints; ++i)
+		{
+			AdvanceConstPointer( points3D, structSize );
+			
+			__m128 result = e3point3d_transform_affine_sse( points3D, row0, row1, row2, row3 );
+			theMin = _mm_min_ps( theMin, result );
+			theMax = _mm_max_ps( theMax, result );
+		}
+		
+		float minValues[4], maxValues[4];
+		_mm_storeu_ps( minValues, theMin );
+		_mm_storeu_ps( maxValues, theMax );
+		
+		pointsBox.min.x = minValues[0];
+		pointsBox.min.y = minValues[1];
+		pointsBox.min.z = minValues[2];
+		pointsBox.max.x = maxValues[0];
+		pointsBox.max.y = maxValues[1];
+		pointsBox.max.z = maxValues[2];
+	}
+	else
+#endif
+	{
+		if (isAffine)
+			E3Point3D_TransformAffine( points3D, matrix4x4, &thePoint );
+		else
+			E3Point3D_Transform( points3D, matrix4x4, &thePoint );
+		
+		pointsBox.min = pointsBox.max = thePoint;
+		
+		for (i = 1; i < numPoints; ++i)
+		{
+			AdvanceConstPointer( points3D, structSize );
+			
+			if (isAffine)
+				E3Point3D_TransformAffine( points3D, matrix4x4, &thePoint );
+			else
+				E3Point3D_Transform( points3D, matrix4x4, &thePoint );
+			
+			if (thePoint.x < pointsBox.min.x)
+				pointsBox.min.x = thePoint.x;
+			else if (thePoint.x > pointsBox.max.x)
+				pointsBox.max.x = thePoint.x;
+			
+			if (thePoint.y < pointsBox.min.y)
+				pointsBox.min.y = thePoint.y;
+			else if (thePoint.y > pointsBox.max.y)
+				pointsBox.max.y = thePoint.y;
+			
+			if (thePoint.z < pointsBox.min.z)
+				pointsBox.min.z = thePoint.z;
+			else if (thePoint.z > pointsBox.max.z)
+				pointsBox.max.z = thePoint.z;
+		}
+	}
+
+	pointsBox.isEmpty = kQ3False;
+
+
+
+	// Accumulate them
+	return(E3BoundingBox_Union(&pointsBox, bBox, bBox));
+}
+
+
+
+
+
 /*!
 	@function	E3BoundingBox_GetCorners
 	@abstract	Find the 8 corners of a bounding box.
@@ -4905,6 +5107,109 @@ E3BoundingSphere_UnionPoint3D(const TQ3BoundingSphere *bSphere, const TQ3Point3D
 
 
 
+//=============================================================================
+//      E3BoundingSphere_UnionPoints3D :	Extend bounding sphere to enclose
+//											set of 3D points.
+//-----------------------------------------------------------------------------
+//		Note :	Uses Ritter's method, in a single pass over the points. An
+//				empty sphere is first set to span the most distant pair of
+//				the points which are extreme along the x, y or z axis. The
+//				sphere is then grown just enough to take in each point which
+//				lies outside it.
+//
+//				The sphere encloses every point, but may be up to about 20%
+//				larger than the smallest one which does.
+//-----------------------------------------------------------------------------
+TQ3BoundingSphere *
+E3BoundingSphere_UnionPoints3D(TQ3BoundingSphere *bSphere, const TQ3Point3D *points3D,
+	TQ3Uns32 numPoints, TQ3Uns32 structSize)
+{
+	const TQ3Point3D	*currPoint3D;
+	TQ3Uns32			i, n;
+
+
+
+	if (numPoints == 0)
+		return(bSphere);
+
+
+
+	// Start an empty sphere from the most distant pair of extreme points
+	if (bSphere->isEmpty)
+	{
+		const TQ3Point3D *minPoints[3] = { points3D, points3D, points3D };
+		const TQ3Point3D *maxPoints[3] = { points3D, points3D, points3D };
+		
+		for (i = 1, currPoint3D = points3D; i < numPoints; ++i)
+		{
+			AdvanceConstPointer( currPoint3D, structSize );
+			
+			if (currPoint3D->x < minPoints[0]->x) minPoints[0] = currPoint3D;
+			if (currPoint3D->x > maxPoints[0]->x) maxPoints[0] = currPoint3D;
+			if (currPoint3D->y < minPoints[1]->y) minPoints[1] = currPoint3D;
+			if (currPoint3D->y > maxPoints[1]->y) maxPoints[1] = currPoint3D;
+			if (currPoint3D->z < minPoints[2]->z) minPoints[2] = currPoint3D;
+			if (currPoint3D->z > maxPoints[2]->z) maxPoints[2] = currPoint3D;
+		}
+		
+		TQ3Uns32 widest = 0;
+		float widestSquared = -1.0f;
+		
+		for (n = 0; n < 3; ++n)
+		{
+			float dx = maxPoints[n]->x - minPoints[n]->x;
+			float dy = maxPoints[n]->y - minPoints[n]->y;
+			float dz = maxPoints[n]->z - minPoints[n]->z;
+			float distSquared = dx*dx + dy*dy + dz*dz;
+			
+			if (distSquared > widestSquared)
+			{
+				widest        = n;
+				widestSquared = distSquared;
+			}
+		}
+		
+		bSphere->origin.x = 0.5f * (minPoints[widest]->x + maxPoints[widest]->x);
+		bSphere->origin.y = 0.5f * (minPoints[widest]->y + maxPoints[widest]->y);
+		bSphere->origin.z = 0.5f * (minPoints[widest]->z + maxPoints[widest]->z);
+		bSphere->radius   = 0.5f * E3Math_SquareRoot( widestSquared );
+		bSphere->isEmpty  = kQ3False;
+	}
+
+
+
+	// Grow the sphere to take in any points outside it
+	float radiusSquared = bSphere->radius * bSphere->radius;
+	
+	for (i = 0, currPoint3D = points3D; i < numPoints; ++i, AdvanceConstPointer( currPoint3D, structSize ))
+	{
+		float dx = currPoint3D->x - bSphere->origin.x;
+		float dy = currPoint3D->y - bSphere->origin.y;
+		float dz = currPoint3D->z - bSphere->origin.z;
+		float distSquared = dx*dx + dy*dy + dz*dz;
+		
+		if (distSquared > radiusSquared)
+		{
+			// Move the centre towards the point, keeping the far side fixed
+			float dist      = E3Math_SquareRoot( distSquared );
+			float newRadius = 0.5f * (bSphere->radius + dist);
+			float shift     = (newRadius - bSphere->radius) / dist;
+			
+			bSphere->origin.x += dx * shift;
+			bSphere->origin.y += dy * shift;
+			bSphere->origin.z += dz * shift;
+			bSphere->radius    = newRadius;
+			radiusSquared      = newRadius * newRadius;
+		}
+	}
+
+	return(bSphere);
+}
+
+
+
+
+
 //=============================================================================
 //      E3BoundingSphere_UnionRationalPoint4D :	Return minimum bounding sphere
 //												that encloses both 'bSphere'
@@ -60,6 +60,10 @@
 #include <algorithm>
 #include <cmath>
 
+#if QUESA_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
 
 
 
@@ -1429,6 +1433,339 @@ E3Ray3D_IntersectTriangle(	const TQ3Ray3D&		theRay,
 
 
 
+
+//=============================================================================
+//      E3Ray3D_GetInverseDirection : Get the inverse of a ray's direction.
+//-----------------------------------------------------------------------------
+//		Note :	A zero component has an infinite inverse, which the packet
+//				tests allow for.
+//-----------------------------------------------------------------------------
+TQ3Vector3D
+E3Ray3D_GetInverseDirection( const TQ3Ray3D& inRay )
+{
+	TQ3Vector3D		inverseDirection;
+	
+	inverseDirection.x = (inRay.direction.x == 0.0f) ? Infinity() : 1.0f / inRay.direction.x;
+	inverseDirection.y = (inRay.direction.y == 0.0f) ? Infinity() : 1.0f / inRay.direction.y;
+	inverseDirection.z = (inRay.direction.z == 0.0f) ? Infinity() : 1.0f / inRay.direction.z;
+	
+	return inverseDirection;
+}
+
+
+
+
+
+//=============================================================================
+//      E3RayPacket_Clear : Empty a ray packet.
+//-----------------------------------------------------------------------------
+void
+E3RayPacket_Clear( E3RayPacket& outPacket )
+{
+	memset( &outPacket, 0, sizeof(outPacket) );
+}
+
+
+
+
+
+//=============================================================================
+//      E3RayPacket_SetLane : Put a ray in one lane of a ray packet.
+//-----------------------------------------------------------------------------
+void
+E3RayPacket_SetLane( E3RayPacket& ioPacket, TQ3Uns32 inLane,
+					const TQ3Ray3D& inRay, const TQ3Vector3D& inInverseDirection,
+					float inMaxParam )
+{
+	Q3_ASSERT( inLane < kE3RayPacketSize );
+
+	ioPacket.originX[ inLane ]    = inRay.origin.x;
+	ioPacket.originY[ inLane ]    = inRay.origin.y;
+	ioPacket.originZ[ inLane ]    = inRay.origin.z;
+	ioPacket.directionX[ inLane ] = inRay.direction.x;
+	ioPacket.directionY[ inLane ] = inRay.direction.y;
+	ioPacket.directionZ[ inLane ] = inRay.direction.z;
+	ioPacket.inverseX[ inLane ]   = inInverseDirection.x;
+	ioPacket.inverseY[ inLane ]   = inInverseDirection.y;
+	ioPacket.inverseZ[ inLane ]   = inInverseDirection.z;
+	ioPacket.maxParam[ inLane ]   = inMaxParam;
+	ioPacket.laneMask            |= (1U << inLane);
+}
+
+
+
+
+
+//=============================================================================
+//      e3raypacket_get_lane : Get the ray in one lane of a ray packet.
+//-----------------------------------------------------------------------------
+static void
+e3raypacket_get_lane( const E3RayPacket& inPacket, TQ3Uns32 inLane, TQ3Ray3D& outRay )
+{
+	outRay.origin.x    = inPacket.originX[ inLane ];
+	outRay.origin.y    = inPacket.originY[ inLane ];
+	outRay.origin.z    = inPacket.originZ[ inLane ];
+	outRay.direction.x = inPacket.directionX[ inLane ];
+	outRay.direction.y = inPacket.directionY[ inLane ];
+	outRay.direction.z = inPacket.directionZ[ inLane ];
+}
+
+
+
+
+
+#if QUESA_USE_SSE
+//=============================================================================
+//      e3raypacket_slab_sse : Clip the rays of a packet against one slab.
+//-----------------------------------------------------------------------------
+//		Note :	A ray parallel to the slab has 0 * inf for one of its
+//				parameters if its origin lies on a face, so those lanes are
+//				handled separately: they either miss, or are not clipped.
+//-----------------------------------------------------------------------------
+static inline void
+e3raypacket_slab_sse( const float* inOrigin, const float* inDirection,
+					const float* inInverse, float inMin, float inMax,
+					__m128& ioNear, __m128& ioFar, __m128& ioMiss )
+{
+	__m128	origin   = _mm_loadu_ps( inOrigin );
+	__m128	boxMin   = _mm_set1_ps( inMin );
+	__m128	boxMax   = _mm_set1_ps( inMax );
+	__m128	inverse  = _mm_loadu_ps( inInverse );
+	__m128	isFlat   = _mm_cmpeq_ps( _mm_loadu_ps( inDirection ), _mm_setzero_ps() );
+	__m128	isInside = _mm_and_ps( _mm_cmpge_ps( origin, boxMin ), _mm_cmple_ps( origin, boxMax ) );
+
+	__m128	t0 = _mm_mul_ps( _mm_sub_ps( boxMin, origin ), inverse );
+	__m128	t1 = _mm_mul_ps( _mm_sub_ps( boxMax, origin ), inverse );
+	__m128	tMin = _mm_min_ps( t0, t1 );
+	__m128	tMax = _mm_max_ps( t0, t1 );
+	
+	tMin = _mm_or_ps( _mm_andnot_ps( isFlat, tMin ), _mm_and_ps( isFlat, _mm_set1_ps( -Infinity() ) ) );
+	tMax = _mm_or_ps( _mm_andnot_ps( isFlat, tMax ), _mm_and_ps( isFlat, _mm_set1_ps(  Infinity() ) ) );
+
+	ioNear = _mm_max_ps( ioNear, tMin );
+	ioFar  = _mm_min_ps( ioFar,  tMax );
+	ioMiss = _mm_or_ps( ioMiss, _mm_andnot_ps( isInside, isFlat ) );
+}
+#endif // QUESA_USE_SSE
+
+
+
+
+
+//=============================================================================
+//      E3Ray3D_IntersectBoundingBoxPacket : Test a packet of rays against a box.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Ray3D_IntersectBoundingBoxPacket( const E3RayPacket& inRays, const TQ3BoundingBox& inBox )
+{
+#if QUESA_USE_SSE
+	__m128	tNear  = _mm_setzero_ps();
+	__m128	tFar   = _mm_loadu_ps( inRays.maxParam );
+	__m128	isMiss = _mm_setzero_ps();
+
+	e3raypacket_slab_sse( inRays.originX, inRays.directionX, inRays.inverseX,
+						inBox.min.x, inBox.max.x, tNear, tFar, isMiss );
+	e3raypacket_slab_sse( inRays.originY, inRays.directionY, inRays.inverseY,
+						inBox.min.y, inBox.max.y, tNear, tFar, isMiss );
+	e3raypacket_slab_sse( inRays.originZ, inRays.directionZ, inRays.inverseZ,
+						inBox.min.z, inBox.max.z, tNear, tFar, isMiss );
+
+	__m128	isHit = _mm_andnot_ps( isMiss, _mm_cmple_ps( tNear, tFar ) );
+	
+	return static_cast<TQ3Uns32>( _mm_movemask_ps( isHit ) ) & inRays.laneMask;
+
+#else
+	const float*	boxMin = &inBox.min.x;
+	const float*	boxMax = &inBox.max.x;
+	TQ3Uns32		hitMask = 0;
+	
+	for (TQ3Uns32 lane = 0; lane < kE3RayPacketSize; ++lane)
+	{
+		if ((inRays.laneMask & (1U << lane)) == 0)
+			continue;
+		
+		const float	origin[3]    = { inRays.originX[lane],    inRays.originY[lane],    inRays.originZ[lane] };
+		const float	direction[3] = { inRays.directionX[lane], inRays.directionY[lane], inRays.directionZ[lane] };
+		const float	inverse[3]   = { inRays.inverseX[lane],   inRays.inverseY[lane],   inRays.inverseZ[lane] };
+		float		tNear = 0.0f;
+		float		tFar  = inRays.maxParam[lane];
+		bool		isHit = true;
+		
+		for (int axis = 0; axis < 3 && isHit; ++axis)
+		{
+			if (direction[axis] == 0.0f)
+			{
+				isHit = (origin[axis] >= boxMin[axis] && origin[axis] <= boxMax[axis]);
+			}
+			else
+			{
+				float	t0 = (boxMin[axis] - origin[axis]) * inverse[axis];
+				float	t1 = (boxMax[axis] - origin[axis]) * inverse[axis];
+				tNear = std::max( tNear, std::min( t0, t1 ) );
+				tFar  = std::min( tFar,  std::max( t0, t1 ) );
+				isHit = (tNear <= tFar);
+			}
+		}
+		
+		if (isHit)
+			hitMask |= (1U << lane);
+	}
+	
+	return hitMask;
+#endif
+}
+
+
+
+
+
+//=============================================================================
+//      E3Ray3D_IntersectTrianglePacket : Test a packet of rays against a triangle.
+//-----------------------------------------------------------------------------
+//		Note :	This is E3Ray3D_IntersectTriangle for four rays at once. Rays
+//				which are nearly parallel to the triangle take the more careful
+//				path of E3Ray3D_IntersectTriangle one at a time.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Ray3D_IntersectTrianglePacket( const E3RayPacket&	inRays,
+								const TQ3Point3D&	point1,
+								const TQ3Point3D&	point2,
+								const TQ3Point3D&	point3,
+								TQ3Boolean			cullBackfacing,
+								TQ3Param3D*			outHitPoints )
+{
+	TQ3Uns32		hitMask  = 0;
+	TQ3Uns32		slowMask = inRays.laneMask;
+
+
+
+#if QUESA_USE_SSE
+	// Calculate the two edges which share vertex 1
+	__m128	edge1X = _mm_set1_ps( point2.x - point1.x );
+	__m128	edge1Y = _mm_set1_ps( point2.y - point1.y );
+	__m128	edge1Z = _mm_set1_ps( point2.z - point1.z );
+	__m128	edge2X = _mm_set1_ps( point3.x - point1.x );
+	__m128	edge2Y = _mm_set1_ps( point3.y - point1.y );
+	__m128	edge2Z = _mm_set1_ps( point3.z - point1.z );
+	__m128	dirX   = _mm_loadu_ps( inRays.directionX );
+	__m128	dirY   = _mm_loadu_ps( inRays.directionY );
+	__m128	dirZ   = _mm_loadu_ps( inRays.directionZ );
+	__m128	zero   = _mm_setzero_ps();
+	__m128	one    = _mm_set1_ps( 1.0f );
+
+
+
+	// Calculate the determinant, leaving rays nearly in the plane of the
+	// triangle for the slow path
+	__m128	pvecX = _mm_sub_ps( _mm_mul_ps( dirY, edge2Z ), _mm_mul_ps( dirZ, edge2Y ) );
+	__m128	pvecY = _mm_sub_ps( _mm_mul_ps( dirZ, edge2X ), _mm_mul_ps( dirX, edge2Z ) );
+	__m128	pvecZ = _mm_sub_ps( _mm_mul_ps( dirX, edge2Y ), _mm_mul_ps( dirY, edge2X ) );
+	__m128	det   = _mm_add_ps( _mm_add_ps( _mm_mul_ps( edge1X, pvecX ),
+									_mm_mul_ps( edge1Y, pvecY ) ),
+									_mm_mul_ps( edge1Z, pvecZ ) );
+	__m128	absDet = _mm_max_ps( det, _mm_sub_ps( zero, det ) );
+	__m128	isFast = _mm_cmpge_ps( absDet, _mm_set1_ps( kQ3RealZero ) );
+	
+	slowMask &= ~static_cast<TQ3Uns32>( _mm_movemask_ps( isFast ) );
+
+
+
+	// Calculate u, v and w
+	__m128	tvecX = _mm_sub_ps( _mm_loadu_ps( inRays.originX ), _mm_set1_ps( point1.x ) );
+	__m128	tvecY = _mm_sub_ps( _mm_loadu_ps( inRays.originY ), _mm_set1_ps( point1.y ) );
+	__m128	tvecZ = _mm_sub_ps( _mm_loadu_ps( inRays.originZ ), _mm_set1_ps( point1.z ) );
+	__m128	qvecX = _mm_sub_ps( _mm_mul_ps( tvecY, edge1Z ), _mm_mul_ps( tvecZ, edge1Y ) );
+	__m128	qvecY = _mm_sub_ps( _mm_mul_ps( tvecZ, edge1X ), _mm_mul_ps( tvecX, edge1Z ) );
+	__m128	qvecZ = _mm_sub_ps( _mm_mul_ps( tvecX, edge1Y ), _mm_mul_ps( tvecY, edge1X ) );
+
+	__m128	u = _mm_add_ps( _mm_add_ps( _mm_mul_ps( tvecX, pvecX ), _mm_mul_ps( tvecY, pvecY ) ),
+							_mm_mul_ps( tvecZ, pvecZ ) );
+	__m128	v = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dirX, qvecX ), _mm_mul_ps( dirY, qvecY ) ),
+							_mm_mul_ps( dirZ, qvecZ ) );
+	__m128	w = _mm_add_ps( _mm_add_ps( _mm_mul_ps( edge2X, qvecX ), _mm_mul_ps( edge2Y, qvecY ) ),
+							_mm_mul_ps( edge2Z, qvecZ ) );
+	__m128	invDet = _mm_div_ps( one, _mm_or_ps( _mm_and_ps( isFast, det ), _mm_andnot_ps( isFast, one ) ) );
+	__m128	isHit;
+
+
+
+	// Test u and v against the triangle, before scaling them for back-face
+	// culling and after for no culling, as E3Ray3D_IntersectTriangle does
+	if (cullBackfacing)
+	{
+		isHit = _mm_and_ps( isFast, _mm_cmpgt_ps( det, zero ) );
+		isHit = _mm_and_ps( isHit, _mm_cmpge_ps( u, zero ) );
+		isHit = _mm_and_ps( isHit, _mm_cmple_ps( u, det ) );
+		isHit = _mm_and_ps( isHit, _mm_cmpge_ps( v, zero ) );
+		isHit = _mm_and_ps( isHit, _mm_cmple_ps( _mm_add_ps( u, v ), det ) );
+		u = _mm_mul_ps( u, invDet );
+		v = _mm_mul_ps( v, invDet );
+	}
+	else
+	{
+		u = _mm_mul_ps( u, invDet );
+		v = _mm_mul_ps( v, invDet );
+		isHit = _mm_and_ps( isFast, _mm_cmpge_ps( u, zero ) );
+		isHit = _mm_and_ps( isHit, _mm_cmple_ps( u, one ) );
+		isHit = _mm_and_ps( isHit, _mm_cmpge_ps( v, zero ) );
+		isHit = _mm_and_ps( isHit, _mm_cmple_ps( _mm_add_ps( u, v ), one ) );
+	}
+	
+	w = _mm_mul_ps( w, invDet );
+	isHit = _mm_and_ps( isHit, _mm_cmpge_ps( w, zero ) );
+	isHit = _mm_and_ps( isHit, _mm_cmple_ps( w, _mm_loadu_ps( inRays.maxParam ) ) );
+	
+	hitMask = static_cast<TQ3Uns32>( _mm_movemask_ps( isHit ) ) & inRays.laneMask;
+
+
+
+	// Return the parameters of the hits
+	if (hitMask != 0)
+	{
+		float	hitU[4], hitV[4], hitW[4];
+		_mm_storeu_ps( hitU, u );
+		_mm_storeu_ps( hitV, v );
+		_mm_storeu_ps( hitW, w );
+
+		for (TQ3Uns32 lane = 0; lane < kE3RayPacketSize; ++lane)
+		{
+			if ((hitMask & (1U << lane)) != 0)
+			{
+				outHitPoints[lane].u = hitU[lane];
+				outHitPoints[lane].v = hitV[lane];
+				outHitPoints[lane].w = hitW[lane];
+			}
+		}
+	}
+#endif // QUESA_USE_SSE
+
+
+
+	// Test any remaining rays one at a time
+	for (TQ3Uns32 lane = 0; slowMask != 0; ++lane)
+	{
+		if ((slowMask & (1U << lane)) != 0)
+		{
+			TQ3Ray3D	theRay;
+			e3raypacket_get_lane( inRays, lane, theRay );
+			
+			if (E3Ray3D_IntersectTriangle( theRay, point1, point2, point3,
+				cullBackfacing, outHitPoints[lane] ) &&
+				outHitPoints[lane].w <= inRays.maxParam[lane])
+			{
+				hitMask |= (1U << lane);
+			}
+			
+			slowMask &= ~(1U << lane);
+		}
+	}
+	
+	return hitMask;
+}
+
+
+
+
 /*!
 	@function	E3Ray3D_IntersectPlaneOfTriangle
 	@abstract	Find the intersection between a ray and the plane of a triangle.
@@ -84,6 +84,101 @@ TQ3Boolean		E3Ray3D_IntersectTriangle(	const TQ3Ray3D&		theRay,
 											TQ3Param3D&			outHitPoint);
 
 
+/*!
+	@struct		E3RayPacket
+	@abstract	Up to four rays, laid out to be tested together.
+	@discussion	Each array holds one component of each ray, so that the rays
+				can be tested with SIMD instructions when QUESA_USE_SSE is
+				set. Bit n of laneMask is set if lane n holds a ray.
+				
+				maxParam is the largest parameter along each ray at which a
+				hit counts, in units of the ray's direction.
+*/
+struct E3RayPacket
+{
+	float			originX[4],    originY[4],    originZ[4];
+	float			directionX[4], directionY[4], directionZ[4];
+	float			inverseX[4],   inverseY[4],   inverseZ[4];
+	float			maxParam[4];
+	TQ3Uns32		laneMask;
+};
+
+const TQ3Uns32 kE3RayPacketSize = 4;
+
+
+/*!
+	@function	E3Ray3D_GetInverseDirection
+	@abstract	Get the componentwise inverse of a ray's direction, for
+				E3RayPacket_SetLane. Zero components have infinite inverses.
+	@param		inRay			A ray.
+	@result		The inverse of the ray's direction.
+*/
+TQ3Vector3D		E3Ray3D_GetInverseDirection( const TQ3Ray3D& inRay );
+
+
+/*!
+	@function	E3RayPacket_Clear
+	@abstract	Empty a ray packet.
+	@param		outPacket		The packet to empty.
+*/
+void			E3RayPacket_Clear( E3RayPacket& outPacket );
+
+
+/*!
+	@function	E3RayPacket_SetLane
+	@abstract	Put a ray in one lane of a ray packet.
+	@param		ioPacket			The packet.
+	@param		inLane				The lane, less than kE3RayPacketSize.
+	@param		inRay				The ray.
+	@param		inInverseDirection	The inverse of the ray's direction, from
+									E3Ray3D_GetInverseDirection.
+	@param		inMaxParam			The largest parameter at which a hit counts.
+*/
+void			E3RayPacket_SetLane( E3RayPacket& ioPacket,
+									TQ3Uns32 inLane,
+									const TQ3Ray3D& inRay,
+									const TQ3Vector3D& inInverseDirection,
+									float inMaxParam );
+
+
+/*!
+	@function	E3Ray3D_IntersectBoundingBoxPacket
+	@abstract	Find which rays of a packet hit a bounding box.
+	@discussion	A ray hits the box if some point of it with a parameter
+				between 0 and the ray's maxParam is in the box. The ray
+				directions need not be normalized.
+	@param		inRays			A packet of rays.
+	@param		inBox			A bounding box.
+	@result		A mask with bit n set if the ray in lane n hits the box.
+*/
+TQ3Uns32		E3Ray3D_IntersectBoundingBoxPacket( const E3RayPacket& inRays,
+													const TQ3BoundingBox& inBox );
+
+
+/*!
+	@function	E3Ray3D_IntersectTrianglePacket
+	@abstract	Find which rays of a packet hit a triangle.
+	@discussion	This is E3Ray3D_IntersectTriangle for each ray of the packet,
+				except that hits beyond a ray's maxParam are not reported.
+	@param		inRays			A packet of rays.
+	@param		point1			A point (a vertex of a triangle).
+	@param		point2			A point (a vertex of a triangle).
+	@param		point3			A point (a vertex of a triangle).
+	@param		cullBackfacing	Whether to omit a hit on the back face.
+	@param		outHitPoints	Array of kE3RayPacketSize parameters. Element n
+								receives the intersection data for the ray in
+								lane n, as for E3Ray3D_IntersectTriangle, if
+								that ray hits.
+	@result		A mask with bit n set if the ray in lane n hits the triangle.
+*/
+TQ3Uns32		E3Ray3D_IntersectTrianglePacket( const E3RayPacket&	inRays,
+												const TQ3Point3D&	point1,
+												const TQ3Point3D&	point2,
+												const TQ3Point3D&	point3,
+												TQ3Boolean			cullBackfacing,
+												TQ3Param3D*			outHitPoints );
+
+
 /*!
 	@function	E3Ray3D_IntersectPlaneOfTriangle
 	@abstract	Find the intersection between a ray and the plane of a triangle.
@@ -85,6 +85,14 @@ const TQ3Uns32 kSlabSmallItemSize						= 256;
 const TQ3Uns32 kSlabSmallGrowSize						= 16 * 1024;
 
 
+// Allocation profiler
+#if Q3_MEMORY_DEBUG
+const TQ3Uns32 kProfileDefaultInterval					= 64 * 1024;
+const TQ3Uns32 kProfileMaxClassDepth					= 16;
+const TQ3Uns32 kProfileHashTableSize					= 1024;
+#endif
+
+
 
 
 
@@ -122,6 +130,26 @@ public :
 
 
 
+// Allocation profile sample
+//
+// Samples are aggregated by the path of object classes being created or
+// submitted when the allocation was made, and by the function which made
+// the allocation (if stack crawls are available on this platform).
+#if Q3_MEMORY_DEBUG
+typedef struct TQ3MemoryProfileRecord {
+	struct TQ3MemoryProfileRecord	*nextRecord;
+	TQ3Uns32						keyHash;
+	TQ3Uns32						classDepth;
+	TQ3ObjectType					classPath[kProfileMaxClassDepth];
+	char							*callSite;
+	TQ3Uns32						numSamples;
+	double							estimatedBytes;
+	double							estimatedCalls;
+} TQ3MemoryProfileRecord;
+#endif
+
+
+
 
 
 //=============================================================================
@@ -132,6 +160,21 @@ static TQ3Int32		sMaxAllocCount    = 0;
 static TQ3Int64		sActiveAllocBytes = { 0, 0 };
 static TQ3Int64		sMaxAllocBytes	  = { 0, 0 };
 
+#if Q3_MEMORY_DEBUG
+static TQ3Boolean				sIsProfiling       = kQ3False;
+static TQ3Uns32					sProfileInterval   = kProfileDefaultInterval;
+static TQ3Uns32					sBytesUntilSample  = kProfileDefaultInterval;
+static TQ3MemoryProfileRecord	*sProfileTable[kProfileHashTableSize];
+
+// The class path follows the submits made by each thread
+static thread_local TQ3Boolean		sIsSampling        = kQ3False;
+static thread_local TQ3Uns32		sProfileClassDepth = 0;
+static thread_local TQ3ObjectType	sProfileClassPath[kProfileMaxClassDepth];
+
+// Instance pools profile each item they hand out, rather than their blocks
+static thread_local TQ3Uns32		sPoolAllocationDepth = 0;
+#endif
+
 
 
 
@@ -261,6 +304,222 @@ static TQ3Uns32 e3memGetSize( const void* inMemBlock )
 
 
 
+#if Q3_MEMORY_DEBUG
+//=============================================================================
+//      e3memory_profile_hash : Hash a profile key.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3memory_profile_hash(TQ3Uns32 classDepth, const TQ3ObjectType *classPath, const char *callSite)
+{	TQ3Uns32		n, theHash;
+
+
+
+	// FNV-1a over the class path and the call site
+	theHash = 2166136261U;
+
+	for (n = 0; n < classDepth; n++)
+		theHash = (theHash ^ (TQ3Uns32) classPath[n]) * 16777619U;
+
+	if (callSite != nullptr)
+		{
+		while (*callSite != 0x00)
+			theHash = (theHash ^ (TQ3Uns8) *callSite++) * 16777619U;
+		}
+
+	return(theHash);
+}
+
+
+
+
+
+//=============================================================================
+//      e3memory_profile_call_site : Get the name of the allocating function.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the first function in the stack crawl outside of the
+//				memory manager, or nullptr if stack crawls are not available.
+//-----------------------------------------------------------------------------
+static const char *
+e3memory_profile_call_site(TQ3StackCrawl theCrawl)
+{	TQ3Uns32		n, numNames;
+	const char		*theName;
+
+
+
+	// Find the first caller outside of the memory manager
+	numNames = E3StackCrawl_Count(theCrawl);
+
+	for (n = 1; n < numNames; n++)
+		{
+		theName = E3StackCrawl_Get(theCrawl, n);
+		if (theName != nullptr && strstr(theName, "Memory_") == nullptr && strstr(theName, "e3memory_") == nullptr)
+			return(theName);
+		}
+
+	return(nullptr);
+}
+
+
+
+
+
+//=============================================================================
+//      e3memory_profile_sample : Record a sampled allocation.
+//-----------------------------------------------------------------------------
+//		Note :	Each sample stands in for the sample interval's worth of bytes,
+//				or for the allocation itself if that is larger.
+//
+//				The profile is kept with malloc rather than our own allocator,
+//				so that recording a sample can not itself be sampled.
+//-----------------------------------------------------------------------------
+static void
+e3memory_profile_sample(TQ3Uns32 theSize)
+{	TQ3MemoryProfileRecord		*theRecord;
+	const char					*callSite;
+	TQ3StackCrawl				theCrawl;
+	TQ3Uns32					classDepth, keyHash;
+	double						sampleBytes;
+
+
+
+	// Guard against re-entry from the stack crawl
+	if (sIsSampling)
+		return;
+
+	sIsSampling = kQ3True;
+
+
+
+	// Build the key for the sample
+	classDepth = E3Num_Min(sProfileClassDepth, kProfileMaxClassDepth);
+	theCrawl   = E3StackCrawl_New();
+	callSite   = e3memory_profile_call_site(theCrawl);
+	keyHash    = e3memory_profile_hash(classDepth, sProfileClassPath, callSite);
+
+
+
+	// Find the record for the key
+	theRecord = sProfileTable[keyHash & (kProfileHashTableSize - 1)];
+	
+	while (theRecord != nullptr)
+		{
+		if (theRecord->keyHash    == keyHash    &&
+			theRecord->classDepth == classDepth &&
+			memcmp(theRecord->classPath, sProfileClassPath, classDepth * sizeof(TQ3ObjectType)) == 0 &&
+			((theRecord->callSite == nullptr && callSite == nullptr) ||
+			 (theRecord->callSite != nullptr && callSite != nullptr && strcmp(theRecord->callSite, callSite) == 0)))
+			break;
+
+		theRecord = theRecord->nextRecord;
+		}
+
+
+
+	// Or create a new record
+	if (theRecord == nullptr)
+		{
+		theRecord = (TQ3MemoryProfileRecord *) calloc(1, sizeof(TQ3MemoryProfileRecord));
+		if (theRecord != nullptr)
+			{
+			theRecord->keyHash    = keyHash;
+			theRecord->classDepth = classDepth;
+			memcpy(theRecord->classPath, sProfileClassPath, classDepth * sizeof(TQ3ObjectType));
+
+			if (callSite != nullptr)
+				{
+				theRecord->callSite = (char *) malloc(strlen(callSite) + 1);
+				if (theRecord->callSite != nullptr)
+					strcpy(theRecord->callSite, callSite);
+				}
+
+			theRecord->nextRecord = sProfileTable[keyHash & (kProfileHashTableSize - 1)];
+			sProfileTable[keyHash & (kProfileHashTableSize - 1)] = theRecord;
+			}
+		}
+
+
+
+	// Update the record
+	if (theRecord != nullptr)
+		{
+		sampleBytes = (double) E3Num_Max(theSize, sProfileInterval);
+
+		theRecord->numSamples     += 1;
+		theRecord->estimatedBytes += sampleBytes;
+		theRecord->estimatedCalls += sampleBytes / (double) theSize;
+		}
+
+	E3StackCrawl_Dispose(theCrawl);
+	sIsSampling = kQ3False;
+}
+
+
+
+
+
+//=============================================================================
+//      e3memory_profile_allocation : Note an allocation for the profiler.
+//-----------------------------------------------------------------------------
+//		Note :	We sample the allocation which takes us past each multiple of
+//				the sample interval, so the cost of profiling is proportional
+//				to the number of bytes allocated rather than allocations made.
+//-----------------------------------------------------------------------------
+static inline void
+e3memory_profile_allocation(TQ3Uns32 theSize)
+{
+
+
+	// Skip the blocks of an instance pool, whose items are noted separately
+	if (sPoolAllocationDepth != 0)
+		return;
+
+
+
+	// Count down to the next sample
+	if (theSize < sBytesUntilSample)
+		sBytesUntilSample -= theSize;
+	else
+		{
+		sBytesUntilSample = sProfileInterval;
+		e3memory_profile_sample(theSize);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3memory_profile_forget : Discard the samples in the profile.
+//-----------------------------------------------------------------------------
+static void
+e3memory_profile_forget(void)
+{	TQ3MemoryProfileRecord		*theRecord, *nextRecord;
+	TQ3Uns32					n;
+
+
+
+	// Free the records
+	for (n = 0; n < kProfileHashTableSize; n++)
+		{
+		theRecord = sProfileTable[n];
+		while (theRecord != nullptr)
+			{
+			nextRecord = theRecord->nextRecord;
+			free(theRecord->callSite);
+			free(theRecord);
+			theRecord = nextRecord;
+			}
+
+		sProfileTable[n] = nullptr;
+		}
+}
+#endif
+
+
+
+
+
 #if Q3_DEBUG
 //=============================================================================
 //      SetDirectoryForDump : If a plain file name was passed to
@@ -355,6 +614,14 @@ E3Memory_UnregisterClass(void)
 	// Unregister the memory classes
 	qd3dStatus = E3ClassTree::UnregisterClass(kQ3ObjectTypeSlab, kQ3True);
 
+
+
+	// Discard any allocation profile
+#if Q3_MEMORY_DEBUG
+	sIsProfiling = kQ3False;
+	e3memory_profile_forget();
+#endif
+
 	return(qd3dStatus);
 }
 
@@ -394,6 +661,10 @@ E3Memory_Allocate(TQ3Uns32 theSize)
 		sMaxAllocCount = E3Num_Max( sMaxAllocCount, sActiveAllocCount );
 		Q3Int64_Uns32_Add( sActiveAllocBytes, e3memGetSize( thePtr ), sActiveAllocBytes );
 		sMaxAllocBytes = e3Int64_Max( sMaxAllocBytes, sActiveAllocBytes );
+
+		// Update the profile
+		if (sIsProfiling)
+			e3memory_profile_allocation( theSize );
 	}
 #endif
 
@@ -443,6 +714,10 @@ E3Memory_AllocateClear(TQ3Uns32 theSize)
 		sMaxAllocCount = E3Num_Max( sMaxAllocCount, sActiveAllocCount );
 		Q3Int64_Uns32_Add( sActiveAllocBytes, e3memGetSize( thePtr ), sActiveAllocBytes );
 		sMaxAllocBytes = e3Int64_Max( sMaxAllocBytes, sActiveAllocBytes );
+
+		// Update the profile
+		if (sIsProfiling)
+			e3memory_profile_allocation( theSize );
 		}
 #endif
 
@@ -567,6 +842,10 @@ E3Memory_Reallocate(void **thePtr, TQ3Uns32 newSize)
 				Q3Int64_Uns32_Subtract( sActiveAllocBytes,
 					oldSize - actualNewSize, sActiveAllocBytes );
 			}
+
+			// Update the profile
+			if (sIsProfiling)
+				e3memory_profile_allocation( newSize );
 		#endif
 		}
 		else
@@ -760,6 +1039,10 @@ E3Memory_StartRecording(void)
 //=============================================================================
 //      E3Memory_StopRecording : Stop recording any more objects.
 //-----------------------------------------------------------------------------
+//		Note :	Recording usually brackets a test or a burst of work, so this
+//				is also a good time to release any instance pool blocks that
+//				the burst left unused.
+//-----------------------------------------------------------------------------
 #if Q3_DEBUG
 TQ3Status
 E3Memory_StopRecording(void)
@@ -769,6 +1052,8 @@ E3Memory_StopRecording(void)
 
 	theGlobals->isLeakChecking = kQ3False;
 	
+	E3ClassTree::TrimPools();
+	
 	return kQ3Success;
 }
 #endif
@@ -1019,13 +1304,21 @@ TQ3Status		E3Memory_GetStatistics( TQ3MemoryStatistics* info )
 	#if Q3_MEMORY_DEBUG
 		TQ3Status	theResult;
 
-		if (info->structureVersion == kQ3MemoryStatisticsStructureVersion)
+		// Version 1 of the structure lacks the instance pool fields
+		if ( (info->structureVersion >= 1) &&
+			(info->structureVersion <= kQ3MemoryStatisticsStructureVersion) )
 		{
 			info->currentAllocations = sActiveAllocCount;
 			info->currentBytes = sActiveAllocBytes;
 			info->maxBytes = sMaxAllocBytes;
 			info->maxAllocations = sMaxAllocCount;
 			
+			if (info->structureVersion >= 2)
+			{
+				E3ClassTree::GetPoolStatistics( &info->instancePoolAllocations,
+					&info->instancePoolHits );
+			}
+			
 			theResult = kQ3Success;
 		}
 		else
@@ -1044,6 +1337,237 @@ TQ3Status		E3Memory_GetStatistics( TQ3MemoryStatistics* info )
 
 
 
+//=============================================================================
+//      E3Memory_StartProfiling : Start sampling allocations.
+//-----------------------------------------------------------------------------
+//		Note :	Any previous profile is discarded.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+TQ3Status
+E3Memory_StartProfiling(TQ3Uns32 sampleInterval)
+{
+	#if Q3_MEMORY_DEBUG
+		// Reset the profile
+		e3memory_profile_forget();
+
+		sProfileInterval  = (sampleInterval != 0) ? sampleInterval : kProfileDefaultInterval;
+		sBytesUntilSample = sProfileInterval;
+		sIsProfiling      = kQ3True;
+		
+		return kQ3Success;
+	#else
+		#pragma unused( sampleInterval )
+		return kQ3Failure;
+	#endif
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      E3Memory_StopProfiling : Stop sampling allocations.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+TQ3Status
+E3Memory_StopProfiling(void)
+{
+	#if Q3_MEMORY_DEBUG
+		sIsProfiling = kQ3False;
+		
+		return kQ3Success;
+	#else
+		return kQ3Failure;
+	#endif
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      E3Memory_DumpProfile : Write the allocation profile to a file.
+//-----------------------------------------------------------------------------
+//		Note :	The profile is written in the "folded stack" format accepted by
+//				flamegraph.pl, speedscope, and pprof's collapsed stack import.
+//				Each line is a semicolon-separated path of frames followed by
+//				the estimated bytes (or number of allocations) for that path.
+//
+//				The frames are the classes being created or submitted when the
+//				allocations were made, outermost first, followed by the function
+//				which made the allocation where stack crawls are available.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+TQ3Status
+E3Memory_DumpProfile( const char* fileName, TQ3Boolean countCalls )
+{
+	#if Q3_MEMORY_DEBUG
+		TQ3MemoryProfileRecord	*theRecord;
+		E3ClassInfoPtr			theClass;
+		const char				*theName;
+		FILE					*dumpFile;
+		TQ3Uns32				n, i;
+		double					theValue;
+
+
+
+		// Open the file
+		Q3_REQUIRE_OR_RESULT( Q3_VALID_PTR( fileName ), kQ3Failure );
+
+		SetDirectoryForDump( fileName );
+		dumpFile = fopen( fileName, "w" );
+		if (dumpFile == nullptr)
+		{
+			E3ErrorManager_PostError( kQ3ErrorFileNotOpen, kQ3False );
+			return kQ3Failure;
+		}
+
+
+
+		// Write a line for each record
+		for (n = 0; n < kProfileHashTableSize; n++)
+		{
+			for (theRecord = sProfileTable[n]; theRecord != nullptr; theRecord = theRecord->nextRecord)
+			{
+				// Write the class path
+				for (i = 0; i < theRecord->classDepth; i++)
+				{
+					theClass = E3ClassTree::GetClass( theRecord->classPath[i] );
+					theName  = (theClass != nullptr) ? theClass->GetName() : "UNKNOWN";
+					fprintf( dumpFile, "%s%s", (i == 0) ? "" : ";", theName );
+				}
+
+
+
+				// Write the call site, which must not contain a frame separator
+				if (theRecord->callSite != nullptr)
+				{
+					fputs( (theRecord->classDepth == 0) ? "" : ";", dumpFile );
+					for (theName = theRecord->callSite; *theName != 0x00; theName++)
+						fputc( (*theName == ';') ? ':' : *theName, dumpFile );
+				}
+				else if (theRecord->classDepth == 0)
+					fputs( "[unattributed]", dumpFile );
+
+
+
+				// Write the value
+				theValue = countCalls ? theRecord->estimatedCalls : theRecord->estimatedBytes;
+				fprintf( dumpFile, " %.0f\n", theValue );
+			}
+		}
+
+		fclose( dumpFile );
+		
+		return kQ3Success;
+	#else
+		#pragma unused( fileName, countCalls )
+		return kQ3Failure;
+	#endif
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      E3Memory_PushProfileClass : Attribute allocations to a class.
+//-----------------------------------------------------------------------------
+//		Note :	Pushes a class onto the path used to attribute sampled
+//				allocations. Normally used through E3MemoryProfileScope.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+void
+E3Memory_PushProfileClass( TQ3ObjectType theType )
+{
+	#if Q3_MEMORY_DEBUG
+		// Push the class, if there is room for it
+		if (sProfileClassDepth < kProfileMaxClassDepth)
+			sProfileClassPath[sProfileClassDepth] = theType;
+
+		sProfileClassDepth++;
+	#else
+		#pragma unused( theType )
+	#endif
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      E3Memory_PopProfileClass : Stop attributing allocations to a class.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+void
+E3Memory_PopProfileClass( void )
+{
+	#if Q3_MEMORY_DEBUG
+		// Pop the class
+		Q3_ASSERT( sProfileClassDepth != 0 );
+		sProfileClassDepth--;
+	#endif
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      E3Memory_BeginPoolAllocation : Start allocating from an instance pool.
+//-----------------------------------------------------------------------------
+//		Note :	Any block the pool allocates from the heap until the matching
+//				E3Memory_EndPoolAllocation is not profiled, since the items in
+//				it are profiled as they are handed out.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+void
+E3Memory_BeginPoolAllocation( void )
+{
+	#if Q3_MEMORY_DEBUG
+		sPoolAllocationDepth++;
+	#endif
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      E3Memory_EndPoolAllocation : Finish allocating from an instance pool.
+//-----------------------------------------------------------------------------
+//		Note :	theSize is the size of the item handed out, or 0 if the pool
+//				could not allocate one.
+//-----------------------------------------------------------------------------
+#if Q3_DEBUG
+void
+E3Memory_EndPoolAllocation( TQ3Uns32 theSize )
+{
+	#if Q3_MEMORY_DEBUG
+		// Leave the pool
+		Q3_ASSERT( sPoolAllocationDepth != 0 );
+		sPoolAllocationDepth--;
+
+
+		// Profile the item as if it came from the heap
+		if (sIsProfiling && theSize != 0)
+			e3memory_profile_allocation( theSize );
+	#else
+		#pragma unused( theSize )
+	#endif
+}
+#endif
+
+
+
+
+
 //=============================================================================
 //      E3SlabMemory_New : Create a new memory slab object.
 //-----------------------------------------------------------------------------
@@ -94,6 +94,13 @@ TQ3Object	E3Memory_NextRecordedObject( TQ3Object inObject );
 TQ3Status	E3Memory_DumpRecording( const char* fileName, const char* memo );
 TQ3Boolean	E3Memory_IsValidBlock( void *thePtr );
 TQ3Status	E3Memory_GetStatistics( TQ3MemoryStatistics* info );
+TQ3Status	E3Memory_StartProfiling( TQ3Uns32 sampleInterval );
+TQ3Status	E3Memory_StopProfiling( void );
+TQ3Status	E3Memory_DumpProfile( const char* fileName, TQ3Boolean countCalls );
+void		E3Memory_PushProfileClass( TQ3ObjectType theType );
+void		E3Memory_PopProfileClass( void );
+void		E3Memory_BeginPoolAllocation( void );
+void		E3Memory_EndPoolAllocation( TQ3Uns32 theSize );
 #endif
 
 TQ3SlabObject E3SlabMemory_New(TQ3Uns32 itemSize, TQ3Uns32 numItems, const void *itemData);
@@ -113,5 +120,36 @@ TQ3Status     E3SlabMemory_SetCount(  TQ3SlabObject theSlab, TQ3Uns32 numItems);
 }
 #endif
 
+
+
+
+
+//=============================================================================
+//      Allocation profiler scope
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+
+// Attributes allocations made during its lifetime to a class, when the
+// allocation profiler is active. Compiles to nothing in non-debug builds.
+class E3MemoryProfileScope
+	{
+public :
+#if Q3_DEBUG
+	explicit				E3MemoryProfileScope ( TQ3ObjectType theType )
+								{ E3Memory_PushProfileClass ( theType ) ; }
+							~E3MemoryProfileScope ( void )
+								{ E3Memory_PopProfileClass () ; }
+#else
+	explicit				E3MemoryProfileScope ( TQ3ObjectType theType )
+								{ (void) theType ; }
+#endif
+
+private :
+							E3MemoryProfileScope ( const E3MemoryProfileScope& ) ;
+	E3MemoryProfileScope&	operator = ( const E3MemoryProfileScope& ) ;
+	} ;
+
+#endif
+
 #endif
 
@@ -104,6 +104,18 @@ struct TQ3WindowRectPickSpecificData
 	TQ3Area		rect;
 };
 
+struct E3PickRayBatch
+{
+	std::vector<TQ3Ray3D>		rays;
+	std::vector<TQ3Uns32>		rayHits;		// index of the hit of each ray, or kQ3ArrayIndexNULL
+	std::vector<float>			rayDistances;	// distance of the hit of each ray
+	std::vector<TQ3Uns32>		allRays;		// indices of every ray
+	const TQ3Uns32*				activeRays;		// indices of the rays being submitted
+	TQ3Uns32					numActiveRays;
+	TQ3Uns32					currentRay;		// ray being tested on its own, or kQ3ArrayIndexNULL
+	TQ3Ray3D					savedRay;		// world ray of the pick while currentRay is set
+};
+
 
 struct TQ3PickBaseData
 {
@@ -113,6 +125,9 @@ struct TQ3PickBaseData
 	float								vertexTolerance;
 	float								edgeTolerance;
 	float								faceTolerance;
+	TQ3Boolean							hasClosestHit;		// pickHits holds just the closest hit
+	float								closestDistance;	// distance of that hit
+	TQ3Point3D							closestFrom;		// point that distance was measured from
 };
 
 
@@ -167,15 +182,29 @@ public :
 	
 
 
-class E3WorldRayPick : public E3Pick  // This is a leaf class so no other classes use this,
+class E3WorldRayPick : public E3Pick  // This is not a leaf class, but only classes in this,
+								// file inherit from it, so it can be declared here in
+								// the .c file rather than in the .h file, hence all
+								// the fields can be public as nobody should be
+								// including this file.
+{
+Q3_CLASS_ENUMS ( kQ3PickTypeWorldRay, E3WorldRayPick, E3Pick )
+public :
+
+	TQ3WorldRayPickSpecificData			instanceData ;
+} ;
+	
+
+
+class E3WorldRayBatchPick : public E3WorldRayPick  // This is a leaf class so no other classes use this,
 								// so it can be here in the .c file rather than in
 								// the .h file, hence all the fields can be public
 								// as nobody should be including this file
 {
-Q3_CLASS_ENUMS ( kQ3PickTypeWorldRay, E3WorldRayPick, E3Pick )
+Q3_CLASS_ENUMS ( kQ3PickTypeWorldRayBatch, E3WorldRayBatchPick, E3WorldRayPick )
 public :
 
-	TQ3WorldRayPickSpecificData			instanceData ;
+	E3PickRayBatch*						batchData ;
 } ;
 	
 
@@ -317,6 +346,129 @@ e3pick_hit_duplicate_path(TQ3HitPath *pickedPath, TQ3HitPath *newPath)
 
 
 
+//=============================================================================
+//      e3pick_get_distance_from : Get the point hit distances are measured from.
+//-----------------------------------------------------------------------------
+//		Note :	World ray picks measure from the origin of the ray, and other
+//				picks measure from the camera.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_get_distance_from(TQ3PickObject thePick, TQ3ViewObject theView, TQ3Point3D *distanceFrom)
+{	TQ3CameraPlacement		cameraPlacement;
+	TQ3CameraObject			theCamera;
+	TQ3Status				qd3dStatus;
+	TQ3Ray3D				pickRay;
+
+
+
+	// Use the ray origin for world ray picks
+	if (Q3Pick_GetType( thePick ) == kQ3PickTypeWorldRay)
+		{
+		qd3dStatus = Q3WorldRayPick_GetRay( thePick, &pickRay );
+		if (qd3dStatus == kQ3Success)
+			*distanceFrom = pickRay.origin;
+		return(qd3dStatus);
+		}
+
+
+
+	// And the camera location for anything else
+	qd3dStatus = Q3View_GetCamera(theView, &theCamera);
+	if (qd3dStatus == kQ3Success)
+		{
+		qd3dStatus = Q3Camera_GetPlacement(theCamera, &cameraPlacement);
+		if (qd3dStatus == kQ3Success)
+			*distanceFrom = cameraPlacement.cameraLocation;
+
+		Q3Object_Dispose(theCamera);
+		}
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_is_closest_hit_only : Does a pick only keep its closest hit?
+//-----------------------------------------------------------------------------
+//		Note :	A pick which returns a single hit sorted near to far will only
+//				ever report the nearest hit, so there is no need to keep any
+//				others.
+//-----------------------------------------------------------------------------
+static bool
+e3pick_is_closest_hit_only(const TQ3PickBaseData *instanceData)
+{
+	return (instanceData->commonData.numHitsToReturn == 1 &&
+			instanceData->commonData.sort == kQ3PickSortNearToFar);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_access_batch : Get the rays of a batch pick.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr if the pick is not a batch pick.
+//-----------------------------------------------------------------------------
+static E3PickRayBatch *
+e3pick_access_batch(TQ3PickObject thePick)
+{
+	if (thePick->GetLeafType() != kQ3PickTypeWorldRayBatch)
+		return(nullptr);
+
+	return(((E3WorldRayBatchPick*) thePick)->batchData);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_batch_fix_data : Fix the common data of a batch pick.
+//-----------------------------------------------------------------------------
+//		Note :	A batch pick keeps one hit per ray, in the order the rays were
+//				first hit, and the hit indices it hands out would be upset by
+//				sorting or clamping the hit list.
+//-----------------------------------------------------------------------------
+static void
+e3pick_batch_fix_data(TQ3PickData *pickData)
+{
+	pickData->sort            = kQ3PickSortNone;
+	pickData->numHitsToReturn = kQ3ReturnAllHits;
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_batch_set_rays : Set the rays of a batch pick.
+//-----------------------------------------------------------------------------
+//		Note :	May throw std::bad_alloc, unless numRays is 0.
+//-----------------------------------------------------------------------------
+static void
+e3pick_batch_set_rays(E3PickRayBatch *theBatch, TQ3Uns32 numRays, const TQ3Ray3D *theRays)
+{
+	theBatch->rays.assign( theRays, theRays + numRays );
+	theBatch->rayHits.assign( numRays, kQ3ArrayIndexNULL );
+	theBatch->rayDistances.assign( numRays, 0.0f );
+	theBatch->allRays.resize( numRays );
+
+	for (TQ3Uns32 n = 0; n < numRays; ++n)
+		theBatch->allRays[n] = n;
+
+	theBatch->activeRays    = theBatch->allRays.data();
+	theBatch->numActiveRays = numRays;
+	theBatch->currentRay    = kQ3ArrayIndexNULL;
+}
+
+
+
+
+
 //=============================================================================
 //      e3pick_hit_initialise : Initialise a TQ3PickHit.
 //-----------------------------------------------------------------------------
@@ -330,14 +482,12 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 						TQ3ShapePartObject		hitShape,
 						const TQ3Param3D*		hitBarycentric,
 						TQ3Uns32				hitFaceIndex )
-{	TQ3CameraPlacement		cameraPlacement;
-	TQ3HitPath				*currentPath;
+{	TQ3HitPath				*currentPath;
 	TQ3Status				qd3dStatus;
-	TQ3CameraObject			theCamera;
 	TQ3Vector3D				eyeVector = { 0.0f, 0.0f, 0.0f };
+	TQ3Point3D				distanceFrom;
 	TQ3PickData				pickData;
 	TQ3ObjectType			theType;
-	TQ3Ray3D				pickRay;
 
 
 
@@ -408,22 +558,9 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 	// Save the distance to the viewer
 	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskDistance) && hitXYZ != nullptr)
 		{
-		if (Q3Pick_GetType( thePick ) == kQ3PickTypeWorldRay)
-			{
-			Q3WorldRayPick_GetRay( thePick, &pickRay );
-			Q3Point3D_Subtract(hitXYZ, &pickRay.origin, &eyeVector);
-			}
-		else
-			{
-			qd3dStatus = Q3View_GetCamera(theView, &theCamera);
-			if (qd3dStatus == kQ3Success)
-				{
-				Q3Camera_GetPlacement(theCamera, &cameraPlacement);
-				Q3Point3D_Subtract(hitXYZ, &cameraPlacement.cameraLocation, &eyeVector);
-				Q3Object_Dispose(theCamera);
+		if (e3pick_get_distance_from(thePick, theView, &distanceFrom) == kQ3Success)
+			Q3Point3D_Subtract(hitXYZ, &distanceFrom, &eyeVector);
 
-				}
-			}
 		theHit->hitDistance = Q3Vector3D_Length(&eyeVector);
 		theHit->validMask  |= kQ3PickDetailMaskDistance;
 		}
@@ -579,6 +716,145 @@ e3pick_hit_find(TQ3PickBaseData *pickInstanceData, TQ3Uns32 n)
 
 
 
+//=============================================================================
+//      e3pick_batch_record_hit : Record a hit against a batch pick.
+//-----------------------------------------------------------------------------
+//		Note :	Hits are only recorded while a single ray is being tested,
+//				and replace the previous hit of that ray if they are nearer.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_batch_record_hit(TQ3PickObject				thePick,
+						E3PickRayBatch			*theBatch,
+						TQ3ViewObject			theView,
+						const TQ3Point3D		*hitXYZ,
+						const TQ3Vector3D		*hitNormal,
+						const TQ3Param2D		*hitUV,
+						TQ3ShapePartObject		hitShape,
+						const TQ3Param3D*		hitBarycentric,
+						TQ3Uns32				hitTriMeshFaceIndex )
+{
+	TQ3PickBaseData	*instanceData = &((E3Pick*) thePick)->baseInstanceData;
+	TQ3Uns32		theRay        = theBatch->currentRay;
+
+
+
+	// Ignore the hit if we don't know which ray it belongs to
+	if (theRay == kQ3ArrayIndexNULL)
+		return(kQ3Success);
+
+
+
+	// Reject the hit if the ray already has one at least as near
+	float		hitDistance = 0.0f;
+	TQ3Uns32	hitIndex    = theBatch->rayHits[theRay];
+	
+	if (hitXYZ != nullptr)
+		hitDistance = Q3Length3D( *hitXYZ - theBatch->rays[theRay].origin );
+
+	if (hitIndex != kQ3ArrayIndexNULL && hitDistance >= theBatch->rayDistances[theRay])
+		return(kQ3Success);
+
+
+
+	try
+	{
+		// Fill out a new hit
+		std::unique_ptr<TQ3PickHit>	theHit( new TQ3PickHit );
+
+		e3pick_hit_initialise( theHit.get(), thePick, theView, hitXYZ,
+			hitNormal, hitUV, hitShape, hitBarycentric, hitTriMeshFaceIndex);
+
+
+
+		// Replace the previous hit of the ray, or add it to the end of the list
+		if (hitIndex != kQ3ArrayIndexNULL)
+		{
+			delete (*instanceData->pickHits)[hitIndex];
+			(*instanceData->pickHits)[hitIndex] = theHit.get();
+		}
+		else
+		{
+			instanceData->pickHits->push_back( theHit.get() );
+			theBatch->rayHits[theRay] = static_cast<TQ3Uns32>(instanceData->pickHits->size() - 1);
+		}
+
+		theHit.release();
+		theBatch->rayDistances[theRay] = hitDistance;
+	}
+	catch (...)
+	{
+		return(kQ3Failure);
+	}
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_batch_move_hits : Move the hits of one batch pick to another.
+//-----------------------------------------------------------------------------
+//		Note :	Each ray keeps the nearer of its two hits. Any hits which are
+//				not moved are disposed of with the source hit list.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_batch_move_hits(TQ3PickObject dstPick, E3PickRayBatch *dstBatch,
+						TQ3PickObject srcPick, E3PickRayBatch *srcBatch)
+{
+	std::vector<TQ3PickHit*>&	dstHits = *((E3Pick*) dstPick)->baseInstanceData.pickHits;
+	std::vector<TQ3PickHit*>&	srcHits = *((E3Pick*) srcPick)->baseInstanceData.pickHits;
+	TQ3Status					theStatus = kQ3Success;
+	TQ3Uns32					numRays   = static_cast<TQ3Uns32>(dstBatch->rays.size());
+
+
+
+	// Move the hit of each ray, if it is nearer than the one we have
+	try
+	{
+		for (TQ3Uns32 n = 0; n < numRays; ++n)
+		{
+			TQ3Uns32	srcIndex = srcBatch->rayHits[n];
+			TQ3Uns32	dstIndex = dstBatch->rayHits[n];
+
+			if (srcIndex == kQ3ArrayIndexNULL)
+				continue;
+
+			if (dstIndex == kQ3ArrayIndexNULL)
+			{
+				dstHits.push_back( srcHits[srcIndex] );
+				dstBatch->rayHits[n] = static_cast<TQ3Uns32>(dstHits.size() - 1);
+			}
+			else if (srcBatch->rayDistances[n] < dstBatch->rayDistances[n])
+			{
+				delete dstHits[dstIndex];
+				dstHits[dstIndex] = srcHits[srcIndex];
+			}
+			else
+				continue;
+
+			dstBatch->rayDistances[n] = srcBatch->rayDistances[n];
+			srcHits[srcIndex] = nullptr;
+		}
+	}
+	catch (...)
+	{
+		theStatus = kQ3Failure;
+	}
+
+
+
+	// Dispose of whatever is left
+	E3Pick_EmptyHitList( srcPick );
+
+	return(theStatus);
+}
+
+
+
+
+
 //=============================================================================
 //      e3pick_set_sort_mask : Set the sort mask as per QD3D.
 //-----------------------------------------------------------------------------
@@ -616,6 +892,7 @@ e3pick_new(TQ3Object theObject, void *privateData, const void *paramData)
 	instanceData->vertexTolerance = 0.0f;
 	instanceData->edgeTolerance = 0.0f;
 	instanceData->faceTolerance = 0.0f;
+	instanceData->hasClosestHit = kQ3False;
 
 	e3pick_set_sort_mask( &instanceData->commonData );
 	
@@ -860,6 +1137,89 @@ e3pick_worldray_metahandler(TQ3XMethodType methodType)
 
 
 
+#pragma mark -
+//=============================================================================
+//      e3pick_worldraybatch_new : World ray batch pick new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_worldraybatch_new(TQ3Object theObject, void *privateData, const void *paramData)
+{
+	E3PickRayBatch**					instanceData = (E3PickRayBatch **) privateData;
+	const TQ3WorldRayBatchPickData		*pickData    = (const TQ3WorldRayBatchPickData *) paramData;
+	E3Pick* parentOb = (E3Pick*) theObject;
+
+
+
+	// Initialise our instance data
+	*instanceData = nullptr;
+
+	try
+	{
+		*instanceData = new E3PickRayBatch;
+		e3pick_batch_set_rays( *instanceData, pickData->numRays, pickData->rays );
+	}
+	catch (...)
+	{
+		delete *instanceData;
+		*instanceData = nullptr;
+		return(kQ3Failure);
+	}
+
+	e3pick_batch_fix_data( &parentOb->baseInstanceData.commonData );
+	
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_delete : World ray batch pick delete method.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_delete(TQ3Object theObject, void *privateData)
+{
+	E3PickRayBatch**	instanceData = (E3PickRayBatch **) privateData;
+
+
+
+	// Dispose of our instance data
+	delete *instanceData;
+	*instanceData = nullptr;
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_metahandler : World ray batch pick metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3pick_worldraybatch_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldraybatch_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldraybatch_delete;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
 //=============================================================================
 //      e3shapepart_new : Shape part new method.
 //-----------------------------------------------------------------------------
@@ -1135,6 +1495,12 @@ E3Pick_RegisterClass(void)
 		qd3dStatus = Q3_REGISTER_CLASS (	kQ3ClassNamePickWorldRay,
 											e3pick_worldray_metahandler,
 											E3WorldRayPick ) ;
+
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3_REGISTER_CLASS_WITH_MEMBER (	kQ3ClassNamePickWorldRayBatch,
+											e3pick_worldraybatch_metahandler,
+											E3WorldRayBatchPick,
+											batchData ) ;
 	
 	//----------------------------------------------------------------------------------
 	
@@ -1192,6 +1558,7 @@ E3Pick_UnregisterClass(void)
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3ShapePartTypeMeshPart,		kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3SharedTypeShapePart,		kQ3True)) && succeeded;
 
+	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWorldRayBatch,	kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWorldRay,			kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWindowRect,		kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWindowPoint,		kQ3True)) && succeeded;
@@ -1278,6 +1645,9 @@ E3Pick_SetData(TQ3PickObject thePick, const TQ3PickData *data)
 
 	e3pick_set_sort_mask(&baseData->commonData);
 
+	if (e3pick_access_batch(thePick) != nullptr)
+		e3pick_batch_fix_data(&baseData->commonData);
+
 	return(kQ3Success);
 }
 
@@ -1438,6 +1808,13 @@ E3Pick_EmptyHitList(TQ3PickObject inPick)
 	}
 	
 	instanceData->pickHits->clear();
+	instanceData->hasClosestHit = kQ3False;
+
+
+	// Forget the hits of each ray of a batch
+	E3PickRayBatch* theBatch = e3pick_access_batch(inPick);
+	if (theBatch != nullptr)
+		std::fill( theBatch->rayHits.begin(), theBatch->rayHits.end(), kQ3ArrayIndexNULL );
 
 	return(kQ3Success);
 }
@@ -1586,6 +1963,13 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(thePick),   kQ3Failure);
 	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theView),   kQ3Failure);
 
+
+	// Batch picks keep the nearest hit of each ray
+	E3PickRayBatch* theBatch = e3pick_access_batch(inPick);
+	if (theBatch != nullptr)
+		return(e3pick_batch_record_hit( inPick, theBatch, theView, hitXYZ, hitNormal,
+										hitUV, hitShape, hitBarycentric, hitTriMeshFaceIndex ));
+
 	
 	// picks are not sorted until e3pick_hit_find is called.
 	instanceData->isSorted = false;
@@ -1610,10 +1994,30 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 	}
 	
 	
+	// If only the closest hit is wanted, reject the hit if it is no nearer
+	// than the one we already have.
+	bool		keepClosestHit = e3pick_is_closest_hit_only( instanceData );
+	float		hitDistance = 0.0f;
+	TQ3Point3D	distanceFrom;
+	
+	if (keepClosestHit)
+	{
+		keepClosestHit = (e3pick_get_distance_from( thePick, theView, &distanceFrom ) == kQ3Success);
+		if (keepClosestHit && (hitXYZ != nullptr))
+			hitDistance = Q3Length3D( *hitXYZ - distanceFrom );
+		
+		if (keepClosestHit && instanceData->hasClosestHit &&
+			(hitDistance >= instanceData->closestDistance))
+		{
+			return theStatus;
+		}
+	}
+	
+	
 	try
 	{
 		// Allocate another hit record
-		std::auto_ptr<TQ3PickHit>	theHit( new TQ3PickHit );
+		std::unique_ptr<TQ3PickHit>	theHit( new TQ3PickHit );
 
 
 
@@ -1623,13 +2027,32 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 
 
 
-		// Save the hit at the end of the list
-		instanceData->pickHits->push_back( theHit.get() );
+		// Save the hit, replacing the previous closest hit if there is one,
+		// or at the end of the list
+		if (keepClosestHit && instanceData->hasClosestHit)
+		{
+			delete (*instanceData->pickHits)[0];
+			(*instanceData->pickHits)[0] = theHit.get();
+		}
+		else
+		{
+			instanceData->pickHits->push_back( theHit.get() );
+		}
 		
 		
 		
 		// The hit is now owned by pickHits
 		theHit.release();
+
+
+
+		// And becomes the distance to beat, if the list holds nothing else
+		if (keepClosestHit && (instanceData->pickHits->size() == 1))
+		{
+			instanceData->hasClosestHit   = kQ3True;
+			instanceData->closestDistance = hitDistance;
+			instanceData->closestFrom     = distanceFrom;
+		}
 	}
 	catch (...)
 	{
@@ -1644,6 +2067,244 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 
 
 
+//=============================================================================
+//      E3Pick_NewEmptyCopy : Create a pick like another, with no hits.
+//-----------------------------------------------------------------------------
+//		Note :	Used to give each worker of a parallel traversal its own hit
+//				list, which is then moved to the original pick.
+//-----------------------------------------------------------------------------
+TQ3PickObject
+E3Pick_NewEmptyCopy(TQ3PickObject inPick)
+{
+	E3Pick* thePick = (E3Pick*) inPick;
+	TQ3PickObject newPick = nullptr;
+
+
+
+	// Create a pick of the same type
+	switch (E3Pick_GetType(inPick))
+	{
+		case kQ3PickTypeWindowPoint:
+			{
+			TQ3WindowPointPickData	pointData;
+			E3WindowPointPick_GetData(inPick, &pointData);
+			newPick = E3WindowPointPick_New(&pointData);
+			}
+			break;
+
+		case kQ3PickTypeWindowRect:
+			{
+			TQ3WindowRectPickData	rectData;
+			E3WindowRectPick_GetData(inPick, &rectData);
+			newPick = E3WindowRectPick_New(&rectData);
+			}
+			break;
+
+		case kQ3PickTypeWorldRay:
+			{
+			TQ3WorldRayPickData		rayData;
+			E3WorldRayPick_GetData(inPick, &rayData);
+
+			E3PickRayBatch* theBatch = e3pick_access_batch(inPick);
+			if (theBatch != nullptr)
+				{
+				TQ3WorldRayBatchPickData	batchData;
+				batchData.data    = rayData;
+				batchData.numRays = static_cast<TQ3Uns32>(theBatch->rays.size());
+				batchData.rays    = theBatch->rays.data();
+				newPick = E3WorldRayBatchPick_New(&batchData);
+				}
+			else
+				newPick = E3WorldRayPick_New(&rayData);
+			}
+			break;
+
+		default:
+			Q3_ASSERT(!"Unknown pick type");
+			break;
+	}
+
+
+
+	// Copy the tolerances, which the data for some types leaves out
+	if (newPick != nullptr)
+	{
+		TQ3PickBaseData	*newData = &((E3Pick*) newPick)->baseInstanceData;
+
+		newData->vertexTolerance = thePick->baseInstanceData.vertexTolerance;
+		newData->edgeTolerance   = thePick->baseInstanceData.edgeTolerance;
+		newData->faceTolerance   = thePick->baseInstanceData.faceTolerance;
+	}
+
+	return newPick;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_MoveHits : Move the hits of one pick to the end of another.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Pick_MoveHits(TQ3PickObject dstPick, TQ3PickObject srcPick)
+{
+	TQ3PickBaseData	*dstData = &((E3Pick*) dstPick)->baseInstanceData;
+	TQ3PickBaseData	*srcData = &((E3Pick*) srcPick)->baseInstanceData;
+	TQ3Status		theStatus = kQ3Success;
+
+
+
+	// Move the hits, which are then owned by the destination
+	if (srcData->pickHits->empty())
+		return theStatus;
+
+	E3PickRayBatch* dstBatch = e3pick_access_batch(dstPick);
+	E3PickRayBatch* srcBatch = e3pick_access_batch(srcPick);
+	if (dstBatch != nullptr && srcBatch != nullptr && dstBatch->rays.size() == srcBatch->rays.size())
+		return(e3pick_batch_move_hits( dstPick, dstBatch, srcPick, srcBatch ));
+
+	bool keepClosestHit = e3pick_is_closest_hit_only( dstData ) &&
+							(srcData->hasClosestHit == kQ3True) &&
+							(dstData->hasClosestHit == kQ3True || dstData->pickHits->empty());
+
+	try
+	{
+		dstData->pickHits->insert( dstData->pickHits->end(),
+			srcData->pickHits->begin(), srcData->pickHits->end() );
+		srcData->pickHits->clear();
+		dstData->isSorted = false;
+	}
+	catch (...)
+	{
+		theStatus = kQ3Failure;
+	}
+
+
+
+	// If the destination only keeps its closest hit, keep the nearer one
+	if (theStatus == kQ3Success && keepClosestHit)
+	{
+		std::vector<TQ3PickHit*>& theHits = *dstData->pickHits;
+		if (theHits.size() == 1 || srcData->closestDistance < dstData->closestDistance)
+		{
+			std::swap( theHits.front(), theHits.back() );
+			dstData->closestDistance = srcData->closestDistance;
+			dstData->closestFrom     = srcData->closestFrom;
+		}
+
+		if (theHits.size() == 2)
+		{
+			delete theHits.back();
+			theHits.pop_back();
+		}
+
+		dstData->hasClosestHit = kQ3True;
+	}
+
+	srcData->hasClosestHit = kQ3False;
+
+	return theStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_IsClosestHitOnly : Does a pick only keep its closest hit?
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Pick_IsClosestHitOnly(TQ3PickObject thePick)
+{
+	// Batch picks keep the closest hit of the ray being tested
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	if (theBatch != nullptr)
+		return(theBatch->currentRay != kQ3ArrayIndexNULL ? kQ3True : kQ3False);
+
+	return (e3pick_is_closest_hit_only( &((E3Pick*) thePick)->baseInstanceData ) ? kQ3True : kQ3False);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_GetClosestHitRayLimit : Get the ray parameter to test up to.
+//-----------------------------------------------------------------------------
+//		Note :	If the pick only keeps its closest hit, and has one, any point
+//				on the world ray beyond the returned parameter is at least as
+//				far away as that hit and would be rejected by E3Pick_RecordHit.
+//
+//				Hit distances are measured from the ray origin for world ray
+//				picks, and from the camera for window picks, so we project the
+//				offset between the two onto the ray to find the parameter.
+//-----------------------------------------------------------------------------
+float
+E3Pick_GetClosestHitRayLimit(TQ3PickObject thePick, const TQ3Ray3D *worldRay)
+{
+	const TQ3PickBaseData	*instanceData = &((E3Pick*) thePick)->baseInstanceData;
+	E3PickRayBatch			*theBatch     = e3pick_access_batch(thePick);
+	float					closestDistance;
+	TQ3Point3D				closestFrom;
+
+
+
+	// Nothing is out of reach until we have a hit
+	if (theBatch != nullptr)
+	{
+		if (theBatch->currentRay == kQ3ArrayIndexNULL ||
+			theBatch->rayHits[theBatch->currentRay] == kQ3ArrayIndexNULL)
+			return(kQ3MaxFloat);
+
+		closestDistance = theBatch->rayDistances[theBatch->currentRay];
+		closestFrom     = theBatch->rays[theBatch->currentRay].origin;
+	}
+	else
+	{
+		if (instanceData->hasClosestHit == kQ3False || !e3pick_is_closest_hit_only( instanceData ))
+			return(kQ3MaxFloat);
+
+		closestDistance = instanceData->closestDistance;
+		closestFrom     = instanceData->closestFrom;
+	}
+
+	float dirLength = Q3Length3D( worldRay->direction );
+	if (dirLength < kQ3RealZero)
+		return(kQ3MaxFloat);
+
+
+
+	// Find the parameter at which the ray is as far away as the closest hit
+	float originOffset = Q3Dot3D( worldRay->origin - closestFrom,
+									worldRay->direction ) / dirLength;
+
+	return((closestDistance - originOffset) / dirLength);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_IsRayBatch : Is a pick testing a batch of rays?
+//-----------------------------------------------------------------------------
+//		Note :	True for a batch pick which is not testing a single ray, in
+//				which case objects should be tested against each of its
+//				active rays.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Pick_IsRayBatch(TQ3PickObject thePick)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+
+	return((theBatch != nullptr && theBatch->currentRay == kQ3ArrayIndexNULL) ? kQ3True : kQ3False);
+}
+
+
+
+
+
 //=============================================================================
 //      E3WindowPointPick_New : Creates a new window point pick.
 //-----------------------------------------------------------------------------
@@ -1901,6 +2562,9 @@ E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data)
 
 	e3pick_set_sort_mask( & pick->baseInstanceData.commonData );
 
+	if (e3pick_access_batch(thePick) != nullptr)
+		e3pick_batch_fix_data( & pick->baseInstanceData.commonData );
+
 	return kQ3Success ;
 }
 
@@ -1908,6 +2572,234 @@ E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data)
 
 
 
+//=============================================================================
+//      E3WorldRayBatchPick_New : Creates a new world ray batch pick.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3PickObject
+E3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data)
+{
+	// Create the object
+	return E3ClassTree::CreateInstance( kQ3PickTypeWorldRayBatch, kQ3True, data );
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetNumRays : Gets the number of rays of a batch.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetNumRays(TQ3PickObject thePick, TQ3Uns32 *numRays)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	if (theBatch == nullptr)
+		return(kQ3Failure);
+
+
+
+	// Get the field
+	*numRays = static_cast<TQ3Uns32>(theBatch->rays.size());
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetRay : Gets one of the rays of a batch.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetRay(TQ3PickObject thePick, TQ3Uns32 rayIndex, TQ3Ray3D *ray)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	if (theBatch == nullptr || rayIndex >= theBatch->rays.size())
+		return(kQ3Failure);
+
+
+
+	// Get the field
+	*ray = theBatch->rays[rayIndex];
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_SetRays : Sets the rays of a batch.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_SetRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Ray3D *rays)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	if (theBatch == nullptr)
+		return(kQ3Failure);
+
+
+
+	// Empty the hit list, since it refers to the old rays
+	E3Pick_EmptyHitList(thePick);
+
+
+
+	// Set the field, leaving the batch empty if we run out of memory
+	try
+	{
+		e3pick_batch_set_rays( theBatch, numRays, rays );
+	}
+	catch (...)
+	{
+		e3pick_batch_set_rays( theBatch, 0, nullptr );
+		return(kQ3Failure);
+	}
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetHitIndex : Gets the hit of a ray of a batch.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetHitIndex(TQ3PickObject thePick, TQ3Uns32 rayIndex, TQ3Uns32 *hitIndex)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	if (theBatch == nullptr || rayIndex >= theBatch->rays.size())
+		return(kQ3Failure);
+
+
+
+	// Get the field
+	*hitIndex = theBatch->rayHits[rayIndex];
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetActiveRays : Gets the rays being submitted.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the number of active rays, and their indices through
+//				activeRays. Initially every ray of the batch is active.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3WorldRayBatchPick_GetActiveRays(TQ3PickObject thePick, const TQ3Uns32 **activeRays)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	Q3_ASSERT(theBatch != nullptr);
+
+
+
+	// Get the field
+	*activeRays = theBatch->activeRays;
+	return(theBatch->numActiveRays);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_SetActiveRays : Sets the rays being submitted.
+//-----------------------------------------------------------------------------
+//		Note :	Used by groups to submit a member with only the rays which may
+//				hit it. The indices are not copied, so the caller must restore
+//				the previous active rays before they go away.
+//-----------------------------------------------------------------------------
+void
+E3WorldRayBatchPick_SetActiveRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Uns32 *activeRays)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	Q3_ASSERT(theBatch != nullptr);
+
+
+
+	// Set the field
+	theBatch->activeRays    = activeRays;
+	theBatch->numActiveRays = numRays;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_SetCurrentRay : Sets the ray being tested.
+//-----------------------------------------------------------------------------
+//		Note :	While a single ray is being tested, the batch behaves like a
+//				world ray pick of that ray which only keeps its closest hit,
+//				and hits are recorded against that ray.
+//
+//				Passing kQ3ArrayIndexNULL returns to testing the active rays,
+//				and restores the world ray that the application set.
+//-----------------------------------------------------------------------------
+void
+E3WorldRayBatchPick_SetCurrentRay(TQ3PickObject thePick, TQ3Uns32 rayIndex)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	TQ3Ray3D&		worldRay = ((E3WorldRayPick*) thePick)->instanceData.ray;
+	Q3_ASSERT(theBatch != nullptr);
+
+
+
+	// Save or restore the application's world ray
+	if (theBatch->currentRay == kQ3ArrayIndexNULL && rayIndex != kQ3ArrayIndexNULL)
+		theBatch->savedRay = worldRay;
+
+	else if (theBatch->currentRay != kQ3ArrayIndexNULL && rayIndex == kQ3ArrayIndexNULL)
+		worldRay = theBatch->savedRay;
+
+
+
+	// Set the field, and the world ray that geometries will pick with
+	theBatch->currentRay = rayIndex;
+
+	if (rayIndex != kQ3ArrayIndexNULL)
+		worldRay = theBatch->rays[rayIndex];
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetRayLimit : Gets the ray parameter to test up to.
+//-----------------------------------------------------------------------------
+//		Note :	Any point on the ray beyond the returned parameter is at least
+//				as far away as the hit that ray already has.
+//-----------------------------------------------------------------------------
+float
+E3WorldRayBatchPick_GetRayLimit(TQ3PickObject thePick, TQ3Uns32 rayIndex)
+{
+	E3PickRayBatch* theBatch = e3pick_access_batch(thePick);
+	Q3_ASSERT(theBatch != nullptr);
+
+
+
+	// Nothing is out of reach until the ray has a hit
+	if (theBatch->rayHits[rayIndex] == kQ3ArrayIndexNULL)
+		return(kQ3MaxFloat);
+
+	float dirLength = Q3Length3D( theBatch->rays[rayIndex].direction );
+	if (dirLength < kQ3RealZero)
+		return(kQ3MaxFloat);
+
+	return(theBatch->rayDistances[rayIndex] / dirLength);
+}
+
+
+
+
+
 //=============================================================================
 //      E3ShapePart_New : Creates a new shape part.
 //		(Semi-private, no access to the 3rd party programmer)
@@ -92,6 +92,11 @@ TQ3Status				E3Pick_RecordHit(TQ3PickObject        		thePick,
 											TQ3ShapePartObject		hitShape,
 											const TQ3Param3D*		hitBarycentric = nullptr,
 											TQ3Uns32				hitTriMeshFaceIndex = kQ3ArrayIndexNULL );
+TQ3PickObject			E3Pick_NewEmptyCopy(TQ3PickObject thePick);
+TQ3Status				E3Pick_MoveHits(TQ3PickObject dstPick, TQ3PickObject srcPick);
+TQ3Boolean				E3Pick_IsClosestHitOnly(TQ3PickObject thePick);
+float					E3Pick_GetClosestHitRayLimit(TQ3PickObject thePick, const TQ3Ray3D *worldRay);
+TQ3Boolean				E3Pick_IsRayBatch(TQ3PickObject thePick);
 
 TQ3PickObject			E3WindowPointPick_New(const TQ3WindowPointPickData *data);
 TQ3Status				E3WindowPointPick_GetPoint(TQ3PickObject thePick, TQ3Point2D *point);
@@ -111,6 +116,16 @@ TQ3Status				E3WorldRayPick_SetRay(TQ3PickObject thePick, const TQ3Ray3D *ray);
 TQ3Status				E3WorldRayPick_GetData(TQ3PickObject thePick, TQ3WorldRayPickData *data);
 TQ3Status				E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data);
 
+TQ3PickObject			E3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data);
+TQ3Status				E3WorldRayBatchPick_GetNumRays(TQ3PickObject thePick, TQ3Uns32 *numRays);
+TQ3Status				E3WorldRayBatchPick_GetRay(TQ3PickObject thePick, TQ3Uns32 rayIndex, TQ3Ray3D *ray);
+TQ3Status				E3WorldRayBatchPick_SetRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Ray3D *rays);
+TQ3Status				E3WorldRayBatchPick_GetHitIndex(TQ3PickObject thePick, TQ3Uns32 rayIndex, TQ3Uns32 *hitIndex);
+TQ3Uns32				E3WorldRayBatchPick_GetActiveRays(TQ3PickObject thePick, const TQ3Uns32 **activeRays);
+void					E3WorldRayBatchPick_SetActiveRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Uns32 *activeRays);
+void					E3WorldRayBatchPick_SetCurrentRay(TQ3PickObject thePick, TQ3Uns32 rayIndex);
+float					E3WorldRayBatchPick_GetRayLimit(TQ3PickObject thePick, TQ3Uns32 rayIndex);
+
 TQ3MeshPartObject		E3MeshPart_New(const TQ3MeshComponent data);
 TQ3ObjectType			E3MeshPart_GetType(TQ3MeshPartObject meshPartObject);
 TQ3Status				E3MeshPart_GetComponent(TQ3MeshPartObject meshPartObject, TQ3MeshComponent *component);
@@ -2351,49 +2351,60 @@ E3Set::SubmitElements ( TQ3ViewObject inView )
 	{
 	TQ3Status qd3dStatus = kQ3Success ;
 
-	// Submit the elements in the set
-
+	// Submit the built-in attributes in the set
+	//
+	// When rendering, picking, or calculating bounds, the built-in attributes
+	// only update the view state, so we can set them all at once. When writing
+	// they must be submitted individually so that they reach the file format.
 	if ( setData.theMask != kQ3XAttributeMaskNone )
 		{
-		TQ3XAttributeMask mask = setData.theMask ;
-		if ( ( ( mask & kQ3XAttributeMaskSurfaceUV ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceUV, &setData.attributes.surfaceUV ) ;
+		if ( E3View_GetViewMode ( inView ) != kQ3ViewModeWriting )
+			E3View_State_SetAttributes ( inView, setData.theMask, &setData.attributes ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskShadingUV ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeShadingUV, &setData.attributes.shadingUV ) ;
+		else
+			{
+			TQ3XAttributeMask mask = setData.theMask ;
+			if ( ( ( mask & kQ3XAttributeMaskSurfaceUV ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceUV, &setData.attributes.surfaceUV ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskNormal ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeNormal, &setData.attributes.normal ) ;
+			if ( ( ( mask & kQ3XAttributeMaskShadingUV ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeShadingUV, &setData.attributes.shadingUV ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskAmbientCoefficient ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeAmbientCoefficient, &setData.attributes.ambientCoeficient ) ;
+			if ( ( ( mask & kQ3XAttributeMaskNormal ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeNormal, &setData.attributes.normal ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskDiffuseColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeDiffuseColor, &setData.attributes.diffuseColor ) ;
+			if ( ( ( mask & kQ3XAttributeMaskAmbientCoefficient ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeAmbientCoefficient, &setData.attributes.ambientCoeficient ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskSpecularColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSpecularColor, &setData.attributes.specularColor ) ;
+			if ( ( ( mask & kQ3XAttributeMaskDiffuseColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeDiffuseColor, &setData.attributes.diffuseColor ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskSpecularControl ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSpecularControl, &setData.attributes.specularControl ) ;
+			if ( ( ( mask & kQ3XAttributeMaskSpecularColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSpecularColor, &setData.attributes.specularColor ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskTransparencyColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeTransparencyColor, &setData.attributes.transparencyColor ) ;
+			if ( ( ( mask & kQ3XAttributeMaskSpecularControl ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSpecularControl, &setData.attributes.specularControl ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskEmissiveColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeEmissiveColor, &setData.attributes.emissiveColor ) ;
+			if ( ( ( mask & kQ3XAttributeMaskTransparencyColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeTransparencyColor, &setData.attributes.transparencyColor ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskSurfaceTangent ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceTangent, &setData.attributes.surfaceTangent ) ;
+			if ( ( ( mask & kQ3XAttributeMaskEmissiveColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeEmissiveColor, &setData.attributes.emissiveColor ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskHighlightState ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeHighlightState, &setData.attributes.highlightState ) ;
+			if ( ( ( mask & kQ3XAttributeMaskSurfaceTangent ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceTangent, &setData.attributes.surfaceTangent ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskSurfaceShader ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceShader, &setData.attributes.surfaceShader ) ;
+			if ( ( ( mask & kQ3XAttributeMaskHighlightState ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeHighlightState, &setData.attributes.highlightState ) ;
 
+			if ( ( ( mask & kQ3XAttributeMaskSurfaceShader ) != 0 ) && ( qd3dStatus == kQ3Success ) )
+				qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceShader, &setData.attributes.surfaceShader ) ;
+			}
 		}
 
+
+
+	// Submit any custom elements
 	if ( ( setData.theTable != nullptr ) && ( qd3dStatus == kQ3Success ) )
 		qd3dStatus = e3set_iterate_elements ( & setData, e3set_iterator_submit, &inView ) ;
 	
@@ -2725,9 +2736,9 @@ E3AttributeSet_Inherit(TQ3AttributeSet parent, TQ3AttributeSet child, TQ3Attribu
 				resultSet->setData.attributes.surfaceShader = Q3Shared_GetReference ( temp->setData.attributes.surfaceShader ) ;
 
 			// Iterate over any additional elements
-			if ( resultSet->setData.theTable != nullptr )
+			if ( temp->setData.theTable != nullptr )
 				{
-				paramInfo.theResult = parent ;
+				paramInfo.theResult = result ;
 				paramInfo.isChild   = kQ3True ;
 				qd3dStatus = e3set_iterate_elements ( &temp->setData , e3attributeset_iterator_inherit , &paramInfo ) ;
 				}
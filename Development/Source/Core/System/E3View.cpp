@@ -45,6 +45,7 @@
 //-----------------------------------------------------------------------------
 #include "E3Prefix.h"
 #include "E3Geometry.h"
+#include "E3Set.h"
 #include "E3Renderer.h"
 #include "E3DrawContext.h"
 #include "E3Transform.h"
@@ -52,9 +53,16 @@
 #include "E3Pick.h"
 #include "E3View.h"
 #include "E3Math_Intersect.h"
-#include "E3FastArray.h"
 #include "E3Math.h"
 
+#include <vector>
+
+#if QUESA_PARALLEL_TRAVERSAL
+	#include "E3Group.h"
+	#include "CQ3ObjectRef.h"
+	#include <thread>
+#endif
+
 
 
 
@@ -64,6 +72,11 @@
 //-----------------------------------------------------------------------------
 // Misc
 #define kApproxBoundsThreshold								12
+#define kApproxBoundsBlockSize								64
+
+
+// Parallel traversal
+#define kParallelMinChildrenPerWorker						8
 
 
 // View stack
@@ -120,10 +133,6 @@ class E3View ;
 
 // Stack data
 typedef struct TQ3ViewStackItem {
-	// Next stack item
-	struct TQ3ViewStackItem*	next;
-	
-	
 	// Stack item state
 	TQ3ViewStackState			stackState;
 	TQ3Matrix4x4				matrixLocalToWorld;
@@ -159,6 +168,57 @@ typedef struct TQ3ViewStackItem {
 } TQ3ViewStackItem;
 
 
+// Stack frame
+//
+// Pushing the stack does not copy the current state. Instead each field is
+// saved to the frame the first time it changes after the push, and popping
+// the stack restores only the fields which were saved.
+typedef struct TQ3ViewStackFrame {
+	// Next stack frame
+	struct TQ3ViewStackFrame*	next;
+
+
+	// Saved state
+	TQ3ViewStackState			savedState;			// fields held in savedItem
+	TQ3ViewStackState			stackState;			// stackState of the current item at the push
+	TQ3ViewStackItem			savedItem;
+} TQ3ViewStackFrame;
+
+
+// Compiled command list
+//
+// Records each geometry submitted within a display group, together with its
+// transform relative to the group and the view state it was drawn with. The
+// list holds references to the geometries and to the objects in each state.
+//
+// Lists can be recorded inside each other, for a compiled group within a
+// compiled group or a recorded pass. Each geometry goes into every list being
+// recorded.
+class E3ViewCommandList
+{
+public:
+	struct Command
+	{
+		TQ3Matrix4x4		localToGroup;		// local-to-world, relative to the group
+		TQ3Object			theGeometry;
+		TQ3Uns32			stateIndex;			// index into theStates
+		TQ3ViewStackState	stateChange;		// state changed since the previous command
+		bool				isSameMatrix;		// localToGroup unchanged since the previous command
+	};
+
+								E3ViewCommandList( void );
+								~E3ViewCommandList( void );
+
+	TQ3ViewStackItem			entryState;			// view state when the group was entered
+	TQ3Matrix4x4				worldToGroup;		// inverse of the entry local-to-world
+	std::vector<TQ3ViewStackItem>	theStates;
+	std::vector<Command>		theCommands;
+	E3ViewCommandList*			parentList;			// list being recorded when this one started
+	TQ3Boolean					savedGroupCulling;	// allowGroupCulling when this one started
+	bool						isValid;			// everything drawn could be recorded
+};
+
+
 // View data
 typedef struct TQ3ViewData {
 	// View state
@@ -170,15 +230,30 @@ typedef struct TQ3ViewData {
 	TQ3AttributeSet				viewAttributes;
 	TQ3AttributeSet				stateAttributes;	// needed for E3View_GetAttributeState
 	TQ3Boolean					allowGroupCulling;
+	TQ3ViewObject				groupBoundsView;
+	TQ3Boolean					boundsSkipSubdivision;	// leave out subdivided geometries
+	TQ3Boolean					boundsUseSubdivision;	// bounds depend on the subdivision style
+	TQ3Uns32					numGeometriesSubmitted;	// counted from the start of the frame
+	TQ3Uns32					numGeometriesCulled;
+
+
+	// Command list recording
+	E3ViewCommandList*			recordingList;
+	TQ3Uns32					recordingSuspendCount;
+	TQ3Boolean					isRecordingPass;
+	TQ3Uns32					lastFramePassCount;
 
 
 	// View stack
 	TQ3ViewStackItem			*viewStack;
-	TQ3ViewStackItem			*viewStackFreeList;
+	TQ3ViewStackItem			viewStackItem;
+	TQ3ViewStackFrame			*viewStackFrames;
+	TQ3ViewStackFrame			*viewStackFreeList;
 	// Note: The renderer may cache pointers into the TQ3ViewStackItem, so the
-	// TQ3ViewStackItem should never move.  This is why we use a linked list
-	// rather than something like std::vector.  We keep a free list instead of
-	// freeing popped records, just to reduce memory allocations and frees.
+	// current state is always held in viewStackItem, and viewStack points to
+	// it while the stack is non-empty. Pushes are recorded as frames in a
+	// linked list, and we keep a free list instead of freeing popped frames,
+	// just to reduce memory allocations and frees.
 
 
 	// Bounds state
@@ -186,7 +261,6 @@ typedef struct TQ3ViewData {
 	TQ3BoundingBox				boundingBox;
 	TQ3SlabObject				boundingPointsSlab;
 	TQ3BoundingSphere			boundingSphere;
-	E3FastArray<TQ3Point3D>*	boundingPointsArray;
 	
 	
 	// Derived cached matrices
@@ -290,6 +364,29 @@ public :
 	
 
 
+#if QUESA_PARALLEL_TRAVERSAL
+// A child of a group being traversed in parallel
+struct E3ViewParallelChild
+	{
+	TQ3GroupPosition			thePosition ;
+	CQ3ObjectRef				theObject ;
+	} ;
+
+
+// A worker of a parallel traversal, which submits a run of the children of
+// the group to a view of its own
+struct E3ViewParallelWorker
+	{
+	TQ3ViewObject				theView ;
+	TQ3PickObject				thePick ;
+	TQ3GroupObject				theGroup ;
+	const E3ViewParallelChild*	firstChild ;
+	const E3ViewParallelChild*	endChild ;
+	} ;
+#endif
+
+
+
 //=============================================================================
 //      Internal functions
 //-----------------------------------------------------------------------------
@@ -311,7 +408,6 @@ e3view_stack_initialise(TQ3ViewStackItem *theItem)
 	Q3Matrix4x4_SetIdentity( &theItem->matrixLocalToCamera );
 	Q3Matrix4x4_SetIdentity(&theItem->matrixCameraToFrustum);
 
-	theItem->next					 = nullptr;
 	theItem->stackState				 = kQ3ViewStateNone;
 	theItem->shaderIllumination		 = Q3NULLIllumination_New();
 	theItem->shaderSurface			 = nullptr;
@@ -563,11 +659,190 @@ e3view_stack_update ( E3View* view, TQ3ViewStackState stateChange )
 
 
 
+//=============================================================================
+//      e3view_stack_fields : Apply a macro to each non-matrix field.
+//-----------------------------------------------------------------------------
+//		Note :	The shared objects are not included, since they need their
+//				reference counts adjusting as they are saved and restored.
+//-----------------------------------------------------------------------------
+#define E3VIEW_STACK_FIELDS(_macro)												\
+	_macro( styleBackfacing,				kQ3ViewStateStyleBackfacing ) ;				\
+	_macro( styleInterpolation,				kQ3ViewStateStyleInterpolation ) ;			\
+	_macro( styleFill,						kQ3ViewStateStyleFill ) ;					\
+	_macro( styleSubdivision,				kQ3ViewStateStyleSubdivision ) ;			\
+	_macro( styleOrientation,				kQ3ViewStateStyleOrientation ) ;			\
+	_macro( styleCastShadows,				kQ3ViewStateStyleCastShadows ) ;			\
+	_macro( styleReceiveShadows,			kQ3ViewStateStyleReceiveShadows ) ;			\
+	_macro( stylePickID,					kQ3ViewStateStylePickID ) ;					\
+	_macro( stylePickParts,					kQ3ViewStateStylePickParts ) ;				\
+	_macro( styleAntiAlias,					kQ3ViewStateStyleAntiAlias ) ;				\
+	_macro( styleFog,						kQ3ViewStateStyleFog ) ;					\
+	_macro( styleLineWidth,					kQ3ViewStateStyleLineWidth ) ;				\
+	_macro( attributeSurfaceUV,				kQ3ViewStateAttributeSurfaceUV ) ;			\
+	_macro( attributeShadingUV,				kQ3ViewStateAttributeShadingUV ) ;			\
+	_macro( attributeNormal,				kQ3ViewStateAttributeNormal ) ;				\
+	_macro( attributeAmbientCoefficient,	kQ3ViewStateAttributeAmbientCoefficient ) ;	\
+	_macro( attributeDiffuseColor,			kQ3ViewStateAttributeDiffuseColour ) ;		\
+	_macro( attributeSpecularColor,			kQ3ViewStateAttributeSpecularColour ) ;		\
+	_macro( attributeSpecularControl,		kQ3ViewStateAttributeSpecularControl ) ;	\
+	_macro( attributeTransparencyColor,		kQ3ViewStateAttributeTransparencyColour ) ;	\
+	_macro( attributeEmissiveColor,			kQ3ViewStateAttributeEmissiveColor ) ;		\
+	_macro( attributeSurfaceTangent,		kQ3ViewStateAttributeSurfaceTangent ) ;		\
+	_macro( attributeHighlightState,		kQ3ViewStateAttributeHighlightState )
+
+
+
+
+
+//=============================================================================
+//      e3view_stack_save_fields : Save fields of the current stack item.
+//-----------------------------------------------------------------------------
+//		Note :	The frame takes its own references to the shared objects, which
+//				are handed back to the current item when the frame is restored.
+//
+//				The matrices depend on each other, so they are always saved
+//				together.
+//-----------------------------------------------------------------------------
+static void
+e3view_stack_save_fields ( TQ3ViewStackFrame* theFrame, const TQ3ViewStackItem* theItem, TQ3ViewStackState theFields )
+	{
+	TQ3ViewStackItem* savedItem = &theFrame->savedItem ;
+
+
+
+	// Save the matrices
+	if ( ( theFields & kQ3ViewStateMatrixAny ) != kQ3ViewStateNone )
+		{
+		savedItem->matrixLocalToWorld    = theItem->matrixLocalToWorld ;
+		savedItem->matrixWorldToCamera   = theItem->matrixWorldToCamera ;
+		savedItem->matrixLocalToCamera   = theItem->matrixLocalToCamera ;
+		savedItem->matrixCameraToFrustum = theItem->matrixCameraToFrustum ;
+		theFields |= kQ3ViewStateMatrixAny ;
+		}
+
+
+
+	// Save the shared objects
+	if ( ( theFields & kQ3ViewStateShaderIllumination ) != kQ3ViewStateNone )
+		E3Shared_Acquire ( &savedItem->shaderIllumination, theItem->shaderIllumination ) ;
+
+	if ( ( theFields & kQ3ViewStateShaderSurface ) != kQ3ViewStateNone )
+		E3Shared_Acquire ( &savedItem->shaderSurface, theItem->shaderSurface ) ;
+
+	if ( ( theFields & kQ3ViewStateStyleHighlight ) != kQ3ViewStateNone )
+		E3Shared_Acquire ( &savedItem->styleHighlight, theItem->styleHighlight ) ;
+
+
+
+	// Save everything else
+	#define E3VIEW_STACK_SAVE(_field, _state)						\
+		if ( ( theFields & _state ) != kQ3ViewStateNone )			\
+			savedItem->_field = theItem->_field
+
+	E3VIEW_STACK_FIELDS( E3VIEW_STACK_SAVE ) ;
+
+	#undef E3VIEW_STACK_SAVE
+
+	theFrame->savedState |= theFields ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_stack_restore_fields : Restore the fields saved in a frame.
+//-----------------------------------------------------------------------------
+static void
+e3view_stack_restore_fields ( TQ3ViewStackFrame* theFrame, TQ3ViewStackItem* theItem )
+	{
+	TQ3ViewStackItem* savedItem = &theFrame->savedItem ;
+	TQ3ViewStackState theFields = theFrame->savedState ;
+
+
+
+	// Restore the matrices
+	if ( ( theFields & kQ3ViewStateMatrixAny ) != kQ3ViewStateNone )
+		{
+		theItem->matrixLocalToWorld    = savedItem->matrixLocalToWorld ;
+		theItem->matrixWorldToCamera   = savedItem->matrixWorldToCamera ;
+		theItem->matrixLocalToCamera   = savedItem->matrixLocalToCamera ;
+		theItem->matrixCameraToFrustum = savedItem->matrixCameraToFrustum ;
+		}
+
+
+
+	// Restore the shared objects, passing our references back to the item
+	if ( ( theFields & kQ3ViewStateShaderIllumination ) != kQ3ViewStateNone )
+		{
+		Q3Object_CleanDispose ( &theItem->shaderIllumination ) ;
+		theItem->shaderIllumination   = savedItem->shaderIllumination ;
+		savedItem->shaderIllumination = nullptr ;
+		}
+
+	if ( ( theFields & kQ3ViewStateShaderSurface ) != kQ3ViewStateNone )
+		{
+		Q3Object_CleanDispose ( &theItem->shaderSurface ) ;
+		theItem->shaderSurface   = savedItem->shaderSurface ;
+		savedItem->shaderSurface = nullptr ;
+		}
+
+	if ( ( theFields & kQ3ViewStateStyleHighlight ) != kQ3ViewStateNone )
+		{
+		Q3Object_CleanDispose ( &theItem->styleHighlight ) ;
+		theItem->styleHighlight   = savedItem->styleHighlight ;
+		savedItem->styleHighlight = nullptr ;
+		}
+
+
+
+	// Restore everything else
+	#define E3VIEW_STACK_RESTORE(_field, _state)					\
+		if ( ( theFields & _state ) != kQ3ViewStateNone )			\
+			theItem->_field = savedItem->_field
+
+	E3VIEW_STACK_FIELDS( E3VIEW_STACK_RESTORE ) ;
+
+	#undef E3VIEW_STACK_RESTORE
+
+	theFrame->savedState = kQ3ViewStateNone ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_stack_save : Save fields before they are changed.
+//-----------------------------------------------------------------------------
+//		Note :	Must be called before any field of the current stack item is
+//				changed, with the mask of the fields about to change. Only the
+//				first change to a field after a push needs to save anything.
+//-----------------------------------------------------------------------------
+static inline void
+e3view_stack_save ( E3View* view, TQ3ViewStackState theFields )
+	{
+	TQ3ViewStackFrame* theFrame = view->instanceData.viewStackFrames ;
+	
+	if ( theFrame != nullptr )
+		{
+		theFields &= ~theFrame->savedState ;
+		if ( theFields != kQ3ViewStateNone )
+			e3view_stack_save_fields ( theFrame, view->instanceData.viewStack, theFields ) ;
+		}
+	}
+
+
+
+
+
 //=============================================================================
 //      e3view_stack_push : Push the view state stack.
 //-----------------------------------------------------------------------------
-//		Note :	The first item is initialise to default values, and further
-//				items are cloned from the previously topmost item on the stack.
+//		Note :	The first push initialises the current item to default values.
+//
+//				Further pushes just start a new frame, which is empty until
+//				the fields of the current item start to change.
 //-----------------------------------------------------------------------------
 static TQ3Status
 e3view_stack_push ( E3View* view )
@@ -578,57 +853,44 @@ e3view_stack_push ( E3View* view )
 
 
 
-	// Grow the view stack to the hold the new item
-	TQ3ViewStackItem* newTop = nullptr;
+	// If this is the first item, initialise it
+	if ( instanceData.viewStack == nullptr )
+		{
+		Q3_ASSERT( instanceData.viewStackFrames == nullptr );
+		e3view_stack_initialise ( &instanceData.viewStackItem ) ;
+		instanceData.viewStack = &instanceData.viewStackItem ;
+		instanceData.isLocalToFrustumValid = false;
+		instanceData.isLocalToFrustumInverseValid = false;
+		return kQ3Success ;
+		}
+
+
+
+	// Otherwise grow the stack to hold a new frame
+	TQ3ViewStackFrame* newFrame = nullptr;
 	if (instanceData.viewStackFreeList != nullptr)
 	{
-		newTop = instanceData.viewStackFreeList;
+		newFrame = instanceData.viewStackFreeList;
 		instanceData.viewStackFreeList = instanceData.viewStackFreeList->next;
 	}
 	else
 	{
-		newTop = (TQ3ViewStackItem*) Q3Memory_Allocate( sizeof ( TQ3ViewStackItem ) );
-		if ( newTop == nullptr )
+		newFrame = (TQ3ViewStackFrame*) Q3Memory_Allocate( sizeof ( TQ3ViewStackFrame ) );
+		if ( newFrame == nullptr )
 		{
 			return kQ3Failure;
 		}
 	}
-	TQ3ViewStackItem* oldTop = instanceData.viewStack;
-	instanceData.viewStack = newTop;
-	
-
-	// If this is the first item, initialise it
-	if ( oldTop == nullptr )
-		{
-		e3view_stack_initialise ( newTop ) ;
-		newTop->next = oldTop ;
-		instanceData.isLocalToFrustumValid = false;
-		instanceData.isLocalToFrustumInverseValid = false;
-		}
-	
-	// Otherwise, clone what was on the top to the new top
-	else
-		{
-		// Take a copy of the state
-		Q3Memory_Copy ( oldTop, newTop, sizeof ( TQ3ViewStackItem ) ) ;
-		newTop->next = oldTop ;
-
-
-
-		// The stack state represents renderer state that has been changed since the push.
-		newTop->stackState = kQ3ViewStateNone ;
 
+	newFrame->next       = instanceData.viewStackFrames ;
+	newFrame->savedState = kQ3ViewStateNone ;
+	newFrame->stackState = instanceData.viewStack->stackState ;
+	instanceData.viewStackFrames = newFrame ;
 
 
-		// Adjust the reference counts of the shared objects. The Q3Memory_Copy will have
-		// have copied them without adjusting the reference counts, which is incorrect.
-		
-		E3Shared_Acquire ( &newTop->shaderIllumination,     oldTop->shaderIllumination ) ;
-		E3Shared_Acquire ( &newTop->shaderSurface,          oldTop->shaderSurface ) ;
-		E3Shared_Acquire ( &newTop->styleHighlight,         oldTop->styleHighlight ) ;
-		}
-
 
+	// The stack state represents renderer state that has been changed since the push.
+	instanceData.viewStack->stackState = kQ3ViewStateNone ;
 
 	return kQ3Success ;
 	}
@@ -647,50 +909,47 @@ e3view_stack_pop ( E3View* view )
 	Q3_ASSERT_VALID_PTR(view);
 	TQ3ViewData& instanceData( view->instanceData );
 	Q3_REQUIRE(Q3_VALID_PTR(instanceData.viewStack));
+	TQ3ViewStackItem* theItem = instanceData.viewStack;
 
 
 
-	// Save the state mask for the topmost item
-	TQ3ViewStackState theStateToUpdate = instanceData.viewStack->stackState;
+	// Invalidate caches
+	instanceData.isLocalToFrustumValid = false;
+	instanceData.isLocalToFrustumInverseValid = false;
 
 
 
-	// Dispose of the shared objects in the topmost item
-	Q3Object_CleanDispose ( & instanceData.viewStack->shaderIllumination );
-	Q3Object_CleanDispose ( & instanceData.viewStack->shaderSurface );
-	Q3Object_CleanDispose ( & instanceData.viewStack->styleHighlight );
+	// If this is the last item, dispose of its shared objects and empty the stack
+	TQ3ViewStackFrame* theFrame = instanceData.viewStackFrames;
+	if ( theFrame == nullptr )
+		{
+		Q3Object_CleanDispose ( & theItem->shaderIllumination );
+		Q3Object_CleanDispose ( & theItem->shaderSurface );
+		Q3Object_CleanDispose ( & theItem->styleHighlight );
+		instanceData.viewStack = nullptr;
+		return;
+		}
 
 
 
-	// Invalidate caches
-	instanceData.isLocalToFrustumValid = false;
-	instanceData.isLocalToFrustumInverseValid = false;
+	// Otherwise restore the fields saved since the push
+	TQ3ViewStackState theStateToUpdate = theItem->stackState;
+	e3view_stack_restore_fields ( theFrame, theItem );
 
 
 
-	// Shrink the stack, moving the top item to the free list
-	TQ3ViewStackItem* theItem = instanceData.viewStack;
-	instanceData.viewStack = theItem->next;
-	theItem->next = instanceData.viewStackFreeList;
-	instanceData.viewStackFreeList = theItem;
+	// Shrink the stack, moving the frame to the free list
+	instanceData.viewStackFrames = theFrame->next;
+	theFrame->next = instanceData.viewStackFreeList;
+	instanceData.viewStackFreeList = theFrame;
 
 
 
-	// Update the renderer, using the state of the previously top
-	// item as the mask indicating what's changed.
-	
-	// In so doing, the mask of changes to view state after the last push
-	// will be ORed with the mask of changes before the push.
-	
-	// One might think that the mask could be kept the same as before the
-	// push, since we are undoing those state changes.  However, with the
-	// current design, it is not quite possible, because the renderer state
-	// keeps pointers into the top of the view stack.
-	// Suppose, for instance, you push twice, then set a diffuse color, then
-	// pop twice.  On the first (inner) pop, the renderer state points at the color
-	// in the TQ3ViewStackItem created by the first (outer) push.  The second
-	// pop deletes that storage, so it had better update the renderer.
+	// Update the renderer with whatever changed since the push. The current
+	// item never moves, so any pointers the renderer holds into it stay valid,
+	// and the restored fields need not be counted as changes to the outer frame.
 	e3view_stack_update ( view, theStateToUpdate ) ;
+	theItem->stackState = theFrame->stackState;
 	}
 
 
@@ -718,147 +977,131 @@ e3view_stack_pop_clean ( E3View* view )
 
 
 //=============================================================================
-//      e3view_init_matrix_state : Initialize matrices in the view state.
+//      e3view_stack_state_diff : Find the state which differs between items.
 //-----------------------------------------------------------------------------
-static TQ3Status
-e3view_init_matrix_state( TQ3ViewObject theView )
-{
-	TQ3Matrix4x4	worldToCamera, cameraToFrustum;
-	TQ3Status		qd3dStatus;
-	E3View*			viewOb = (E3View*) theView;
-	
-	qd3dStatus = Q3Camera_GetWorldToView( viewOb->instanceData.theCamera,
-		&worldToCamera );
-		
-	if ( qd3dStatus != kQ3Failure )
-		qd3dStatus = Q3Camera_GetViewToFrustum( viewOb->instanceData.theCamera,
-			&cameraToFrustum ) ;
+//		Note :	The matrices are not compared.
+//-----------------------------------------------------------------------------
+static TQ3ViewStackState
+e3view_stack_state_diff ( const TQ3ViewStackItem* itemA, const TQ3ViewStackItem* itemB )
+	{
+	TQ3ViewStackState theChange = kQ3ViewStateNone ;
 
-	if ( qd3dStatus != kQ3Failure )
-		qd3dStatus = E3View_State_SetMatrix( theView,
-			(TQ3MatrixState) ( kQ3MatrixStateWorldToCamera | kQ3MatrixStateCameraToFrustum ),
-			nullptr, &worldToCamera, &cameraToFrustum );
-	
-	return qd3dStatus;
-}
+	#define E3VIEW_STATE_DIFF(_field, _state)											\
+		if ( memcmp( &itemA->_field, &itemB->_field, sizeof(itemA->_field) ) != 0 )	\
+			theChange |= _state
+
+	E3VIEW_STATE_DIFF( shaderIllumination,			kQ3ViewStateShaderIllumination ) ;
+	E3VIEW_STATE_DIFF( shaderSurface,				kQ3ViewStateShaderSurface ) ;
+	E3VIEW_STATE_DIFF( styleBackfacing,				kQ3ViewStateStyleBackfacing ) ;
+	E3VIEW_STATE_DIFF( styleInterpolation,			kQ3ViewStateStyleInterpolation ) ;
+	E3VIEW_STATE_DIFF( styleFill,					kQ3ViewStateStyleFill ) ;
+	E3VIEW_STATE_DIFF( styleHighlight,				kQ3ViewStateStyleHighlight ) ;
+	E3VIEW_STATE_DIFF( styleSubdivision,			kQ3ViewStateStyleSubdivision ) ;
+	E3VIEW_STATE_DIFF( styleOrientation,			kQ3ViewStateStyleOrientation ) ;
+	E3VIEW_STATE_DIFF( styleCastShadows,			kQ3ViewStateStyleCastShadows ) ;
+	E3VIEW_STATE_DIFF( styleReceiveShadows,			kQ3ViewStateStyleReceiveShadows ) ;
+	E3VIEW_STATE_DIFF( stylePickID,					kQ3ViewStateStylePickID ) ;
+	E3VIEW_STATE_DIFF( stylePickParts,				kQ3ViewStateStylePickParts ) ;
+	E3VIEW_STATE_DIFF( styleAntiAlias,				kQ3ViewStateStyleAntiAlias ) ;
+	E3VIEW_STATE_DIFF( styleFog,					kQ3ViewStateStyleFog ) ;
+	E3VIEW_STATE_DIFF( styleLineWidth,				kQ3ViewStateStyleLineWidth ) ;
+	E3VIEW_STATE_DIFF( attributeSurfaceUV,			kQ3ViewStateAttributeSurfaceUV ) ;
+	E3VIEW_STATE_DIFF( attributeShadingUV,			kQ3ViewStateAttributeShadingUV ) ;
+	E3VIEW_STATE_DIFF( attributeNormal,				kQ3ViewStateAttributeNormal ) ;
+	E3VIEW_STATE_DIFF( attributeAmbientCoefficient,	kQ3ViewStateAttributeAmbientCoefficient ) ;
+	E3VIEW_STATE_DIFF( attributeDiffuseColor,		kQ3ViewStateAttributeDiffuseColour ) ;
+	E3VIEW_STATE_DIFF( attributeSpecularColor,		kQ3ViewStateAttributeSpecularColour ) ;
+	E3VIEW_STATE_DIFF( attributeSpecularControl,	kQ3ViewStateAttributeSpecularControl ) ;
+	E3VIEW_STATE_DIFF( attributeTransparencyColor,	kQ3ViewStateAttributeTransparencyColour ) ;
+	E3VIEW_STATE_DIFF( attributeEmissiveColor,		kQ3ViewStateAttributeEmissiveColor ) ;
+	E3VIEW_STATE_DIFF( attributeSurfaceTangent,		kQ3ViewStateAttributeSurfaceTangent ) ;
+	E3VIEW_STATE_DIFF( attributeHighlightState,		kQ3ViewStateAttributeHighlightState ) ;
+
+	#undef E3VIEW_STATE_DIFF
+
+	return theChange ;
+	}
 
 
 
 
 
 //=============================================================================
-//      e3view_bounds_box_exact : Update our bounds.
+//      e3view_stack_state_retain : Copy a stack item into a command list.
 //-----------------------------------------------------------------------------
-//		Note :	We transform the vertices to world coordinates, then union them
-//				with the view bounding box.
+//		Note :	The copy holds its own references to the shared objects.
 //-----------------------------------------------------------------------------
 static void
-e3view_bounds_box_exact ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStride, const TQ3Point3D *thePoints )
-{
-	// Validate our parameters
-	Q3_ASSERT_VALID_PTR(view) ;
-	Q3_ASSERT(numPoints != 0) ;
+e3view_stack_state_retain ( TQ3ViewStackItem* dstItem, const TQ3ViewStackItem* srcItem )
+	{
+	Q3Memory_Copy ( srcItem, dstItem, sizeof ( TQ3ViewStackItem ) ) ;
+
+	E3Shared_Acquire ( &dstItem->shaderIllumination, srcItem->shaderIllumination ) ;
+	E3Shared_Acquire ( &dstItem->shaderSurface,      srcItem->shaderSurface ) ;
+	E3Shared_Acquire ( &dstItem->styleHighlight,     srcItem->styleHighlight ) ;
+	}
 
 
 
-	// Get the local to world matrix
-	const TQ3Matrix4x4* localToWorld = & view->instanceData.viewStack->matrixLocalToWorld ;
-	Q3_ASSERT_VALID_PTR(localToWorld);
 
 
-	// Make a buffer to hold transformed points.
-	if (view->instanceData.boundingPointsArray == nullptr)
+//=============================================================================
+//      e3view_stack_state_release : Release a stack item copy.
+//-----------------------------------------------------------------------------
+static void
+e3view_stack_state_release ( TQ3ViewStackItem* theItem )
 	{
-		view->instanceData.boundingPointsArray = new E3FastArray<TQ3Point3D>;
+	Q3Object_CleanDispose ( &theItem->shaderIllumination ) ;
+	Q3Object_CleanDispose ( &theItem->shaderSurface ) ;
+	Q3Object_CleanDispose ( &theItem->styleHighlight ) ;
 	}
-	E3FastArray<TQ3Point3D>& workArray( *(view->instanceData.boundingPointsArray) );
-	workArray.resizeNotPreserving( numPoints );
-	
-	
-	// Transform the points to world space.
-	E3Point3D_To3DTransformArray( thePoints, localToWorld, &workArray[0],
-		numPoints, pointStride, sizeof(TQ3Point3D) );
-	
-	
-	// Find the bounds of the points in the buffer, and union with the accumulating bounds.
-	TQ3BoundingBox thisBox;
-	E3BoundingBox_SetFromPoints3D( &thisBox, &workArray[0], numPoints, sizeof(TQ3Point3D) );
-	E3BoundingBox_Union( &thisBox, &view->instanceData.boundingBox, &view->instanceData.boundingBox );
-}
 
 
 
 
 
 //=============================================================================
-//      e3view_bounds_box_approx : Update our bounds.
+//      e3view_stack_state_apply : Apply recorded state to the top stack item.
 //-----------------------------------------------------------------------------
-//		Note :	We calculate a bounding box in local coordinates, transform the
-//				bounding box to world coordinates, then union this with the
-//				view bounding box.
+//		Note :	Everything except the matrices is replaced, and the renderer
+//				is told about the fields in stateChange.
 //-----------------------------------------------------------------------------
-static void
-e3view_bounds_box_approx ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStride, const TQ3Point3D *thePoints )
+static TQ3Status
+e3view_stack_state_apply ( E3View* view, const TQ3ViewStackItem* srcItem, TQ3ViewStackState stateChange )
 	{
-	TQ3BoundingBox		transformedBounds ;
-	TQ3BoundingBox		localBounds ;
-	TQ3Point3D			tempPoint ;
+	TQ3ViewStackItem* theItem = view->instanceData.viewStack ;
+	TQ3ViewStackItem  oldItem = *theItem ;
 
 
 
-	// Validate our parameters and state
-	Q3_ASSERT(numPoints                    != 0);
-	Q3_ASSERT(view->instanceData.boundingMethod == kQ3BoxBoundsApprox);
+	// Save the fields which will change
+	e3view_stack_save ( view, e3view_stack_state_diff ( theItem, srcItem ) ) ;
 
 
 
-	// Get the local to world matrix
-	const TQ3Matrix4x4* localToWorld = & view->instanceData.viewStack->matrixLocalToWorld ;
-	Q3_ASSERT_VALID_PTR(localToWorld);
+	// Copy the state, keeping the change mask and the matrices
+	*theItem = *srcItem ;
+	theItem->stackState            = oldItem.stackState ;
+	theItem->matrixLocalToWorld    = oldItem.matrixLocalToWorld ;
+	theItem->matrixWorldToCamera   = oldItem.matrixWorldToCamera ;
+	theItem->matrixLocalToCamera   = oldItem.matrixLocalToCamera ;
+	theItem->matrixCameraToFrustum = oldItem.matrixCameraToFrustum ;
 
 
 
-	// Calculate a bounding box in local coordinates
-	Q3BoundingBox_SetFromPoints3D ( & localBounds, thePoints, numPoints, pointStride ) ;
+	// Swap the references to the shared objects
+	theItem->shaderIllumination = oldItem.shaderIllumination ;
+	theItem->shaderSurface      = oldItem.shaderSurface ;
+	theItem->styleHighlight     = oldItem.styleHighlight ;
 
+	E3Shared_Replace ( &theItem->shaderIllumination, srcItem->shaderIllumination ) ;
+	E3Shared_Replace ( &theItem->shaderSurface,      srcItem->shaderSurface ) ;
+	E3Shared_Replace ( &theItem->styleHighlight,     srcItem->styleHighlight ) ;
 
 
-	// Transform the bounding box to world coordinates
-	Q3Point3D_Transform ( & localBounds.min, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_Set ( & transformedBounds,&tempPoint,&tempPoint,kQ3False ) ;
-		
-	Q3Point3D_Set ( & tempPoint, localBounds.min.x,localBounds.min.y,localBounds.max.z ) ;
-	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	Q3Point3D_Set ( & tempPoint, localBounds.max.x,localBounds.min.y,localBounds.max.z ) ;
-	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	Q3Point3D_Set ( & tempPoint, localBounds.max.x,localBounds.min.y,localBounds.min.z ) ;
-	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	Q3Point3D_Transform ( & localBounds.max, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	Q3Point3D_Set ( & tempPoint, localBounds.max.x,localBounds.max.y,localBounds.min.z ) ;
-	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	Q3Point3D_Set ( & tempPoint, localBounds.min.x,localBounds.max.y,localBounds.min.z ) ;
-	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	Q3Point3D_Set ( & tempPoint, localBounds.min.x,localBounds.max.y,localBounds.max.z ) ;
-	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
-	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
-	
-	
-	
 
-	// Accumulate the bounding box
-	Q3BoundingBox_Union ( & transformedBounds, & view->instanceData.boundingBox, & view->instanceData.boundingBox ) ;
+	// Update the renderer
+	return e3view_stack_update ( view, stateChange ) ;
 	}
 
 
@@ -866,12 +1109,287 @@ e3view_bounds_box_approx ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStrid
 
 
 //=============================================================================
-//      e3view_bounds_sphere_exact : Update our bounds.
+//      E3ViewCommandList::E3ViewCommandList : Constructor.
 //-----------------------------------------------------------------------------
-//		Note :	We transform the vertices to world coordinates, then union them
-//				with the view bounding sphere.
-//-----------------------------------------------------------------------------
-static void
+E3ViewCommandList::E3ViewCommandList( void )
+	: parentList( nullptr ), savedGroupCulling( kQ3True ), isValid( true )
+	{
+	Q3Memory_Clear( &entryState, sizeof(entryState) );
+	Q3Matrix4x4_SetIdentity( &worldToGroup );
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ViewCommandList::~E3ViewCommandList : Destructor.
+//-----------------------------------------------------------------------------
+E3ViewCommandList::~E3ViewCommandList( void )
+	{
+	for (std::vector<Command>::iterator i = theCommands.begin(); i != theCommands.end(); ++i)
+		Q3Object_Dispose( i->theGeometry );
+
+	for (std::vector<TQ3ViewStackItem>::iterator i = theStates.begin(); i != theStates.end(); ++i)
+		e3view_stack_state_release( &*i );
+
+	e3view_stack_state_release( &entryState );
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_commandlist_is_state : Does a class only change the view state?
+//-----------------------------------------------------------------------------
+//		Note :	Objects of these classes need not be recorded, since their
+//				effect is captured in the state recorded for each geometry.
+//-----------------------------------------------------------------------------
+static bool
+e3view_commandlist_is_state ( E3ClassInfo* theClass )
+	{
+	if ( theClass->IsType ( kQ3ShapeTypeGeometry ) )
+		return false ;
+
+	if ( theClass->IsType ( kQ3ElementTypeAttribute ) )
+		return theClass->GetType () < kQ3AttributeTypeNumTypes ;
+
+	// Only the local-to-world matrix is restored on replay, so transforms
+	// which set the camera matrices, or custom transforms which might, have
+	// to be drawn as they are
+	if ( theClass->IsType ( kQ3ShapeTypeTransform ) )
+		{
+		switch ( theClass->GetType () )
+			{
+			case kQ3TransformTypeMatrix:
+			case kQ3TransformTypeScale:
+			case kQ3TransformTypeTranslate:
+			case kQ3TransformTypeRotate:
+			case kQ3TransformTypeRotateAboutPoint:
+			case kQ3TransformTypeRotateAboutAxis:
+			case kQ3TransformTypeQuaternion:
+			case kQ3TransformTypeReset:
+				return true ;
+			
+			default:
+				return false ;
+			}
+		}
+
+	return theClass->IsType ( kQ3ShapeTypeGroup )         ||
+		   theClass->IsType ( kQ3ShapeTypeStyle )         ||
+		   theClass->IsType ( kQ3ShapeTypeShader )        ||
+		   theClass->IsType ( kQ3ShapeTypeStateOperator ) ||
+		   theClass->IsType ( kQ3SharedTypeSet ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_commandlist_record : Record a retained submit.
+//-----------------------------------------------------------------------------
+//		Note :	Geometries are added to the command list with the current
+//				view state, and we return true so that the caller can ignore
+//				anything they submit while they are drawn.
+//
+//				Any other object that can draw, rather than just change the
+//				view state, makes the list invalid.
+//-----------------------------------------------------------------------------
+static bool
+e3view_commandlist_record ( E3View* view, E3ViewCommandList* theList, E3Root* theClass, TQ3Object theObject )
+	{
+	// Check the object
+	if ( theClass->submitRenderMethod == nullptr || ! theList->isValid )
+		return false ;
+
+	if ( ! theClass->IsType ( kQ3ShapeTypeGeometry ) )
+		{
+		if ( ! e3view_commandlist_is_state ( theClass ) )
+			theList->isValid = false ;
+		return false ;
+		}
+
+
+
+	// Record the command
+	TQ3ViewStackItem* theItem = view->instanceData.viewStack ;
+	try
+		{
+		E3ViewCommandList::Command theCommand ;
+		const TQ3ViewStackItem* prevState = theList->theStates.empty() ? &theList->entryState : &theList->theStates.back() ;
+		theCommand.stateChange = e3view_stack_state_diff ( prevState, theItem ) ;
+		
+		if ( theList->theStates.empty() || theCommand.stateChange != kQ3ViewStateNone )
+			{
+			theList->theStates.push_back ( TQ3ViewStackItem() ) ;
+			e3view_stack_state_retain ( &theList->theStates.back(), theItem ) ;
+			}
+		theCommand.stateIndex = (TQ3Uns32) ( theList->theStates.size() - 1 ) ;
+
+		Q3Matrix4x4_Multiply ( &theItem->matrixLocalToWorld, &theList->worldToGroup, &theCommand.localToGroup ) ;
+		theCommand.isSameMatrix = ! theList->theCommands.empty() &&
+			memcmp ( &theCommand.localToGroup, &theList->theCommands.back().localToGroup, sizeof(TQ3Matrix4x4) ) == 0 ;
+
+		theCommand.theGeometry = Q3Shared_GetReference ( theObject ) ;
+		theList->theCommands.push_back ( theCommand ) ;
+		}
+	catch (...)
+		{
+		theList->isValid = false ;
+		}
+	
+	return true ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_init_matrix_state : Initialize matrices in the view state.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3view_init_matrix_state( TQ3ViewObject theView )
+{
+	TQ3Matrix4x4	worldToCamera, cameraToFrustum;
+	TQ3Status		qd3dStatus;
+	E3View*			viewOb = (E3View*) theView;
+	
+	qd3dStatus = Q3Camera_GetWorldToView( viewOb->instanceData.theCamera,
+		&worldToCamera );
+		
+	if ( qd3dStatus != kQ3Failure )
+		qd3dStatus = Q3Camera_GetViewToFrustum( viewOb->instanceData.theCamera,
+			&cameraToFrustum ) ;
+
+	if ( qd3dStatus != kQ3Failure )
+		qd3dStatus = E3View_State_SetMatrix( theView,
+			(TQ3MatrixState) ( kQ3MatrixStateWorldToCamera | kQ3MatrixStateCameraToFrustum ),
+			nullptr, &worldToCamera, &cameraToFrustum );
+	
+	return qd3dStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      e3view_bounds_box_exact : Update our bounds.
+//-----------------------------------------------------------------------------
+//		Note :	We transform the vertices to world coordinates, then union them
+//				with the view bounding box. The transformed vertices are
+//				reduced as they are produced, rather than being stored.
+//-----------------------------------------------------------------------------
+static void
+e3view_bounds_box_exact ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStride, const TQ3Point3D *thePoints )
+{
+	// Validate our parameters
+	Q3_ASSERT_VALID_PTR(view) ;
+	Q3_ASSERT(numPoints != 0) ;
+
+
+
+	// Get the local to world matrix
+	const TQ3Matrix4x4* localToWorld = & view->instanceData.viewStack->matrixLocalToWorld ;
+	Q3_ASSERT_VALID_PTR(localToWorld);
+
+
+
+	// Transform the points to world space, and union with the accumulating bounds
+	E3BoundingBox_UnionTransformedPoints3D( &view->instanceData.boundingBox,
+		thePoints, numPoints, pointStride, localToWorld );
+}
+
+
+
+
+
+//=============================================================================
+//      e3view_bounds_box_approx : Update our bounds.
+//-----------------------------------------------------------------------------
+//		Note :	We calculate a bounding box in local coordinates, transform the
+//				bounding box to world coordinates, then union this with the
+//				view bounding box.
+//-----------------------------------------------------------------------------
+static void
+e3view_bounds_box_approx ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStride, const TQ3Point3D *thePoints )
+	{
+	TQ3BoundingBox		transformedBounds ;
+	TQ3BoundingBox		localBounds ;
+	TQ3Point3D			tempPoint ;
+
+
+
+	// Validate our parameters and state
+	Q3_ASSERT(numPoints                    != 0);
+	Q3_ASSERT(view->instanceData.boundingMethod == kQ3BoxBoundsApprox);
+
+
+
+	// Get the local to world matrix
+	const TQ3Matrix4x4* localToWorld = & view->instanceData.viewStack->matrixLocalToWorld ;
+	Q3_ASSERT_VALID_PTR(localToWorld);
+
+
+
+	// Calculate a bounding box in local coordinates
+	Q3BoundingBox_SetFromPoints3D ( & localBounds, thePoints, numPoints, pointStride ) ;
+
+
+
+	// Transform the bounding box to world coordinates
+	Q3Point3D_Transform ( & localBounds.min, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_Set ( & transformedBounds,&tempPoint,&tempPoint,kQ3False ) ;
+		
+	Q3Point3D_Set ( & tempPoint, localBounds.min.x,localBounds.min.y,localBounds.max.z ) ;
+	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	Q3Point3D_Set ( & tempPoint, localBounds.max.x,localBounds.min.y,localBounds.max.z ) ;
+	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	Q3Point3D_Set ( & tempPoint, localBounds.max.x,localBounds.min.y,localBounds.min.z ) ;
+	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	Q3Point3D_Transform ( & localBounds.max, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	Q3Point3D_Set ( & tempPoint, localBounds.max.x,localBounds.max.y,localBounds.min.z ) ;
+	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	Q3Point3D_Set ( & tempPoint, localBounds.min.x,localBounds.max.y,localBounds.min.z ) ;
+	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	Q3Point3D_Set ( & tempPoint, localBounds.min.x,localBounds.max.y,localBounds.max.z ) ;
+	Q3Point3D_Transform ( & tempPoint, localToWorld, &tempPoint ) ;
+	Q3BoundingBox_UnionPoint3D ( & transformedBounds,&tempPoint,&transformedBounds ) ;
+	
+	
+	
+
+	// Accumulate the bounding box
+	Q3BoundingBox_Union ( & transformedBounds, & view->instanceData.boundingBox, & view->instanceData.boundingBox ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_bounds_sphere_exact : Update our bounds.
+//-----------------------------------------------------------------------------
+//		Note :	We transform the vertices to world coordinates, then union them
+//				with the view bounding sphere.
+//-----------------------------------------------------------------------------
+static void
 e3view_bounds_sphere_exact ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStride, const TQ3Point3D *thePoints )
 	{
 	// Validate our parameters and state
@@ -905,16 +1423,15 @@ e3view_bounds_sphere_exact ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStr
 //=============================================================================
 //      e3view_bounds_sphere_approx : Update our bounds.
 //-----------------------------------------------------------------------------
-//		Note :	We calculate a bounding sphere in local coordinates, transform
-//				the bounding sphere to world coordinates, then union this with
-//				the view bounding sphere.
+//		Note :	We transform the vertices to world coordinates in blocks, and
+//				grow the view bounding sphere to enclose each block with
+//				Ritter's method. Unlike the exact sphere, this needs no memory
+//				for the vertices of the whole scene.
 //-----------------------------------------------------------------------------
 static void
 e3view_bounds_sphere_approx ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointStride, const TQ3Point3D *thePoints )
 	{
-	TQ3SphericalPoint		radSpherical;
-	TQ3BoundingSphere		localBounds;
-	TQ3Point3D				radPoint;
+	TQ3Point3D		worldPoints[kApproxBoundsBlockSize] ;
 
 
 
@@ -930,29 +1447,20 @@ e3view_bounds_sphere_approx ( E3View* view, TQ3Uns32 numPoints, TQ3Uns32 pointSt
 
 
 
-	// Calculate a bounding sphere in local coordinates
-	Q3BoundingSphere_SetFromPoints3D ( & localBounds, thePoints, numPoints, pointStride ) ;
-
-
-
-	// Transform the bounding sphere origin to world coordinates
-	Q3Point3D_Transform ( & localBounds.origin, localToWorld, & localBounds.origin ) ;
-
-
-
-	// Transform the bounding sphere radius to world coordinate
-	Q3SphericalPoint_Set ( & radSpherical, localBounds.radius, 0.0f, 0.0f ) ;
-
-	Q3SphericalPoint_ToPoint3D ( & radSpherical, & radPoint ) ;
-	Q3Point3D_Transform ( & radPoint, localToWorld, & radPoint ) ;
-	Q3Point3D_ToSpherical ( & radPoint, & radSpherical ) ;
-
-	localBounds.radius = radSpherical.rho ;
+	// Accumulate the bounding sphere
+	while ( numPoints != 0 )
+		{
+		TQ3Uns32 blockSize = E3Num_Min ( numPoints, (TQ3Uns32) kApproxBoundsBlockSize ) ;
 
+		E3Point3D_To3DTransformArray ( thePoints, localToWorld, worldPoints,
+									   blockSize, pointStride, sizeof ( TQ3Point3D ) ) ;
 
+		E3BoundingSphere_UnionPoints3D ( & view->instanceData.boundingSphere,
+										 worldPoints, blockSize, sizeof ( TQ3Point3D ) ) ;
 
-	// Accumulate the bounding sphere
-	Q3BoundingSphere_Union ( & localBounds, & view->instanceData.boundingSphere, & view->instanceData.boundingSphere ) ;
+		thePoints  = (const TQ3Point3D*) ( ( (const char*) thePoints ) + blockSize * pointStride ) ;
+		numPoints -= blockSize ;
+		}
 	}
 
 
@@ -998,6 +1506,54 @@ e3view_submit_retained_error ( E3View* view, TQ3Object theObject )
 
 
 
+//=============================================================================
+//      e3view_pick_needs_rays : Must a class be picked once per ray?
+//-----------------------------------------------------------------------------
+//		Note :	While a batch pick is testing several rays at once, geometries
+//				which can't pick them all at once are picked with each of the
+//				active rays of the batch in turn. Groups and other objects are
+//				submitted once, and find their own way to the geometries.
+//-----------------------------------------------------------------------------
+static bool
+e3view_pick_needs_rays ( E3View* view, E3Root* theClass )
+	{
+	return view->instanceData.thePick != nullptr &&
+		E3Pick_IsRayBatch ( view->instanceData.thePick ) &&
+		Q3_CLASS_INFO_IS_CLASS ( theClass, E3Geometry ) &&
+		theClass->GetMethod ( kQ3XMethodTypeGeomPicksRayBatch ) == nullptr ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_submit_pick_rays : Pick an object once per ray of a batch.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3view_submit_pick_rays ( E3View* view, E3Root* theClass, TQ3ObjectType objectType,
+							TQ3Object theObject, const void* objectData )
+	{
+	TQ3PickObject thePick = view->instanceData.thePick ;
+	const TQ3Uns32* activeRays ;
+	TQ3Uns32 numRays = E3WorldRayBatchPick_GetActiveRays ( thePick, &activeRays ) ;
+	TQ3Status qd3dStatus = kQ3Success ;
+
+	for ( TQ3Uns32 n = 0 ; n < numRays && qd3dStatus == kQ3Success ; ++n )
+		{
+		E3WorldRayBatchPick_SetCurrentRay ( thePick, activeRays [ n ] ) ;
+		qd3dStatus = theClass->submitPickMethod ( view, objectType, theObject, objectData ) ;
+		}
+
+	E3WorldRayBatchPick_SetCurrentRay ( thePick, kQ3ArrayIndexNULL ) ;
+
+	return qd3dStatus ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3view_submit_retained_pick : viewMode == kQ3ViewModePicking.
 //-----------------------------------------------------------------------------
@@ -1005,6 +1561,7 @@ static TQ3Status
 e3view_submit_retained_pick ( E3View* view, TQ3Object theObject )
 	{
 	E3Root* theClass = (E3Root*) theObject->GetClass () ;
+	E3MemoryProfileScope profileScope ( theClass->GetType () ) ;
 
 	// Update the current hit target. We only do this if we are not
 	// within a decomposed object, as we want to track the object submitted by the
@@ -1017,7 +1574,13 @@ e3view_submit_retained_pick ( E3View* view, TQ3Object theObject )
 	// Call the method
 	TQ3Status qd3dStatus = kQ3Success ;
 	if ( theClass->submitPickMethod != nullptr )
-		qd3dStatus = theClass->submitPickMethod ( view, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
+		{
+		E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodPick ) ;
+		if ( e3view_pick_needs_rays ( view, theClass ) )
+			qd3dStatus = e3view_submit_pick_rays ( view, theClass, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
+		else
+			qd3dStatus = theClass->submitPickMethod ( view, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
+		}
 
 
 	// Reset the current hit target. Not strictly necessary (since we
@@ -1050,6 +1613,7 @@ e3view_submit_retained_write ( E3View* theView, TQ3Object theObject)
 	if ( theClass->submitWriteMethod == nullptr )
 		return kQ3Success ;
 		
+	E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodWrite ) ;
 	return theClass->submitWriteMethod ( theView, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
 	}
 
@@ -1071,6 +1635,7 @@ e3view_submit_retained_bounds ( E3View* theView, TQ3Object theObject )
 	if ( theClass->submitBoundsMethod == nullptr )
 		return kQ3Success ;
 	
+	E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodBounds ) ;
 	return theClass->submitBoundsMethod ( theView, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
 	}
 
@@ -1102,12 +1667,35 @@ e3view_submit_retained_render ( E3View* theView, TQ3Object theObject)
 	{
 	TQ3Status qd3dStatus = kQ3Success ;
 	E3Root* theClass = (E3Root*) theObject->GetClass () ;
+	E3MemoryProfileScope profileScope ( theClass->GetType () ) ;
+
+
+
+	// Record the object if we're compiling a command list
+	bool isRecorded = false ;
+	if ( theView->instanceData.recordingSuspendCount == 0 )
+		{
+		for ( E3ViewCommandList* theList = theView->instanceData.recordingList ; theList != nullptr ; theList = theList->parentList )
+			{
+			if ( e3view_commandlist_record ( theView, theList, theClass, theObject ) )
+				isRecorded = true ;
+			}
+		}
+
+	if ( isRecorded )
+		++theView->instanceData.recordingSuspendCount ;
 
 
 
 	// Submit the object
 	if (theClass->submitRenderMethod != nullptr)
+		{
+		E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodRender ) ;
 		qd3dStatus = theClass->submitRenderMethod ( theView, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
+		}
+
+	if ( isRecorded )
+		--theView->instanceData.recordingSuspendCount ;
 
 
 	return qd3dStatus ;
@@ -1176,7 +1764,18 @@ e3view_submit_immediate_render ( E3View* theView , TQ3ObjectType objectType , co
 	// Call the rendering submit method unless it is nullptr
 	if ( theClass->submitRenderMethod == nullptr )
 		return kQ3Success ;
-		
+
+
+	// If we're compiling a command list, we can't record immediate drawing
+	if ( theView->instanceData.recordingSuspendCount == 0 &&
+		 ! e3view_commandlist_is_state ( theClass ) )
+		{
+		for ( E3ViewCommandList* theList = theView->instanceData.recordingList ; theList != nullptr ; theList = theList->parentList )
+			theList->isValid = false ;
+		}
+		
+	E3MemoryProfileScope profileScope ( objectType ) ;
+	E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodRender ) ;
 	return theClass->submitRenderMethod ( theView, objectType, nullptr, objectData ) ;
 	}
 
@@ -1208,9 +1807,16 @@ e3view_submit_immediate_pick ( E3View* view , TQ3ObjectType objectType , const v
 		E3View_PickStack_SaveObject ( view, nullptr ) ;
 
 	// Call the method
+	E3MemoryProfileScope profileScope ( objectType ) ;
 	TQ3Status qd3dStatus ;
 	if ( theClass->submitPickMethod != nullptr )
-		qd3dStatus = theClass->submitPickMethod ( view, objectType, nullptr, objectData ) ;
+		{
+		E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodPick ) ;
+		if ( e3view_pick_needs_rays ( view, theClass ) )
+			qd3dStatus = e3view_submit_pick_rays ( view, theClass, objectType, nullptr, objectData ) ;
+		else
+			qd3dStatus = theClass->submitPickMethod ( view, objectType, nullptr, objectData ) ;
+		}
 	else
 		qd3dStatus = kQ3Success ;
 		
@@ -1247,6 +1853,7 @@ e3view_submit_immediate_write ( E3View* theView , TQ3ObjectType objectType , con
 	if ( theClass->submitWriteMethod == nullptr )
 		return kQ3Success ;
 	
+	E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodWrite ) ;
 	return theClass->submitWriteMethod ( theView, objectType, nullptr, objectData ) ;
 	}
 
@@ -1274,6 +1881,7 @@ e3view_submit_immediate_bounds ( E3View* theView , TQ3ObjectType objectType , co
 	if ( theClass->submitBoundsMethod == nullptr )
 		return kQ3Success ;
 	
+	E3ClassStatsScope statsScope ( theClass, kQ3StatsMethodBounds ) ;
 	return theClass->submitBoundsMethod ( theView, objectType, nullptr, objectData ) ;
 	}
 
@@ -1409,11 +2017,344 @@ e3view_submit_initial_state ( E3View* view)
 
 
 
-	// Submit the view attribute state, if any
-	if ( view->instanceData.viewAttributes != nullptr && qd3dStatus != kQ3Failure )
-		qd3dStatus = Q3AttributeSet_Submit ( view->instanceData.viewAttributes, view ) ;
+	// Submit the view attribute state, if any
+	if ( view->instanceData.viewAttributes != nullptr && qd3dStatus != kQ3Failure )
+		qd3dStatus = Q3AttributeSet_Submit ( view->instanceData.viewAttributes, view ) ;
+
+	return qd3dStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_submit_end : End a submit loop.
+//-----------------------------------------------------------------------------
+//		Note :	If the current view state is within a submitting a loop, the
+//				submitStatus value is used as the result of the submit loop.
+//-----------------------------------------------------------------------------
+static TQ3ViewStatus
+e3view_submit_end ( E3View* view, TQ3ViewStatus submitStatus )
+	{
+	TQ3ViewStatus		viewStatus;
+
+
+	// End the pass
+	if ( view->instanceData.viewState == kQ3ViewStateCancelled )
+		viewStatus = kQ3ViewStatusCancelled ;
+	else
+	if ( view->instanceData.viewState == kQ3ViewStateSubmitting )
+		viewStatus = submitStatus ;
+	else
+		viewStatus = kQ3ViewStatusDone ;
+
+
+
+	// Pop the view stack
+	e3view_stack_pop_clean ( view ) ;
+
+
+
+	// Handle re-traversal
+	if ( viewStatus == kQ3ViewStatusRetraverse )
+		{
+		// Restart the submit
+		view->instanceData.viewState = kQ3ViewStateSubmitting ; 
+		view->instanceData.viewPass++ ;
+		TQ3Status qd3dStatus = e3view_submit_begin ( view, view->instanceData.viewMode )  ;
+
+
+		// Invoke the start pass method		
+		if ( qd3dStatus != kQ3Failure )
+			{
+			view->instanceData.rendererFinishedFrame = kQ3False ;
+
+			if ( view->instanceData.viewMode == kQ3ViewModeDrawing)
+				{
+				e3view_init_matrix_state( view );
+				qd3dStatus = E3Renderer_Method_StartPass ( view, view->instanceData.theCamera, view->instanceData.theLights ) ;
+				}
+			else
+			if ( view->instanceData.viewMode == kQ3ViewModeWriting )
+				qd3dStatus = E3FileFormat_Method_StartPass ( view ) ;
+			}
+
+
+		// Submit the initial state
+		if ( qd3dStatus != kQ3Failure )
+			qd3dStatus = e3view_submit_initial_state ( view )  ;
+
+
+		// If something went wrong, stop
+		if ( qd3dStatus == kQ3Failure )
+			viewStatus = kQ3ViewStatusError ;
+		}
+	else
+		{
+		view->instanceData.viewState             = kQ3ViewStateInactive ;
+		view->instanceData.viewPass              = 0 ;
+		view->instanceData.submitRetainedMethod  = (TQ3XViewSubmitRetainedMethod) e3view_submit_retained_error ;
+		view->instanceData.submitImmediateMethod = (TQ3XViewSubmitImmediateMethod) e3view_submit_immediate_error ;
+
+
+		// Discard any command lists left unfinished by a failed submit
+		while ( view->instanceData.recordingList != nullptr )
+			E3View_DisposeCommandList ( E3View_EndCommandList ( view ) ) ;
+
+		view->instanceData.isRecordingPass = kQ3False ;
+		}
+
+
+
+	// Return the view status
+	return viewStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_pick_begin : Prepare to pick.
+//-----------------------------------------------------------------------------
+//		Note :	Saves a reference to the current pick object, so it can't be
+//				released during the pick.
+//
+//				If the current pick is a window point pick, recalculates the
+//				ray from the camera location through the picked pixel.
+//-----------------------------------------------------------------------------
+static void
+e3view_pick_begin ( E3View* view, TQ3PickObject thePick )
+	{
+	TQ3Matrix4x4			worldToFrustum, frustumToWindow, worldToWindow, windowToWorld;
+	TQ3Point3D				worldPoint, windowPoint3D;
+	TQ3CameraPlacement		thePlacement;
+	TQ3Point2D				windowPoint;
+	TQ3Vector3D				theVector;
+
+
+
+	// Validate our state
+	Q3_ASSERT( view->instanceData.viewMode == kQ3ViewModePicking);
+
+
+
+	// Save a reference to the pick object
+	Q3_ASSERT( view->instanceData.thePick == nullptr);
+	view->instanceData.thePick = thePick ;
+
+
+
+	// Initialise our state
+	Q3Memory_Clear(& view->instanceData.pickedPath, sizeof( view->instanceData.pickedPath)); 
+	view->instanceData.pickedObject       = nullptr;
+	view->instanceData.pickDecomposeCount = 0;
+
+
+
+	// If this is a window-point pick, recalculate the pick ray
+	Q3Memory_Clear(& view->instanceData.rayThroughPick, sizeof( view->instanceData.rayThroughPick));
+	if (Q3Pick_GetType(thePick) == kQ3PickTypeWindowPoint)
+		{
+		// Get the point that was picked, in window coordinates
+		Q3WindowPointPick_GetPoint(thePick, &windowPoint);
+
+		windowPoint3D.x = windowPoint.x;
+		windowPoint3D.y = windowPoint.y;
+		windowPoint3D.z = 0.0f;
+		
+
+
+		// Transform this point from window to world coordinates
+		Q3Camera_GetWorldToFrustum( view->instanceData.theCamera, &worldToFrustum);
+		E3View_GetFrustumToWindowMatrixState ( view, &frustumToWindow ) ;
+		Q3Matrix4x4_Multiply( &worldToFrustum, &frustumToWindow, &worldToWindow );
+		Q3Matrix4x4_Invert(&worldToWindow, &windowToWorld);
+		Q3Point3D_Transform(&windowPoint3D,  &windowToWorld, &worldPoint);
+
+
+
+		switch( Q3Camera_GetType( view->instanceData.theCamera )	)	
+			{
+		
+			case kQ3CameraTypeViewPlane:
+			case kQ3CameraTypeViewAngleAspect:
+
+				// Initialise the ray origin - the camera location
+				Q3Camera_GetPlacement( view->instanceData.theCamera, &thePlacement);
+				view->instanceData.rayThroughPick.origin = thePlacement.cameraLocation;
+
+
+
+				// Initialise the ray - from the pixel back to the camera
+				Q3Point3D_Subtract(&worldPoint,  & view->instanceData.rayThroughPick.origin, &theVector);
+				Q3Vector3D_Normalize(&theVector, & view->instanceData.rayThroughPick.direction);
+				break;
+				
+			case kQ3CameraTypeOrthographic:
+			
+				// Set origin of pick to the pick loc in world coordinates
+				Q3Camera_GetPlacement( view->instanceData.theCamera, &thePlacement);
+				view->instanceData.rayThroughPick.origin = worldPoint;
+
+
+
+				// Initialise the ray - from the pixel back to the camera
+				Q3Point3D_Subtract(&thePlacement.pointOfInterest, &thePlacement.cameraLocation, &theVector);
+				Q3Vector3D_Normalize(&theVector, & view->instanceData.rayThroughPick.direction);
+				break;
+			}
+		}
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_pick_end : End a picking loop.
+//-----------------------------------------------------------------------------
+static void
+e3view_pick_end ( E3View* view )
+	{
+	// Validate our state
+	Q3_ASSERT( view->instanceData.viewMode           == kQ3ViewModePicking ) ;
+	Q3_ASSERT( view->instanceData.pickDecomposeCount == 0 ) ;
+
+
+
+	// Forget our reference to the pick object (don't dispose of it, as picks aren't shared)
+	view->instanceData.thePick = nullptr ;
+
+
+
+	// Empty the pick path
+	Q3HitPath_EmptyData ( & view->instanceData.pickedPath ) ;
+
+
+
+	// Dispose of our reference to the picked object
+	Q3Object_CleanDispose ( & view->instanceData.pickedObject ) ;
+	}
+
+
+
+
+
+#if QUESA_PARALLEL_TRAVERSAL
+//=============================================================================
+//      e3view_parallel_can_split : Can an object be traversed on its own?
+//-----------------------------------------------------------------------------
+//		Note :	A worker only sees the view state at the start of the group,
+//				so each child must leave the state as it found it. Geometries
+//				and non-inline display groups do, but transforms, styles,
+//				attribute sets and inline groups change the state seen by the
+//				objects after them.
+//-----------------------------------------------------------------------------
+static bool
+e3view_parallel_can_split ( TQ3Object theObject )
+	{
+	if ( Q3Object_IsType ( theObject, kQ3ShapeTypeGeometry ) )
+		return true ;
+
+	if ( Q3Object_IsType ( theObject, kQ3GroupTypeDisplay ) )
+		{
+		TQ3DisplayGroupState theState ;
+		return Q3DisplayGroup_GetState ( theObject, &theState ) == kQ3Success &&
+			   ! E3Bit_AnySet ( theState, kQ3DisplayGroupStateMaskIsInline ) ;
+		}
+
+	return false ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_parallel_collect : Collect the children of a group to split.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the group should be submitted normally. We
+//				only split bounding and picking loops, which don't change the
+//				objects they traverse, and only picks at the top level of the
+//				pick path.
+//
+//				The children are collected in the order the group submits
+//				them, which need not be the order of their positions.
+//-----------------------------------------------------------------------------
+static bool
+e3view_parallel_collect ( E3View* view, TQ3GroupObject theGroup, std::vector<E3ViewParallelChild>& theChildren )
+	{
+	TQ3DisplayGroupState	theState ;
+
+
+
+	// Check the group would be submitted, and not submitted inline
+	if ( view->instanceData.viewState != kQ3ViewStateSubmitting ||
+		 ! Q3Object_IsType ( theGroup, kQ3GroupTypeDisplay ) ||
+		 Q3DisplayGroup_GetState ( theGroup, &theState ) == kQ3Failure ||
+		 E3Bit_AnySet ( theState, kQ3DisplayGroupStateMaskIsInline ) )
+		return false ;
+
+	switch ( view->instanceData.viewMode )
+		{
+		case kQ3ViewModeCalcBounds:
+			if ( E3Bit_AnySet ( theState, kQ3DisplayGroupStateMaskIsNotForBounding ) )
+				return false ;
+
+#if QUESA_AUTO_GROUP_BOUNDS
+			// The group can use its own box, which is quicker still
+			if ( view->instanceData.boundingMethod == kQ3BoxBoundsApprox &&
+				 ( (E3DisplayGroup*) theGroup )->HasCurrentAutoBoundingBox ( view ) )
+				return false ;
+#endif
+			break ;
+
+		case kQ3ViewModePicking:
+			if ( ! E3Bit_AnySet ( theState, kQ3DisplayGroupStateMaskIsPicked ) ||
+				 view->instanceData.pickedPath.depth   != 0 ||
+				 view->instanceData.pickDecomposeCount != 0 )
+				return false ;
+			break ;
+
+		default:
+			return false ;
+		}
+
+
+
+	// Collect the children, giving up if any of them can't be split off
+	E3GroupInfo* groupClass = ( (E3Group*) theGroup )->GetClass () ;
+	TQ3GroupPosition thePosition ;
+	TQ3Object subObject ;
+
+	TQ3Status qd3dStatus = groupClass->startIterateMethod ( theGroup, &thePosition, &subObject, view ) ;
+	while ( qd3dStatus != kQ3Failure && subObject != nullptr )
+		{
+		if ( ! e3view_parallel_can_split ( subObject ) )
+			{
+			Q3Object_Dispose ( subObject ) ;
+			return false ;
+			}
+
+		try
+			{
+			E3ViewParallelChild theChild ;
+			theChild.thePosition = thePosition ;
+			theChild.theObject   = CQ3ObjectRef ( Q3Shared_GetReference ( subObject ) ) ;
+			theChildren.push_back ( std::move ( theChild ) ) ;
+			}
+		catch (...)
+			{
+			Q3Object_Dispose ( subObject ) ;
+			return false ;
+			}
+
+		qd3dStatus = groupClass->endIterateMethod ( theGroup, &thePosition, &subObject, view ) ;
+		}
 
-	return qd3dStatus ;
+	return qd3dStatus != kQ3Failure ;
 	}
 
 
@@ -1421,79 +2362,72 @@ e3view_submit_initial_state ( E3View* view)
 
 
 //=============================================================================
-//      e3view_submit_end : End a submit loop.
+//      e3view_parallel_start : Start the loop of a parallel worker.
 //-----------------------------------------------------------------------------
-//		Note :	If the current view state is within a submitting a loop, the
-//				submitStatus value is used as the result of the submit loop.
+//		Note :	The worker's view starts the same kind of loop as our own, and
+//				carries on from our current state.
 //-----------------------------------------------------------------------------
-static TQ3ViewStatus
-e3view_submit_end ( E3View* view, TQ3ViewStatus submitStatus )
+static TQ3Status
+e3view_parallel_start ( E3View* view, E3ViewParallelWorker* theWorker )
 	{
-	TQ3ViewStatus		viewStatus;
-
-
-	// End the pass
-	if ( view->instanceData.viewState == kQ3ViewStateCancelled )
-		viewStatus = kQ3ViewStatusCancelled ;
-	else
-	if ( view->instanceData.viewState == kQ3ViewStateSubmitting )
-		viewStatus = submitStatus ;
-	else
-		viewStatus = kQ3ViewStatusDone ;
+	E3View*		workerView = (E3View*) theWorker->theView ;
+	TQ3Status	qd3dStatus = kQ3Failure ;
 
 
 
-	// Pop the view stack
-	e3view_stack_pop_clean ( view ) ;
+	// Share our camera and draw context, which picks need for the pick ray.
+	// We don't use E3View_SetDrawContext, which would reset its state.
+	E3Shared_Replace ( &workerView->instanceData.theCamera,      view->instanceData.theCamera ) ;
+	E3Shared_Replace ( &workerView->instanceData.theDrawContext, view->instanceData.theDrawContext ) ;
 
 
 
-	// Handle re-traversal
-	if ( viewStatus == kQ3ViewStatusRetraverse )
+	// Start the loop
+	if ( view->instanceData.viewMode == kQ3ViewModePicking )
 		{
-		// Restart the submit
-		view->instanceData.viewState = kQ3ViewStateSubmitting ; 
-		view->instanceData.viewPass++ ;
-		TQ3Status qd3dStatus = e3view_submit_begin ( view, view->instanceData.viewMode )  ;
+		theWorker->thePick = E3Pick_NewEmptyCopy ( view->instanceData.thePick ) ;
+		if ( theWorker->thePick != nullptr )
+			qd3dStatus = E3View_StartPicking ( workerView, theWorker->thePick ) ;
+		}
+	else
+		{
+		switch ( view->instanceData.boundingMethod )
+			{
+			case kQ3BoxBoundsExact:
+				qd3dStatus = E3View_StartBoundingBox ( workerView, kQ3ComputeBoundsExact ) ;
+				break ;
 
+			case kQ3BoxBoundsApprox:
+				qd3dStatus = E3View_StartBoundingBox ( workerView, kQ3ComputeBoundsApproximate ) ;
+				break ;
 
-		// Invoke the start pass method		
-		if ( qd3dStatus != kQ3Failure )
-			{
-			view->instanceData.rendererFinishedFrame = kQ3False ;
+			case kQ3SphereBoundsExact:
+				qd3dStatus = E3View_StartBoundingSphere ( workerView, kQ3ComputeBoundsExact ) ;
+				break ;
 
-			if ( view->instanceData.viewMode == kQ3ViewModeDrawing)
-				{
-				e3view_init_matrix_state( view );
-				qd3dStatus = E3Renderer_Method_StartPass ( view, view->instanceData.theCamera, view->instanceData.theLights ) ;
-				}
-			else
-			if ( view->instanceData.viewMode == kQ3ViewModeWriting )
-				qd3dStatus = E3FileFormat_Method_StartPass ( view ) ;
+			case kQ3SphereBoundsApprox:
+				qd3dStatus = E3View_StartBoundingSphere ( workerView, kQ3ComputeBoundsApproximate ) ;
+				break ;
 			}
+		}
 
 
-		// Submit the initial state
-		if ( qd3dStatus != kQ3Failure )
-			qd3dStatus = e3view_submit_initial_state ( view )  ;
-
 
-		// If something went wrong, stop
-		if ( qd3dStatus == kQ3Failure )
-			viewStatus = kQ3ViewStatusError ;
-		}
-	else
+	// Copy our current state
+	if ( qd3dStatus != kQ3Failure )
 		{
-		view->instanceData.viewState             = kQ3ViewStateInactive ;
-		view->instanceData.viewPass              = 0 ;
-		view->instanceData.submitRetainedMethod  = (TQ3XViewSubmitRetainedMethod) e3view_submit_retained_error ;
-		view->instanceData.submitImmediateMethod = (TQ3XViewSubmitImmediateMethod) e3view_submit_immediate_error ;
-		}
+		TQ3ViewStackItem* theItem = workerView->instanceData.viewStack ;
+		TQ3ViewStackState stackState = theItem->stackState ;
 
+		e3view_stack_state_release ( theItem ) ;
+		e3view_stack_state_retain  ( theItem, view->instanceData.viewStack ) ;
+		theItem->stackState = stackState ;
 
+		workerView->instanceData.isLocalToFrustumValid        = false ;
+		workerView->instanceData.isLocalToFrustumInverseValid = false ;
+		}
 
-	// Return the view status
-	return viewStatus ;
+	return qd3dStatus ;
 	}
 
 
@@ -1501,96 +2435,105 @@ e3view_submit_end ( E3View* view, TQ3ViewStatus submitStatus )
 
 
 //=============================================================================
-//      e3view_pick_begin : Prepare to pick.
+//      e3view_parallel_submit_range : Submit the children of a worker.
 //-----------------------------------------------------------------------------
-//		Note :	Saves a reference to the current pick object, so it can't be
-//				released during the pick.
-//
-//				If the current pick is a window point pick, recalculates the
-//				ray from the camera location through the picked pixel.
+//		Note :	Runs on the worker's thread, and must only touch the worker's
+//				own view and pick.
 //-----------------------------------------------------------------------------
 static void
-e3view_pick_begin ( E3View* view, TQ3PickObject thePick )
+e3view_parallel_submit_range ( E3ViewParallelWorker* theWorker )
 	{
-	TQ3Matrix4x4			worldToFrustum, frustumToWindow, worldToWindow, windowToWorld;
-	TQ3Point3D				worldPoint, windowPoint3D;
-	TQ3CameraPlacement		thePlacement;
-	TQ3Point2D				windowPoint;
-	TQ3Vector3D				theVector;
+	TQ3ViewObject	theView   = theWorker->theView ;
+	bool			isPicking = ( theWorker->thePick != nullptr ) ;
 
 
 
-	// Validate our state
-	Q3_ASSERT( view->instanceData.viewMode == kQ3ViewModePicking);
-
+	// Submit the children as the group would, ignoring errors
+	if ( isPicking && E3View_PickStack_PushGroup ( theView, theWorker->theGroup ) == kQ3Failure )
+		return ;
 
+	for ( const E3ViewParallelChild* theChild = theWorker->firstChild ; theChild != theWorker->endChild ; ++theChild )
+		{
+		if ( isPicking )
+			E3View_PickStack_SavePosition ( theView, theChild->thePosition ) ;
 
-	// Save a reference to the pick object
-	Q3_ASSERT( view->instanceData.thePick == nullptr);
-	view->instanceData.thePick = thePick ;
+		E3View_SubmitRetained ( theView, theChild->theObject.get () ) ;
+		}
 
+	if ( isPicking )
+		E3View_PickStack_PopGroup ( theView ) ;
+	}
 
 
-	// Initialise our state
-	Q3Memory_Clear(& view->instanceData.pickedPath, sizeof( view->instanceData.pickedPath)); 
-	view->instanceData.pickedObject       = nullptr;
-	view->instanceData.pickDecomposeCount = 0;
 
 
 
-	// If this is a window-point pick, recalculate the pick ray
-	Q3Memory_Clear(& view->instanceData.rayThroughPick, sizeof( view->instanceData.rayThroughPick));
-	if (Q3Pick_GetType(thePick) == kQ3PickTypeWindowPoint)
-		{
-		// Get the point that was picked, in window coordinates
-		Q3WindowPointPick_GetPoint(thePick, &windowPoint);
+//=============================================================================
+//      e3view_parallel_finish : Merge the results of a worker.
+//-----------------------------------------------------------------------------
+//		Note :	Ends the worker's loop and disposes of its view and pick. The
+//				results are only merged into our own if shouldMerge is set.
+//-----------------------------------------------------------------------------
+static void
+e3view_parallel_finish ( E3View* view, E3ViewParallelWorker* theWorker, bool shouldMerge )
+	{
+	E3View*		workerView = (E3View*) theWorker->theView ;
 
-		windowPoint3D.x = windowPoint.x;
-		windowPoint3D.y = windowPoint.y;
-		windowPoint3D.z = 0.0f;
-		
 
 
-		// Transform this point from window to world coordinates
-		Q3Camera_GetWorldToFrustum( view->instanceData.theCamera, &worldToFrustum);
-		E3View_GetFrustumToWindowMatrixState ( view, &frustumToWindow ) ;
-		Q3Matrix4x4_Multiply( &worldToFrustum, &frustumToWindow, &worldToWindow );
-		Q3Matrix4x4_Invert(&worldToWindow, &windowToWorld);
-		Q3Point3D_Transform(&windowPoint3D,  &windowToWorld, &worldPoint);
+	// Merge the results, and end the worker's loop
+	if ( workerView != nullptr && workerView->instanceData.viewState == kQ3ViewStateSubmitting )
+		{
+		TQ3BoundingBox		theBox ;
+		TQ3BoundingSphere	theSphere ;
 
+		if ( view->instanceData.viewMode == kQ3ViewModePicking )
+			{
+			if ( shouldMerge )
+				E3Pick_MoveHits ( view->instanceData.thePick, theWorker->thePick ) ;
 
+			E3View_EndPicking ( workerView ) ;
+			}
 
-		switch( Q3Camera_GetType( view->instanceData.theCamera )	)	
+		else if ( view->instanceData.boundingMethod == kQ3BoxBoundsExact ||
+				  view->instanceData.boundingMethod == kQ3BoxBoundsApprox )
 			{
-		
-			case kQ3CameraTypeViewPlane:
-			case kQ3CameraTypeViewAngleAspect:
-
-				// Initialise the ray origin - the camera location
-				Q3Camera_GetPlacement( view->instanceData.theCamera, &thePlacement);
-				view->instanceData.rayThroughPick.origin = thePlacement.cameraLocation;
+			if ( shouldMerge )
+				E3BoundingBox_Union ( &workerView->instanceData.boundingBox,
+									  &view->instanceData.boundingBox,
+									  &view->instanceData.boundingBox ) ;
 
+			E3View_EndBoundingBox ( workerView, &theBox ) ;
+			}
 
+		else
+			{
+			// Exact spheres are fitted to all the points at once, so we take
+			// the worker's points rather than its sphere
+			TQ3SlabObject workerPoints = workerView->instanceData.boundingPointsSlab ;
+			TQ3Uns32      numPoints    = ( workerPoints != nullptr ) ? Q3SlabMemory_GetCount ( workerPoints ) : 0 ;
 
-				// Initialise the ray - from the pixel back to the camera
-				Q3Point3D_Subtract(&worldPoint,  & view->instanceData.rayThroughPick.origin, &theVector);
-				Q3Vector3D_Normalize(&theVector, & view->instanceData.rayThroughPick.direction);
-				break;
-				
-			case kQ3CameraTypeOrthographic:
-			
-				// Set origin of pick to the pick loc in world coordinates
-				Q3Camera_GetPlacement( view->instanceData.theCamera, &thePlacement);
-				view->instanceData.rayThroughPick.origin = worldPoint;
+			if ( shouldMerge && numPoints != 0 && view->instanceData.boundingPointsSlab != nullptr )
+				Q3SlabMemory_AppendData ( view->instanceData.boundingPointsSlab, numPoints,
+										  Q3SlabMemory_GetData ( workerPoints, 0 ) ) ;
 
+			if ( shouldMerge )
+				Q3BoundingSphere_Union ( &workerView->instanceData.boundingSphere,
+										 &view->instanceData.boundingSphere,
+										 &view->instanceData.boundingSphere ) ;
 
+			if ( workerPoints != nullptr )
+				Q3SlabMemory_SetCount ( workerPoints, 0 ) ;
 
-				// Initialise the ray - from the pixel back to the camera
-				Q3Point3D_Subtract(&thePlacement.pointOfInterest, &thePlacement.cameraLocation, &theVector);
-				Q3Vector3D_Normalize(&theVector, & view->instanceData.rayThroughPick.direction);
-				break;
+			E3View_EndBoundingSphere ( workerView, &theSphere ) ;
 			}
 		}
+
+
+
+	// Dispose of the worker
+	Q3Object_CleanDispose ( &theWorker->thePick ) ;
+	Q3Object_CleanDispose ( &theWorker->theView ) ;
 	}
 
 
@@ -1598,30 +2541,85 @@ e3view_pick_begin ( E3View* view, TQ3PickObject thePick )
 
 
 //=============================================================================
-//      e3view_pick_end : End a picking loop.
+//      e3view_parallel_submit : Submit the children of a group in parallel.
 //-----------------------------------------------------------------------------
-static void
-e3view_pick_end ( E3View* view )
+//		Note :	Each worker gets an equal run of the children, and the first
+//				run is submitted on this thread. Results are merged in the
+//				order of the runs, so the hits of an unsorted pick are in the
+//				same order as for a serial traversal.
+//
+//				If the workers can't be started, the group is submitted
+//				normally instead.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3view_parallel_submit ( E3View* view, TQ3GroupObject theGroup,
+						 const std::vector<E3ViewParallelChild>& theChildren, TQ3Uns32 numWorkers )
 	{
-	// Validate our state
-	Q3_ASSERT( view->instanceData.viewMode           == kQ3ViewModePicking ) ;
-	Q3_ASSERT( view->instanceData.pickDecomposeCount == 0 ) ;
+	std::vector<E3ViewParallelWorker>	theWorkers ;
+	std::vector<std::thread>			theThreads ;
+	TQ3Status							qd3dStatus = kQ3Success ;
 
 
 
-	// Forget our reference to the pick object (don't dispose of it, as picks aren't shared)
-	view->instanceData.thePick = nullptr ;
+	// Start the workers' loops
+	try
+		{
+		theWorkers.resize ( numWorkers ) ;
+		theThreads.reserve ( numWorkers - 1 ) ;
+		}
+	catch (...)
+		{
+		return E3View_SubmitRetained ( view, theGroup ) ;
+		}
 
+	TQ3Uns32 numChildren = static_cast<TQ3Uns32>( theChildren.size () ) ;
+	for ( TQ3Uns32 n = 0 ; n < numWorkers && qd3dStatus != kQ3Failure ; ++n )
+		{
+		E3ViewParallelWorker& theWorker = theWorkers[ n ] ;
+		theWorker.theView    = E3View_New () ;
+		theWorker.thePick    = nullptr ;
+		theWorker.theGroup   = theGroup ;
+		theWorker.firstChild = theChildren.data () + ( numChildren *   n       ) / numWorkers ;
+		theWorker.endChild   = theChildren.data () + ( numChildren * ( n + 1 ) ) / numWorkers ;
+
+		qd3dStatus = ( theWorker.theView != nullptr ) ? e3view_parallel_start ( view, &theWorker ) : kQ3Failure ;
+		}
 
 
-	// Empty the pick path
-	Q3HitPath_EmptyData ( & view->instanceData.pickedPath ) ;
 
+	// Run the workers, submitting a run ourselves if a thread can't be started
+	if ( qd3dStatus != kQ3Failure )
+		{
+		for ( TQ3Uns32 n = 1 ; n < numWorkers ; ++n )
+			{
+			try
+				{
+				theThreads.push_back ( std::thread ( e3view_parallel_submit_range, &theWorkers[ n ] ) ) ;
+				}
+			catch (...)
+				{
+				e3view_parallel_submit_range ( &theWorkers[ n ] ) ;
+				}
+			}
+
+		e3view_parallel_submit_range ( &theWorkers[ 0 ] ) ;
 
+		for ( std::vector<std::thread>::iterator i = theThreads.begin () ; i != theThreads.end () ; ++i )
+			i->join () ;
+		}
 
-	// Dispose of our reference to the picked object
-	Q3Object_CleanDispose ( & view->instanceData.pickedObject ) ;
+
+
+	// Merge the results and dispose of the workers
+	for ( TQ3Uns32 n = 0 ; n < numWorkers ; ++n )
+		e3view_parallel_finish ( view, &theWorkers[ n ], qd3dStatus != kQ3Failure ) ;
+
+	if ( qd3dStatus == kQ3Failure )
+		qd3dStatus = E3View_SubmitRetained ( view, theGroup ) ;
+
+	return qd3dStatus ;
 	}
+#endif
 
 
 
@@ -1785,16 +2783,22 @@ e3view_delete ( E3View* view, void *privateData )
 	Q3Object_CleanDispose(&instanceData->theDrawContext);
 	Q3Object_CleanDispose(&instanceData->defaultAttributeSet);
 	Q3Object_CleanDispose(&instanceData->boundingPointsSlab);
-	delete instanceData->boundingPointsArray;
+	Q3Object_CleanDispose(&instanceData->groupBoundsView);
+	while (instanceData->recordingList != nullptr)
+		{
+		E3ViewCommandList* theList = instanceData->recordingList;
+		instanceData->recordingList = theList->parentList;
+		delete theList;
+		}
 
 	e3view_stack_pop_clean ( view ) ;
 	
 	// Clear the free list
 	while (instanceData->viewStackFreeList != nullptr)
 	{
-		TQ3ViewStackItem* topItem = instanceData->viewStackFreeList;
+		TQ3ViewStackFrame* topFrame = instanceData->viewStackFreeList;
 		instanceData->viewStackFreeList = instanceData->viewStackFreeList->next;
-		Q3Memory_Free( &topItem );
+		Q3Memory_Free( &topFrame );
 	}
 }
 
@@ -2033,6 +3037,47 @@ E3View_SubmitRetained ( TQ3ViewObject theView , TQ3Object theObject )
 
 
 
+//=============================================================================
+//      E3View_SubmitParallel : Submit a display group to a view, splitting its
+//                              children across worker threads.
+//-----------------------------------------------------------------------------
+//		Note :	Only used for bounding and picking loops, for display groups
+//				whose children can each be traversed on their own. Otherwise
+//				the group is submitted normally.
+//
+//				Each worker starts the same kind of loop on a view of its own,
+//				from our current state. Boxes and spheres are then unioned
+//				with ours, and hits moved to our pick.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_SubmitParallel ( TQ3ViewObject theView, TQ3GroupObject theGroup, TQ3Uns32 numThreads )
+	{
+#if QUESA_PARALLEL_TRAVERSAL
+	// Use a worker per processor by default
+	if ( numThreads == 0 )
+		numThreads = std::thread::hardware_concurrency () ;
+
+
+
+	// Split the group if it's worth it
+	std::vector<E3ViewParallelChild> theChildren ;
+	if ( numThreads > 1 && e3view_parallel_collect ( (E3View*) theView, theGroup, theChildren ) )
+		{
+		TQ3Uns32 numWorkers = E3Num_Min ( numThreads, static_cast<TQ3Uns32>( theChildren.size () / kParallelMinChildrenPerWorker ) ) ;
+		if ( numWorkers > 1 )
+			return e3view_parallel_submit ( (E3View*) theView, theGroup, theChildren, numWorkers ) ;
+		}
+#else
+	#pragma unused ( numThreads )
+#endif
+
+	return E3View_SubmitRetained ( theView, theGroup ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3View_SubmitImmediate : Submit an immediate mode object to a view.
 //-----------------------------------------------------------------------------
@@ -2388,8 +3433,7 @@ E3View_UpdateBounds(TQ3ViewObject theView, TQ3Uns32 numPoints, TQ3Uns32 pointStr
 			break;
 
 		case kQ3SphereBoundsApprox:
-			e3view_bounds_sphere_exact ( (E3View*) theView, numPoints, pointStride, thePoints ) ;
-//			e3view_bounds_sphere_approx(theView, numPoints, pointStride, thePoints);
+			e3view_bounds_sphere_approx ( (E3View*) theView, numPoints, pointStride, thePoints ) ;
 			break;
 
 		default:
@@ -2853,6 +3897,7 @@ E3View_State_SetMatrix(TQ3ViewObject			theView,
 
 	// Set the matrices which have changed
 	TQ3ViewStackState stateChange = kQ3ViewStateNone;
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateMatrixAny ) ;
 	
 	if (theState & kQ3MatrixStateLocalToWorld)
 		{
@@ -2917,6 +3962,7 @@ E3View_State_SetShaderIllumination(TQ3ViewObject theView, const TQ3IlluminationS
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateShaderIllumination ) ;
 	E3Shared_Replace ( & ( (E3View*) theView )->instanceData.viewStack->shaderIllumination, theData ) ;
 
 
@@ -2944,6 +3990,7 @@ E3View_State_SetShaderSurface(	TQ3ViewObject theView, const TQ3SurfaceShaderObje
 	if ( ( (E3View*) theView )->instanceData.viewStack->shaderSurface != theData )
 		{
 		// Set the value
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateShaderSurface ) ;
 		E3Shared_Replace ( & ( (E3View*) theView )->instanceData.viewStack->shaderSurface, theData ) ;
 
 
@@ -2972,6 +4019,7 @@ E3View_State_SetStyleSubdivision(TQ3ViewObject theView, const TQ3SubdivisionStyl
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleSubdivision ) ;
 	( (E3View*) theView )->instanceData.viewStack->styleSubdivision = *theData ;
 
 
@@ -3002,6 +4050,7 @@ E3View_State_SetStylePickID(TQ3ViewObject theView, TQ3Uns32 pickID)
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStylePickID ) ;
 	( (E3View*) theView )->instanceData.viewStack->stylePickID = pickID ;
 
 
@@ -3026,6 +4075,7 @@ E3View_State_SetStylePickParts(TQ3ViewObject theView, TQ3PickParts pickParts)
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStylePickParts ) ;
 	( (E3View*) theView )->instanceData.viewStack->stylePickParts = pickParts ;
 
 
@@ -3050,6 +4100,7 @@ E3View_State_SetStyleCastShadows(TQ3ViewObject theView, TQ3Boolean castShadows)
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleCastShadows ) ;
 	( (E3View*) theView )->instanceData.viewStack->styleCastShadows = castShadows ;
 
 
@@ -3074,6 +4125,7 @@ E3View_State_SetStyleReceiveShadows(TQ3ViewObject theView, TQ3Boolean receiveSha
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleReceiveShadows ) ;
 	( (E3View*) theView )->instanceData.viewStack->styleReceiveShadows = receiveShadows;
 
 
@@ -3100,6 +4152,7 @@ E3View_State_SetStyleFill(TQ3ViewObject theView, TQ3FillStyle fillStyle)
 	if ( ( (E3View*) theView )->instanceData.viewStack->styleFill != fillStyle )
 		{
 		// Set the value
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleFill ) ;
 		( (E3View*) theView )->instanceData.viewStack->styleFill = fillStyle ;
 
 
@@ -3127,6 +4180,7 @@ E3View_State_SetStyleBackfacing(TQ3ViewObject theView, TQ3BackfacingStyle backfa
 	if ( ( (E3View*) theView )->instanceData.viewStack->styleBackfacing != backfacingStyle )
 		{
 		// Set the value
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleBackfacing ) ;
 		( (E3View*) theView )->instanceData.viewStack->styleBackfacing = backfacingStyle ;
 
 
@@ -3154,6 +4208,7 @@ E3View_State_SetStyleInterpolation(TQ3ViewObject theView, TQ3InterpolationStyle
 	if ( ( (E3View*) theView )->instanceData.viewStack->styleInterpolation != interpolationStyle )
 		{
 		// Set the value
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleInterpolation ) ;
 		( (E3View*) theView )->instanceData.viewStack->styleInterpolation = interpolationStyle ;
 
 
@@ -3179,6 +4234,7 @@ E3View_State_SetStyleHighlight(TQ3ViewObject theView, TQ3AttributeSet highlightA
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleHighlight ) ;
 	E3Shared_Replace ( & ( (E3View*) theView )->instanceData.viewStack->styleHighlight, highlightAttribute ) ;
 
 
@@ -3205,6 +4261,7 @@ E3View_State_SetStyleOrientation(TQ3ViewObject theView, TQ3OrientationStyle fron
 	if ( ( (E3View*) theView )->instanceData.viewStack->styleOrientation != frontFacingDirection )
 		{
 		// Set the value
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleOrientation ) ;
 		( (E3View*) theView )->instanceData.viewStack->styleOrientation = frontFacingDirection ;
 
 
@@ -3235,6 +4292,7 @@ E3View_State_SetStyleAntiAlias(TQ3ViewObject theView, const TQ3AntiAliasStyleDat
 	// so we can avoid updating the renderer if the style state does not change.
 	if ( memcmp ( & ( (E3View*) theView )->instanceData.viewStack->styleAntiAlias, theData, sizeof ( TQ3AntiAliasStyleData ) ) != 0 )
 		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleAntiAlias ) ;
 		( (E3View*) theView )->instanceData.viewStack->styleAntiAlias = *theData ;
 		e3view_stack_update ( (E3View*) theView, kQ3ViewStateStyleAntiAlias ) ;
 		}
@@ -3261,6 +4319,7 @@ E3View_State_SetStyleFog(TQ3ViewObject theView, const TQ3FogStyleData *theData)
 	// so we can avoid updating the renderer if the style state does not change.
 	if ( memcmp ( & ( (E3View*) theView )->instanceData.viewStack->styleFog, theData, sizeof ( TQ3FogStyleData ) ) != 0 )
 		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleFog ) ;
 		( (E3View*) theView )->instanceData.viewStack->styleFog = *theData ;
 		e3view_stack_update ( (E3View*) theView, kQ3ViewStateStyleFog ) ;
 		}
@@ -3282,6 +4341,7 @@ E3View_State_SetStyleLineWidth(TQ3ViewObject theView, float inWidth)
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateStyleLineWidth ) ;
 	( (E3View*) theView )->instanceData.viewStack->styleLineWidth = inWidth;
 
 
@@ -3306,6 +4366,7 @@ E3View_State_SetAttributeSurfaceUV(TQ3ViewObject theView, const TQ3Param2D *theD
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSurfaceUV ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeSurfaceUV = *theData ;
 
 
@@ -3330,6 +4391,7 @@ E3View_State_SetAttributeShadingUV(TQ3ViewObject theView, const TQ3Param2D *theD
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeShadingUV ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeShadingUV = *theData ;
 
 
@@ -3354,6 +4416,7 @@ E3View_State_SetAttributeNormal(TQ3ViewObject theView, const TQ3Vector3D *theDat
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeNormal ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeNormal = *theData ;
 
 
@@ -3378,6 +4441,7 @@ E3View_State_SetAttributeAmbientCoefficient(TQ3ViewObject theView, const float *
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeAmbientCoefficient ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeAmbientCoefficient = *theData ;
 
 
@@ -3402,6 +4466,7 @@ E3View_State_SetAttributeDiffuseColor(TQ3ViewObject theView, const TQ3ColorRGB *
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeDiffuseColour ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeDiffuseColor = *theData ;
 
 
@@ -3426,6 +4491,7 @@ E3View_State_SetAttributeSpecularColor(TQ3ViewObject theView, const TQ3ColorRGB
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSpecularColour ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeSpecularColor = *theData ;
 
 
@@ -3450,6 +4516,7 @@ E3View_State_SetAttributeSpecularControl(TQ3ViewObject theView, const float *the
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSpecularControl ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeSpecularControl = *theData ;
 
 
@@ -3474,6 +4541,7 @@ E3View_State_SetAttributeTransparencyColor(TQ3ViewObject theView, const TQ3Color
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeTransparencyColour ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeTransparencyColor = *theData ;
 
 
@@ -3498,6 +4566,7 @@ E3View_State_SetAttributeEmissiveColor(TQ3ViewObject theView, const TQ3ColorRGB
 
 
 	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeEmissiveColor ) ;
 	( (E3View*) theView )->instanceData.viewStack->attributeEmissiveColor = *theData ;
 
 
@@ -3522,60 +4591,182 @@ E3View_State_SetAttributeSurfaceTangent(TQ3ViewObject theView, const TQ3Tangent2
 
 
 	// Set the value
-	( (E3View*) theView )->instanceData.viewStack->attributeSurfaceTangent = *theData ;
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSurfaceTangent ) ;
+	( (E3View*) theView )->instanceData.viewStack->attributeSurfaceTangent = *theData ;
+
+
+
+	// Update the renderer
+	e3view_stack_update ( (E3View*) theView, kQ3ViewStateAttributeSurfaceTangent ) ;
+	}	
+
+
+
+
+
+//=============================================================================
+//      E3View_State_SetAttributeHighlightState : Set the highlight state.
+//-----------------------------------------------------------------------------
+void
+E3View_State_SetAttributeHighlightState(TQ3ViewObject theView, const TQ3Switch *theData)
+	{
+	// Validate our state
+	Q3_ASSERT ( Q3_VALID_PTR ( ( (E3View*) theView )->instanceData.viewStack ) ) ;
+
+
+
+	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeHighlightState ) ;
+	( (E3View*) theView )->instanceData.viewStack->attributeHighlightState = *theData ;
+
+
+
+	// Update the renderer
+	e3view_stack_update ( (E3View*) theView, kQ3ViewStateAttributeHighlightState ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3View_State_SetAttributeSurfaceShader : Set the surface shader.
+//-----------------------------------------------------------------------------
+void
+E3View_State_SetAttributeSurfaceShader(TQ3ViewObject theView, const TQ3SurfaceShaderObject *theData)
+	{
+	// Validate our state
+	Q3_ASSERT ( Q3_VALID_PTR ( ( (E3View*) theView )->instanceData.viewStack ) ) ;
+
+
+
+	// Set the value
+	e3view_stack_save ( (E3View*) theView, kQ3ViewStateShaderSurface ) ;
+	E3Shared_Replace ( & ( (E3View*) theView )->instanceData.viewStack->shaderSurface, *theData ) ;
 
 
 
 	// Update the renderer
-	e3view_stack_update ( (E3View*) theView, kQ3ViewStateAttributeSurfaceTangent ) ;
-	}	
+	e3view_stack_update ( (E3View*) theView, kQ3ViewStateShaderSurface ) ;
+	}
 
 
 
 
 
 //=============================================================================
-//      E3View_State_SetAttributeHighlightState : Set the highlight state.
+//      E3View_State_SetAttributes : Set the state for built-in attributes.
+//-----------------------------------------------------------------------------
+//		Note :	Sets every built-in attribute in theMask from an attribute
+//				set's inline attribute data, then informs the renderer of all
+//				the changes at once.
+//
+//				This is equivalent to submitting each attribute in turn, but
+//				avoids a class lookup and a renderer update per attribute.
 //-----------------------------------------------------------------------------
 void
-E3View_State_SetAttributeHighlightState(TQ3ViewObject theView, const TQ3Switch *theData)
+E3View_State_SetAttributes(TQ3ViewObject theView, TQ3XAttributeMask theMask, const TQ3SetAttributes *theData)
 	{
+	TQ3ViewStackState	stateChange = kQ3ViewStateNone ;
+
+
+
 	// Validate our state
 	Q3_ASSERT ( Q3_VALID_PTR ( ( (E3View*) theView )->instanceData.viewStack ) ) ;
+	TQ3ViewStackItem* theItem = ( (E3View*) theView )->instanceData.viewStack ;
 
 
 
-	// Set the value
-	( (E3View*) theView )->instanceData.viewStack->attributeHighlightState = *theData ;
+	// Set the values
+	if ( ( theMask & kQ3XAttributeMaskSurfaceUV ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSurfaceUV ) ;
+		theItem->attributeSurfaceUV = theData->surfaceUV ;
+		stateChange |= kQ3ViewStateAttributeSurfaceUV ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskShadingUV ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeShadingUV ) ;
+		theItem->attributeShadingUV = theData->shadingUV ;
+		stateChange |= kQ3ViewStateAttributeShadingUV ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskNormal ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeNormal ) ;
+		theItem->attributeNormal = theData->normal ;
+		stateChange |= kQ3ViewStateAttributeNormal ;
+		}
 
-	// Update the renderer
-	e3view_stack_update ( (E3View*) theView, kQ3ViewStateAttributeHighlightState ) ;
-	}
+	if ( ( theMask & kQ3XAttributeMaskAmbientCoefficient ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeAmbientCoefficient ) ;
+		theItem->attributeAmbientCoefficient = theData->ambientCoeficient ;
+		stateChange |= kQ3ViewStateAttributeAmbientCoefficient ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskDiffuseColor ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeDiffuseColour ) ;
+		theItem->attributeDiffuseColor = theData->diffuseColor ;
+		stateChange |= kQ3ViewStateAttributeDiffuseColour ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskSpecularColor ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSpecularColour ) ;
+		theItem->attributeSpecularColor = theData->specularColor ;
+		stateChange |= kQ3ViewStateAttributeSpecularColour ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskSpecularControl ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSpecularControl ) ;
+		theItem->attributeSpecularControl = theData->specularControl ;
+		stateChange |= kQ3ViewStateAttributeSpecularControl ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskTransparencyColor ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeTransparencyColour ) ;
+		theItem->attributeTransparencyColor = theData->transparencyColor ;
+		stateChange |= kQ3ViewStateAttributeTransparencyColour ;
+		}
 
-//=============================================================================
-//      E3View_State_SetAttributeSurfaceShader : Set the surface shader.
-//-----------------------------------------------------------------------------
-void
-E3View_State_SetAttributeSurfaceShader(TQ3ViewObject theView, const TQ3SurfaceShaderObject *theData)
-	{
-	// Validate our state
-	Q3_ASSERT ( Q3_VALID_PTR ( ( (E3View*) theView )->instanceData.viewStack ) ) ;
+	if ( ( theMask & kQ3XAttributeMaskEmissiveColor ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeEmissiveColor ) ;
+		theItem->attributeEmissiveColor = theData->emissiveColor ;
+		stateChange |= kQ3ViewStateAttributeEmissiveColor ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskSurfaceTangent ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeSurfaceTangent ) ;
+		theItem->attributeSurfaceTangent = theData->surfaceTangent ;
+		stateChange |= kQ3ViewStateAttributeSurfaceTangent ;
+		}
 
+	if ( ( theMask & kQ3XAttributeMaskHighlightState ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateAttributeHighlightState ) ;
+		theItem->attributeHighlightState = theData->highlightState ;
+		stateChange |= kQ3ViewStateAttributeHighlightState ;
+		}
 
-	// Set the value
-	E3Shared_Replace ( & ( (E3View*) theView )->instanceData.viewStack->shaderSurface, *theData ) ;
+	if ( ( theMask & kQ3XAttributeMaskSurfaceShader ) != 0 )
+		{
+		e3view_stack_save ( (E3View*) theView, kQ3ViewStateShaderSurface ) ;
+		E3Shared_Replace ( & theItem->shaderSurface, theData->surfaceShader ) ;
+		stateChange |= kQ3ViewStateShaderSurface ;
+		}
 
 
 
 	// Update the renderer
-	e3view_stack_update ( (E3View*) theView, kQ3ViewStateShaderSurface ) ;
+	if ( stateChange != kQ3ViewStateNone )
+		e3view_stack_update ( (E3View*) theView, stateChange ) ;
 	}
 
 
@@ -3833,6 +5024,9 @@ E3View_StartRendering(TQ3ViewObject theView)
 	// If this is the first pass then update the draw context and start the frame
 	if ( ( (E3View*) theView )->instanceData.viewPass == 1 && qd3dStatus != kQ3Failure )
 		{
+		( (E3View*) theView )->instanceData.numGeometriesSubmitted = 0 ;
+		( (E3View*) theView )->instanceData.numGeometriesCulled    = 0 ;
+
 		qd3dStatus = ( (E3DrawContext*) ( (E3View*) theView )->instanceData.theDrawContext )->Update () ;
 
 		if ( qd3dStatus != kQ3Failure )
@@ -3859,6 +5053,23 @@ E3View_StartRendering(TQ3ViewObject theView)
 
 
 
+#if QUESA_REPLAY_PASSES
+	// If the last frame took several passes, record the first pass of this
+	// one so that E3View_EndRendering can replay it for the others
+	//
+	// Culling is turned off while recording, since whether a box is visible
+	// depends on the pass: the lights of a pass, or whether it marks shadows,
+	// may keep objects that the first pass would have dropped.
+	( (E3View*) theView )->instanceData.isRecordingPass = kQ3False ;
+
+	if ( ( (E3View*) theView )->instanceData.viewPass == 1 && qd3dStatus != kQ3Failure &&
+		 ( (E3View*) theView )->instanceData.lastFramePassCount > 1 )
+		( (E3View*) theView )->instanceData.isRecordingPass =
+			(TQ3Boolean) ( E3View_StartCommandList ( theView, kQ3False ) == kQ3Success ) ;
+#endif
+
+
+
 	// Handle failure
 	if ( qd3dStatus == kQ3Failure )
 		(void) e3view_submit_end ( (E3View*) theView, kQ3ViewStatusError ) ;
@@ -3876,16 +5087,67 @@ E3View_StartRendering(TQ3ViewObject theView)
 TQ3ViewStatus
 E3View_EndRendering(TQ3ViewObject theView)
 	{
+	TQ3ViewData& instanceData( ( (E3View*) theView )->instanceData );
 	TQ3ViewStatus viewStatus = kQ3ViewStatusDone ;
 
 
 
 	// If we're still in the submit loop, end the pass
-	if ( ( (E3View*) theView )->instanceData.viewState == kQ3ViewStateSubmitting )
+	if ( instanceData.viewState == kQ3ViewStateSubmitting )
 		viewStatus = E3Renderer_Method_EndPass ( theView ) ;
 
 
 
+#if QUESA_REPLAY_PASSES
+	// Take the recording of the first pass, if any
+	E3ViewCommandList* passList = nullptr ;
+	if ( instanceData.isRecordingPass )
+		{
+		passList = E3View_EndCommandList ( theView ) ;
+		instanceData.isRecordingPass = kQ3False ;
+		}
+
+
+
+	// If the renderer wants more passes, replay the first pass to it rather
+	// than asking the application to submit the scene again
+	while ( passList != nullptr && viewStatus == kQ3ViewStatusRetraverse )
+		{
+		// Start the next pass
+		viewStatus = e3view_submit_end ( (E3View*) theView, kQ3ViewStatusRetraverse ) ;
+		if ( viewStatus != kQ3ViewStatusRetraverse )
+			{
+			E3View_DisposeCommandList ( passList ) ;
+			return viewStatus ;
+			}
+
+
+		// Replay the first pass. If the view state has changed, the
+		// application has to submit this pass after all.
+		if ( E3View_SubmitCommandList ( theView, passList ) == kQ3Failure )
+			{
+			E3View_DisposeCommandList ( passList ) ;
+			return kQ3ViewStatusRetraverse ;
+			}
+
+
+		// End the pass
+		viewStatus = kQ3ViewStatusDone ;
+		if ( instanceData.viewState == kQ3ViewStateSubmitting )
+			viewStatus = E3Renderer_Method_EndPass ( theView ) ;
+		}
+
+	E3View_DisposeCommandList ( passList ) ;
+#endif
+
+
+
+	// Remember how many passes the frame took
+	if ( viewStatus != kQ3ViewStatusRetraverse )
+		instanceData.lastFramePassCount = instanceData.viewPass ;
+
+
+
 	// End the submit loop
 	return e3view_submit_end ( (E3View*) theView, viewStatus ) ;
 	}
@@ -4051,10 +5313,14 @@ E3View_StartBoundingSphere(TQ3ViewObject theView, TQ3ComputeBounds computeBounds
 		// clean previous points from an aborted operation...
 		Q3Object_CleanDispose ( & ( (E3View*) theView )->instanceData.boundingPointsSlab ) ;
 		
-		// allocate new Slab to hold the points
-		( (E3View*) theView )->instanceData.boundingPointsSlab = Q3SlabMemory_New ( sizeof ( TQ3Point3D ), 0, nullptr ) ;
-		if ( ( (E3View*) theView )->instanceData.boundingPointsSlab == nullptr )
-			return qd3dStatus ;
+		// allocate new Slab to hold the points, if we fit the sphere to them
+		// all at the end
+		if ( computeBounds == kQ3ComputeBoundsExact )
+			{
+			( (E3View*) theView )->instanceData.boundingPointsSlab = Q3SlabMemory_New ( sizeof ( TQ3Point3D ), 0, nullptr ) ;
+			if ( ( (E3View*) theView )->instanceData.boundingPointsSlab == nullptr )
+				return qd3dStatus ;
+			}
 		
 		
 		if ( computeBounds == kQ3ComputeBoundsExact )
@@ -4509,6 +5775,331 @@ E3View_IsGroupCullingAllowed( TQ3ViewObject theView )
 
 
 
+//=============================================================================
+//      E3View_CountGeometry : Count a geometry submitted for rendering.
+//-----------------------------------------------------------------------------
+//		Note :	Called for each geometry which is either passed on to the
+//				renderer, or culled before it reaches it.
+//-----------------------------------------------------------------------------
+void
+E3View_CountGeometry( TQ3ViewObject theView, TQ3Boolean wasCulled )
+{	TQ3ViewData		*instanceData = &( (E3View*) theView )->instanceData;
+
+
+
+	if ( wasCulled )
+		instanceData->numGeometriesCulled++;
+	else
+		instanceData->numGeometriesSubmitted++;
+}
+
+
+
+
+
+//=============================================================================
+//      E3View_GetGeometryCounts : Get the geometry counts for the frame.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_GetGeometryCounts( TQ3ViewObject theView, TQ3Uns32 *numSubmitted, TQ3Uns32 *numCulled )
+{	TQ3ViewData		*instanceData = &( (E3View*) theView )->instanceData;
+
+
+
+	*numSubmitted = instanceData->numGeometriesSubmitted;
+	*numCulled    = instanceData->numGeometriesCulled;
+	
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3View_CalcLocalBounds : Calculate the bounds of an object.
+//-----------------------------------------------------------------------------
+//		Note :	Used by display groups and geometries to maintain their own
+//				bounding boxes while theView is rendering. The object is
+//				submitted to a private bounds view, which is created on demand,
+//				so the box is in the local coordinates of the object.
+//
+//				The current subdivision and orientation styles of theView are
+//				submitted first, so that any geometry caches built by the
+//				bounds pass are still valid when the object is rendered.
+//
+//				Only geometries that are tessellated according to the
+//				subdivision style depend on it, and usesSubdivision (which may
+//				be nullptr) returns whether the object contains any. If the
+//				subdivision is not constant we fail for those objects, since
+//				their tessellation then depends on the transform and camera of
+//				theView, but other objects are bounded under any style.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_CalcLocalBounds( TQ3ViewObject theView, TQ3Object theObject, TQ3BoundingBox *theBBox, TQ3Boolean *usesSubdivision )
+{	TQ3ViewData		*instanceData = &( (E3View*) theView )->instanceData;
+	TQ3ViewStatus	viewStatus;
+	TQ3Status		qd3dStatus;
+
+
+
+	// Get the styles we need to match
+	const TQ3SubdivisionStyleData* subdivisionStyle = E3View_State_GetStyleSubdivision( theView );
+	TQ3OrientationStyle orientationStyle = E3View_State_GetStyleOrientation( theView );
+
+	if ( usesSubdivision != nullptr )
+		*usesSubdivision = kQ3False;
+
+
+
+	// Create the bounds view if necessary
+	if ( instanceData->groupBoundsView == nullptr )
+		{
+		instanceData->groupBoundsView = Q3View_New();
+		if ( instanceData->groupBoundsView == nullptr )
+			return kQ3Failure;
+		}
+
+
+
+	// Calculate the bounds
+	TQ3ViewObject boundsView = instanceData->groupBoundsView;
+	TQ3ViewData* boundsData = &( (E3View*) boundsView )->instanceData;
+	if ( E3View_StartBoundingBox( boundsView, kQ3ComputeBoundsApproximate ) == kQ3Failure )
+		return kQ3Failure;
+
+	boundsData->boundsSkipSubdivision = (TQ3Boolean) ( subdivisionStyle->method != kQ3SubdivisionMethodConstant );
+	boundsData->boundsUseSubdivision  = kQ3False;
+
+	do
+		{
+		Q3SubdivisionStyle_Submit( subdivisionStyle, boundsView );
+		Q3OrientationStyle_Submit( orientationStyle, boundsView );
+		
+		qd3dStatus = E3View_SubmitRetained( boundsView, theObject );
+		viewStatus = E3View_EndBoundingBox( boundsView, theBBox );
+		}
+	while ( viewStatus == kQ3ViewStatusRetraverse );
+
+	TQ3Boolean isSkipped = (TQ3Boolean) ( boundsData->boundsSkipSubdivision && boundsData->boundsUseSubdivision );
+	if ( usesSubdivision != nullptr )
+		*usesSubdivision = boundsData->boundsUseSubdivision;
+
+	boundsData->boundsSkipSubdivision = kQ3False;
+	boundsData->boundsUseSubdivision  = kQ3False;
+	
+	if ( viewStatus != kQ3ViewStatusDone || isSkipped )
+		return kQ3Failure;
+
+	return qd3dStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      E3View_CanBoundSubdivision : Can a subdivided geometry be bounded?
+//-----------------------------------------------------------------------------
+//		Note :	Called while bounding a geometry whose tessellation follows
+//				the subdivision style. Records that the bounds depend on the
+//				style, and returns kQ3False if E3View_CalcLocalBounds can't
+//				use the current style, in which case the geometry should be
+//				left out.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3View_CanBoundSubdivision( TQ3ViewObject theView )
+{	TQ3ViewData		*instanceData = &( (E3View*) theView )->instanceData;
+
+
+
+	// Record the dependency
+	instanceData->boundsUseSubdivision = kQ3True;
+	
+	return (TQ3Boolean) ! instanceData->boundsSkipSubdivision;
+}
+
+
+
+
+
+
+//=============================================================================
+//      E3View_StartCommandList : Start recording a command list.
+//-----------------------------------------------------------------------------
+//		Note :	Used by compiled display groups, and to replay rendering
+//				passes. Until E3View_EndCommandList, each geometry submitted
+//				for rendering is recorded along with its view state and its
+//				transform relative to the current local-to-world matrix.
+//
+//				Group culling can be turned off while recording, for lists
+//				which must hold everything that was submitted.
+//
+//				A list can be started while another is being recorded, such as
+//				the first rendering pass, so that a compiled group can still
+//				record its own list. Lists must be ended in the reverse order.
+//				We fail while a recorded geometry is being drawn, since what
+//				it submits is not recorded.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_StartCommandList( TQ3ViewObject theView, TQ3Boolean allowGroupCulling )
+{	TQ3ViewData		*instanceData = &( (E3View*) theView )->instanceData;
+
+
+
+	// Check our state
+	if ( instanceData->viewMode != kQ3ViewModeDrawing ||
+		 instanceData->viewStack == nullptr ||
+		 ( instanceData->recordingList != nullptr && instanceData->recordingSuspendCount != 0 ) )
+		return kQ3Failure;
+
+
+
+	// We need to map geometries back into the local coordinates of the group
+	const TQ3Matrix4x4& localToWorld = instanceData->viewStack->matrixLocalToWorld;
+	if ( E3Float_Abs( Q3Matrix4x4_Determinant( &localToWorld ) ) < kQ3RealZero )
+		return kQ3Failure;
+
+
+
+	// Create the list
+	E3ViewCommandList* theList = new(std::nothrow) E3ViewCommandList;
+	if ( theList == nullptr )
+		{
+		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
+		return kQ3Failure;
+		}
+
+	e3view_stack_state_retain( &theList->entryState, instanceData->viewStack );
+	Q3Matrix4x4_Invert( &localToWorld, &theList->worldToGroup );
+
+
+
+	// Start recording
+	theList->parentList        = instanceData->recordingList;
+	theList->savedGroupCulling = instanceData->allowGroupCulling;
+
+	instanceData->recordingList         = theList;
+	instanceData->recordingSuspendCount = 0;
+	if ( ! allowGroupCulling )
+		instanceData->allowGroupCulling = kQ3False;
+
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3View_EndCommandList : Finish recording a command list.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr if something was drawn which could not be
+//				recorded.
+//-----------------------------------------------------------------------------
+E3ViewCommandList *
+E3View_EndCommandList( TQ3ViewObject theView )
+{	TQ3ViewData		*instanceData = &( (E3View*) theView )->instanceData;
+
+
+
+	// Stop recording
+	E3ViewCommandList* theList = instanceData->recordingList;
+	if ( theList == nullptr )
+		return nullptr;
+
+	instanceData->recordingList     = theList->parentList;
+	instanceData->allowGroupCulling = theList->savedGroupCulling;
+	theList->parentList             = nullptr;
+
+
+
+	// Discard the list if it's incomplete
+	if ( ! theList->isValid )
+		{
+		delete theList;
+		theList = nullptr;
+		}
+
+	return theList;
+}
+
+
+
+
+
+//=============================================================================
+//      E3View_SubmitCommandList : Replay a command list.
+//-----------------------------------------------------------------------------
+//		Note :	Each geometry is drawn with its recorded state, without
+//				traversing the groups or resubmitting the state objects that
+//				produced it.
+//
+//				Fails without drawing anything if the view state differs from
+//				the state when the list was recorded, since the recorded state
+//				would then be wrong. The caller should record the list again.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_SubmitCommandList( TQ3ViewObject theView, E3ViewCommandList *theList )
+{	E3View			*view = (E3View*) theView;
+
+
+
+	// Check the entry state
+	Q3_REQUIRE_OR_RESULT( view->instanceData.viewStack != nullptr, kQ3Failure );
+	
+	if ( e3view_stack_state_diff( &theList->entryState, view->instanceData.viewStack ) != kQ3ViewStateNone )
+		return kQ3Failure;
+
+	if ( theList->theCommands.empty() )
+		return kQ3Success;
+
+
+
+	// Replay the commands
+	TQ3Matrix4x4 groupToWorld = view->instanceData.viewStack->matrixLocalToWorld;
+	TQ3Matrix4x4 localToWorld;
+
+	if ( e3view_stack_push( view ) == kQ3Failure )
+		return kQ3Failure;
+
+	for (std::vector<E3ViewCommandList::Command>::const_iterator i = theList->theCommands.begin();
+		i != theList->theCommands.end(); ++i)
+		{
+		if ( i->stateChange != kQ3ViewStateNone )
+			e3view_stack_state_apply( view, &theList->theStates[ i->stateIndex ], i->stateChange );
+
+		if ( ! i->isSameMatrix )
+			{
+			Q3Matrix4x4_Multiply( &i->localToGroup, &groupToWorld, &localToWorld );
+			E3View_State_SetMatrix( theView, kQ3MatrixStateLocalToWorld, &localToWorld, nullptr, nullptr );
+			}
+
+		E3View_SubmitRetained( theView, i->theGeometry );
+		}
+
+	e3view_stack_pop( view );
+
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3View_DisposeCommandList : Dispose of a command list.
+//-----------------------------------------------------------------------------
+void
+E3View_DisposeCommandList( E3ViewCommandList *theList )
+{
+	delete theList;
+}
+
+
+
+
+
 //=============================================================================
 //      E3View_TransformLocalToWorld : Transform a point from local->world.
 //-----------------------------------------------------------------------------
@@ -100,6 +100,7 @@ TQ3Status				E3View_RegisterClass(void);
 TQ3Status				E3View_UnregisterClass(void);
 TQ3Status				E3View_SubmitRetained(TQ3ViewObject theView, TQ3Object theObject);
 TQ3Status				E3View_SubmitImmediate(TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData);
+TQ3Status				E3View_SubmitParallel(TQ3ViewObject theView, TQ3GroupObject theGroup, TQ3Uns32 numThreads);
 TQ3Status				E3View_CallIdleMethod(TQ3ViewObject theView, TQ3Uns32 current, TQ3Uns32 completed);
 TQ3PickObject			E3View_AccessPick(TQ3ViewObject theView);
 TQ3RendererObject		E3View_AccessRenderer(TQ3ViewObject theView);
@@ -167,6 +168,7 @@ void							E3View_State_SetAttributeEmissiveColor(TQ3ViewObject theView, const T
 void							E3View_State_SetAttributeSurfaceTangent(TQ3ViewObject theView, const TQ3Tangent2D *theData);
 void							E3View_State_SetAttributeHighlightState(TQ3ViewObject theView, const TQ3Switch *theData);
 void							E3View_State_SetAttributeSurfaceShader(TQ3ViewObject theView, const TQ3SurfaceShaderObject *theData);
+void							E3View_State_SetAttributes(TQ3ViewObject theView, TQ3XAttributeMask theMask, const struct TQ3SetAttributes *theData);
 
 TQ3ViewObject			E3View_New(void);
 TQ3ViewObject			E3View_NewWithDefaults(TQ3ObjectType drawContextType, void *drawContextTarget);
@@ -197,6 +199,14 @@ TQ3Status				E3View_SetEndFrameMethod(TQ3ViewObject theView, TQ3ViewEndFrameMeth
 TQ3Boolean				E3View_IsBoundingBoxVisible(TQ3ViewObject theView, const TQ3BoundingBox *theBBox);
 TQ3Status				E3View_AllowAllGroupCulling(TQ3ViewObject theView, TQ3Boolean allowCulling);
 TQ3Boolean				E3View_IsGroupCullingAllowed( TQ3ViewObject theView );
+void					E3View_CountGeometry( TQ3ViewObject theView, TQ3Boolean wasCulled );
+TQ3Status				E3View_GetGeometryCounts( TQ3ViewObject theView, TQ3Uns32 *numSubmitted, TQ3Uns32 *numCulled );
+TQ3Status				E3View_CalcLocalBounds( TQ3ViewObject theView, TQ3Object theObject, TQ3BoundingBox *theBBox, TQ3Boolean *usesSubdivision );
+TQ3Boolean				E3View_CanBoundSubdivision( TQ3ViewObject theView );
+TQ3Status				E3View_StartCommandList( TQ3ViewObject theView, TQ3Boolean allowGroupCulling );
+class E3ViewCommandList*	E3View_EndCommandList( TQ3ViewObject theView );
+TQ3Status				E3View_SubmitCommandList( TQ3ViewObject theView, class E3ViewCommandList *theList );
+void					E3View_DisposeCommandList( class E3ViewCommandList *theList );
 TQ3Status				E3View_TransformLocalToWorld(TQ3ViewObject theView, const TQ3Point3D *localPoint, TQ3Point3D *worldPoint);
 TQ3Status				E3View_TransformLocalToWindow(TQ3ViewObject theView, const TQ3Point3D *localPoint, TQ3Point2D *windowPoint);
 TQ3Status				E3View_TransformWorldToWindow(TQ3ViewObject theView, const TQ3Point3D *worldPoint, TQ3Point2D *windowPoint);
@@ -1633,6 +1633,62 @@ bool	QORenderer::Renderer::IsFakeSeparateSpecularColorNeeded() const
 
 
 
+/*!
+	@function	ForgetRepeatedTriMesh
+	@abstract	Forget the last TriMesh drawn on the fast path, because
+				something other than the local to camera matrix has changed
+				since it was drawn.
+*/
+void	QORenderer::Renderer::ForgetRepeatedTriMesh()
+{
+	mRepeatTriMesh = CQ3ObjectRef();
+	mRepeatDrawnTriMesh = CQ3ObjectRef();
+}
+
+/*!
+	@function	RenderRepeatedTriMesh
+	@abstract	If a TriMesh is the same one that was last drawn on the fast
+				path, and only the matrix has changed since, draw it again
+				from its cached buffers.
+	@discussion	This is how we handle many placements of the same geometry.
+				The colors, textures, client states and shader program set
+				up for the first placement are all still current, so each
+				further placement costs a matrix load and one draw call.
+	@param		inTriMesh		A TriMesh object.  May be nullptr.
+	@result		True if the TriMesh was drawn.
+*/
+bool	QORenderer::Renderer::RenderRepeatedTriMesh(
+								TQ3GeometryObject inTriMesh )
+{
+	if ( (inTriMesh == nullptr) || (inTriMesh != mRepeatTriMesh.get()) ||
+		(Q3Shared_GetEditIndex( inTriMesh ) != mRepeatEditIndex) )
+	{
+		return false;
+	}
+	
+	GLDrawContext_SetCurrent( mGLContext, kQ3False );
+	
+	TQ3Boolean	didRender;
+	
+	if (mGLExtensions.vertexBufferObjects == kQ3True)
+	{
+		GLenum	mode = (mStyleState.mFill == kQ3FillStyleEdges)?
+			GL_TRIANGLES : GL_TRIANGLE_STRIP;
+		
+		didRender = RenderCachedVBO( mGLContext, mBufferFuncs,
+			mRepeatDrawnTriMesh.get(), mode );
+	}
+	else
+	{
+		didRender = RenderCachedDisplayList( mGLContext,
+			mRepeatDrawnTriMesh.get(), mStyleState.mFill );
+	}
+	
+	return didRender == kQ3True;
+}
+
+
+
 /*!
 	@function		SubmitTriMesh
 	
@@ -1669,6 +1725,15 @@ bool	QORenderer::Renderer::SubmitTriMesh(
 		return true;
 	}
 	
+	// Another placement of the TriMesh we just drew needs no setup
+	if (RenderRepeatedTriMesh( inTriMesh ))
+	{
+		mNumPrimitivesRenderedInFrame += inGeomData->numTriangles;
+		return true;
+	}
+	ForgetRepeatedTriMesh();
+	TQ3GeometryObject	submittedTriMesh = inTriMesh;
+	
 	bool didHandle = false;
 	
 	ImmediateModePush( inView, inTriMesh, inGeomData->triMeshAttributeSet );
@@ -1795,6 +1860,14 @@ bool	QORenderer::Renderer::SubmitTriMesh(
 			SimulateSeparateSpecularColor( 3 * inGeomData->numTriangles,
 				inGeomData->triangles[0].pointIndices );
 		}
+		else if ( (submittedTriMesh != nullptr) &&
+			(inGeomData->numTriangles >= kMinTrianglesToCache) )
+		{
+			// Remember it, in case it is submitted again with a new matrix
+			mRepeatTriMesh = CQ3ObjectRef( Q3Shared_GetReference( submittedTriMesh ) );
+			mRepeatDrawnTriMesh = CQ3ObjectRef( Q3Shared_GetReference( inTriMesh ) );
+			mRepeatEditIndex = Q3Shared_GetEditIndex( submittedTriMesh );
+		}
 	}
 	
 	if (! didHandle)
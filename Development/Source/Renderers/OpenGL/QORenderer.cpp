@@ -154,6 +154,7 @@ QORenderer::Renderer::Renderer( TQ3RendererObject inRenderer )
 	, mAllowLineSmooth( true )
 	, mIsCachingShadows( false )
 	, mNumPrimitivesRenderedInFrame( 0 )
+	, mRepeatEditIndex( 0 )
 	, mLineWidth( 1.0f )
 	, mAttributesMask( kQ3XAttributeMaskAll )
 	, mUpdateShader( true )
@@ -366,6 +366,9 @@ protected:
 	bool					IsFirstPass() const { return (mPassIndex == 0) &&
 														mLights.IsFirstPass(); }
 	void					RenderTransparent( TQ3ViewObject inView );
+	bool					RenderRepeatedTriMesh(
+									TQ3GeometryObject inTriMesh );
+	void					ForgetRepeatedTriMesh();
 
 	
 	TQ3RendererObject		mRendererObject;
@@ -388,6 +391,13 @@ protected:
 	bool					mIsCachingShadows;
 	unsigned long long		mNumPrimitivesRenderedInFrame;
 	
+	// Last TriMesh drawn on the fast path, and the TriMesh whose cached
+	// buffers were drawn for it, so that a repeated submit with nothing but a
+	// new matrix can be drawn again without setting up state
+	CQ3ObjectRef			mRepeatTriMesh;
+	CQ3ObjectRef			mRepeatDrawnTriMesh;
+	TQ3Uns32				mRepeatEditIndex;
+	
 	// Buffers used temporarily in QOGeometry.cpp, only members to reduce
 	// memory allocation
 	E3FastArray<char>		mScratchBuffer;
@@ -130,6 +130,7 @@ TQ3Status	QORenderer::Statics::StartFrameMethod(
 								TQ3DrawContextObject inDrawContext )
 {
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	try
 	{
@@ -149,6 +150,7 @@ TQ3Status	QORenderer::Statics::EndFrameMethod(
 {
 #pragma unused( inDrawContext )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	try
 	{
@@ -169,6 +171,7 @@ TQ3Status	QORenderer::Statics::StartPassMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	try
 	{
@@ -187,6 +190,7 @@ TQ3ViewStatus	QORenderer::Statics::EndPassMethod(
 {
 	TQ3ViewStatus	theStatus = kQ3ViewStatusError;
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	try
 	{
 		theStatus = me->EndPass( inView );
@@ -244,6 +248,7 @@ TQ3Status	QORenderer::Statics::SubmitTriangleMethod(
 									const void* inGeomData )
 {
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	
 	try
@@ -266,6 +271,7 @@ TQ3Status	QORenderer::Statics::SubmitPointMethod(
 {
 #pragma unused( inView, inGeomObject )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	
 	try
@@ -288,6 +294,7 @@ TQ3Status	QORenderer::Statics::SubmitLineMethod(
 {
 #pragma unused( inView, inGeomObject )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	
 	try
@@ -309,6 +316,7 @@ TQ3Status	QORenderer::Statics::SubmitPolyLineMethod(
 							const void* inGeomData )
 {
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	
 	try
@@ -378,6 +386,7 @@ TQ3Status	QORenderer::Statics::UpdateCameraToFrustumMethod(
 									const TQ3Matrix4x4* inMatrix )
 {
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	TQ3Status	result = kQ3Success;
 	try
 	{
@@ -417,6 +426,7 @@ TQ3Status	QORenderer::Statics::UpdateDiffuseColorMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateDiffuseColor( inAttColor );
 	return kQ3Success;
 }
@@ -428,6 +438,7 @@ TQ3Status	QORenderer::Statics::UpdateSpecularColorMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateSpecularColor( inAttColor );
 	return kQ3Success;
 }
@@ -439,6 +450,7 @@ TQ3Status	QORenderer::Statics::UpdateSpecularControlMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateSpecularControl( inAttValue );
 	return kQ3Success;
 }
@@ -450,6 +462,7 @@ TQ3Status	QORenderer::Statics::UpdateTransparencyColorMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateTransparencyColor( inAttColor );
 	return kQ3Success;
 }
@@ -461,6 +474,7 @@ TQ3Status	QORenderer::Statics::UpdateEmissiveColorMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateEmissiveColor( inAttColor );
 	return kQ3Success;
 }
@@ -472,6 +486,7 @@ TQ3Status	QORenderer::Statics::UpdateHiliteStateMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateHiliteState( inAttState );
 	return kQ3Success;
 }
@@ -484,6 +499,7 @@ TQ3Status	QORenderer::Statics::UpdateSurfaceShaderMethod(
 #pragma unused( inView )
 	TQ3Status	result = kQ3Success;
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	try
 	{
 		TQ3ShaderObject	theShader = (inAttShader == nullptr)? nullptr : *inAttShader;
@@ -504,6 +520,7 @@ TQ3Status	QORenderer::Statics::UpdateIlluminationShaderMethod(
 #pragma unused( inView )
 	TQ3Status	result = kQ3Success;
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	try
 	{
 		if (inShader != nullptr)
@@ -592,6 +609,7 @@ TQ3Status	QORenderer::Statics::UpdateInterpolationStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateInterpolationStyle( (TQ3InterpolationStyle*) publicData );
 	return kQ3Success;
 }
@@ -603,6 +621,7 @@ TQ3Status	QORenderer::Statics::UpdateBackfacingStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateBackfacingStyle( (TQ3BackfacingStyle*) publicData );
 	return kQ3Success;
 }
@@ -614,6 +633,7 @@ TQ3Status	QORenderer::Statics::UpdateFillStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateFillStyle( (TQ3FillStyle*) publicData );
 	return kQ3Success;
 }
@@ -625,6 +645,7 @@ TQ3Status	QORenderer::Statics::UpdateOrientationStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateOrientationStyle( (TQ3OrientationStyle*) publicData );
 	return kQ3Success;
 }
@@ -636,6 +657,7 @@ TQ3Status	QORenderer::Statics::UpdateHighlightStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateHighlightStyle( (TQ3AttributeSet*) publicData );
 	return kQ3Success;
 }
@@ -647,6 +669,7 @@ TQ3Status	QORenderer::Statics::UpdateAntiAliasStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateAntiAliasStyle( (TQ3AntiAliasStyleData*) publicData );
 	return kQ3Success;
 }
@@ -658,6 +681,7 @@ TQ3Status	QORenderer::Statics::UpdateCastShadowsStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateCastShadowsStyle( * (TQ3Boolean*) publicData );
 	return kQ3Success;
 }
@@ -669,6 +693,7 @@ TQ3Status	QORenderer::Statics::UpdateLineWidthStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateLineWidthStyle( * (float*) publicData );
 	return kQ3Success;
 }
@@ -680,6 +705,7 @@ TQ3Status	QORenderer::Statics::UpdateFogStyleMethod(
 {
 #pragma unused( inView )
 	QORenderer::Renderer*	me = *(QORenderer::Renderer**)privateData;
+	me->ForgetRepeatedTriMesh();
 	me->UpdateFogStyle( (TQ3FogStyleData*) publicData );
 	return kQ3Success;
 }
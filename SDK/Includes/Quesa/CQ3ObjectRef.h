@@ -71,8 +71,10 @@
 				
 				Due to a HeaderDoc bug, it is not possible to automatically
 				document more than one constructor.  Besides the constructor from
-				a TQ3Object, there is a default constructor (which holds nullptr)
-				and a copy constructor.
+				a TQ3Object, there is a default constructor (which holds nullptr),
+				a copy constructor, and a move constructor.  Moving a wrapper
+				transfers its reference without touching the reference count,
+				so prefer moves when filling or reorganizing containers.
 				
 				This wrapper is not fully functional with objects that are not
 				reference-counted (such as views and picks) because the copy
@@ -96,6 +98,19 @@ public:
 							*/
 							CQ3ObjectRef( const CQ3ObjectRef& inOther );
 							
+							/*!
+								@function	CQ3ObjectRef
+								@abstract	Move constructor.
+								@discussion	Takes over the reference held by the other
+											wrapper, which is left holding nullptr.
+								@param		ioOther		Another CQ3ObjectRef.
+							*/
+							CQ3ObjectRef( CQ3ObjectRef&& ioOther ) noexcept
+									: mObject( ioOther.mObject )
+									{
+										ioOther.mObject = nullptr;
+									}
+							
 							/*!
 								@function	CQ3ObjectRef
 								@abstract	Constructor from a TQ3Object.
@@ -124,6 +139,17 @@ public:
 							*/
 	CQ3ObjectRef&			operator=( const CQ3ObjectRef& inOther );
 	
+							/*!
+								@function	operator=
+								@abstract	Move assignment operator.
+								@discussion	The previous object held by this wrapper
+											is disposed, and the reference held by
+											the other wrapper replaces it.  The other
+											wrapper is left holding nullptr.
+								@param		ioOther		Another CQ3ObjectRef.
+							*/
+	CQ3ObjectRef&			operator=( CQ3ObjectRef&& ioOther ) noexcept;
+	
 							/*!
 								@function	swap
 								@abstract	Swap contents with another CQ3ObjectRef.
@@ -191,4 +217,12 @@ inline CQ3ObjectRef&	CQ3ObjectRef::operator=( const CQ3ObjectRef& inOther )
 	return *this;
 }
 
+inline CQ3ObjectRef&	CQ3ObjectRef::operator=( CQ3ObjectRef&& ioOther ) noexcept
+{
+	CQ3ObjectRef	temp;
+	temp.swap( ioOther );
+	swap( temp );
+	return *this;
+}
+
 #endif
@@ -639,6 +639,9 @@ Q3DENUMSIZED(TQ3ObjectType) {
         kQ3PickTypeWindowPoint                  = Q3_OBJECT_TYPE('p', 'k', 'w', 'p'),
         kQ3PickTypeWindowRect                   = Q3_OBJECT_TYPE('p', 'k', 'w', 'r'),
         kQ3PickTypeWorldRay                     = Q3_OBJECT_TYPE('p', 'k', 'r', 'y'),
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+            kQ3PickTypeWorldRayBatch            = Q3_OBJECT_TYPE('p', 'k', 'r', 'b'),
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
     kQ3ObjectTypeShared                         = Q3_OBJECT_TYPE('s', 'h', 'r', 'd'),
         kQ3SharedTypeRenderer                   = Q3_OBJECT_TYPE('r', 'd', 'd', 'r'),
             kQ3RendererTypeWireFrame            = Q3_OBJECT_TYPE('w', 'r', 'f', 'r'),
@@ -670,6 +673,9 @@ Q3DENUMSIZED(TQ3ObjectType) {
                 kQ3GeometryTypePolyhedron       = Q3_OBJECT_TYPE('p', 'l', 'h', 'd'),
                 kQ3GeometryTypeTorus            = Q3_OBJECT_TYPE('t', 'o', 'r', 's'),
                 kQ3GeometryTypeTriMesh          = Q3_OBJECT_TYPE('t', 'm', 's', 'h'),
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+                kQ3GeometryTypeInstances        = Q3_OBJECT_TYPE('i', 'n', 's', 't'),
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
             kQ3ShapeTypeShader                  = Q3_OBJECT_TYPE('s', 'h', 'd', 'r'),
                 kQ3ShaderTypeSurface            = Q3_OBJECT_TYPE('s', 'u', 's', 'h'),
                     kQ3SurfaceShaderTypeTexture = Q3_OBJECT_TYPE('t', 'x', 's', 'u'),
@@ -1846,6 +1852,37 @@ Q3Object_CleanDispose (
 #endif // QUESA_ALLOW_QD3D_EXTENSIONS
 
 
+
+/*!
+ *  @function
+ *      Q3Object_DisposeArray
+ *  @discussion
+ *      Disposes of an array of Quesa objects.
+ *
+ *      Equivalent to calling Q3Object_Dispose on each non-NULL object in the
+ *      array, in order.
+ *
+ *      The array itself is not changed.
+ *      
+ *      <em>This function is not available in QD3D.</em>
+ *      
+ *  @param numObjects       The number of objects in the array.
+ *  @param theObjects       The objects to dispose (entries may be NULL).
+ *  @result                 Success or failure of the operation. If an entry
+ *                          is not a valid object it is skipped, and the
+ *                          remaining objects are still disposed of.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Object_DisposeArray (
+    TQ3Uns32                                numObjects,
+    TQ3Object _Nullable                     * _Nonnull theObjects
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 /*!
  *	@function
  *		Q3Object_GetWeakReference
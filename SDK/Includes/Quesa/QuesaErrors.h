@@ -590,6 +590,56 @@ typedef Q3_CALLBACK_API_C(void,                TQ3NoticeMethod)(
                             TQ3Int32            userData);
 
 
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+/*!
+ *  @enum
+ *      TQ3ErrorReportKind
+ *  @discussion
+ *      The kind of code held in a TQ3ErrorReport.
+ *
+ *      <em>This type is not available in QD3D.</em>
+ *
+ *  @constant kQ3ErrorReportKindError           A TQ3Error.
+ *  @constant kQ3ErrorReportKindWarning         A TQ3Warning.
+ *  @constant kQ3ErrorReportKindNotice          A TQ3Notice.
+ *  @constant kQ3ErrorReportKindPlatform        A platform-specific error code.
+ */
+typedef enum TQ3ErrorReportKind {
+    kQ3ErrorReportKindError                     = 0,
+    kQ3ErrorReportKindWarning                   = 1,
+    kQ3ErrorReportKindNotice                    = 2,
+    kQ3ErrorReportKindPlatform                  = 3,
+    kQ3ErrorReportKindSize32                    = 0xFFFFFFFF
+} TQ3ErrorReportKind;
+
+
+/*!
+ *  @struct
+ *      TQ3ErrorReport
+ *  @discussion
+ *      An entry in the log of recently posted errors, warnings, and notices,
+ *      as returned by Q3Error_DrainReports.
+ *
+ *      <em>This type is not available in QD3D.</em>
+ *
+ *  @field serialNumber     Position of the report in the order of posting.
+ *                          A gap between consecutive serial numbers means that
+ *                          reports were discarded because the log was full.
+ *  @field kind             The kind of code in the report.
+ *  @field code             The error, warning, notice, or platform-specific code.
+ *  @field isFatal          True if the code is an error that was posted as fatal.
+ */
+typedef struct TQ3ErrorReport {
+    TQ3Uns32                                    serialNumber;
+    TQ3ErrorReportKind                          kind;
+    TQ3Int32                                    code;
+    TQ3Boolean                                  isFatal;
+} TQ3ErrorReport;
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 
 
 
@@ -805,6 +855,41 @@ Q3Error_PlatformPost (
 
 
 
+/*!
+ *  @function
+ *      Q3Error_DrainReports
+ *  @discussion
+ *      Removes the oldest reports from the log of recently posted errors,
+ *		warnings, notices, and platform-specific errors.
+ *
+ *		The values returned by Q3Error_Get and its relatives are kept per
+ *		thread, and only describe the errors posted by the calling thread.
+ *		Every error is also added to a small log shared by all threads, which
+ *		can be drained by any thread (for example, a thread which monitors
+ *		several importers or renderers running in parallel). When the log is
+ *		full, the oldest reports are discarded to make room for new ones.
+ *
+ *		Posting and draining reports never blocks, and draining does not clear
+ *		the state returned by Q3Error_Get.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param reports          Array to receive the reports, oldest first.
+ *  @param maxReports       The number of entries in the reports array.
+ *  @result                 The number of reports that were returned.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Uns32  )
+Q3Error_DrainReports (
+    TQ3ErrorReport                * _Nonnull reports,
+    TQ3Uns32                      maxReports
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
  *  @function
  *      Q3Error_ToString
@@ -1201,6 +1201,38 @@ typedef struct TQ3TriMeshData {
 } TQ3TriMeshData;
 
 
+/*!
+ *	@struct		TQ3InstancesData
+ *	@discussion
+ *		Structure describing an Instances object, which draws one geometry at
+ *		several placements.  Submitting an Instances object is equivalent to
+ *		submitting a group holding, for each placement, a matrix transform
+ *		followed by the geometry.  Since nothing but the matrix changes between
+ *		placements, a renderer can set up the geometry once and draw each
+ *		placement with a single draw call.
+ *
+ *		<em>This structure is not available in QD3D.</em>
+ *
+ *	@field		geometry				The geometry to draw.  May be nullptr.
+ *	@field		numInstances			Number of transforms in the following array.
+ *	@field		instanceTransforms		Pointer to an array of transforms, one for each
+ *										placement.  Each is applied on top of the current
+ *										local to world transform.  May be nullptr, if
+ *										<code>numInstances</code> is 0.
+ *	@field		instancesAttributeSet	Set of attributes for the whole object.  May be nullptr.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+typedef struct TQ3InstancesData {
+    TQ3GeometryObject _Nullable                 geometry;
+    TQ3Uns32                                    numInstances;
+    TQ3Matrix4x4                                * _Nullable instanceTransforms;
+    TQ3AttributeSet _Nullable                   instancesAttributeSet;
+} TQ3InstancesData;
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 
 
 
@@ -3669,6 +3701,137 @@ Q3GeneralPolygon_GetShapeHint (
 
 
 
+/*!
+	@functiongroup	Instances Functions
+*/
+
+
+
+/*!
+ *  @function
+ *      Q3Instances_New
+ *  @discussion
+ *      Create a new Instances geometry object.
+ *
+ *		The transforms are copied, and the geometry and attribute set gain
+ *		a reference.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param instancesData    Data describing an Instances object.
+ *  @result                 Reference to a new Instances geometry object, or nullptr on failure.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3GeometryObject _Nullable )
+Q3Instances_New (
+    const TQ3InstancesData        * _Nonnull instancesData
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Instances_Submit
+ *  @discussion
+ *		Submits an Instances object for drawing, picking, bounding, or writing in immediate mode.
+ *
+ *		This function should only be called in a submitting loop.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param instancesData    Data describing an Instances object.
+ *  @param view             A view object.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Instances_Submit (
+    const TQ3InstancesData        * _Nonnull instancesData,
+    TQ3ViewObject _Nonnull                view
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Instances_SetData
+ *  @discussion
+ *      Modify an Instances object by supplying a full new set of data.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param instances        An Instances object.
+ *  @param instancesData    Data describing an Instances object.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Instances_SetData (
+    TQ3GeometryObject _Nonnull            instances,
+    const TQ3InstancesData        * _Nonnull instancesData
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Instances_GetData
+ *  @discussion
+ *      Get the data of an Instances object.
+ *
+ *      This function may allocate memory, which should be freed using
+ *		<code>Q3Instances_EmptyData</code>.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param instances        An Instances object.
+ *  @param instancesData    Receives data describing the Instances object.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Instances_GetData (
+    TQ3GeometryObject _Nonnull            instances,
+    TQ3InstancesData              * _Nonnull instancesData
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Instances_EmptyData
+ *  @discussion
+ *      Release memory allocated by <code>Q3Instances_GetData</code>.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param instancesData    Data describing an Instances object, previously obtained with
+ *							<code>Q3Instances_GetData</code>.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Instances_EmptyData (
+    TQ3InstancesData              * _Nonnull instancesData
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
 	@functiongroup	Line Functions
 */
@@ -99,6 +99,10 @@ extern "C" {
  *  @constant kQ3DisplayGroupStateMaskIsWritten            The group will be submitted during writing.
  *	@constant kQ3DisplayGroupStateMaskIsNotForBounding	   The group will not be submitted during bounding.
  *														   (Not in QD3D.)
+ *	@constant kQ3DisplayGroupStateMaskIsCompiled		   The group is rendered from a list of its geometries
+ *														   and their state, which is rebuilt when anything in
+ *														   the group is edited. Ignored for inline groups.
+ *														   (Not in QD3D.)
  */
 typedef enum {
     kQ3DisplayGroupStateNone                    = 0,
@@ -111,6 +115,7 @@ typedef enum {
     
 #if QUESA_ALLOW_QD3D_EXTENSIONS
     kQ3DisplayGroupStateMaskIsNotForBounding	= (1 << 6),
+    kQ3DisplayGroupStateMaskIsCompiled			= (1 << 7),
 #endif // QUESA_ALLOW_QD3D_EXTENSIONS
 
     kQ3DisplayGroupStateMaskSize32              = 0xFFFFFFFF
@@ -76,7 +76,7 @@ extern "C" {
 	@constant	kQ3MemoryStatisticsStructureVersion
 	@abstract	Current version of TQ3MemoryStatistics structure.
 */
-#define	kQ3MemoryStatisticsStructureVersion	1
+#define	kQ3MemoryStatisticsStructureVersion	2
 
 
 
@@ -95,6 +95,13 @@ extern "C" {
 	@field		currentBytes		Current number of memory bytes allocated by Quesa.
 	@field		maxBytes			Maximum number of memory bytes allocated by Quesa
 									("high-water mark").
+	@field		instancePoolAllocations	Number of object instances allocated from
+									the per-class instance pools.
+									Only filled in for structure version 2 or later.
+	@field		instancePoolHits	Number of those pool allocations that reused a
+									previously disposed instance, rather than
+									growing the pool.
+									Only filled in for structure version 2 or later.
 */
 typedef struct TQ3MemoryStatistics
 {
@@ -103,6 +110,8 @@ typedef struct TQ3MemoryStatistics
 	TQ3Uns32	maxAllocations;
 	TQ3Int64	currentBytes;
 	TQ3Int64	maxBytes;
+	TQ3Uns32	instancePoolAllocations;
+	TQ3Uns32	instancePoolHits;
 } TQ3MemoryStatistics;
 
 
@@ -349,6 +358,9 @@ Q3Memory_StartRecording(
  *	@discussion
  *      Stop recording allocations of Quesa objects.
  *
+ *      This also returns any memory that the per-class instance free-lists
+ *      are holding but no longer using to the heap.
+ *
  *      In non-debug builds, this function does nothing.
  *
  *      <em>This function is not available in QD3D.</em>
@@ -531,6 +543,106 @@ Q3Memory_GetStatistics(
 
 
 
+/*!
+ *	@function
+ *		Q3Memory_StartProfiling
+ *	@abstract
+ *		Start sampling memory allocations made by Quesa.
+ *
+ *	@discussion
+ *		Starts a sampling allocation profiler, discarding any previous profile.
+ *		Roughly one allocation is sampled for every sampleInterval bytes
+ *		allocated, so the overhead of profiling is low enough to leave on while
+ *		rendering a frame.
+ *
+ *		Each sample is attributed to the classes of the objects being created
+ *		or submitted when it was made and, on platforms which support stack
+ *		crawls, to the function which made the allocation.
+ *		
+ *		In non-debug builds (compiled with Q3_DEBUG or Q3_MEMORY_DEBUG set to 0)
+ *		this function returns kQ3Failure.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@param		sampleInterval		Average number of bytes between samples, or 0
+ *									for the default of 64K.
+ *	@result		Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status )
+Q3Memory_StartProfiling(
+	TQ3Uns32						sampleInterval
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *	@function
+ *		Q3Memory_StopProfiling
+ *	@abstract
+ *		Stop sampling memory allocations.
+ *
+ *	@discussion
+ *		The samples collected so far are kept until the next call to
+ *		Q3Memory_StartProfiling, or until Quesa is shut down.
+ *		
+ *		In non-debug builds this function returns kQ3Failure.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@result		Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status )
+Q3Memory_StopProfiling(
+	void
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *	@function
+ *		Q3Memory_DumpProfile
+ *	@abstract
+ *		Write the allocation profile to a file.
+ *
+ *	@discussion
+ *		Writes the samples collected by the allocation profiler as "folded
+ *		stacks", which can be read by flamegraph.pl, speedscope, or pprof.
+ *		Each line holds a semicolon-separated path of class names (outermost
+ *		first), followed by the allocating function where known, and the
+ *		estimated number of bytes or allocations for that path.
+ *
+ *		If there is already a file in the default directory with the specified
+ *		name, it is replaced. Must be called before Q3Exit shuts down Quesa.
+ *		
+ *		In non-debug builds this function returns kQ3Failure.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@param		fileName		Name of profile file.
+ *	@param		countCalls		If kQ3True, write the estimated number of allocations
+ *								rather than the estimated number of bytes.
+ *	@result		Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status )
+Q3Memory_DumpProfile(
+	const char* _Nonnull			fileName,
+	TQ3Boolean						countCalls
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
 	@function	Q3Memory_GetObjectCount
 	@abstract	Get a count of Quesa objects currently in existence.
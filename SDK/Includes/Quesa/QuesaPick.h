@@ -257,6 +257,34 @@ typedef struct TQ3WorldRayPickData {
 } TQ3WorldRayPickData;
 
 
+/*!
+ *  @struct
+ *      TQ3WorldRayBatchPickData
+ *  @discussion
+ *      Describes the state for a world-ray batch pick object.
+ *
+ *      A batch pick tests several rays in a single submit, and keeps the
+ *      nearest hit of each ray. The ray field of data is not used, and the
+ *      sort and numHitsToReturn fields are ignored.
+ *
+ *      <em>This structure is not available in QD3D.</em>
+ *
+ *  @field data             The common state for the pick.
+ *  @field numRays          The number of rays in the batch.
+ *  @field rays             The pick rays in world coordinates.  The directions
+ *							must be normalized.  The rays are copied.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+typedef struct TQ3WorldRayBatchPickData {
+    TQ3WorldRayPickData                         data;
+    TQ3Uns32                                    numRays;
+    const TQ3Ray3D                              * _Nullable rays;
+} TQ3WorldRayBatchPickData;
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 /*!
  *  @struct
  *      TQ3HitPath
@@ -868,6 +896,150 @@ Q3WorldRayPick_SetData (
     const TQ3WorldRayPickData     * _Nonnull data
 );
 
+
+
+/*!
+	@functiongroup	World Ray Batch Picking
+*/
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_New
+ *  @discussion
+ *      Create a new world-ray batch pick object.
+ *
+ *      A batch pick is a kind of world-ray pick, so Q3Pick_GetType returns
+ *      kQ3PickTypeWorldRay for it, and the world-ray pick functions may be
+ *      used to change its tolerances. Submitting objects to it finds the
+ *      nearest hit of every ray at once, which is much faster than picking
+ *      each ray in turn when many rays are cast into the same scene.
+ *
+ *      The hit list holds at most one hit per ray, in no particular order.
+ *      Use Q3WorldRayBatchPick_GetHitIndex to find the hit of a ray.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param data             The data for the pick object.
+ *  @result                 The new pick object.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3PickObject _Nullable )
+Q3WorldRayBatchPick_New (
+    const TQ3WorldRayBatchPickData     * _Nonnull data
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetNumRays
+ *  @discussion
+ *      Get the number of rays of a world-ray batch pick object.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to query.
+ *  @param numRays          Receives the number of rays of the pick object.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetNumRays (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                      * _Nonnull numRays
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetRay
+ *  @discussion
+ *      Get one of the rays of a world-ray batch pick object.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to query.
+ *  @param rayIndex         The index of the ray.
+ *  @param ray              Receives the ray.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetRay (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                              rayIndex,
+    TQ3Ray3D                      * _Nonnull ray
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_SetRays
+ *  @discussion
+ *      Set the rays of a world-ray batch pick object.
+ *
+ *      The rays are copied, and the hit list of the pick is emptied.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to update.
+ *  @param numRays          The number of rays.
+ *  @param rays             The new rays for the pick object.  The directions
+ *							must be normalized.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_SetRays (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                              numRays,
+    const TQ3Ray3D                * _Nullable rays
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetHitIndex
+ *  @discussion
+ *      Get the index in the hit list of the nearest hit of a ray.
+ *
+ *      The index may be passed to Q3Pick_GetPickDetailData to find out
+ *      about the hit. If the ray did not hit anything, hitIndex is set to
+ *      kQ3ArrayIndexNULL.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param pick             The pick object to query.
+ *  @param rayIndex         The index of the ray.
+ *  @param hitIndex         Receives the index of the hit of the ray.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetHitIndex (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                              rayIndex,
+    TQ3Uns32                      * _Nonnull hitIndex
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
 /*!
 	@functiongroup	Object Parts
 */
@@ -0,0 +1,264 @@
+/*! @header QuesaStats.h
+        Declares the Quesa per-class instrumentation API.
+         
+	@ignore	_Nullable
+	@ignore _Nonnull
+	@ignore	_Null_unspecified
+ */
+/*  NAME:
+        QuesaStats.h
+
+    DESCRIPTION:
+        Quesa public header.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2018, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <http://www.quesa.org/>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef QUESA_STATS_HDR
+#define QUESA_STATS_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "Quesa.h"
+
+
+
+
+
+//=============================================================================
+//      C++ preamble
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+//=============================================================================
+//      Constants
+//-----------------------------------------------------------------------------
+/*!
+	@constant	kQ3ClassStatisticsStructureVersion
+	@abstract	Current version of TQ3ClassStatistics structure.
+*/
+#define	kQ3ClassStatisticsStructureVersion	1
+
+
+/*!
+ *  @enum
+ *      TQ3StatsMethod
+ *  @discussion
+ *      The submit methods which are counted and timed for each class.
+ *
+ *  @constant kQ3StatsMethodRender              Submits while rendering.
+ *  @constant kQ3StatsMethodPick                Submits while picking.
+ *  @constant kQ3StatsMethodBounds              Submits while calculating bounds.
+ *  @constant kQ3StatsMethodWrite               Submits while writing.
+ *  @constant kQ3StatsMethodCount               The number of submit methods.
+ */
+typedef enum TQ3StatsMethod {
+    kQ3StatsMethodRender                        = 0,
+    kQ3StatsMethodPick                          = 1,
+    kQ3StatsMethodBounds                        = 2,
+    kQ3StatsMethodWrite                         = 3,
+    kQ3StatsMethodCount                         = 4,
+    kQ3StatsMethodSize32                        = 0xFFFFFFFF
+} TQ3StatsMethod;
+
+
+
+
+
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+/*!
+	@struct		TQ3ClassStatistics
+	@abstract	Parameter structure for Q3Stats_GetClassStatistics.
+	@discussion	The submit arrays are indexed by TQ3StatsMethod.
+	@field		structureVersion	Version of this structure.
+									Initialize to kQ3ClassStatisticsStructureVersion.
+	@field		classType			The class the statistics are for.
+	@field		numInstances		Current number of instances of the class.
+	@field		numSubmits			Number of objects of the class submitted
+									since statistics were last reset.
+	@field		totalTime			Time in seconds spent in the submit method of
+									the class, including any objects it submitted
+									in turn (for example, the members of a group).
+	@field		selfTime			Time in seconds spent in the submit method of
+									the class, excluding any objects it submitted
+									in turn.
+*/
+typedef struct TQ3ClassStatistics
+{
+	TQ3Uns32		structureVersion;
+	TQ3ObjectType	classType;
+	TQ3Uns32		numInstances;
+	TQ3Uns32		numSubmits[kQ3StatsMethodCount];
+	TQ3Float64		totalTime[kQ3StatsMethodCount];
+	TQ3Float64		selfTime[kQ3StatsMethodCount];
+} TQ3ClassStatistics;
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+/*!
+ *	@function
+ *		Q3Stats_IsAvailable
+ *	@abstract
+ *		Test whether per-class statistics are being collected.
+ *
+ *	@discussion
+ *		Statistics are only collected when Quesa is built with QUESA_CLASS_STATS
+ *		set to 1. Otherwise the collection code is compiled out completely, and
+ *		the other Q3Stats functions return kQ3Failure.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@result		True if statistics are being collected.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Boolean )
+Q3Stats_IsAvailable(
+	void
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *	@function
+ *		Q3Stats_Reset
+ *	@abstract
+ *		Reset the submit counts and times of every class.
+ *
+ *	@discussion
+ *		Call this at the start of a frame, and read the statistics at the end
+ *		of it, to find out where the time in that frame was spent.
+ *
+ *		Instance counts are not affected.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@result		Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status )
+Q3Stats_Reset(
+	void
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *	@function
+ *		Q3Stats_GetClassStatistics
+ *	@abstract
+ *		Get the statistics collected for a class.
+ *
+ *	@discussion
+ *		Submits are attributed to the leaf class of the submitted object, so
+ *		the statistics for a base class such as kQ3ShapeTypeGeometry do not
+ *		include those of its sub-classes.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@param		classType	The class to query.
+ *	@param		info		Structure to receive the statistics.  You must initialize
+ *							the structureVersion field to kQ3ClassStatisticsStructureVersion.
+ *	@result		Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status )
+Q3Stats_GetClassStatistics(
+	TQ3ObjectType					classType,
+	TQ3ClassStatistics* _Nonnull	info
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *	@function
+ *		Q3Stats_Dump
+ *	@abstract
+ *		Write the statistics of every class to a text file.
+ *
+ *	@discussion
+ *		Writes one line for each class which has been submitted since the
+ *		statistics were last reset, giving its instance count and the submit
+ *		count, total time, and self time of each submit method.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *	@param		fileName	A file name or path to which the statistics will be written.
+ *	@result		Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status )
+Q3Stats_Dump(
+	const char* _Nonnull	fileName
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+
+
+//=============================================================================
+//      C++ postamble
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
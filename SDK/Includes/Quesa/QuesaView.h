@@ -496,6 +496,55 @@ Q3View_EndPicking (
 
 
 
+/*!
+ *  @function
+ *      Q3View_SubmitParallel
+ *  @discussion
+ *      Submit a display group to a view, splitting the traversal of its
+ *      top-level children across several threads.
+ *
+ *      Use this in place of Q3Object_Submit within a bounding or picking
+ *      loop. Each thread submits a run of the children to a view of its
+ *      own, starting from the current state of the view, and the results
+ *      are merged into the view once they have all finished. Hits are
+ *      added to the pick in the same order as a normal submit would add
+ *      them.
+ *
+ *      A child that may change the view state seen by the children after
+ *      it, such as a transform or an inline group, means the children
+ *      can't be split. In that case, or in a rendering or writing loop,
+ *      or in builds without QUESA_PARALLEL_TRAVERSAL, the group is simply
+ *      submitted.
+ *
+ *      The objects within the group must not be changed by another thread
+ *      while it is being submitted, and an error handler may be called on
+ *      any of the threads.
+ *
+ *      Since QUESA_PARALLEL_TRAVERSAL needs QUESA_ATOMIC_REFCOUNTS, and the
+ *      pick hierarchies of display groups and TriMeshes are off by default
+ *      in those builds, parallel picks test every member and triangle.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view to submit the group to.
+ *  @param group            The display group to submit.
+ *  @param numThreads       The most threads to use, or 0 to use one per
+ *                          processor.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3View_SubmitParallel (
+    TQ3ViewObject _Nonnull                view,
+    TQ3GroupObject _Nonnull               group,
+    TQ3Uns32                      numThreads
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
  *  @function
  *      Q3View_GetCamera
@@ -816,6 +865,39 @@ Q3View_AllowAllGroupCulling (
 
 
 
+/*!
+ *  @function
+ *      Q3View_GetGeometryCounts
+ *  @discussion
+ *      Get the number of geometries submitted to the renderer, and the
+ *      number culled before reaching it, since the start of the current
+ *      or most recent frame.
+ *
+ *      While group culling is allowed, retained geometries are culled
+ *      against their bounding boxes. Geometries which are decomposed are
+ *      counted by the forms that reach the renderer. Geometries submitted
+ *      by passes after the first are counted again.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view to query.
+ *  @param numSubmitted     Receives the number of geometries submitted to the renderer.
+ *  @param numCulled        Receives the number of geometries culled.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3View_GetGeometryCounts (
+    TQ3ViewObject _Nonnull                view,
+    TQ3Uns32                      * _Nonnull numSubmitted,
+    TQ3Uns32                      * _Nonnull numCulled
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
  *  @function
  *      Q3View_TransformLocalToWorld